@@ -7,6 +7,7 @@
 #include <string.h>
 #include <core/memory.h>
 #include <core/hashing.h>
+#include <core/simd.h>
 
 // TEMPLATE
 
@@ -29,6 +30,9 @@
 // to create new stack_subarrays
 #define partial_array(type) partial_##type##_##array
 
+// the amount the capacity of an array is multiplied by when it grows, unless the array has its own GrowthFactor
+#define ARRAY_DEFAULT_GROWTH_FACTOR 2.0f
+
 #define _EXPAND_STRUCT_NAME(type) _array_##type
 #define _EXPAND_METHOD_NAME(type, method) _array_##type##_##method
 
@@ -54,8 +58,17 @@
 	bool Dirty;\
 	/* The Hash of this array */\
 	ulong Hash;\
-	/* Whether or not this array is auto hashed, default is true */\
+	/* The state of the hash after the last complete block of the values, lets Append hash only the appended bytes */\
+	ulong HashState;\
+	/* Whether or not Append keeps the Hash up to date, arrays from Create default to false\
+	and are hashed on demand by Hash() */\
 	bool AutoHash;\
+	/* The amount the capacity is multiplied by when the array grows, 0 uses ARRAY_DEFAULT_GROWTH_FACTOR */\
+	float GrowthFactor;\
+	/* The minimum capacity the array grows to the next time it grows, cleared once it's used */\
+	ulong ReserveHint;\
+	/* Whether or not Values is stored in the same block of memory as the array, see small_array */\
+	bool InlineStorage;\
 }; \
 typedef struct _array_##type partial_##type##_##array;\
 typedef struct _array_##type* type##_array;
@@ -100,6 +113,11 @@ typedef struct _array_##type* type##_array;
 #define _dynamic_array(type, initialCount) _EXPAND_METHOD_NAME(type,Create)(initialCount) 
 #define dynamic_array(type, initialCount) _dynamic_array(type, initialCount)
 
+#define _small_array(type, inlineCount) _EXPAND_METHOD_NAME(type,CreateSmall)(inlineCount) 
+// Creates an array(type) that stores up to inlineCount elements in the same allocation as the array
+// and only moves them to the heap once it grows past inlineCount, works with every arrays(type) method
+#define small_array(type, inlineCount) _small_array(type, inlineCount)
+
 // checks the corresponding attribute against the provided value
 // throws if the value is out of bounds, otherwise returns value
 #define guard_array_attribute(arr,attribute,value) ((value) > (arr)->attribute ? throw_in_expression(IndexOutOfRangeException) : (value))
@@ -224,11 +242,28 @@ typedef array(void) Array;
 
 DEFINE_TYPE_ID(Array);
 
+// The type of the key RadixSort reads from each element
+enum RadixKey {
+	RadixKeyInt,
+	RadixKeyUlong,
+	RadixKeyFloat
+};
+
 struct _arrayMethods
 {
 	Array(*Create)(ulong elementSize, ulong count, ulong typeId);
+	// Creates an array with room for count elements stored in the same allocation as the array itself
+	Array(*CreateSmall)(ulong elementSize, ulong count, ulong typeId);
 	void (*AutoResize)(Array);
 	void (*Resize)(Array, ulong newCount);
+	// Grows the backing array so it can store at least count elements without resizing
+	void (*Reserve)(Array, ulong count);
+	// Shrinks the backing array so it only stores the elements currently in the array
+	void (*ShrinkToFit)(Array);
+	// Sets how the array grows, the capacity is multiplied by growthFactor(0 for the default) when the array is full
+	// and the next growth reserves at least reserveHint elements, throws InvalidArgumentException when growthFactor
+	// isn't 0 and isn't greater than 1
+	void (*SetGrowthPolicy)(Array, float growthFactor, ulong reserveHint);
 	// Appends the given item to the end of the array
 	void (*Append)(Array, void*);
 	// Removes the given index, moving all contents to the left
@@ -238,6 +273,15 @@ struct _arrayMethods
 	void (*Swap)(Array, ulong firstIndex, ulong secondIndex);
 	// Insertion sorts given the provided comparator Func
 	void (*InsertionSort)(Array, bool(comparator)(void* leftMemoryBlock, void* rightMemoryBlock));
+	// Sorts the array with introsort, the comparator returns true when left belongs after right,
+	// doesn't preserve the order of equal elements
+	void (*Sort)(Array, bool(comparator)(void* leftMemoryBlock, void* rightMemoryBlock));
+	// Merge sorts the array preserving the order of equal elements, the scratch buffer is taken from the
+	// arena and released before returning, or from the heap when scratch is null
+	void (*StableSort)(Array, bool(comparator)(void* leftMemoryBlock, void* rightMemoryBlock), Arena scratch);
+	// Sorts the array in ascending order of the int, ulong or float key found keyOffset bytes into each element,
+	// preserves the order of equal elements, scratch is used the same way as StableSort
+	void (*RadixSort)(Array, enum RadixKey key, ulong keyOffset, Arena scratch);
 	// Gets a pointer to the value contained at index
 	void* (*At)(Array, ulong index);
 	// Appends the given value array to the end of the given array
@@ -245,6 +289,8 @@ struct _arrayMethods
 	Array(*InsertArray)(Array dest, Array src, ulong index);
 	void (*Clear)(Array array);
 	bool (*Equals)(Array left, Array right);
+	// Gets the hash of the values of the array, only rehashing them when the array changed since the last hash
+	ulong(*Hash)(Array);
 	void (*Foreach)(Array, void(*method)(void*));
 	void (*ForeachWithContext)(Array, void* context, void(*method)(void* context, void* item));
 	void (*Dispose)(Array);
@@ -260,6 +306,11 @@ private array(type) _EXPAND_METHOD_NAME(type,Create)(ulong count)\
 REGISTER_TYPE(type##_array); \
 return (array(type))Arrays.Create(sizeof(type), count, type##_arrayTypeId); \
 }\
+private array(type) _EXPAND_METHOD_NAME(type,CreateSmall)(ulong count)\
+{\
+REGISTER_TYPE(type##_array); \
+return (array(type))Arrays.CreateSmall(sizeof(type), count, type##_arrayTypeId); \
+}\
 private void _EXPAND_METHOD_NAME(type,AutoResize)(array(type) array)\
 {\
 Arrays.AutoResize((Array)array); \
@@ -268,6 +319,21 @@ private void _EXPAND_METHOD_NAME(type,Resize)(array(type) array, ulong newCount)
 {\
 Arrays.Resize((Array)array, newCount); \
 }\
+private array(type) _EXPAND_METHOD_NAME(type,Reserve)(array(type) array, ulong count)\
+{\
+Arrays.Reserve((Array)array, count); \
+return array;\
+}\
+private array(type) _EXPAND_METHOD_NAME(type,ShrinkToFit)(array(type) array)\
+{\
+Arrays.ShrinkToFit((Array)array); \
+return array;\
+}\
+private array(type) _EXPAND_METHOD_NAME(type,SetGrowthPolicy)(array(type) array, float growthFactor, ulong reserveHint)\
+{\
+Arrays.SetGrowthPolicy((Array)array, growthFactor, reserveHint); \
+return array;\
+}\
 private array(type) _EXPAND_METHOD_NAME(type,Append)(array(type)array, type value)\
 {\
 Arrays.Append((Array)array, &value); \
@@ -329,6 +395,18 @@ private void _EXPAND_METHOD_NAME(type, InsertionSort)(array(type) array, bool(co
 {\
 Arrays.InsertionSort((Array)array, comparator); \
 }\
+private void _EXPAND_METHOD_NAME(type, Sort)(array(type) array, bool(comparator)(type* leftMemoryBlock, type* rightMemoryBlock))\
+{\
+Arrays.Sort((Array)array, comparator); \
+}\
+private void _EXPAND_METHOD_NAME(type, StableSort)(array(type) array, bool(comparator)(type* leftMemoryBlock, type* rightMemoryBlock), Arena scratch)\
+{\
+Arrays.StableSort((Array)array, comparator, scratch); \
+}\
+private void _EXPAND_METHOD_NAME(type, RadixSort)(array(type) array, enum RadixKey key, ulong keyOffset, Arena scratch)\
+{\
+Arrays.RadixSort((Array)array, key, keyOffset, scratch); \
+}\
 private type _EXPAND_METHOD_NAME(type, ValueAt)(array(type) array, ulong index)\
 {\
 return at(array,index); \
@@ -370,12 +448,7 @@ Arrays.Dispose((Array)array); \
 }\
 private ulong _EXPAND_METHOD_NAME(type, Hash)(array(type) array)\
 {\
-if(array->Dirty)\
-{\
-	array->Dirty = false;\
-	array->Hash = Hashing.HashSafe((byte*)array->Values, array->Count * array->ElementSize);\
-}\
-return array->Hash; \
+return Arrays.Hash((Array)array); \
 }\
 private bool _EXPAND_METHOD_NAME(type, Equals)(array(type) left, array(type) right)\
 {\
@@ -389,10 +462,8 @@ return Arrays.Equals((Array)sub, (Array)value); \
 }\
 private array(type) _EXPAND_METHOD_NAME(type, Fill)(array(type) array, type value)\
 {\
-	for(int i = 0; i < array->Count; i++)\
-	{\
-		at(array, i) = value;\
-	}array->Dirty = true;array->Hash = 0;\
+	Simd.Fill(array->Values, array->Count, sizeof(type), &value);\
+	array->Dirty = true;array->Hash = 0;\
 	return array;\
 }\
 private type _EXPAND_METHOD_NAME(type, Last)(array(type)array)\
@@ -409,14 +480,12 @@ private type _EXPAND_METHOD_NAME(type, Pop)(array(type)array)\
 }\
 private int _EXPAND_METHOD_NAME(type, IndexOf)(array(type) array, type value)\
 {\
-for (int i = 0; i < array->Count; i++)\
-{\
-if (memcmp(&value, &(at(array, i)), array->ElementSize) is 0)\
-{\
-return i; \
-}\
+const ulong index = Simd.FindFirstEqual(array->Values, array->Count, sizeof(type), &value); \
+return index is SIMD_NOT_FOUND ? -1 : (int)index; \
 }\
-return -1; \
+private ulong _EXPAND_METHOD_NAME(type, CountOf)(array(type) array, type value)\
+{\
+return Simd.Count(array->Values, array->Count, sizeof(type), &value); \
 }\
 private void _EXPAND_METHOD_NAME(type, Print)(void* stream, array(type) array)\
 {\
@@ -461,14 +530,21 @@ return null; \
 const static struct _array_##type##_methods\
 {\
 array(type) (*Create)(ulong count); \
+array(type) (*CreateSmall)(ulong inlineCount); \
 void (*AutoResize)(array(type)); \
 void (*Resize)(array(type), ulong newCount); \
+array(type) (*Reserve)(array(type), ulong count); \
+array(type) (*ShrinkToFit)(array(type)); \
+array(type) (*SetGrowthPolicy)(array(type), float growthFactor, ulong reserveHint); \
 array(type) (*Append)(array(type), type); \
 void (*RemoveIndex)(array(type), ulong index); \
 array(type) (*RemoveRange)(array(type), ulong startIndex, ulong count); \
 bool (*Empty)(array(type)); \
 void (*Swap)(array(type), ulong firstIndex, ulong secondIndex); \
 void (*InsertionSort)(array(type), bool(comparator)(type* left, type* right)); \
+void (*Sort)(array(type), bool(comparator)(type* left, type* right)); \
+void (*StableSort)(array(type), bool(comparator)(type* left, type* right), Arena scratch); \
+void (*RadixSort)(array(type), enum RadixKey key, ulong keyOffset, Arena scratch); \
 type* (*At)(array(type), ulong index); \
 type(*ValueAt)(array(type), ulong index); \
 array(type) (*AppendArray)(array(type), const array(type) appendedValue); \
@@ -480,6 +556,8 @@ array(type) (*Clear)(array(type)); \
 void (*Foreach)(array(type), void(*method)(type*)); \
 void (*ForeachWithContext)(array(type), void* context, void(*method)(void*, type*)); \
 int (*IndexOf)(array(type), type); \
+/* Gets the number of elements equal to the value */\
+ulong (*CountOf)(array(type), type); \
 int (*IndexWhere)(array(type), void* state, bool(*Expression)(type value, void* state)); \
 type(*Select)(array(type), void* state, bool(*Expression)(type value, void* state)); \
 array(type) (*Any)(array(type), void* state, bool(*Expression)(type value, void* state)); \
@@ -494,14 +572,21 @@ void (*Dispose)(array(type)); \
 } type##_array##Arrays = \
 {\
 .Create = _EXPAND_METHOD_NAME(type, Create), \
+.CreateSmall = _EXPAND_METHOD_NAME(type, CreateSmall), \
 .AutoResize = _EXPAND_METHOD_NAME(type, AutoResize), \
 .Resize = _EXPAND_METHOD_NAME(type, Resize), \
+.Reserve = _EXPAND_METHOD_NAME(type, Reserve), \
+.ShrinkToFit = _EXPAND_METHOD_NAME(type, ShrinkToFit), \
+.SetGrowthPolicy = _EXPAND_METHOD_NAME(type, SetGrowthPolicy), \
 .Append = _EXPAND_METHOD_NAME(type, Append), \
 .RemoveIndex = _EXPAND_METHOD_NAME(type, RemoveIndex), \
 .RemoveRange = _EXPAND_METHOD_NAME(type, RemoveRange), \
 .Empty = _EXPAND_METHOD_NAME(type, Empty), \
 .Swap = _EXPAND_METHOD_NAME(type, Swap), \
 .InsertionSort = _EXPAND_METHOD_NAME(type, InsertionSort), \
+.Sort = _EXPAND_METHOD_NAME(type, Sort), \
+.StableSort = _EXPAND_METHOD_NAME(type, StableSort), \
+.RadixSort = _EXPAND_METHOD_NAME(type, RadixSort), \
 .At = _EXPAND_METHOD_NAME(type, At), \
 .ValueAt = _EXPAND_METHOD_NAME(type, ValueAt), \
 .AppendArray = _EXPAND_METHOD_NAME(type, AppendArray), \
@@ -519,6 +604,7 @@ void (*Dispose)(array(type)); \
 .Push = _EXPAND_METHOD_NAME(type, Append), \
 .Last = _EXPAND_METHOD_NAME(type, Last), \
 .IndexOf = _EXPAND_METHOD_NAME(type, IndexOf), \
+.CountOf = _EXPAND_METHOD_NAME(type, CountOf), \
 .IndexWhere = _EXPAND_METHOD_NAME(type, IndexWhere), \
 .Select = _EXPAND_METHOD_NAME(type, Select), \
 .Any = _EXPAND_METHOD_NAME(type, Any), \
@@ -595,8 +681,6 @@ DEFINE_TUPLE_BOTH_WAYS(type,string);
 
 #define FORWARD_CONTAINER_TYPE(type) struct _EXPAND_STRUCT_NAME(type); typedef struct _array_##type* type##_array;
 
-DEFINE_TUPLE_INTRINSIC(string);
-
 typedef void* void_ptr;
 DEFINE_CONTAINERS(void_ptr);
 DEFINE_CONTAINERS(array(int));
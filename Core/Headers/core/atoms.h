@@ -0,0 +1,47 @@
+#pragma once
+
+#include "core/csharp.h"
+#include "core/array.h"
+
+// the most strings that can be interned, atoms are never released so this only limits how many unique strings exist
+#define ATOMS_MAX_COUNT (1024 * 1024 * 4)
+
+// A handle to an interned string, every copy of the same string interns to the same atom so atoms
+// can be compared and hashed as integers instead of comparing their bytes
+typedef struct {
+	// The index of the interned string, 0 is the empty atom that doesn't refer to any string
+	uint Id;
+	// The length, in bytes, of the interned string
+	uint Length;
+	// The hash of the interned string, the same as Hashing.HashSafe of its bytes
+	ulong Hash;
+} atom;
+
+// the atom that doesn't refer to any string, returned when interning fails or a string wasn't found
+static const atom EmptyAtom = { 0 };
+
+// Compares two atoms by id
+#define atom_equals(left, right) ((left).Id == (right).Id)
+
+struct _atomMethods {
+	// Interns the given bytes and returns their atom, the bytes are copied the first time they're interned,
+	// safe to call from any thread
+	atom(*Intern)(const char* bytes, ulong length);
+	// Interns the contents of the given string
+	atom(*InternString)(const string);
+	// Interns a null terminated string
+	atom(*InternCString)(const char* cString);
+	// Gets the atom of the given bytes without interning them, returns false if they were never interned
+	bool (*TryFind)(const char* bytes, ulong length, atom* out_atom);
+	// Gets the interned string of the atom, the string is null terminated, lives until the program
+	// exits and must never be modified or disposed
+	string(*String)(atom);
+	// Gets the null terminated bytes of the atom, "" for the empty atom
+	const char* (*CString)(atom);
+	bool (*Equals)(atom left, atom right);
+	// The number of unique strings that have been interned
+	ulong(*Count)(void);
+	void (*RunUnitTests)();
+};
+
+extern const struct _atomMethods Atoms;
@@ -0,0 +1,23 @@
+#pragma once
+
+#include "core/csharp.h"
+
+// the largest number of bytes Compression.Compress can write for the given number of input bytes
+#define COMPRESSION_BOUND(size) ((size) + ((size) / 255) + 16)
+
+struct _compressionMethods {
+	/// <summary>
+	/// Compresses the bytes into destination using the LZ4 block format, favours decompression speed over ratio
+	/// </summary>
+	/// <returns>The number of bytes written, 0 when destination is smaller than COMPRESSION_BOUND(size)</returns>
+	ulong(*Compress)(const byte* source, ulong size, byte* destination, ulong destinationSize);
+	/// <summary>
+	/// Decompresses an LZ4 block into destination, every read and write is bounds checked so corrupt blocks fail
+	/// instead of overrunning the buffers
+	/// </summary>
+	/// <returns>false if the block is corrupt or doesn't fit within destination, otherwise sets the number of bytes written</returns>
+	bool (*TryDecompress)(const byte* source, ulong size, byte* destination, ulong destinationSize, ulong* out_size);
+	void (*RunUnitTests)();
+};
+
+extern const struct _compressionMethods Compression;
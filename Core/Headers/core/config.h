@@ -3,6 +3,12 @@
 #include "core/file.h"
 #include "core/array.h"
 
+// define CONFIG_CACHE to cache configs with a binary layout after they're parsed, see _configDefinition.SaveBinary
+// the cache is written next to the config as <path>.cache, it's only faster than parsing the text when both are read
+// from a pack, so it's off unless the build ships packed caches
+// appended to the path of a config to get the path of its cache
+#define CONFIG_CACHE_EXTENSION ".cache"
+
 struct _configToken
 {
 	const char* Token;
@@ -33,6 +39,15 @@ static bool __AbortTokenReturnTrue(const char* buffer, const ulong length, void*
 
 typedef const struct _configDefinition* ConfigDefinition;
 
+/// <summary>
+/// Reads the fixed layout blob written by _configDefinition.SaveBinary, every read is bounds checked
+/// </summary>
+typedef struct {
+	const byte* Values;
+	ulong Count;
+	ulong Position;
+} ConfigReader;
+
 struct _configDefinition {
 	// list of tokens
 	const struct _configToken* Tokens;
@@ -48,6 +63,20 @@ struct _configDefinition {
 	/// The token that when encountered should signify continued config reading should be aborted
 	/// </summary>
 	struct _configToken AbortToken;
+	/// <summary>
+	/// OPTIONAL: The version of the layout written by SaveBinary, caches written with a different version are parsed from the text again
+	/// </summary>
+	const uint BinaryVersion;
+	/// <summary>
+	/// OPTIONAL: Writes the state loaded from the text to the blob with a fixed layout, the text stays the source of truth and the
+	/// blob is only used while the text's hash matches
+	/// </summary>
+	void (*SaveBinary)(string blob, void* state);
+	/// <summary>
+	/// OPTIONAL: Loads the state from a blob written by SaveBinary instead of parsing the text, must leave the state untouched
+	/// when it returns false so the text can be parsed instead
+	/// </summary>
+	bool (*TryLoadBinary)(ConfigReader* reader, void* state);
 };
 
 #define DEFINE_CONFIG(name,optionalBody) static const struct _configDefinition name##ConfigDefinition = {\
@@ -61,7 +90,7 @@ struct _configDefinition {
 
 struct _configMethods {
 	/// <summary>
-	/// Attempts to open the given path and locate each token within the config definition, once found OnTokenFound within the definition is invoked
+	/// Attempts to load the state from the path's cache when its hash matches the text, otherwise maps the given path and locates each token within the config definition, once found OnTokenFound within the definition is invoked
 	/// with the index of the token within the token array and the data for that token, along with the state pointer originally passed to the method,
 	/// this method returns true when all calls to OnTokenFound return true and no file error occurs, otherwise false
 	/// </summary>
@@ -74,8 +103,25 @@ struct _configMethods {
 	/// </summary>
 	bool (*TryLoadConfigStream)(File stream, const ConfigDefinition, void* state);
 
+	/// <summary>
+	/// Locates each token within the buffer without copying it, each line is dispatched to its token with a single hash lookup
+	/// and TokenLoad is handed a slice of the buffer that ends before the line's newline and isn't nul terminated,
+	/// this method returns true when all calls to TokenLoad return true
+	/// </summary>
+	bool (*TryLoadConfigBuffer)(const char* buffer, ulong length, const ConfigDefinition, void* state);
+
 	void (*SaveConfig)(const string path, const ConfigDefinition, void* state);
 	void (*SaveConfigStream)(File stream, const ConfigDefinition, void* state);
+
+	// appends the bytes to the blob
+	void (*Write)(string blob, const void* values, ulong size);
+	// appends the length of the string followed by its characters to the blob, null strings are written so they're read back as null
+	void (*WriteString)(string blob, const char* value, ulong length);
+	// copies the next size bytes of the blob into destination
+	bool (*TryRead)(ConfigReader* reader, void* destination, ulong size);
+	// sets the out value to a slice of the next string within the blob, without copying it, null strings are read as null
+	bool (*TryReadString)(ConfigReader* reader, const char** out_value, ulong* out_length);
+	void (*RunUnitTests)();
 };
 
 extern const struct _configMethods Configs;
\ No newline at end of file
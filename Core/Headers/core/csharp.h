@@ -5,7 +5,12 @@
 #endif // !_csharp_h_
 
 #include <stdbool.h>
+#ifdef _MSC_VER
 #include <intrin.h>
+#else
+#include <x86intrin.h>
+#endif
+#include "core/portable.h"
 #include "core/exceptions.h"
 #include <stdio.h>
 #include <stdlib.h>
@@ -117,7 +122,12 @@ static int BreakDebugger(int errorCode)
 #define STATIC_LIB_API
 #endif
 
+#ifdef _MSC_VER
 #define public STATIC_LIB_API inline
+#else
+// gcc and clang only emit an inline function where it's inlined, weak keeps one callable definition per module
+#define public STATIC_LIB_API __attribute__((weak))
+#endif
 
 #define atomic _Atomic
 
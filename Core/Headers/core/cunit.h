@@ -108,7 +108,7 @@ private bool _PrintStringDifferences(void* stream, void* left, void* right)
 static int _DangerousPrintString(void* str)
 {
 	string s = (string)str;
-	fprintf(stdout, "%s", s ? s->Values ? s->Values : "Null String" : "Null Array");
+	fprintf(stdout, "%s", s ? s->Values ? (char*)s->Values : "Null String" : "Null Array");
 	return true;
 }
 
@@ -0,0 +1,31 @@
+#pragma once
+
+#include "core/csharp.h"
+#include "core/array.h"
+
+// the most phases a graph can run at once
+#define EVENT_GRAPH_MAX_PHASES 8
+
+typedef void(*EventMethod)(void);
+
+typedef struct _eventGraph* EventGraph;
+
+struct _eventGraphMethods {
+	EventGraph (*Create)(void);
+	// Declares that the method reads the resource, a resource is any name shared by the methods that use it
+	// methods that only declare the resources they use don't wait on whole phases, only on the methods they conflict with
+	void (*Reads)(EventGraph, EventMethod method, const char* resource);
+	// Declares that the method writes the resource, it runs after every earlier method that uses the resource and
+	// before every later one
+	void (*Writes)(EventGraph, EventMethod method, const char* resource);
+	// Declares that the method only starts once the dependency finished
+	void (*DependsOn)(EventGraph, EventMethod method, EventMethod dependency);
+	// Runs every method of the phases, phases are arrays of EventMethod run in order, methods that didn't declare anything
+	// wait for every method in earlier phases like a barrier, the graph is only rebuilt when the phases or declarations change
+	// returns once every method has finished
+	void (*Run)(EventGraph, Array* phases, ulong phaseCount);
+	void (*Dispose)(EventGraph);
+	void (*RunUnitTests)(void);
+};
+
+extern const struct _eventGraphMethods EventGraphs;
@@ -46,6 +46,9 @@ struct _fileMethods {
 	/// <returns>true if the file was opened successfully, otherwise false</returns>
 	bool (*TryOpen)(const string path, FileMode fileMode, File* out_file);
 
+	// whether the path exists within a mounted pack or on disk, missing files aren't reported as errors
+	bool (*Exists)(const string path);
+
 	File(*Open)(const string path, FileMode fileMode);
 
 	ulong(*GetFileSize)(const File file);
@@ -67,6 +70,18 @@ struct _fileMethods {
 	// to the string
 	bool (*TryReadAll)(const string path, string* out_data);
 
+	// maps the file at the provided path into memory and returns a read only view of its bytes,
+	// files that can't be mapped are read into memory with a single read instead, paths within a mounted pack
+	// are views of the pack, or decompressed into memory when the entry is compressed
+	// the view must be released with Unmap, never modified or disposed, and isn't guaranteed to be nul terminated
+	string(*Map)(const string path);
+
+	// maps the file at the provided path and sets the out value to the view, see Map
+	bool (*TryMap)(const string path, string* out_view);
+
+	// releases a view returned from Map or TryMap
+	void (*Unmap)(string view);
+
 	// reads the file into buffer at the given offset
 	// DOES NOT MODIFY buffer count while reading
 	// returns true when successful and outputs line length that was read
@@ -91,6 +106,8 @@ struct _fileMethods {
 	/// Determines if all files that were opened were closed appropriately
 	/// </summary>
 	bool (*TryVerifyCleanup)(void);
+
+	void (*RunUnitTests)();
 };
 
 extern const struct _fileMethods Files;
@@ -0,0 +1,93 @@
+#pragma once
+
+#include "core/csharp.h"
+#include "core/atomic.h"
+#include <stdatomic.h>
+
+typedef byte FutureState;
+
+static const struct _futureStates {
+	// The result hasn't been set yet
+	FutureState Pending;
+	// The result was set and can be read
+	FutureState Completed;
+	// The future will never have a result
+	FutureState Faulted;
+} FutureStates = {
+	.Pending = 0,
+	.Completed = 1,
+	.Faulted = 2
+};
+
+typedef byte FutureScheduler;
+
+static const struct _futureSchedulers {
+	// Runs on any of the job threads, see Jobs
+	FutureScheduler Pool;
+	// Runs on the thread that calls Futures.Update, normally the main thread at the start of the next frame
+	FutureScheduler MainThread;
+} FutureSchedulers = {
+	.Pool = 0,
+	.MainThread = 1
+};
+
+typedef struct _future* Future;
+
+// A future whose result is the given type, only documents the type, see future_result
+#define future(type) Future
+// The result of a completed future as the given type
+#define future_result(type, future) (*(type*)(future)->Result)
+
+// Called once the antecedent completed, writes the result of the future it continues into out_result
+// returns false to fault that future instead
+typedef bool (*FutureMethod)(Future antecedent, void* state, void* out_result);
+
+struct _futureContinuation;
+
+struct _future {
+	_Atomic(FutureState) State;
+	// The size of the result in bytes, may be 0
+	ulong ResultSize;
+	// The result, valid once the state is completed, stored after the future within the same allocation
+	void* Result;
+	// The future is freed once nothing references it, the creator holds one reference until it calls Dispose
+	_Atomic(long) References;
+	locker Lock;
+	// What runs once the future is no longer pending, in the order it was added
+	struct _futureContinuation* Continuations;
+	struct _futureContinuation* LastContinuation;
+};
+
+struct _futureMethods {
+	// Creates a pending future with room for a result of resultSize bytes, completed with Complete or Fault
+	Future(*Create)(ulong resultSize);
+	// Creates a future that's already completed with a copy of the result
+	Future(*FromResult)(const void* result, ulong resultSize);
+	// Runs the method on the scheduler and completes the returned future with its result, the antecedent is null
+	Future(*Run)(FutureMethod method, void* state, ulong resultSize, FutureScheduler scheduler);
+	// Copies the result into the future and runs its continuations, result may be null when it was written in place
+	void (*Complete)(Future, const void* result);
+	// Faults the future and its continuations
+	void (*Fault)(Future);
+	// Runs the method on the scheduler once the future completes and completes the returned future with its result
+	// when the future faults the method never runs and the returned future faults too, never blocks
+	Future(*Then)(Future, FutureMethod method, void* state, ulong resultSize, FutureScheduler scheduler);
+	// Returns a future that completes once every future completed, or faults once they're all done when any faulted
+	// it has no result
+	Future(*WhenAll)(Future* futures, ulong count);
+	// Returns a future that completes once any of the futures is no longer pending, its result is the ulong index
+	// of that future
+	Future(*WhenAny)(Future* futures, ulong count);
+	// Whether the future is no longer pending
+	bool (*IsCompleted)(Future);
+	// Blocks the calling thread until the future is no longer pending or the timeout elapsed, returns the state
+	// runs queued jobs while it waits, like Jobs.Wait, never wait from the main thread on a future that needs Update to complete
+	FutureState(*Wait)(Future, ulong milliseconds);
+	// Runs the continuations scheduled on the main thread, returns the number that ran
+	ulong(*Update)(void);
+	// Releases the creator's reference, the future stays alive until its continuations no longer need it
+	void (*Dispose)(Future);
+	void (*RunUnitTests)(void);
+};
+
+extern const struct _futureMethods Futures;
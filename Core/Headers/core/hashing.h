@@ -2,6 +2,29 @@
 #include <stdlib.h>
 #include "core/csharp.h"
 
+// the number of bytes the hash consumes at a time, streams only buffer the bytes of an incomplete block
+#define HASH_BLOCK_SIZE 16
+
+/// <summary>
+/// A 128 bit hash, used to identify content like assets where a 64 bit hash colliding isn't acceptable
+/// </summary>
+typedef struct {
+	ulong Low;
+	ulong High;
+} hash128;
+
+/// <summary>
+/// The state of a hash that is fed bytes over time, hashing bytes in any number of pieces produces the same
+/// hash as hashing them all at once with HashSeeded
+/// </summary>
+typedef struct {
+	ulong State;
+	// The total number of bytes fed to the stream
+	ulong Length;
+	// The bytes of the block that isn't complete yet
+	byte Pending[HASH_BLOCK_SIZE];
+} HashStream;
+
 struct _hashingMethods {
 	/// <summary>
 	/// NON-CRYPTOGRAPHIC; Hashes the provided bytes
@@ -13,16 +36,31 @@ struct _hashingMethods {
 	ulong(*HashSafe)(const char* bytes, ulong size);
 	/// <summary>
 	/// NON-CRYPTOGRAPHIC; Used to chain multiple hashes in a row to produce deterministic hashing using multiple sets
-	/// of char*
+	/// of char*, each set is hashed using the previous hash as the seed
 	/// </summary>
 	ulong(*ChainHash)(const char* bytes, const ulong previousHash);
 	/// <summary>
 	/// NON-CRYPTOGRAPHIC; Used to chain multiple hashes in a row to produce deterministic hashing using multiple sets
-	/// of char*
+	/// of char*, each set is hashed using the previous hash as the seed
 	/// </summary>
 	ulong(*ChainHashSafe)(const char* bytes, const ulong size, const ulong previousHash);
 	// Chain hashes a single byte
 	ulong(*ChainHashSingle)(const char byte, const ulong previousHash);
+	/// <summary>
+	/// NON-CRYPTOGRAPHIC; Hashes the provided bytes, different seeds produce unrelated hashes for the same bytes
+	/// </summary>
+	ulong(*HashSeeded)(const void* bytes, ulong size, ulong seed);
+	/// <summary>
+	/// NON-CRYPTOGRAPHIC; Hashes the provided bytes into 128 bits, for content addressing
+	/// </summary>
+	hash128(*Hash128)(const void* bytes, ulong size, ulong seed);
+	// Starts a stream that produces the same hash as HashSeeded with the given seed
+	void (*Begin)(HashStream*, ulong seed);
+	// Feeds the bytes to the stream
+	void (*Update)(HashStream*, const void* bytes, ulong size);
+	// Gets the hash of every byte fed to the stream so far, the stream can continue to be updated afterwards
+	ulong(*End)(const HashStream*);
+	void (*RunUnitTests)();
 };
 
-extern const struct _hashingMethods Hashing;
\ No newline at end of file
+extern const struct _hashingMethods Hashing;
@@ -0,0 +1,68 @@
+#pragma once
+
+#include "core/csharp.h"
+#include "core/array.h"
+#include <stdatomic.h>
+
+// the number of threads that service io requests when they're started on first use
+#define IO_DEFAULT_THREAD_COUNT 2
+
+typedef byte IOStatus;
+
+static const struct _ioStatuses {
+	// The request is queued or being read
+	IOStatus Pending;
+	// The bytes were read into the request's Data
+	IOStatus Completed;
+	// The file couldn't be opened or read
+	IOStatus Failed;
+} IOStatuses = {
+	.Pending = 0,
+	.Completed = 1,
+	.Failed = 2
+};
+
+typedef struct _ioRequest* IORequest;
+
+// Called on the thread that calls IORequests.Update, normally the main thread at the start of the next frame
+typedef void (*IOCompletion)(IORequest request, void* state);
+
+struct _ioRequest {
+	// The path of the file that is read, copied when the request is created
+	string Path;
+	// The offset within the file reading starts at
+	ulong Offset;
+	// The number of bytes to read, 0 reads until the end of the file
+	ulong Length;
+	// The bytes that were read, nul terminated, set to null to take ownership of them before the request is disposed
+	string Data;
+	// Written once by the io thread after Data, read it with atomic_load before reading Data
+	_Atomic(IOStatus) Status;
+	// Called with the request once it's completed or failed, when set the request is disposed after it returns
+	IOCompletion OnCompleted;
+	void* State;
+	// The next request within whichever queue this request is in
+	struct _ioRequest* Next;
+};
+
+struct _ioRequestMethods {
+	// Queues a read of the whole file at the path, onCompleted may be null
+	IORequest(*Read)(const string path, IOCompletion onCompleted, void* state);
+	// Queues a read of length bytes starting at offset within the file, onCompleted may be null
+	IORequest(*ReadRange)(const string path, ulong offset, ulong length, IOCompletion onCompleted, void* state);
+	// Whether or not the request is no longer pending, the request's Data can be read once this returns true
+	bool (*IsCompleted)(IORequest);
+	// Waits for the request to no longer be pending, returns the status of the request
+	IOStatus(*Wait)(IORequest, ulong milliseconds);
+	// Calls the completions of every request that finished since the last update, returns the number called
+	ulong(*Update)(void);
+	// Disposes a request that doesn't have a completion, along with its Data
+	void (*Dispose)(IORequest);
+	// Starts the io threads, called automatically with IO_DEFAULT_THREAD_COUNT by the first request
+	void (*Start)(int threadCount);
+	// Asks the io threads to exit once the queued requests are read and waits for them
+	void (*Shutdown)(void);
+	void (*RunUnitTests)();
+};
+
+extern const struct _ioRequestMethods IORequests;
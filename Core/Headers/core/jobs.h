@@ -0,0 +1,43 @@
+#pragma once
+
+#include "core/csharp.h"
+#include <stdatomic.h>
+
+// the most jobs a thread can have queued at once, jobs queued past this run right away on the thread that queued them
+// must be a power of two
+#define JOBS_QUEUE_CAPACITY 8192
+// the most threads that run jobs, including the thread that started the workers
+#define JOBS_MAX_THREADS 64
+// how many times a thread looks for work before it goes to sleep
+#define JOBS_SPIN_COUNT 512
+
+typedef void (*JobMethod)(void* state);
+
+/// <summary>
+/// Counts the jobs that were queued with it that haven't finished, see Jobs.Wait
+/// </summary>
+typedef struct {
+	_Atomic(long long) Remaining;
+} JobCounter;
+
+struct _jobMethods {
+	// Starts the worker threads, a thread count of 0 uses every core, the calling thread counts as one of the threads
+	// and runs jobs whenever it waits on them
+	void (*Start)(int threadCount);
+	// Runs every queued job and stops the worker threads
+	void (*Stop)(void);
+	// Queues the method to run on any thread, the counter, when not null, is incremented until the method returns
+	// methods run right away on the calling thread when the workers aren't started
+	void (*Run)(JobMethod method, void* state, JobCounter* counter);
+	// Runs queued jobs on the calling thread until every job queued with the counter has finished
+	void (*Wait)(JobCounter* counter);
+	// Runs one queued job on the calling thread, returns false when there was nothing to run
+	bool (*TryRunOne)(void);
+	// Whether the worker threads were started
+	bool (*Started)(void);
+	// The number of threads that run jobs, including the thread that started them
+	int (*ThreadCount)(void);
+	void (*RunUnitTests)(void);
+};
+
+extern const struct _jobMethods Jobs;
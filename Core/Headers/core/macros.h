@@ -67,3 +67,22 @@
    40,39,38,37,36,35,34,33,32,31,30,29,28,27,26,25,24,23,22,21, \
    20,19,18,17,16,15,14,13,12,11,10,9,8,7,6,5,4,3,2,1))
 #define VAR_COUNT(...) GLUE(_VAR_COUNT_EMPTY_, IS_EMPTY(__VA_ARGS__))(__VA_ARGS__)
+
+/* Calls macro(data, index, argument) for every argument (up to 16 arguments), index is an expression starting at 0. */
+#define _FOR_EACH_1(macro, data, index, x) macro(data, index, x)
+#define _FOR_EACH_2(macro, data, index, x, ...) macro(data, index, x) EXPAND(_FOR_EACH_1(macro, data, index + 1, __VA_ARGS__))
+#define _FOR_EACH_3(macro, data, index, x, ...) macro(data, index, x) EXPAND(_FOR_EACH_2(macro, data, index + 1, __VA_ARGS__))
+#define _FOR_EACH_4(macro, data, index, x, ...) macro(data, index, x) EXPAND(_FOR_EACH_3(macro, data, index + 1, __VA_ARGS__))
+#define _FOR_EACH_5(macro, data, index, x, ...) macro(data, index, x) EXPAND(_FOR_EACH_4(macro, data, index + 1, __VA_ARGS__))
+#define _FOR_EACH_6(macro, data, index, x, ...) macro(data, index, x) EXPAND(_FOR_EACH_5(macro, data, index + 1, __VA_ARGS__))
+#define _FOR_EACH_7(macro, data, index, x, ...) macro(data, index, x) EXPAND(_FOR_EACH_6(macro, data, index + 1, __VA_ARGS__))
+#define _FOR_EACH_8(macro, data, index, x, ...) macro(data, index, x) EXPAND(_FOR_EACH_7(macro, data, index + 1, __VA_ARGS__))
+#define _FOR_EACH_9(macro, data, index, x, ...) macro(data, index, x) EXPAND(_FOR_EACH_8(macro, data, index + 1, __VA_ARGS__))
+#define _FOR_EACH_10(macro, data, index, x, ...) macro(data, index, x) EXPAND(_FOR_EACH_9(macro, data, index + 1, __VA_ARGS__))
+#define _FOR_EACH_11(macro, data, index, x, ...) macro(data, index, x) EXPAND(_FOR_EACH_10(macro, data, index + 1, __VA_ARGS__))
+#define _FOR_EACH_12(macro, data, index, x, ...) macro(data, index, x) EXPAND(_FOR_EACH_11(macro, data, index + 1, __VA_ARGS__))
+#define _FOR_EACH_13(macro, data, index, x, ...) macro(data, index, x) EXPAND(_FOR_EACH_12(macro, data, index + 1, __VA_ARGS__))
+#define _FOR_EACH_14(macro, data, index, x, ...) macro(data, index, x) EXPAND(_FOR_EACH_13(macro, data, index + 1, __VA_ARGS__))
+#define _FOR_EACH_15(macro, data, index, x, ...) macro(data, index, x) EXPAND(_FOR_EACH_14(macro, data, index + 1, __VA_ARGS__))
+#define _FOR_EACH_16(macro, data, index, x, ...) macro(data, index, x) EXPAND(_FOR_EACH_15(macro, data, index + 1, __VA_ARGS__))
+#define FOR_EACH(macro, data, ...) EXPAND(GLUE(_FOR_EACH_, VAR_COUNT(__VA_ARGS__))(macro, data, 0, __VA_ARGS__))
@@ -0,0 +1,163 @@
+#pragma once
+
+#include "core/csharp.h"
+#include "core/memory.h"
+
+// TEMPLATE
+
+#define _EXPAND_map(key, value) key##_##value##_map
+#define _EXPAND_Maps(key, value) key##_##value##_map##Maps
+
+// Creates a hash map from key to value, remember to define the map with DEFINE_MAP if this fails to compile
+#define map(key, value) _EXPAND_map(key, value)
+// Convenience methods that can be used with a map(key, value)
+#define maps(key, value) _EXPAND_Maps(key, value)
+
+// the number of control bytes that are compared at once when probing
+#define MAP_GROUP_SIZE 16
+// the smallest capacity a map can have, must be a power of two no smaller than MAP_GROUP_SIZE
+#define MAP_MINIMUM_CAPACITY 16
+// control byte of a slot that doesn't contain an entry, every used slot stores 7 bits of its hash instead
+#define MAP_EMPTY 0x80
+
+// hashes the key that key points to, keySize is the size of the key type
+typedef ulong(*MapHashFunction)(const void* key, ulong keySize);
+// compares the keys that left and right point to
+typedef bool(*MapEqualityFunction)(const void* left, const void* right, ulong keySize);
+
+#define _MAP_DEFINE_STRUCT(key, value) struct _map_##key##_##value\
+{\
+	/* One byte per slot, MAP_EMPTY for empty slots, otherwise 7 bits of the hash of the key in the slot.\
+	The first MAP_GROUP_SIZE bytes are repeated at the end so a group can always be loaded at once */\
+	byte* Controls;\
+	key* Keys;\
+	value* Values;\
+	/* The number of entries in the map */\
+	ulong Count;\
+	/* The number of slots, always a power of two */\
+	ulong Capacity;\
+	ulong KeySize;\
+	ulong ValueSize;\
+	/* The typeid used to allocate the slots */\
+	ulong TypeId;\
+	MapHashFunction Hash;\
+	MapEqualityFunction Equals;\
+};\
+typedef struct _map_##key##_##value* key##_##value##_map;
+
+_MAP_DEFINE_STRUCT(void, void);
+typedef map(void, void) Map;
+
+DEFINE_TYPE_ID(Map);
+
+struct _mapMethods {
+	Map(*Create)(ulong keySize, ulong valueSize, ulong capacity, ulong typeId, MapHashFunction hash, MapEqualityFunction equals);
+	// Grows the map so it can store at least count entries without growing again
+	void (*Reserve)(Map, ulong count);
+	// Sets the value stored for key, adding the key if it doesn't exist
+	void (*Set)(Map, const void* key, const void* value);
+	// Gets a pointer to the value stored for key, returns null when the key doesn't exist,
+	// the pointer is only valid until the map is modified
+	void* (*Get)(Map, const void* key);
+	bool (*TryGetValue)(Map, const void* key, void* out_value);
+	bool (*ContainsKey)(Map, const void* key);
+	// Removes the key and its value, returns false if the key doesn't exist
+	bool (*Remove)(Map, const void* key);
+	void (*Clear)(Map);
+	void (*Foreach)(Map, void* context, void(*method)(void* context, void* key, void* value));
+	void (*Dispose)(Map);
+	// The default hash, hashes the bytes of the key
+	ulong(*HashBytes)(const void* key, ulong keySize);
+	// The default equality, compares the bytes of the keys
+	bool (*BytesEqual)(const void* left, const void* right, ulong keySize);
+	// Hashes the contents of a string key rather than the pointer to it
+	ulong(*HashString)(const void* key, ulong keySize);
+	// Compares the contents of string keys rather than the pointers to them
+	bool (*StringsEqual)(const void* left, const void* right, ulong keySize);
+	void (*RunUnitTests)();
+};
+
+extern const struct _mapMethods Maps;
+
+#define _EXPAND_MAP_METHOD_NAME(key, value, method) _map_##key##_##value##_##method
+
+// TEMPLATE FOR METHODS
+#define _EXPAND_DEFINE_MAP(key, value) _MAP_DEFINE_STRUCT(key, value)\
+DEFINE_TYPE_ID(key##_##value##_map);\
+private map(key, value) _EXPAND_MAP_METHOD_NAME(key, value, CreateWith)(ulong capacity, MapHashFunction hash, MapEqualityFunction equals)\
+{\
+	REGISTER_TYPE(key##_##value##_map);\
+	return (map(key, value))Maps.Create(sizeof(key), sizeof(value), capacity, key##_##value##_mapTypeId, hash, equals);\
+}\
+private map(key, value) _EXPAND_MAP_METHOD_NAME(key, value, Create)(ulong capacity)\
+{\
+	return _EXPAND_MAP_METHOD_NAME(key, value, CreateWith)(capacity, Maps.HashBytes, Maps.BytesEqual);\
+}\
+private void _EXPAND_MAP_METHOD_NAME(key, value, Reserve)(map(key, value) map, ulong count)\
+{\
+	Maps.Reserve((Map)map, count);\
+}\
+private map(key, value) _EXPAND_MAP_METHOD_NAME(key, value, Set)(map(key, value) map, key k, value v)\
+{\
+	Maps.Set((Map)map, &k, &v);\
+	return map;\
+}\
+private value* _EXPAND_MAP_METHOD_NAME(key, value, Get)(map(key, value) map, key k)\
+{\
+	return (value*)Maps.Get((Map)map, &k);\
+}\
+private bool _EXPAND_MAP_METHOD_NAME(key, value, TryGetValue)(map(key, value) map, key k, value* out_value)\
+{\
+	return Maps.TryGetValue((Map)map, &k, out_value);\
+}\
+private bool _EXPAND_MAP_METHOD_NAME(key, value, ContainsKey)(map(key, value) map, key k)\
+{\
+	return Maps.ContainsKey((Map)map, &k);\
+}\
+private bool _EXPAND_MAP_METHOD_NAME(key, value, Remove)(map(key, value) map, key k)\
+{\
+	return Maps.Remove((Map)map, &k);\
+}\
+private map(key, value) _EXPAND_MAP_METHOD_NAME(key, value, Clear)(map(key, value) map)\
+{\
+	Maps.Clear((Map)map);\
+	return map;\
+}\
+private void _EXPAND_MAP_METHOD_NAME(key, value, Foreach)(map(key, value) map, void* context, void(*method)(void* context, key* k, value* v))\
+{\
+	Maps.Foreach((Map)map, context, (void(*)(void*, void*, void*))method);\
+}\
+private void _EXPAND_MAP_METHOD_NAME(key, value, Dispose)(map(key, value) map)\
+{\
+	Maps.Dispose((Map)map);\
+}\
+const static struct _map_##key##_##value##_methods\
+{\
+	map(key, value) (*Create)(ulong capacity);\
+	/* Creates a map that uses the provided hash and equality instead of comparing the bytes of the keys */\
+	map(key, value) (*CreateWith)(ulong capacity, MapHashFunction hash, MapEqualityFunction equals);\
+	void (*Reserve)(map(key, value), ulong count);\
+	map(key, value) (*Set)(map(key, value), key, value);\
+	value* (*Get)(map(key, value), key);\
+	bool (*TryGetValue)(map(key, value), key, value* out_value);\
+	bool (*ContainsKey)(map(key, value), key);\
+	bool (*Remove)(map(key, value), key);\
+	map(key, value) (*Clear)(map(key, value));\
+	void (*Foreach)(map(key, value), void* context, void(*method)(void* context, key* k, value* v));\
+	void (*Dispose)(map(key, value));\
+} key##_##value##_map##Maps = \
+{\
+	.Create = _EXPAND_MAP_METHOD_NAME(key, value, Create),\
+	.CreateWith = _EXPAND_MAP_METHOD_NAME(key, value, CreateWith),\
+	.Reserve = _EXPAND_MAP_METHOD_NAME(key, value, Reserve),\
+	.Set = _EXPAND_MAP_METHOD_NAME(key, value, Set),\
+	.Get = _EXPAND_MAP_METHOD_NAME(key, value, Get),\
+	.TryGetValue = _EXPAND_MAP_METHOD_NAME(key, value, TryGetValue),\
+	.ContainsKey = _EXPAND_MAP_METHOD_NAME(key, value, ContainsKey),\
+	.Remove = _EXPAND_MAP_METHOD_NAME(key, value, Remove),\
+	.Clear = _EXPAND_MAP_METHOD_NAME(key, value, Clear),\
+	.Foreach = _EXPAND_MAP_METHOD_NAME(key, value, Foreach),\
+	.Dispose = _EXPAND_MAP_METHOD_NAME(key, value, Dispose)\
+};
+
+#define DEFINE_MAP(key, value) _EXPAND_DEFINE_MAP(key, value)
@@ -6,12 +6,94 @@
 
 #include "core/csharp.h"
 
+// Allocation statistics are only tracked in debug builds, define MEMORY_TRACKING
+// to track them in release builds as well
+#if !defined(NDEBUG) && !defined(MEMORY_TRACKING)
+#define MEMORY_TRACKING
+#endif
+
+typedef struct _arena* Arena;
+
+// A linear block of memory that hands out memory by bumping an offset, individual allocations are never freed
+// instead the whole arena is reset, or rewound to a previously taken mark
+struct _arena {
+	// The backing block of memory
+	byte* Values;
+	// The size, in bytes, of the backing block
+	ulong Size;
+	// The offset, in bytes, of the next available byte within the backing block
+	volatile ulong Offset;
+	// The largest offset this arena has reached since it was created
+	ulong HighWaterMark;
+	// The typeid used to allocate the backing block, used to report usage in Memory.PrintAlloc
+	ulong TypeId;
+};
+
+// An offset within an arena that can be rewound to using Memory.Arena.Rewind
+typedef ulong ArenaMark;
+
+struct _arenaMethods {
+	// The size, in bytes, of the per-frame arena, only used when the frame arena is first created
+	// default: 4mb
+	ulong FrameSize;
+	// Creates a new arena with a backing block of the given size, typeID is the id of the registered type name
+	// that the arena should report it's usage under
+	Arena(*Create)(ulong size, ulong typeID);
+	// Allocates size bytes from the arena aligned to the size of a pointer, throws OutOfMemoryException
+	// when the arena is exhausted
+	// thread safe
+	void* (*Alloc)(Arena, ulong size);
+	// Allocates size bytes from the arena aligned to the provided alignment(must be a power of two), throws
+	// OutOfMemoryException when the arena is exhausted
+	// thread safe
+	void* (*AllocAligned)(Arena, ulong alignment, ulong size);
+	// Gets the current position of the arena so it can later be rewound to
+	ArenaMark(*Mark)(Arena);
+	// Releases everything allocated from the arena after the given mark
+	void (*Rewind)(Arena, ArenaMark mark);
+	// Releases everything allocated from the arena
+	void (*Reset)(Arena);
+	// Gets the per-frame arena, everything allocated from this arena is released at the end of every frame
+	// by the runtime, never keep memory from this arena past the current frame
+	Arena(*Frame)(void);
+	// Resets the per-frame arena, this is called by the runtime at the end of every frame
+	void (*ResetFrame)(void);
+	void (*Dispose)(Arena);
+};
+
+// The blocks that were alive when Memory.Profiler.Snapshot() was called, grouped by type and call site
+typedef struct _memorySnapshot* MemorySnapshot;
+
+struct _memoryProfilerMethods {
+	// Starts recording the call site, size and type of every block allocated with Alloc, Calloc and AllocAligned
+	// until it's freed, blocks allocated before profiling was started are ignored,
+	// does nothing when MEMORY_TRACKING isn't defined
+	void (*Start)(void);
+	// Stops recording allocations and forgets every recorded block
+	void (*Stop)(void);
+	// Captures the bytes held by every type and every call site of the blocks that are currently alive
+	MemorySnapshot(*Snapshot)(void);
+	// Prints the bytes held by each type and the count call sites that hold the most bytes
+	void (*Print)(FILE* stream, MemorySnapshot snapshot, ulong count);
+	// Prints the count call sites that grew the most between the previous and current snapshot
+	void (*PrintGrowth)(FILE* stream, MemorySnapshot previous, MemorySnapshot current, ulong count);
+	// Writes the current snapshot to the file at path, the growth since the previous snapshot is also
+	// written when previous isn't null, returns false if the file couldn't be opened
+	bool (*TrySave)(const char* path, MemorySnapshot previous, MemorySnapshot current, ulong count);
+	void (*DisposeSnapshot)(MemorySnapshot);
+};
+
 struct _memoryMethods {
+	// Statistics are counted per thread, these are only updated when
+	// Memory.CollectStatistics(), PrintAlloc() or PrintFree() is called
 	ulong FreeCount;
 	ulong AllocCount;
 	ulong AllocSize;
 	void (*PrintAlloc)(FILE* stream);
 	void (*PrintFree)(FILE* stream);
+	// Sums the allocation statistics of every thread into FreeCount, AllocCount and AllocSize,
+	// does nothing when MEMORY_TRACKING isn't defined
+	void (*CollectStatistics)(void);
 	// MemoryID for a generic block of memory with no associated type
 	const ulong GenericMemoryBlock;
 	// MemoryId for a string
@@ -29,11 +111,13 @@ struct _memoryMethods {
 	/// <summary>
 	/// Safely allocates the provided size of memory with the provided alignment, otherwise throws OutOfMemoryException and exits program forcibly, 
 	/// use Memory.AllocCount for the number of calls to this method, use AllocSize() for the amount of memory allocated using this method
+	/// typeID has to be registered with REGISTER_ALIGNED_TYPE so Free() knows how to release the block
 	/// </summary>
 	void* (*AllocAligned)(ulong alignment, ulong size, ulong typeID);
 
 	// Attempts to realloc the address to the new size, returns true if successfull, otherwise false
-	bool (*TryRealloc)(void* address, const ulong previousSize, const ulong newSize, void** out_address);
+	// typeID must be the type the address was allocated with, elements of the type's slab are never realloced
+	bool (*TryRealloc)(void* address, const ulong previousSize, const ulong newSize, ulong typeID, void** out_address);
 
 	// Fills the array with zeros
 	void (*ZeroArray)(void* address, const ulong size);
@@ -48,8 +132,22 @@ struct _memoryMethods {
 
 	// registers the provided typename and returns the id that should be passed into the Alloc() method
 	void(*RegisterTypeName)(const char* name, ulong* out_typeId);
-	// performs memcmp while also performing a hash at the same time
+	// registers the provided typename and returns the id that should be passed into the Alloc() method,
+	// Alloc() calls with this id for exactly elementSize bytes are served from a per-type slab so instances
+	// are contiguous and Free() returns them to a per-type free list instead of the heap
+	void(*RegisterSlabTypeName)(const char* name, ulong elementSize, ulong* out_typeId);
+	// registers the provided typename and returns the id that should be passed into the Alloc() method,
+	// every allocation made with this id, including Alloc() and Calloc(), is aligned to at least alignment(a power of two)
+	// and Free() releases them with _aligned_free, aligned blocks are never realloced
+	void(*RegisterAlignedTypeName)(const char* name, ulong alignment, ulong* out_typeId);
+	// compares the memory like memcmp and hashes both blocks
 	int (*CompareMemoryAndHash)(const char* left, ulong leftSize, const char* right, ulong rightSize, ulong* out_leftHash, ulong* out_rightHash);
+	// Linear allocators for short-lived memory, see Memory.Arena.Frame() for memory that only needs to live
+	// for the current frame
+	struct _arenaMethods Arena;
+	// Records where live blocks were allocated from to find leaks in long running sessions, call sites are
+	// return addresses and can be resolved with the debug symbols for the build
+	struct _memoryProfilerMethods Profiler;
 };
 
 extern struct _memoryMethods Memory;
@@ -62,6 +160,13 @@ extern struct _memoryMethods Memory;
 // registers the provided name with the memory handler
 #define REGISTER_TYPE(name) Memory.RegisterTypeName(#name, &name##TypeId)
 
+// registers the provided name with the memory handler, allocations of exactly elementSize bytes
+// using the type id are served from a slab
+#define REGISTER_SLAB_TYPE(name, elementSize) Memory.RegisterSlabTypeName(#name, elementSize, &name##TypeId)
+
+// registers the provided name with the memory handler, every allocation using the type id is aligned to alignment
+#define REGISTER_ALIGNED_TYPE(name, alignment) Memory.RegisterAlignedTypeName(#name, alignment, &name##TypeId)
+
 DEFINE_TYPE_ID(char);
 DEFINE_TYPE_ID(int);
 DEFINE_TYPE_ID(long);
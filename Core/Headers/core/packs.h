@@ -0,0 +1,49 @@
+#pragma once
+
+#include "core/csharp.h"
+#include "core/array.h"
+
+// "FPAK" read as a little endian uint
+#define PACK_MAGIC 0x4B415046
+#define PACK_VERSION 1
+// entries start on page boundaries so any entry can be mapped on its own
+#define PACK_ALIGNMENT 4096
+// the most packs that can be mounted at once, packs mounted later are searched first
+#define PACK_MAX_MOUNTED 8
+
+/// <summary>
+/// An archive of files mapped into memory, see Packs.Mount
+/// </summary>
+typedef struct _pack* Pack;
+
+/// <summary>
+/// A file stored within a mounted pack
+/// </summary>
+typedef struct {
+	// The bytes of the entry as they're stored in the pack, compressed when Compressed is true
+	const byte* Values;
+	// The size, in bytes, of the file
+	ulong Size;
+	// The size, in bytes, of the entry within the pack
+	ulong StoredSize;
+	bool Compressed;
+} PackEntry;
+
+struct _packMethods {
+	// Maps the pack at the path and adds it to the packs Files resolves paths through
+	bool (*TryMount)(const string path, Pack* out_pack);
+	// Removes the pack from the packs Files resolves paths through and unmaps it, views of its entries become invalid
+	void (*Unmount)(Pack);
+	// Looks for the path within every mounted pack, separators and case are ignored
+	bool (*TryGetEntry)(const string path, PackEntry* out_entry);
+	// Copies or decompresses the entry into destination, which must be at least entry.Size bytes
+	bool (*TryReadEntry)(const PackEntry* entry, byte* destination);
+	// Bundles the files at the given paths into a pack at outputPath, entries are only stored compressed
+	// when compress is true and compressing them saves space
+	bool (*TryBuild)(const array(string) paths, const string outputPath, bool compress);
+	// Bundles every file within the directory and its subdirectories into a pack at outputPath
+	bool (*TryBuildDirectory)(const string directory, const string outputPath, bool compress);
+	void (*RunUnitTests)();
+};
+
+extern const struct _packMethods Packs;
@@ -0,0 +1,41 @@
+#pragma once
+
+#include "core/csharp.h"
+#include "core/array.h"
+
+// when no grain is given For splits the range into this many ranges per job thread so threads that finish early can
+// take ranges from threads that don't
+#define PARALLEL_RANGES_PER_THREAD 8
+// when no grain is given Reduce splits the range into at most this many ranges regardless of the number of threads
+// so the result is the same no matter how many threads there are
+#define PARALLEL_REDUCE_RANGES 256
+
+// Called with a range of indices within [begin, end) of the loop
+typedef void (*ParallelMethod)(void* context, ulong begin, ulong end);
+// Reduces the range into the result, the result starts as a copy of the identity
+typedef void (*ParallelReduceMethod)(void* context, ulong begin, ulong end, void* result);
+// Combines the partial result of the range after result's into result
+typedef void (*ParallelCombineMethod)(void* context, void* result, const void* partial);
+
+struct _parallelMethods {
+	// Splits [begin, end) into ranges of grain indices and calls the method with each range on the job threads,
+	// a grain of 0 picks one from the number of threads, returns once every range has finished
+	void (*For)(ulong begin, ulong end, ulong grain, ParallelMethod method, void* context);
+	// Calls the method with a pointer to each element of the array on the job threads, returns once every element has been visited
+	void (*ForeachArray)(Array array, void(*method)(void* item));
+	// Calls the method with the context and a pointer to each element of the array on the job threads
+	void (*ForeachArrayWithContext)(Array array, void* context, void(*method)(void* context, void* item));
+	// Splits [begin, end) into ranges of grain indices, reduces each range on the job threads starting from a copy of the
+	// identity and then combines the partial results from the first range to the last on the calling thread,
+	// the ranges only depend on the grain and the length of the range so the result never depends on the number of threads
+	// a grain of 0 splits the range into at most PARALLEL_REDUCE_RANGES ranges
+	void (*Reduce)(ulong begin, ulong end, ulong grain,
+		const void* identity, ulong resultSize,
+		ParallelReduceMethod method,
+		ParallelCombineMethod combine,
+		void* context,
+		void* out_result);
+	void (*RunUnitTests)(void);
+};
+
+extern const struct _parallelMethods Parallel;
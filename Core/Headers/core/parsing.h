@@ -2,12 +2,44 @@
 
 #include "core/csharp.h"
 
+/// <summary>
+/// A view of characters within a buffer, slices aren't nul terminated and are only valid while the buffer is
+/// </summary>
+typedef struct {
+	const char* Values;
+	ulong Length;
+} slice;
+
 struct _parsing {
 	bool (*TryGetBool)(const char* buffer, const ulong bufferLength, bool* out_bool);
 	bool (*TryGetLine)(const char* buffer, const ulong bufferLength, const ulong maxStringLength, char** out_string);
 	bool (*TryGetString)(const char* buffer, const ulong bufferLength, const ulong maxStringLength, char** out_string);
 	bool (*TryGetStrings)(const char* buffer, const ulong bufferLength, char*** out_array, ulong** out_lengths, ulong* out_count);
+
+	// parses the float at the position, after any whitespace, and moves the position past it, never reads at or past end
+	// the result is the same as strtof without allocating or requiring the buffer to be nul terminated
+	bool (*TryReadFloat)(const char** position, const char* end, float* out_value);
+	// parses the base 10 integer at the position, after any whitespace, and moves the position past it, never reads at or past end
+	bool (*TryReadInt)(const char** position, const char* end, long long* out_value);
+	// parses the base 16 integer at the position, after any whitespace and an optional 0x, never reads at or past end
+	bool (*TryReadHex)(const char** position, const char* end, unsigned long long* out_value);
+	// parses the first float within the buffer
+	bool (*TryGetFloat)(const char* buffer, const ulong bufferLength, float* out_value);
+	// parses the first integer within the buffer
+	bool (*TryGetInt)(const char* buffer, const ulong bufferLength, long long* out_value);
+	// parses the first base 16 integer within the buffer
+	bool (*TryGetHex)(const char* buffer, const ulong bufferLength, unsigned long long* out_value);
+	// parses count whitespace separated floats from the buffer in one call, returns false when there are fewer than count
+	bool (*TryGetFloats)(const char* buffer, const ulong bufferLength, float* out_values, const ulong count);
+	// sets the out value to the first whitespace delimited string within the buffer without copying it
+	bool (*TryGetStringSlice)(const char* buffer, const ulong bufferLength, slice* out_slice);
+	// sets the out value to the buffer after any leading whitespace without copying it
+	bool (*TryGetLineSlice)(const char* buffer, const ulong bufferLength, slice* out_slice);
+	// splits the buffer at each ',' or ';' or the end of the line into at most capacity slices, empty slices are kept
+	// returns the number of slices within the buffer, which may be larger than capacity
+	ulong (*GetStringSlices)(const char* buffer, const ulong bufferLength, slice* out_slices, const ulong capacity);
+
 	void(*RunParsingUnitTests)();
 };
 
-extern const struct _parsing Parsing;
\ No newline at end of file
+extern const struct _parsing Parsing;
@@ -0,0 +1,94 @@
+#pragma once
+
+// maps the msvc names the engine uses onto gcc and clang so Core can build off Windows, msvc builds skip all of this
+#ifndef _MSC_VER
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <limits.h>
+
+// __declspec(align(16)) becomes _DECLSPEC_align(16) and so on, specifiers without a mapping fail to compile
+#define __declspec(specifier) _DECLSPEC_##specifier
+#define _declspec(specifier) _DECLSPEC_##specifier
+#define _DECLSPEC_align(bytes) __attribute__((aligned(bytes)))
+#define _DECLSPEC_thread __thread
+#define _DECLSPEC_selectany __attribute__((weak))
+#define _DECLSPEC_dllexport
+#define _DECLSPEC_dllimport
+
+// only used to silence msvc warnings
+#define __pragma(directive)
+#define __cdecl
+
+#define __debugbreak() __builtin_trap()
+#define _ReturnAddress() __builtin_return_address(0)
+
+#ifndef min
+#define min(a,b) (((a) < (b)) ? (a) : (b))
+#endif
+#ifndef max
+#define max(a,b) (((a) > (b)) ? (a) : (b))
+#endif
+
+// the interlocked intrinsics are full barriers and return the same values as msvc's
+#define _InterlockedIncrement(address) __atomic_add_fetch((address), 1, __ATOMIC_SEQ_CST)
+#define _InterlockedDecrement(address) __atomic_sub_fetch((address), 1, __ATOMIC_SEQ_CST)
+#define _InterlockedIncrement64(address) __atomic_add_fetch((address), 1, __ATOMIC_SEQ_CST)
+#define _InterlockedDecrement64(address) __atomic_sub_fetch((address), 1, __ATOMIC_SEQ_CST)
+#define _InterlockedExchangeAdd(address, value) __atomic_fetch_add((address), (value), __ATOMIC_SEQ_CST)
+#define _InterlockedExchangeAdd64(address, value) __atomic_fetch_add((address), (value), __ATOMIC_SEQ_CST)
+#define _InterlockedExchange(address, value) __atomic_exchange_n((address), (value), __ATOMIC_SEQ_CST)
+#define _InterlockedExchangePointer(address, value) __atomic_exchange_n((address), (value), __ATOMIC_SEQ_CST)
+#define _InterlockedCompareExchange(address, exchange, comparand) __sync_val_compare_and_swap((address), (comparand), (exchange))
+#define _InterlockedCompareExchange64(address, exchange, comparand) __sync_val_compare_and_swap((address), (comparand), (exchange))
+#define _InterlockedCompareExchangePointer(address, exchange, comparand) __sync_val_compare_and_swap((address), (comparand), (exchange))
+
+static inline unsigned char _BitScanForward(unsigned long* index, unsigned long mask)
+{
+	if (mask == 0)
+	{
+		return 0;
+	}
+
+	*index = (unsigned long)__builtin_ctzl(mask);
+
+	return 1;
+}
+
+static inline void* _aligned_malloc(size_t size, size_t alignment)
+{
+	void* address = NULL;
+
+	return posix_memalign(&address, alignment < sizeof(void*) ? sizeof(void*) : alignment, size) == 0 ? address : NULL;
+}
+
+#define _aligned_free free
+
+typedef int errno_t;
+
+static inline errno_t fopen_s(FILE** file, const char* path, const char* mode)
+{
+	*file = fopen(path, mode);
+
+	return *file ? 0 : errno;
+}
+
+static inline errno_t strerror_s(char* buffer, size_t size, errno_t error)
+{
+	snprintf(buffer, size, "%s", strerror(error));
+
+	return 0;
+}
+
+// sscanf_s takes a buffer size after %s, %c and %[, the engine only passes those last where sscanf ignores the extra size
+#define sscanf_s sscanf
+#define sprintf_s snprintf
+
+#define _ftelli64 ftello
+#define _fseeki64 fseeko
+
+#define _MAX_PATH 260
+
+#endif
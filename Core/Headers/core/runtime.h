@@ -1,6 +1,7 @@
 #pragma once
 
 #include <stdio.h>
+#include <string.h>
 #include "core/csharp.h"
 #include "core/array.h"
 
@@ -14,18 +15,50 @@ typedef void(__cdecl* _VoidMethod)(void);
 DEFINE_CONTAINERS(_VoidMethod);
 DEFINE_CONTAINERS(array(_VoidMethod));
 
-#define SECTION_METHOD_MARKER(sectionHeader, sectionName) \
-__declspec(allocate(sectionHeader)) __declspec(selectany)  const _VoidMethod sectionName = (_VoidMethod)1;
-
 #define _ONSTART_SECTION(id) _STRING(.srt$a ## id)
 #define _ONSTART_NAME(id, name) name ## id
 #define _METHOD_NAME(sectionName,id) _On##sectionName##Body ## id
 #define _METHOD_ADDRESS(sectionName,id) _On##sectionName##Address ## id
 
+#ifdef _MSC_VER
+#define SECTION_METHOD_MARKER(sectionHeader, sectionName) \
+__declspec(allocate(sectionHeader)) __declspec(selectany)  const _VoidMethod sectionName = (_VoidMethod)1;
+
 #define _ON_START(sectionId,name,id) static void _METHOD_NAME(name,id)(void);\
 __pragma(section(_STRING(sectionId##id), read)); \
 __declspec(allocate(_STRING(sectionId##id))) const _VoidMethod _METHOD_ADDRESS(name,id) = (_VoidMethod) _METHOD_NAME(name,id); \
 static void _METHOD_NAME(name,id)(void)
+#else
+// gcc and clang don't sort sections by name, so each method adds itself to a list sorted the same way before main runs
+struct _sectionMethod {
+	const char* Order;
+	_VoidMethod Method;
+	struct _sectionMethod* Next;
+};
+
+#define SECTION_METHOD_MARKER(sectionHeader, sectionName)
+
+#define _SECTION_METHODS(sectionName) GLOBAL_##sectionName##SectionMethods
+// weak so every file that uses a section shares one list per module, like a section would be
+#define _DECLARE_SECTION_METHODS(sectionName) __attribute__((weak)) struct _sectionMethod* _SECTION_METHODS(sectionName);
+
+private void AddSectionMethod(struct _sectionMethod** list, struct _sectionMethod* method)
+{
+	while (*list and strcmp((*list)->Order, method->Order) < 0)
+	{
+		list = &(*list)->Next;
+	}
+
+	method->Next = *list;
+	*list = method;
+}
+
+#define _ON_START(sectionId,name,id) static void _METHOD_NAME(name,id)(void);\
+_DECLARE_SECTION_METHODS(name) \
+static struct _sectionMethod _METHOD_ADDRESS(name,id) = { .Order = _STRING(id), .Method = _METHOD_NAME(name,id) }; \
+__attribute__((constructor)) static void _On##name##Register##id(void) { AddSectionMethod(&_SECTION_METHODS(name), &_METHOD_ADDRESS(name,id)); } \
+static void _METHOD_NAME(name,id)(void)
+#endif
 
 private int CountSectionSize(_VoidMethod* start, _VoidMethod* end) {
 	int count = 0;
@@ -56,6 +89,7 @@ private _VoidMethod* GetSectionMethods(_VoidMethod* sectionHeader, _VoidMethod*
 }
 
 
+#ifdef _MSC_VER
 #define DEFINE_SECTION_METHOD_RUNNER(sectionName,sectionHeaderName,sectionFooterName)\
 public void RunOn##sectionName##Methods() {\
 	const _VoidMethod* x = &sectionHeaderName;\
@@ -66,6 +100,24 @@ public _VoidMethod* Get##sectionName##Methods(){\
 	return GetSectionMethods((_VoidMethod*)&sectionHeaderName,(_VoidMethod*)&sectionFooterName);\
 }\
 
+#else
+#define DEFINE_SECTION_METHOD_RUNNER(sectionName,sectionHeaderName,sectionFooterName)\
+_DECLARE_SECTION_METHODS(sectionName) \
+public void RunOn##sectionName##Methods() {\
+	for (struct _sectionMethod* x = _SECTION_METHODS(sectionName); x; x = x->Next)\
+		x->Method();\
+};\
+public _VoidMethod* Get##sectionName##Methods(){\
+	int count = 0;\
+	for (struct _sectionMethod* x = _SECTION_METHODS(sectionName); x; x = x->Next) count++;\
+	_VoidMethod* methods = calloc(count + 1, sizeof(_VoidMethod));\
+	int i = 0;\
+	for (struct _sectionMethod* x = _SECTION_METHODS(sectionName); x; x = x->Next) methods[i++] = x->Method;\
+	return methods;\
+}\
+
+#endif
+
 #define START_SECTION_HEADER ".srt$a"
 #define START_SECTION_FOOTER ".srt$z"
 
@@ -163,6 +215,13 @@ DEFINE_SECTION_METHOD_RUNNER(AfterFixedUpdate, GLOBAL_AfterFixedUpdateSegStart,
 // to determine the order this method gets run against the rest
 #define AfterFixedUpdate(order) _ON_START(.afu$a,AfterFixedUpdate, order)
 
+// The methods created by OnUpdate, AfterUpdate, OnFixedUpdate and AfterFixedUpdate within the same file
+// so they can declare what they use, for example Application.Writes(UpdateMethod(A), "Transforms")
+#define UpdateMethod(order) _METHOD_NAME(Update, order)
+#define AfterUpdateMethod(order) _METHOD_NAME(AfterUpdate, order)
+#define FixedUpdateMethod(order) _METHOD_NAME(FixedUpdate, order)
+#define AfterFixedUpdateMethod(order) _METHOD_NAME(AfterFixedUpdate, order)
+
 #define RENDER_SECTION_HEADER ".rdr$a"
 #define RENDER_SECTION_FOOTER ".rdr$z"
 
@@ -253,6 +312,13 @@ extern struct _Application {
 	void (*RemoveEvent)(RuntimeEventType, void(*Method)(void));
 	void (*SetParentApplication)(struct _Application* parent);
 	void (*InitializeThreadedEvents)();
+	// Declares that the Update, AfterUpdate, FixedUpdate or AfterFixedUpdate event reads the named resource
+	// events that declare what they use only wait on the events they conflict with instead of every earlier phase
+	void (*Reads)(void(*Method)(void), const char* resource);
+	// Declares that the threaded event writes the named resource
+	void (*Writes)(void(*Method)(void), const char* resource);
+	// Declares that the threaded event only starts once the dependency finished
+	void (*DependsOn)(void(*Method)(void), void(*Dependency)(void));
 	struct _state {
 		// Flag that when non-zero sigals
 		// the application runtime to exit the
@@ -0,0 +1,36 @@
+#pragma once
+
+#include "core/csharp.h"
+
+// returned by the search kernels when nothing was found
+#define SIMD_NOT_FOUND ((ulong)-1)
+
+// The instruction sets the kernels can use, ordered from least to most capable
+enum SimdLevel {
+	SimdLevelScalar,
+	SimdLevelSSE2,
+	SimdLevelAVX2
+};
+
+// Vectorized kernels over raw memory, the best instruction set the cpu supports is picked the first time a kernel is used.
+// Elements that are 1, 4 or 8 bytes large are compared a whole register at a time, any other size falls back to comparing one
+// element at a time. Elements are compared bitwise like memcmp, so a float 0.0f and -0.0f are different.
+struct _simdMethods {
+	// The instruction set the kernels are currently using
+	enum SimdLevel(*Level)(void);
+	// Forces the kernels to use the given instruction set, clamped to what the cpu supports, returns the level that was set
+	enum SimdLevel(*SetLevel)(enum SimdLevel level);
+	// Gets the index of the first byte equal to value, or SIMD_NOT_FOUND
+	ulong(*FindByte)(const void* values, ulong count, byte value);
+	// Gets the index of the first element equal to the element value points to, or SIMD_NOT_FOUND
+	ulong(*FindFirstEqual)(const void* values, ulong count, ulong elementSize, const void* value);
+	// Gets the index of the first byte that differs between left and right, or SIMD_NOT_FOUND if they're the same
+	ulong(*Mismatch)(const void* left, const void* right, ulong size);
+	// Sets every element to the element value points to
+	void (*Fill)(void* values, ulong count, ulong elementSize, const void* value);
+	// Gets the number of elements equal to the element value points to
+	ulong(*Count)(const void* values, ulong count, ulong elementSize, const void* value);
+	void (*RunUnitTests)();
+};
+
+extern struct _simdMethods Simd;
@@ -0,0 +1,179 @@
+#pragma once
+
+#include "core/csharp.h"
+#include "core/memory.h"
+#include "core/macros.h"
+
+// TEMPLATE
+
+#define _EXPAND_soa(type) type##_soa
+#define _EXPAND_SoAs(type) type##_soa##SoAs
+
+// Creates a structure of arrays that stores every field of type in its own column,
+// remember to define the type with DEFINE_SOA if this fails to compile
+#define soa(type) _EXPAND_soa(type)
+// Convenience methods that can be used with a soa(type)
+#define soas(type) _EXPAND_SoAs(type)
+
+// Gets the bit that selects the column of the given field, combine columns with | to
+// select more than one column
+#define soa_column(type, field) _soa_##type##_column_##field
+
+// Gets the value of field at the given index within the soa
+// Will throw if out of bounds
+#define soa_at(soa, field, index) ((soa)->field[(index) >= (soa)->Count ? throw_in_expression(IndexOutOfRangeException) : (index)])
+
+// the most columns a soa(type) can have
+#define SOA_MAX_COLUMNS 16
+
+// every column can hold at least this many elements after the first time the soa grows
+#define SOA_MINIMUM_CAPACITY 16
+
+struct _soa {
+	// The number of elements stored in every column
+	ulong Count;
+	// The number of elements every column can store before they have to grow
+	ulong Capacity;
+	// The typeid used to allocate the columns
+	ulong TypeId;
+	ulong ColumnCount;
+	// The size in bytes of a single element of each column
+	const ulong* ColumnSizes;
+	// The backing array of each column
+	void* Columns[];
+};
+
+typedef struct _soa* SoA;
+
+DEFINE_TYPE_ID(SoA);
+
+struct _soaMethods {
+	SoA(*Create)(ulong columnCount, const ulong* columnSizes, ulong capacity, ulong typeId);
+	// Grows every column so it can store at least count elements without resizing
+	void (*Reserve)(SoA, ulong count);
+	// Adds a zeroed element to the end of every column and returns its index
+	ulong(*Append)(SoA);
+	// Removes the element at index by moving the last element into its place, doesn't preserve order
+	void (*SwapRemove)(SoA, ulong index);
+	void (*Clear)(SoA);
+	// Writes the backing array of each selected column into out_columns, in column order,
+	// returns the number of columns written
+	ulong(*SelectColumns)(SoA, ulong columns, void** out_columns);
+	// Invokes method for every element with a pointer to the element within each selected column, in column order,
+	// only the selected columns are read so unselected columns never get pulled into the cache
+	void (*Foreach)(SoA, ulong columns, void* context, void(*method)(void* context, void** elements));
+	void (*Dispose)(SoA);
+	void (*RunUnitTests)();
+};
+
+extern const struct _soaMethods SoAs;
+
+#define _SOA_FIELD_TYPE_(fieldType, fieldName) fieldType
+#define _SOA_FIELD_NAME_(fieldType, fieldName) fieldName
+#define _SOA_FIELD_TYPE(field) EXPAND(_SOA_FIELD_TYPE_ field)
+#define _SOA_FIELD_NAME(field) EXPAND(_SOA_FIELD_NAME_ field)
+
+#define _SOA_DEFINE_COLUMN(type, index, field) _SOA_FIELD_TYPE(field)* _SOA_FIELD_NAME(field);
+#define _SOA_DEFINE_COLUMN_BIT(type, index, field) GLUE(_soa_##type##_column_, _SOA_FIELD_NAME(field)) = (1 << (index)),
+#define _SOA_DEFINE_COLUMN_SIZE(type, index, field) sizeof(_SOA_FIELD_TYPE(field)),
+#define _SOA_SCATTER_FIELD(type, index, field) soa->_SOA_FIELD_NAME(field)[elementIndex] = value._SOA_FIELD_NAME(field);
+#define _SOA_GATHER_FIELD(type, index, field) value._SOA_FIELD_NAME(field) = soa->_SOA_FIELD_NAME(field)[elementIndex];
+
+#define _EXPAND_SOA_METHOD_NAME(type, method) _soa_##type##_##method
+
+// TEMPLATE FOR METHODS
+// fields are (fieldType, fieldName) pairs of the fields of type that should each get their own column
+// example:
+// DEFINE_SOA(vector3, (float, x), (float, y), (float, z));
+// soa(vector3) positions = soas(vector3).Create(0);
+// positions->y[index] -= gravity;
+#define _EXPAND_DEFINE_SOA(type, ...) struct _soa_##type\
+{\
+	ulong Count;\
+	ulong Capacity;\
+	ulong TypeId;\
+	ulong ColumnCount;\
+	const ulong* ColumnSizes;\
+	union {\
+		struct { FOR_EACH(_SOA_DEFINE_COLUMN, type, __VA_ARGS__) };\
+		void* Columns[VAR_COUNT(__VA_ARGS__)];\
+	};\
+};\
+typedef struct _soa_##type* type##_soa;\
+enum { FOR_EACH(_SOA_DEFINE_COLUMN_BIT, type, __VA_ARGS__) };\
+static const ulong _soa_##type##_ColumnSizes[] = { FOR_EACH(_SOA_DEFINE_COLUMN_SIZE, type, __VA_ARGS__) };\
+DEFINE_TYPE_ID(type##_soa);\
+private soa(type) _EXPAND_SOA_METHOD_NAME(type, Create)(ulong capacity)\
+{\
+	REGISTER_TYPE(type##_soa);\
+	return (soa(type))SoAs.Create(VAR_COUNT(__VA_ARGS__), _soa_##type##_ColumnSizes, capacity, type##_soaTypeId);\
+}\
+private void _EXPAND_SOA_METHOD_NAME(type, Reserve)(soa(type) soa, ulong count)\
+{\
+	SoAs.Reserve((SoA)soa, count);\
+}\
+private ulong _EXPAND_SOA_METHOD_NAME(type, Append)(soa(type) soa, type value)\
+{\
+	const ulong elementIndex = SoAs.Append((SoA)soa);\
+	FOR_EACH(_SOA_SCATTER_FIELD, type, __VA_ARGS__)\
+	return elementIndex;\
+}\
+private type _EXPAND_SOA_METHOD_NAME(type, Get)(soa(type) soa, ulong elementIndex)\
+{\
+	if (elementIndex >= soa->Count) { throw(IndexOutOfRangeException); }\
+	type value = { 0 };\
+	FOR_EACH(_SOA_GATHER_FIELD, type, __VA_ARGS__)\
+	return value;\
+}\
+private void _EXPAND_SOA_METHOD_NAME(type, Set)(soa(type) soa, ulong elementIndex, type value)\
+{\
+	if (elementIndex >= soa->Count) { throw(IndexOutOfRangeException); }\
+	FOR_EACH(_SOA_SCATTER_FIELD, type, __VA_ARGS__)\
+}\
+private void _EXPAND_SOA_METHOD_NAME(type, SwapRemove)(soa(type) soa, ulong index)\
+{\
+	SoAs.SwapRemove((SoA)soa, index);\
+}\
+private void _EXPAND_SOA_METHOD_NAME(type, Clear)(soa(type) soa)\
+{\
+	SoAs.Clear((SoA)soa);\
+}\
+private void _EXPAND_SOA_METHOD_NAME(type, Foreach)(soa(type) soa, ulong columns, void* context, void(*method)(void* context, void** elements))\
+{\
+	SoAs.Foreach((SoA)soa, columns, context, method);\
+}\
+private ulong _EXPAND_SOA_METHOD_NAME(type, SelectColumns)(soa(type) soa, ulong columns, void** out_columns)\
+{\
+	return SoAs.SelectColumns((SoA)soa, columns, out_columns);\
+}\
+private void _EXPAND_SOA_METHOD_NAME(type, Dispose)(soa(type) soa)\
+{\
+	SoAs.Dispose((SoA)soa);\
+}\
+const static struct _soa_##type##_methods\
+{\
+	soa(type) (*Create)(ulong capacity);\
+	void (*Reserve)(soa(type), ulong count);\
+	ulong (*Append)(soa(type), type value);\
+	type (*Get)(soa(type), ulong index);\
+	void (*Set)(soa(type), ulong index, type value);\
+	void (*SwapRemove)(soa(type), ulong index);\
+	void (*Clear)(soa(type));\
+	void (*Foreach)(soa(type), ulong columns, void* context, void(*method)(void* context, void** elements));\
+	ulong (*SelectColumns)(soa(type), ulong columns, void** out_columns);\
+	void (*Dispose)(soa(type));\
+} type##_soa##SoAs = \
+{\
+	.Create = _EXPAND_SOA_METHOD_NAME(type, Create),\
+	.Reserve = _EXPAND_SOA_METHOD_NAME(type, Reserve),\
+	.Append = _EXPAND_SOA_METHOD_NAME(type, Append),\
+	.Get = _EXPAND_SOA_METHOD_NAME(type, Get),\
+	.Set = _EXPAND_SOA_METHOD_NAME(type, Set),\
+	.SwapRemove = _EXPAND_SOA_METHOD_NAME(type, SwapRemove),\
+	.Clear = _EXPAND_SOA_METHOD_NAME(type, Clear),\
+	.Foreach = _EXPAND_SOA_METHOD_NAME(type, Foreach),\
+	.SelectColumns = _EXPAND_SOA_METHOD_NAME(type, SelectColumns),\
+	.Dispose = _EXPAND_SOA_METHOD_NAME(type, Dispose)\
+};
+
+#define DEFINE_SOA(type, ...) _EXPAND_DEFINE_SOA(type, __VA_ARGS__)
@@ -2,6 +2,8 @@
 #include <stdlib.h>
 #include "core/csharp.h"
 #include "core/array.h"
+#include "core/memory.h"
+#include "core/math/quaternions.h"
 
 // max number of bytes to alloc for parsing a string from a file buffer
 #define MAX_PARSABLE_STRING_LENGTH 1024
@@ -94,4 +96,54 @@ struct _stringMethods {
 	string(*ReplaceInvisibleCharacters)(const string str);
 };
 
-extern const struct _stringMethods Strings;
\ No newline at end of file
+extern const struct _stringMethods Strings;
+
+// the most digits after the decimal point StringBuilders.AppendFloat writes
+#define STRING_BUILDER_MAX_DECIMALS 9
+// the number of digits after the decimal point vectors and quaternions are written with, the same as "%f"
+#define STRING_BUILDER_DEFAULT_DECIMALS 6
+
+/// <summary>
+/// Builds a string by appending values to it without allocating, the bytes are written into a buffer
+/// provided by the caller or allocated from an arena
+/// </summary>
+typedef struct _stringBuilder StringBuilder;
+
+struct _stringBuilder {
+	// The string being built, always null terminated, can be read anywhere a string can but must not be disposed
+	partial_string String;
+	// The arena larger buffers are allocated from when an append doesn't fit, when null the append is truncated instead
+	Arena Arena;
+	// Whether or not an append didn't fit within the buffer and was truncated
+	bool Truncated;
+};
+
+struct _stringBuilderMethods {
+	// Creates a builder that writes into the given buffer, one byte of the buffer is reserved for the nul terminator
+	StringBuilder(*Create)(char* buffer, ulong bufferSize);
+	// Creates a builder that allocates its buffer from the arena and grows within it when an append doesn't fit
+	StringBuilder(*CreateFromArena)(Arena, ulong initialCapacity);
+	// Removes every character from the builder, the buffer is kept
+	void (*Clear)(StringBuilder*);
+	// Appends the given bytes, returns false if they were truncated
+	bool (*Append)(StringBuilder*, const char* bytes, ulong length);
+	bool (*AppendCString)(StringBuilder*, const char* cString);
+	bool (*AppendString)(StringBuilder*, const string);
+	bool (*AppendChar)(StringBuilder*, char character);
+	bool (*AppendInt)(StringBuilder*, long long value);
+	bool (*AppendUlong)(StringBuilder*, ulong value);
+	// Appends the value with the given number of digits after the decimal point without using the locale,
+	// writes the same digits as "%.*f" for floats smaller than 2^63 / 10^decimals
+	bool (*AppendFloat)(StringBuilder*, double value, int decimals);
+	bool (*AppendBool)(StringBuilder*, bool value);
+	// Appends the components separated by spaces, the same format as Vector2s.TrySerialize
+	bool (*AppendVector2)(StringBuilder*, vector2);
+	bool (*AppendVector3)(StringBuilder*, vector3);
+	bool (*AppendVector4)(StringBuilder*, vector4);
+	bool (*AppendQuaternion)(StringBuilder*, quaternion);
+	// Gets the nul terminated characters of the builder
+	const char* (*CString)(const StringBuilder*);
+	void (*RunUnitTests)();
+};
+
+extern const struct _stringBuilderMethods StringBuilders;
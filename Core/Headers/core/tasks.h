@@ -67,6 +67,14 @@ extern struct _taskMethods {
 	void (*NotifyAllThreadsAddressChanged)(void* address);
 	void (*NotifyAddressChanged)(void* address);
 	bool (*WaitOnAddress)(volatile void* address, ulong addressSize, ulong milliseconds);
+	// Sleeps until the value at the address no longer equals expected or the address is notified, returns false when
+	// the timeout elapsed, unlike WaitOnAddress a change made before this is called is never missed
+	bool (*WaitWhileEqual)(volatile void* address, const void* expected, ulong addressSize, ulong milliseconds);
+	// Returns the deadline for WaitUntil that's the given milliseconds from now, Forever stays Forever
+	ulong(*DeadlineAfter)(ulong milliseconds);
+	// Same as WaitWhileEqual but waits until a deadline from DeadlineAfter, so waiting again in a loop after a wake up
+	// doesn't restart the timeout
+	bool (*WaitUntil)(volatile void* address, const void* expected, ulong addressSize, ulong deadline);
 	WaitStatus(*Wait)(Task task, ulong milliseconds);
 	WaitStatus(*WaitAll)(array(Task) tasks, ulong milliseconds);
 	WaitStatus(*WaitAny)(array(Task) tasks, ulong milliseconds);
@@ -77,4 +85,5 @@ extern struct _taskMethods {
 	Task(*TaskForThread)(int threadId);
 	WaitStatus(*WaitForState)(Task task, WaitStatus state, ulong milliseconds);
 	void (*Dispose)(Task);
+	void (*RunUnitTests)();
 } Tasks;
\ No newline at end of file
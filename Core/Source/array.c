@@ -2,16 +2,24 @@
 #include "core/memory.h"
 #include <memory.h>
 #include <string.h>
+#include <stddef.h>
 #include "core/cunit.h"
 
 private Array Create(ulong elementSize, ulong count, ulong typeId);
+private Array CreateSmall(ulong elementSize, ulong count, ulong typeId);
 private ulong GetNextAvailableIndex(Array);
 private void AutoResize(Array);
 private void Resize(Array, ulong newCount);
+private void Reserve(Array, ulong count);
+private void ShrinkToFit(Array);
+private void SetGrowthPolicy(Array, float growthFactor, ulong reserveHint);
 private void Dispose(Array);
 private void Append(Array, void*);
 private void RemoveIndex(Array, ulong index);
 private void InsertionSort(Array, bool(comparator)(void* leftMemoryBlock, void* rightMemoryBlock));
+private void Sort(Array, bool(comparator)(void* leftMemoryBlock, void* rightMemoryBlock));
+private void StableSort(Array, bool(comparator)(void* leftMemoryBlock, void* rightMemoryBlock), Arena scratch);
+private void RadixSort(Array, enum RadixKey key, ulong keyOffset, Arena scratch);
 private void Swap(Array, ulong firstIndex, ulong secondIndex);
 private Array AppendArray(Array array, Array appendedValue);
 private void* At(Array array, ulong index);
@@ -20,13 +28,21 @@ private void Foreach(Array array, void(*method)(void* item));
 private void ForeachWithContext(Array array, void* context, void(*method)(void* context, void* item));
 private Array InsertArray(Array dest, Array src, ulong index);
 private bool Equals(Array left, Array right);
+private ulong Hash(Array array);
 
 const struct _arrayMethods Arrays = {
 	.Create = Create,
+	.CreateSmall = CreateSmall,
 	.AutoResize = AutoResize,
 	.Resize = Resize,
+	.Reserve = Reserve,
+	.ShrinkToFit = ShrinkToFit,
+	.SetGrowthPolicy = SetGrowthPolicy,
 	.Append = Append,
 	.InsertionSort = InsertionSort,
+	.Sort = Sort,
+	.StableSort = StableSort,
+	.RadixSort = RadixSort,
 	.RemoveIndex = RemoveIndex,
 	.Swap = Swap,
 	.Dispose = Dispose,
@@ -36,12 +52,13 @@ const struct _arrayMethods Arrays = {
 	.Clear = Clear,
 	.Foreach = Foreach,
 	.ForeachWithContext = ForeachWithContext,
-	.Equals = Equals
+	.Equals = Equals,
+	.Hash = Hash
 };
 
 private Array Create(ulong elementSize, ulong count, ulong typeId)
 {
-	REGISTER_TYPE(Array);
+	REGISTER_SLAB_TYPE(Array, sizeof(struct _array_void));
 
 	array(void) array = Memory.Alloc(sizeof(struct _array_void), ArrayTypeId);
 
@@ -61,21 +78,104 @@ private Array Create(ulong elementSize, ulong count, ulong typeId)
 	array->Size = (elementSize * count) + 1;
 	array->Capacity = count;
 	array->Dirty = true;
-	array->AutoHash = true;
+	// most arrays are never hashed, only maintain the hash on append when the caller asks for it
+	array->AutoHash = false;
 	array->StackObject = false;
 	array->Hash = 0;
+	array->HashState = 0;
+	array->GrowthFactor = 0;
+	array->ReserveHint = 0;
+	array->InlineStorage = false;
 
 	return array;
 }
 
+// inline elements start at the first 16 byte boundary after the array so vectors stay aligned
+#define ARRAY_INLINE_OFFSET ((sizeof(struct _array_void) + 15) & ~(ulong)15)
+
+private Array CreateSmall(ulong elementSize, ulong count, ulong typeId)
+{
+	REGISTER_SLAB_TYPE(Array, sizeof(struct _array_void));
+
+	const ulong size = (elementSize * count) + 1;
+
+	// the array and its values share a single allocation, this block is never the size of a
+	// regular array so it's served from the heap rather than the Array slab
+	array(void) array = Memory.Alloc(ARRAY_INLINE_OFFSET + size, ArrayTypeId);
+
+	array->Values = (byte*)array + ARRAY_INLINE_OFFSET;
+	array->Count = 0;
+	array->ElementSize = elementSize;
+	array->TypeId = typeId;
+	array->Size = size;
+	array->Capacity = count;
+	array->Dirty = true;
+	array->AutoHash = false;
+	array->StackObject = false;
+	array->Hash = 0;
+	array->HashState = 0;
+	array->GrowthFactor = 0;
+	array->ReserveHint = 0;
+	array->InlineStorage = true;
+
+	return array;
+}
+
+// moves the inline values of a small array to their own block with room for count elements
+private void SpillInlineStorage(Array array, ulong count)
+{
+	const ulong newSize = array->ElementSize * count;
+
+	void* values = Memory.Alloc(newSize + 1, array->TypeId);
+
+	memcpy(values, array->Values, min(array->Count, count) * array->ElementSize);
+
+	array->Values = values;
+	array->Size = newSize + 1;
+	array->Capacity = count;
+	array->InlineStorage = false;
+}
+
 private ulong HashArray(Array array)
 {
-	array->Hash = Hashing.HashSafe(array->Values, array->Count * array->ElementSize);
+	HashStream stream;
+
+	Hashing.Begin(&stream, 0);
+	Hashing.Update(&stream, array->Values, array->Count * array->ElementSize);
+
+	array->HashState = stream.State;
+	array->Hash = Hashing.End(&stream);
 	array->Dirty = false;
 
 	return array->Hash;
 }
 
+// continues the hash from the state saved by the last hash, only the bytes after the last complete block
+// have to be hashed again so appending stays O(1) and still matches hashing the whole array at once
+private void HashAppended(Array array, ulong previousSize)
+{
+	HashStream stream = {
+		.State = array->HashState,
+		.Length = previousSize - (previousSize % HASH_BLOCK_SIZE)
+	};
+
+	// the bytes of the incomplete block are still in the array
+	Hashing.Update(&stream, (byte*)array->Values + stream.Length, (array->Count * array->ElementSize) - stream.Length);
+
+	array->HashState = stream.State;
+	array->Hash = Hashing.End(&stream);
+}
+
+private ulong Hash(Array array)
+{
+	if (array->Dirty)
+	{
+		HashArray(array);
+	}
+
+	return array->Hash;
+}
+
 private void Append(Array array, void* value)
 {
 	// check to see if we need to resize or not
@@ -88,15 +188,20 @@ private void Append(Array array, void* value)
 		if (array->AutoHash)
 		{
 			// we only have to hash the new value
-			if (array->Dirty is false and array->AutoHash)
+			if (array->Dirty is false)
 			{
-				array->Hash = Hashing.ChainHashSafe(value, array->ElementSize, array->Hash);
+				HashAppended(array, (array->Count - 1) * array->ElementSize);
 			}
 			else
 			{
 				HashArray(array);
 			}
 		}
+		else
+		{
+			// the hash is calculated on demand the next time it's needed
+			array->Dirty = true;
+		}
 	}
 	else
 	{
@@ -105,8 +210,36 @@ private void Append(Array array, void* value)
 	}
 }
 
+// grows the array to at least minimumCount elements following the array's growth policy
+private void Grow(Array array, ulong minimumCount)
+{
+	const float factor = array->GrowthFactor isnt 0 ? array->GrowthFactor : ARRAY_DEFAULT_GROWTH_FACTOR;
+
+	ulong newCapacity = (ulong)(array->Capacity * factor);
+
+	// small factors may not grow small arrays at all
+	newCapacity = max(newCapacity, safe_add(array->Capacity, 1));
+	newCapacity = max(newCapacity, minimumCount);
+	newCapacity = max(newCapacity, array->ReserveHint);
+
+	// the hint only sizes the first growth, later growths follow the factor
+	array->ReserveHint = 0;
+
+	Reserve(array, newCapacity);
+}
+
 private void AutoResize(Array array)
 {
+	Grow(array, safe_add(array->Capacity, 1));
+}
+
+private void Reserve(Array array, ulong count)
+{
+	if (count <= array->Capacity and array->Values isnt null)
+	{
+		return;
+	}
+
 	// if a user allocs a array on the stack they can't modify past the given
 	// memory block without overwriting stack stuff
 	if (array->StackObject)
@@ -114,36 +247,69 @@ private void AutoResize(Array array)
 		throw(StackObjectModifiedException);
 	}
 
-	ulong newSize = max(array->Size << 1, array->ElementSize);
-
-	if ((newSize % array->ElementSize) isnt 0)
+	// inline values can't be realloced since they share a block with the array
+	if (array->InlineStorage)
 	{
-		newSize = safe_add(newSize, (newSize % array->ElementSize));
+		SpillInlineStorage(array, count);
+		return;
 	}
 
-	if (array->Size is 0)
+	const ulong newSize = array->ElementSize * count;
+
+	// alloc one more byte so its terminated, realloc grows the block in place when
+	// it can and zeroes the new bytes so the terminator is kept
+	Memory.ReallocOrCopy(&array->Values, array->Size, newSize + 1, array->TypeId);
+
+	array->Capacity = count;
+	array->Size = newSize + 1;
+}
+
+private void ShrinkToFit(Array array)
+{
+	if (array->StackObject)
 	{
-		// alloc one more byte so its terminated
-		array->Values = Memory.Alloc(newSize + 1, array->TypeId);
+		throw(StackObjectModifiedException);
 	}
-	else
+
+	// inline values don't cost an extra allocation so there's nothing to shrink
+	if (array->InlineStorage or array->Count is array->Capacity)
 	{
-		// alloc one more byte so its terminated
-		//Memory.ReallocOrCopy(&array->Values, array->Size, newSize + 1, array->TypeId);
-		void* old = array->Values;
-		array->Values = Memory.Alloc(newSize + 1, array->TypeId);
-		if (old)
-		{
-			memcpy(array->Values, old, array->Size);
+		return;
+	}
 
-			Memory.Free(old, array->TypeId);
-		}
+	if (array->Count is 0)
+	{
+		Memory.Free(array->Values, array->TypeId);
+		array->Values = null;
+		array->Size = 1;
+		array->Capacity = 0;
+		return;
 	}
 
-	array->Capacity = newSize / array->ElementSize;
+	const ulong newSize = array->ElementSize * array->Count;
+
+	Memory.ReallocOrCopy(&array->Values, array->Size, newSize + 1, array->TypeId);
+
+	// realloc only zeroes bytes when the block grows
+	((byte*)array->Values)[newSize] = 0;
+
+	array->Capacity = array->Count;
 	array->Size = newSize + 1;
 }
 
+private void SetGrowthPolicy(Array array, float growthFactor, ulong reserveHint)
+{
+	// factors of 1 or less would never grow the array, 0 uses the default, written so NaN is rejected too
+	if (growthFactor isnt 0 and not (growthFactor > 1.0f))
+	{
+		fprintf_red(stderr, "The growth factor of an array must be greater than 1, or 0 for the default, got %f"NEWLINE, growthFactor);
+		throw(InvalidArgumentException);
+	}
+
+	array->GrowthFactor = growthFactor;
+	array->ReserveHint = reserveHint;
+}
+
 private void Resize(Array array, ulong newCount)
 {
 	// if a user allocs a array on the stack they can't modify past the given
@@ -153,12 +319,27 @@ private void Resize(Array array, ulong newCount)
 		throw(StackObjectModifiedException);
 	}
 
+	if (array->InlineStorage)
+	{
+		if (newCount <= array->Capacity)
+		{
+			// keep the inline block and clear what's past the new count like realloc would
+			memset((byte*)array->Values + (newCount * array->ElementSize), 0, ((array->Capacity - newCount) * array->ElementSize) + 1);
+
+			array->Count = newCount;
+			return;
+		}
+
+		SpillInlineStorage(array, newCount);
+	}
+
 	if (newCount is 0)
 	{
 		Memory.Free(array->Values, array->TypeId);
 		array->Values = null;
 		array->Size = 0;
 		array->Count = 0;
+		array->Capacity = 0;
 		return;
 	}
 
@@ -167,6 +348,7 @@ private void Resize(Array array, ulong newCount)
 	Memory.ReallocOrCopy(&array->Values, array->Size, newSize + 1, array->TypeId);
 
 	array->Size = newSize + 1;
+	array->Capacity = newCount;
 	array->Count = newCount;
 }
 
@@ -246,6 +428,393 @@ private void InsertionSort(Array array, bool(comparator)(void* leftMemoryBlock,
 	array->Hash = 0;
 }
 
+// ranges this small are insertion sorted instead of partitioned or merged
+#define SORT_INSERTION_CUTOFF 16
+
+#define ELEMENT_AT(values, index, size) ((byte*)(values) + ((index) * (size)))
+
+private void SwapElements(byte* left, byte* right, ulong size)
+{
+	while (size >= sizeof(ulong))
+	{
+		ulong tmp;
+		memcpy(&tmp, left, sizeof(ulong));
+		memcpy(left, right, sizeof(ulong));
+		memcpy(right, &tmp, sizeof(ulong));
+
+		left += sizeof(ulong);
+		right += sizeof(ulong);
+		size -= sizeof(ulong);
+	}
+
+	while (size--)
+	{
+		const byte tmp = *left;
+		*left++ = *right;
+		*right++ = tmp;
+	}
+}
+
+// comparator(left, right) returns true when left belongs after right, the same contract InsertionSort uses
+// the swaps only ever move an element past neighbours that belong after it so this is stable
+private void InsertionSortRange(byte* values, ulong start, ulong end, ulong size, bool(comparator)(void* leftMemoryBlock, void* rightMemoryBlock))
+{
+	for (ulong i = start + 1; i < end; i++)
+	{
+		for (ulong j = i; j > start; j--)
+		{
+			byte* current = ELEMENT_AT(values, j, size);
+			byte* previous = current - size;
+
+			if (comparator(previous, current) is false)
+			{
+				break;
+			}
+
+			SwapElements(previous, current, size);
+		}
+	}
+}
+
+private void SiftDown(byte* values, ulong start, ulong root, ulong count, ulong size, bool(comparator)(void* leftMemoryBlock, void* rightMemoryBlock))
+{
+	while (true)
+	{
+		ulong child = (root << 1) + 1;
+
+		if (child >= count)
+		{
+			return;
+		}
+
+		if (child + 1 < count and comparator(ELEMENT_AT(values, start + child + 1, size), ELEMENT_AT(values, start + child, size)))
+		{
+			++child;
+		}
+
+		if (comparator(ELEMENT_AT(values, start + child, size), ELEMENT_AT(values, start + root, size)) is false)
+		{
+			return;
+		}
+
+		SwapElements(ELEMENT_AT(values, start + child, size), ELEMENT_AT(values, start + root, size), size);
+
+		root = child;
+	}
+}
+
+// used when quicksort keeps picking bad pivots so the worst case stays O(n log n)
+private void HeapSortRange(byte* values, ulong start, ulong end, ulong size, bool(comparator)(void* leftMemoryBlock, void* rightMemoryBlock))
+{
+	const ulong count = end - start;
+
+	for (ulong i = count >> 1; i-- > 0;)
+	{
+		SiftDown(values, start, i, count, size, comparator);
+	}
+
+	for (ulong last = count - 1; last > 0; last--)
+	{
+		SwapElements(ELEMENT_AT(values, start, size), ELEMENT_AT(values, start + last, size), size);
+		SiftDown(values, start, 0, last, size, comparator);
+	}
+}
+
+// moves the median of the first, middle and last elements to the start of the range to be used as the pivot
+private void MoveMedianToStart(byte* values, ulong start, ulong end, ulong size, bool(comparator)(void* leftMemoryBlock, void* rightMemoryBlock))
+{
+	byte* first = ELEMENT_AT(values, start + 1, size);
+	byte* middle = ELEMENT_AT(values, start + ((end - start) >> 1), size);
+	byte* last = ELEMENT_AT(values, end - 1, size);
+
+	if (comparator(first, middle))
+	{
+		SwapElements(first, middle, size);
+	}
+	if (comparator(middle, last))
+	{
+		SwapElements(middle, last, size);
+	}
+	if (comparator(first, middle))
+	{
+		SwapElements(first, middle, size);
+	}
+
+	SwapElements(ELEMENT_AT(values, start, size), middle, size);
+}
+
+private void IntroSortRange(byte* values, ulong start, ulong end, ulong size, ulong depth, bool(comparator)(void* leftMemoryBlock, void* rightMemoryBlock))
+{
+	while (end - start > SORT_INSERTION_CUTOFF)
+	{
+		if (depth is 0)
+		{
+			HeapSortRange(values, start, end, size, comparator);
+			return;
+		}
+
+		--depth;
+
+		MoveMedianToStart(values, start, end, size, comparator);
+
+		byte* pivot = ELEMENT_AT(values, start, size);
+
+		ulong left = start;
+		ulong right = end;
+
+		// both scans stop on elements equal to the pivot so ranges full of duplicates still split in half
+		while (true)
+		{
+			while (comparator(pivot, ELEMENT_AT(values, ++left, size)) and left < end - 1);
+			while (comparator(ELEMENT_AT(values, --right, size), pivot));
+
+			if (left >= right)
+			{
+				break;
+			}
+
+			SwapElements(ELEMENT_AT(values, left, size), ELEMENT_AT(values, right, size), size);
+		}
+
+		SwapElements(pivot, ELEMENT_AT(values, right, size), size);
+
+		// recurse into the smaller half and loop on the larger one so the stack stays O(log n)
+		if (right - start < end - right)
+		{
+			IntroSortRange(values, start, right, size, depth, comparator);
+			start = right + 1;
+		}
+		else
+		{
+			IntroSortRange(values, right + 1, end, size, depth, comparator);
+			end = right;
+		}
+	}
+
+	InsertionSortRange(values, start, end, size, comparator);
+}
+
+private void Sort(Array array, bool(comparator)(void* leftMemoryBlock, void* rightMemoryBlock))
+{
+	if (array->Count > 1)
+	{
+		ulong depth = 0;
+
+		for (ulong count = array->Count; count > 1; count >>= 1)
+		{
+			depth += 2;
+		}
+
+		IntroSortRange((byte*)array->Values, 0, array->Count, array->ElementSize, depth, comparator);
+	}
+
+	array->Dirty = true;
+	array->Hash = 0;
+}
+
+// gets size bytes of scratch memory from the arena, or from the heap when no arena was provided
+private void* AllocScratch(Arena scratch, ulong size)
+{
+	if (scratch isnt null)
+	{
+		return Memory.Arena.Alloc(scratch, size);
+	}
+
+	return Memory.Alloc(size, Memory.GenericMemoryBlock);
+}
+
+private void FreeScratch(Arena scratch, ArenaMark mark, void* block)
+{
+	if (scratch isnt null)
+	{
+		Memory.Arena.Rewind(scratch, mark);
+		return;
+	}
+
+	Memory.Free(block, Memory.GenericMemoryBlock);
+}
+
+private void StableSort(Array array, bool(comparator)(void* leftMemoryBlock, void* rightMemoryBlock), Arena scratch)
+{
+	const ulong count = array->Count;
+	const ulong size = array->ElementSize;
+
+	if (count <= SORT_INSERTION_CUTOFF)
+	{
+		InsertionSortRange((byte*)array->Values, 0, count, size, comparator);
+
+		array->Dirty = true;
+		array->Hash = 0;
+		return;
+	}
+
+	const ArenaMark mark = scratch isnt null ? Memory.Arena.Mark(scratch) : 0;
+
+	byte* source = (byte*)array->Values;
+	byte* destination = AllocScratch(scratch, count * size);
+	byte* buffer = destination;
+
+	for (ulong start = 0; start < count; start += SORT_INSERTION_CUTOFF)
+	{
+		InsertionSortRange(source, start, min(start + SORT_INSERTION_CUTOFF, count), size, comparator);
+	}
+
+	// bottom up merge passes that alternate between the array and the scratch buffer
+	for (ulong width = SORT_INSERTION_CUTOFF; width < count; width <<= 1)
+	{
+		for (ulong start = 0; start < count; start += width << 1)
+		{
+			const ulong middle = min(start + width, count);
+			const ulong end = min(start + (width << 1), count);
+
+			ulong left = start;
+			ulong right = middle;
+			byte* output = ELEMENT_AT(destination, start, size);
+
+			while (left < middle and right < end)
+			{
+				// only take from the right run when it belongs strictly before the left so equal elements keep their order
+				if (comparator(ELEMENT_AT(source, left, size), ELEMENT_AT(source, right, size)))
+				{
+					memcpy(output, ELEMENT_AT(source, right++, size), size);
+				}
+				else
+				{
+					memcpy(output, ELEMENT_AT(source, left++, size), size);
+				}
+
+				output += size;
+			}
+
+			memcpy(output, ELEMENT_AT(source, left, size), (middle - left) * size);
+			output += (middle - left) * size;
+			memcpy(output, ELEMENT_AT(source, right, size), (end - right) * size);
+		}
+
+		byte* tmp = source;
+		source = destination;
+		destination = tmp;
+	}
+
+	if (source isnt (byte*)array->Values)
+	{
+		memcpy(array->Values, source, count * size);
+	}
+
+	FreeScratch(scratch, mark, buffer);
+
+	array->Dirty = true;
+	array->Hash = 0;
+}
+
+// flips the key so that comparing it as an unsigned integer gives the same order as comparing the original value
+private ulong RadixSortableKey(const byte* element, enum RadixKey key)
+{
+	switch (key)
+	{
+	case RadixKeyInt:
+	{
+		unsigned int value;
+		memcpy(&value, element, sizeof(unsigned int));
+		return value ^ 0x80000000u;
+	}
+	case RadixKeyFloat:
+	{
+		unsigned int value;
+		memcpy(&value, element, sizeof(unsigned int));
+		// negative floats are stored as sign and magnitude so all of their bits flip, positive floats only need the sign
+		return value ^ ((value & 0x80000000u) ? 0xFFFFFFFFu : 0x80000000u);
+	}
+	case RadixKeyUlong:
+	default:
+	{
+		ulong value;
+		memcpy(&value, element, sizeof(ulong));
+		return value;
+	}
+	}
+}
+
+private void RadixSort(Array array, enum RadixKey key, ulong keyOffset, Arena scratch)
+{
+	const ulong count = array->Count;
+	const ulong size = array->ElementSize;
+	const ulong keySize = key is RadixKeyUlong ? sizeof(ulong) : sizeof(unsigned int);
+
+	if (keyOffset + keySize > size)
+	{
+		throw(InvalidArgumentException);
+	}
+
+	if (count > 1)
+	{
+		// one pass per byte of the key, the counts for every pass are gathered up front
+		ulong histograms[sizeof(ulong)][256] = { 0 };
+
+		byte* values = (byte*)array->Values;
+
+		for (ulong i = 0; i < count; i++)
+		{
+			const ulong sortable = RadixSortableKey(ELEMENT_AT(values, i, size) + keyOffset, key);
+
+			for (ulong pass = 0; pass < keySize; pass++)
+			{
+				++histograms[pass][(sortable >> (pass << 3)) & 0xFF];
+			}
+		}
+
+		const ArenaMark mark = scratch isnt null ? Memory.Arena.Mark(scratch) : 0;
+
+		byte* source = values;
+		byte* destination = AllocScratch(scratch, count * size);
+		byte* buffer = destination;
+
+		for (ulong pass = 0; pass < keySize; pass++)
+		{
+			ulong* histogram = histograms[pass];
+
+			const ulong shift = pass << 3;
+
+			// every element has the same byte here, the pass wouldn't move anything
+			if (histogram[(RadixSortableKey(source + keyOffset, key) >> shift) & 0xFF] is count)
+			{
+				continue;
+			}
+
+			ulong offset = 0;
+
+			for (ulong digit = 0; digit < 256; digit++)
+			{
+				const ulong digitCount = histogram[digit];
+				histogram[digit] = offset;
+				offset += digitCount;
+			}
+
+			for (ulong i = 0; i < count; i++)
+			{
+				const byte* element = ELEMENT_AT(source, i, size);
+				const ulong digit = (RadixSortableKey(element + keyOffset, key) >> shift) & 0xFF;
+
+				memcpy(ELEMENT_AT(destination, histogram[digit]++, size), element, size);
+			}
+
+			byte* tmp = source;
+			source = destination;
+			destination = tmp;
+		}
+
+		if (source isnt values)
+		{
+			memcpy(values, source, count * size);
+		}
+
+		FreeScratch(scratch, mark, buffer);
+	}
+
+	array->Dirty = true;
+	array->Hash = 0;
+}
+
 // Gets a pointer to the value contained at index
 private void* At(Array array, ulong index)
 {
@@ -284,7 +853,7 @@ private Array InsertArray(Array destination, Array source, ulong index)
 		return destination;
 	}
 
-	AutoResize(destination);
+	Grow(destination, safe_add(destination->Count, source->Count));
 	return InsertArray(destination, source, index);
 }
 
@@ -329,7 +898,11 @@ private void Dispose(Array array)
 		throw(StackObjectModifiedException);
 	}
 
-	Memory.Free(array->Values, array->TypeId);
+	if (array->InlineStorage is false)
+	{
+		Memory.Free(array->Values, array->TypeId);
+	}
+
 	Memory.Free(array, ArrayTypeId);
 }
 
@@ -376,25 +949,14 @@ private bool Equals(Array left, Array right)
 			return rightOrLeft is leftOrRight;
 		}
 
-		// we calc the hashes in the next method
-		right->Dirty = false;
-		left->Dirty = false;
-
-		return Memory.CompareMemoryAndHash(
-			left->Values,
-			left->Count * left->ElementSize,
-			right->Values,
-			right->Count * right->ElementSize,
-			&left->Hash, &right->Hash) is 0;
+		return HashArray(left) is HashArray(right);
 	}
 
-	return memcmp(left->Values,
+	return Simd.Mismatch(left->Values,
 		right->Values,
-		left->ElementSize * left->Count) is 0;
+		left->ElementSize * left->Count) is SIMD_NOT_FOUND;
 }
 
-#include "core/runtime.h"
-
 TEST(Equals)
 {
 	string left = dynamic_string("ABCDEF");
@@ -539,6 +1101,112 @@ TEST(Sorting)
 
 	IsEqual(expected, data);
 
+	data = stack_string("21875098126354912839");
+
+	strings.Sort(data, GreaterThan);
+
+	IsEqual(expected, data);
+
+	data = stack_string("21875098126354912839");
+
+	strings.StableSort(data, GreaterThan, null);
+
+	IsEqual(expected, data);
+
+	return true;
+}
+
+// sorts by the key and leaves the index alone so stability can be checked
+typedef struct {
+	float Key;
+	int Index;
+} keyedIndex;
+
+DEFINE_ARRAY(keyedIndex);
+
+private bool KeyGreaterThan(keyedIndex* left, keyedIndex* right)
+{
+	return left->Key > right->Key;
+}
+
+private bool IsSortedStable(array(keyedIndex) values)
+{
+	for (ulong i = 1; i < values->Count; i++)
+	{
+		const keyedIndex previous = values->Values[i - 1];
+		const keyedIndex current = values->Values[i];
+
+		if (previous.Key > current.Key or (previous.Key == current.Key and previous.Index > current.Index))
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+TEST(LargeSorting)
+{
+	const ulong count = 10000;
+
+	array(keyedIndex) values = arrays(keyedIndex).Create(count);
+	array(int) ints = arrays(int).Create(count);
+
+	Arena scratch = Memory.Arena.Create(count * sizeof(keyedIndex), Memory.GenericMemoryBlock);
+
+	unsigned int seed = 1;
+
+	for (ulong i = 0; i < count; i++)
+	{
+		seed = (seed * 1103515245) + 12345;
+
+		// lots of duplicates and negative keys
+		keyedIndex value = { .Key = (float)((int)((seed >> 16) % 200) - 100) * 0.5f, .Index = (int)i };
+
+		arrays(keyedIndex).Append(values, value);
+		arrays(int).Append(ints, (int)seed);
+	}
+
+	arrays(keyedIndex).StableSort(values, KeyGreaterThan, scratch);
+
+	IsTrue(IsSortedStable(values));
+	// the scratch buffer is given back to the arena
+	IsEqual((ulong)0, scratch->Offset);
+
+	// shuffle the order back up by the index and sort by the float key instead
+	for (ulong i = 0; i < count; i++)
+	{
+		values->Values[i].Index = (int)((i * 7919) % count);
+	}
+
+	arrays(keyedIndex).Sort(values, KeyGreaterThan);
+
+	for (ulong i = 1; i < count; i++)
+	{
+		IsTrue(values->Values[i - 1].Key <= values->Values[i].Key);
+	}
+
+	for (ulong i = 0; i < count; i++)
+	{
+		values->Values[i].Index = (int)i;
+		values->Values[i].Key = -values->Values[i].Key;
+	}
+
+	arrays(keyedIndex).RadixSort(values, RadixKeyFloat, offsetof(keyedIndex, Key), scratch);
+
+	IsTrue(IsSortedStable(values));
+
+	arrays(int).RadixSort(ints, RadixKeyInt, 0, null);
+
+	for (ulong i = 1; i < count; i++)
+	{
+		IsTrue(ints->Values[i - 1] <= ints->Values[i]);
+	}
+
+	Memory.Arena.Dispose(scratch);
+	arrays(int).Dispose(ints);
+	arrays(keyedIndex).Dispose(values);
+
 	return true;
 }
 
@@ -597,11 +1265,229 @@ TEST(RemoveRange)
 	return true;
 }
 
+TEST(Growth)
+{
+	array(int) data = arrays(int).Create(0);
+
+	arrays(int).Reserve(data, 100);
+
+	IsEqual((ulong)100, data->Capacity);
+	IsEqual((ulong)0, data->Count);
+
+	for (int i = 0; i < 101; i++)
+	{
+		arrays(int).Append(data, i);
+	}
+
+	// the default policy doubles the capacity
+	IsEqual((ulong)200, data->Capacity);
+
+	for (int i = 0; i < 101; i++)
+	{
+		IsEqual(i, at(data, i));
+	}
+
+	arrays(int).ShrinkToFit(data);
+
+	IsEqual((ulong)101, data->Capacity);
+	IsEqual((ulong)101, data->Count);
+	IsEqual(100, at(data, 100));
+	IsEqual('\0', *((byte*)data->Values + data->Count * data->ElementSize));
+
+	arrays(int).SetGrowthPolicy(data, 1.5f, 0);
+	arrays(int).Append(data, 101);
+
+	IsEqual((ulong)151, data->Capacity);
+
+	arrays(int).Clear(data);
+	arrays(int).ShrinkToFit(data);
+
+	IsEqual((ulong)0, data->Capacity);
+
+	arrays(int).SetGrowthPolicy(data, 0, 64);
+	arrays(int).Append(data, 1);
+
+	IsEqual((ulong)64, data->Capacity);
+	IsEqual(1, at(data, 0));
+
+	// the hint is only used by the first growth
+	for (int i = 0; i < 64; i++)
+	{
+		arrays(int).Append(data, i);
+	}
+
+	IsEqual((ulong)128, data->Capacity);
+
+	arrays(int).Clear(data);
+	arrays(int).ShrinkToFit(data);
+	arrays(int).Append(data, 1);
+
+	IsEqual((ulong)1, data->Capacity);
+
+	arrays(int).Dispose(data);
+
+	return true;
+}
+
+TEST(SmallArray)
+{
+	array(int) data = small_array(int, 4);
+
+	IsTrue(data->InlineStorage);
+	IsEqual((ulong)4, data->Capacity);
+	IsTrue((void*)data->Values > (void*)data);
+
+	arrays(int).Append(data, 1);
+	arrays(int).Append(data, 2);
+	arrays(int).Append(data, 3);
+	arrays(int).Append(data, 4);
+
+	// still inline
+	IsTrue(data->InlineStorage);
+	IsTrue(arrays(int).Equals(data, auto_stack_array(int, 1, 2, 3, 4)));
+
+	arrays(int).Append(data, 5);
+
+	// spilled to the heap
+	IsFalse(data->InlineStorage);
+	IsEqual((ulong)8, data->Capacity);
+	IsTrue(arrays(int).Equals(data, auto_stack_array(int, 1, 2, 3, 4, 5)));
+
+	arrays(int).Dispose(data);
+
+	string path = small_array(byte, 16);
+
+	strings.AppendArray(path, stack_string("assets"));
+	strings.Resize(path, 3);
+
+	string expected = stack_string("ass");
+
+	IsTrue(path->InlineStorage);
+	IsEqual(expected, path);
+	IsEqual('\0', *(path->Values + 3));
+
+	strings.ShrinkToFit(path);
+	IsTrue(path->InlineStorage);
+
+	strings.Dispose(path);
+
+	return true;
+}
+
+#define BENCHMARK_APPEND_COUNT 10000000
+
+TEST(AppendBenchmark)
+{
+	array(int) data = arrays(int).Create(BENCHMARK_APPEND_COUNT);
+
+	fprintf(__test_stream, "\tAppend %i ints with AutoHash ", BENCHMARK_APPEND_COUNT);
+
+	data->AutoHash = true;
+
+	Benchmark(
+		for (int i = 0; i < BENCHMARK_APPEND_COUNT; i++)
+		{
+			arrays(int).Append(data, i);
+		}, __test_stream
+	);
+
+	const ulong autoHash = data->Hash;
+
+	fprintf(__test_stream, NEWLINE);
+
+	arrays(int).Clear(data);
+
+	fprintf(__test_stream, "\tAppend %i ints hashing on demand ", BENCHMARK_APPEND_COUNT);
+
+	data->AutoHash = false;
+
+	Benchmark(
+		for (int i = 0; i < BENCHMARK_APPEND_COUNT; i++)
+		{
+			arrays(int).Append(data, i);
+		}
+		arrays(int).Hash(data), __test_stream
+	);
+
+	fprintf(__test_stream, NEWLINE);
+
+	// both ways of hashing have to agree
+	IsEqual(autoHash, data->Hash);
+	IsFalse(data->Dirty);
+
+	arrays(int).Dispose(data);
+
+	return true;
+}
+
+DEFINE_COMPARATOR(int, IntGreaterThan, > );
+
+private void FillRandomInts(array(int) data, ulong count, unsigned int seed)
+{
+	arrays(int).Clear(data);
+
+	for (ulong i = 0; i < count; i++)
+	{
+		seed = (seed * 1103515245) + 12345;
+
+		arrays(int).Append(data, (int)seed);
+	}
+}
+
+private void BenchmarkSorts(FILE* stream, ulong count)
+{
+	array(int) data = arrays(int).Create(count);
+
+	// insertion sort is quadratic, only small arrays finish in a reasonable time
+	if (count <= 1000)
+	{
+		FillRandomInts(data, count, 1);
+
+		fprintf(stream, "\t%lli ints InsertionSort ", count);
+		Benchmark(arrays(int).InsertionSort(data, IntGreaterThan), stream);
+		fprintf(stream, NEWLINE);
+	}
+
+	FillRandomInts(data, count, 1);
+
+	fprintf(stream, "\t%lli ints Sort ", count);
+	Benchmark(arrays(int).Sort(data, IntGreaterThan), stream);
+	fprintf(stream, NEWLINE);
+
+	FillRandomInts(data, count, 1);
+
+	fprintf(stream, "\t%lli ints StableSort ", count);
+	Benchmark(arrays(int).StableSort(data, IntGreaterThan, null), stream);
+	fprintf(stream, NEWLINE);
+
+	FillRandomInts(data, count, 1);
+
+	fprintf(stream, "\t%lli ints RadixSort ", count);
+	Benchmark(arrays(int).RadixSort(data, RadixKeyInt, 0, null), stream);
+	fprintf(stream, NEWLINE);
+
+	arrays(int).Dispose(data);
+}
+
+TEST(SortBenchmark)
+{
+	BenchmarkSorts(__test_stream, 1000);
+	BenchmarkSorts(__test_stream, 100000);
+	BenchmarkSorts(__test_stream, 10000000);
+
+	return true;
+}
+
 TEST_SUITE(RunUnitTests,
 	APPEND_TEST(Hashing)
 	APPEND_TEST(Equals)
 	APPEND_TEST(Sorting)
+	APPEND_TEST(LargeSorting)
 	APPEND_TEST(RemoveRange)
+	APPEND_TEST(Growth)
+	APPEND_TEST(SmallArray)
+	APPEND_TEST(AppendBenchmark)
+	APPEND_TEST(SortBenchmark)
 );
 
 //OnStart(11)
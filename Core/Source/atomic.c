@@ -1,21 +1,21 @@
 #include "core/atomic.h"
-#include "stdatomic.h"
-#include <vcruntime_c11_stdatomic.h>
+#include <stdatomic.h>
 
-int TryLock(locker*);
-void Release(locker*);
+static int TryLock(locker*);
+static void Release(locker*);
 
 struct _atomicMethods Atomics = {
 	.TryLock = TryLock,
 	.Release = Release
 };
 
-static inline int TryLock(locker* lock)
+// returns true while another thread holds the lock
+static int TryLock(locker* lock)
 {
-	return atomic_flag_test_and_set(lock);
+	return atomic_exchange_explicit(&lock->_Val, 1, memory_order_acquire);
 }
 
-static inline void Release(locker* lock)
+static void Release(locker* lock)
 {
-	atomic_flag_clear(lock);
-}
\ No newline at end of file
+	atomic_store_explicit(&lock->_Val, 0, memory_order_release);
+}
@@ -0,0 +1,464 @@
+#include "core/atoms.h"
+#include "core/memory.h"
+#include "core/hashing.h"
+#include "core/atomic.h"
+#include "core/tasks.h"
+#include "core/cunit.h"
+#include <string.h>
+
+private atom Intern(const char* bytes, ulong length);
+private atom InternString(const string value);
+private atom InternCString(const char* cString);
+private bool TryFind(const char* bytes, ulong length, atom* out_atom);
+private string String(atom);
+private const char* CString(atom);
+private bool Equals(atom left, atom right);
+private ulong Count(void);
+private void RunUnitTests();
+
+const struct _atomMethods Atoms = {
+	.Intern = Intern,
+	.InternString = InternString,
+	.InternCString = InternCString,
+	.TryFind = TryFind,
+	.String = String,
+	.CString = CString,
+	.Equals = Equals,
+	.Count = Count,
+	.RunUnitTests = RunUnitTests
+};
+
+// strings are looked up in one of several independent tables picked by their hash so threads
+// interning different strings rarely wait on each other
+#define ATOMS_SHARD_COUNT 16
+#define ATOMS_SHARD_BITS 4
+#define ATOMS_MINIMUM_CAPACITY 64
+// interned strings are copied into arenas of this size, larger strings get an arena of their own
+#define ATOMS_ARENA_SIZE (64 * 1024)
+// atoms are stored in pages that are never moved so reading an atom never needs a lock
+#define ATOMS_PAGE_SIZE 1024
+#define ATOMS_PAGE_COUNT (ATOMS_MAX_COUNT / ATOMS_PAGE_SIZE)
+
+struct _atomShard {
+	locker Lock;
+	// open addressed table of atom ids, 0 marks an empty slot
+	uint* Slots;
+	ulong Capacity;
+	ulong Count;
+	// the arena strings are currently copied into, full arenas are kept alive by the strings in them
+	Arena Strings;
+};
+
+static struct _atomShard GLOBAL_Shards[ATOMS_SHARD_COUNT];
+
+// the interned string of every atom by id
+static string* volatile GLOBAL_Pages[ATOMS_PAGE_COUNT];
+
+// the id of the last atom that was created
+static volatile long GLOBAL_LastId = 0;
+
+DEFINE_TYPE_ID(Atom);
+
+private string EntryAt(uint id)
+{
+	return GLOBAL_Pages[id / ATOMS_PAGE_SIZE][id % ATOMS_PAGE_SIZE];
+}
+
+private struct _atomShard* ShardFor(ulong hash)
+{
+	// the low bits pick the slot within the shard
+	return &GLOBAL_Shards[hash >> (64 - ATOMS_SHARD_BITS)];
+}
+
+private bool EntryEquals(string entry, const char* bytes, ulong length, ulong hash)
+{
+	return entry->Hash is hash and entry->Count is length and memcmp(entry->Values, bytes, length) is 0;
+}
+
+// returns the slot that contains the string, or the empty slot it would be stored in
+private ulong FindSlot(struct _atomShard* shard, const char* bytes, ulong length, ulong hash)
+{
+	const ulong mask = shard->Capacity - 1;
+
+	ulong index = hash & mask;
+
+	while (shard->Slots[index] isnt 0)
+	{
+		if (EntryEquals(EntryAt(shard->Slots[index]), bytes, length, hash))
+		{
+			break;
+		}
+
+		index = (index + 1) & mask;
+	}
+
+	return index;
+}
+
+private void GrowShard(struct _atomShard* shard)
+{
+	uint* previous = shard->Slots;
+	const ulong previousCapacity = shard->Capacity;
+
+	shard->Capacity = max(previousCapacity << 1, ATOMS_MINIMUM_CAPACITY);
+	shard->Slots = Memory.Alloc(sizeof(uint) * shard->Capacity, AtomTypeId);
+
+	const ulong mask = shard->Capacity - 1;
+
+	for (ulong i = 0; i < previousCapacity; i++)
+	{
+		const uint id = previous[i];
+
+		if (id isnt 0)
+		{
+			ulong index = EntryAt(id)->Hash & mask;
+
+			while (shard->Slots[index] isnt 0)
+			{
+				index = (index + 1) & mask;
+			}
+
+			shard->Slots[index] = id;
+		}
+	}
+
+	if (previous isnt null)
+	{
+		Memory.Free(previous, AtomTypeId);
+	}
+}
+
+// copies the string into the shard's arena behind a string header that never moves
+private string CopyString(struct _atomShard* shard, const char* bytes, ulong length, ulong hash)
+{
+	const ulong size = sizeof(struct _array_byte) + length + 1;
+
+	Arena arena = shard->Strings;
+
+	if (arena is null or (arena->Size - arena->Offset) < size + sizeof(void*))
+	{
+		// the old arena is never disposed, the strings within it are still in use
+		arena = shard->Strings = Memory.Arena.Create(max(ATOMS_ARENA_SIZE, size + sizeof(void*)), AtomTypeId);
+	}
+
+	string entry = Memory.Arena.Alloc(arena, size);
+	byte* values = (byte*)(entry + 1);
+
+	memcpy(values, bytes, length);
+	values[length] = 0;
+
+	// interned strings are read only, marking them as stack objects makes disposing them throw
+	// and the hash of their bytes is already known
+	*entry = (struct _array_byte){
+		.Values = values,
+		.Size = length + 1,
+		.ElementSize = sizeof(byte),
+		.Capacity = length,
+		.Count = length,
+		.TypeId = 0,
+		.StackObject = true,
+		.Dirty = false,
+		.Hash = hash,
+		.AutoHash = false
+	};
+
+	return entry;
+}
+
+private uint CreateId(string entry)
+{
+	const long id = _InterlockedIncrement(&GLOBAL_LastId);
+
+	if (id >= ATOMS_MAX_COUNT)
+	{
+		throw(OutOfMemoryException);
+	}
+
+	const ulong page = (ulong)id / ATOMS_PAGE_SIZE;
+
+	// the first atom of a page creates it, every shard can be creating atoms at once so the page is published
+	// with a compare exchange and the loser frees its copy
+	if (GLOBAL_Pages[page] is null)
+	{
+		string* entries = Memory.Alloc(sizeof(string) * ATOMS_PAGE_SIZE, AtomTypeId);
+
+		if (_InterlockedCompareExchangePointer((void* volatile*)&GLOBAL_Pages[page], entries, null) isnt null)
+		{
+			Memory.Free(entries, AtomTypeId);
+		}
+	}
+
+	GLOBAL_Pages[page][id % ATOMS_PAGE_SIZE] = entry;
+
+	return (uint)id;
+}
+
+private uint InternLocked(struct _atomShard* shard, const char* bytes, ulong length, ulong hash)
+{
+	// keep the table at most half full
+	if ((shard->Count + 1) * 2 > shard->Capacity)
+	{
+		GrowShard(shard);
+	}
+
+	const ulong slot = FindSlot(shard, bytes, length, hash);
+
+	if (shard->Slots[slot] is 0)
+	{
+		shard->Slots[slot] = CreateId(CopyString(shard, bytes, length, hash));
+		++(shard->Count);
+	}
+
+	return shard->Slots[slot];
+}
+
+private uint FindLocked(struct _atomShard* shard, const char* bytes, ulong length, ulong hash)
+{
+	if (shard->Capacity is 0)
+	{
+		return 0;
+	}
+
+	return shard->Slots[FindSlot(shard, bytes, length, hash)];
+}
+
+private atom Intern(const char* bytes, ulong length)
+{
+	if (bytes is null)
+	{
+		return EmptyAtom;
+	}
+
+	if (length > UINT_MAX)
+	{
+		throw(InvalidArgumentException);
+	}
+
+	REGISTER_TYPE(Atom);
+
+	const ulong hash = Hashing.HashSafe(bytes, length);
+
+	struct _atomShard* shard = ShardFor(hash);
+
+	uint id;
+
+	lock(shard->Lock,
+		id = InternLocked(shard, bytes, length, hash);
+	);
+
+	return (atom) { .Id = id, .Length = (uint)length, .Hash = hash };
+}
+
+private atom InternString(const string value)
+{
+	if (value is null)
+	{
+		return EmptyAtom;
+	}
+
+	return Intern((const char*)value->Values, value->Count);
+}
+
+private atom InternCString(const char* cString)
+{
+	if (cString is null)
+	{
+		return EmptyAtom;
+	}
+
+	return Intern(cString, strlen(cString));
+}
+
+private bool TryFind(const char* bytes, ulong length, atom* out_atom)
+{
+	*out_atom = EmptyAtom;
+
+	if (bytes is null)
+	{
+		return false;
+	}
+
+	const ulong hash = Hashing.HashSafe(bytes, length);
+
+	struct _atomShard* shard = ShardFor(hash);
+
+	uint id;
+
+	lock(shard->Lock,
+		id = FindLocked(shard, bytes, length, hash);
+	);
+
+	if (id is 0)
+	{
+		return false;
+	}
+
+	*out_atom = (atom){ .Id = id, .Length = (uint)length, .Hash = hash };
+
+	return true;
+}
+
+private string String(atom value)
+{
+	if (value.Id is 0 or value.Id > (uint)GLOBAL_LastId)
+	{
+		return null;
+	}
+
+	return EntryAt(value.Id);
+}
+
+private const char* CString(atom value)
+{
+	string entry = String(value);
+
+	return entry is null ? "" : (const char*)entry->Values;
+}
+
+private bool Equals(atom left, atom right)
+{
+	return atom_equals(left, right);
+}
+
+private ulong Count(void)
+{
+	return (ulong)GLOBAL_LastId;
+}
+
+TEST(Intern)
+{
+	const ulong count = Count();
+
+	const atom first = InternCString("assets/shaders/default.vertex");
+
+	string copy = dynamic_string("assets/shaders/default.vertex");
+
+	const atom second = InternString(copy);
+
+	// a different copy of the same string interns to the same atom
+	IsTrue(Equals(first, second));
+	IsEqual(first.Hash, second.Hash);
+	const ulong expectedCount = count + 1;
+	IsEqual(expectedCount, Count());
+	IsEqual(first.Hash, Hashing.HashSafe("assets/shaders/default.vertex", first.Length));
+
+	strings.Dispose(copy);
+
+	const atom other = InternCString("assets/shaders/default.fragment");
+
+	IsFalse(Equals(first, other));
+
+	// the interned string outlives the string it was interned from
+	IsTrue(strcmp(CString(first), "assets/shaders/default.vertex") is 0);
+
+	string interned = String(first);
+
+	IsEqual((ulong)first.Length, interned->Count);
+	IsEqual(first.Hash, strings.Hash(interned));
+
+	atom found;
+	IsTrue(TryFind("assets/shaders/default.fragment", strlen("assets/shaders/default.fragment"), &found));
+	IsTrue(Equals(other, found));
+	IsFalse(TryFind("assets/shaders/missing", strlen("assets/shaders/missing"), &found));
+	IsTrue(Equals(EmptyAtom, found));
+
+	IsTrue(strcmp(CString(EmptyAtom), "") is 0);
+
+	// the empty string is a string, not the empty atom
+	const atom empty = Intern("", 0);
+	IsFalse(Equals(EmptyAtom, empty));
+
+	return true;
+}
+
+TEST(ManyAtoms)
+{
+	char name[64];
+
+	for (int i = 0; i < 10000; i++)
+	{
+		const int length = sprintf_s(name, sizeof(name), "uniform_%i", i);
+		Intern(name, length);
+	}
+
+	ulong missing = 0;
+	for (int i = 0; i < 10000; i += 7)
+	{
+		const int length = sprintf_s(name, sizeof(name), "uniform_%i", i);
+
+		atom found;
+		if (TryFind(name, length, &found) is false or strcmp(CString(found), name) isnt 0)
+		{
+			++missing;
+		}
+	}
+
+	IsZero(missing);
+
+	return true;
+}
+
+#define CONCURRENT_TASK_COUNT 4
+#define CONCURRENT_ATOM_COUNT 5000
+
+static atom GLOBAL_ConcurrentAtoms[CONCURRENT_TASK_COUNT][CONCURRENT_ATOM_COUNT];
+
+private int InternConcurrently(void* state)
+{
+	atom* atoms = state;
+
+	const int task = (int)((atoms - GLOBAL_ConcurrentAtoms[0]) / CONCURRENT_ATOM_COUNT);
+
+	char name[64];
+
+	// every task interns the same strings in a different order
+	for (int i = 0; i < CONCURRENT_ATOM_COUNT; i++)
+	{
+		const int index = (i * 7919 + task) % CONCURRENT_ATOM_COUNT;
+		const int length = sprintf_s(name, sizeof(name), "material_%i", index);
+
+		atoms[index] = Intern(name, length);
+	}
+
+	return 0;
+}
+
+TEST(ConcurrentIntern)
+{
+	array(Task) tasks = arrays(Task).Create(CONCURRENT_TASK_COUNT);
+
+	for (int i = 0; i < CONCURRENT_TASK_COUNT; i++)
+	{
+		arrays(Task).Append(tasks, Tasks.Run(Tasks.Create(InternConcurrently), GLOBAL_ConcurrentAtoms[i]));
+	}
+
+	const WaitStatus signaled = WaitStatuses.Signaled;
+	IsEqual(signaled, Tasks.WaitAll(tasks, Tasks.Forever));
+
+	// every task has to have gotten the same atom for the same string
+	ulong mismatches = 0;
+	for (int task = 1; task < CONCURRENT_TASK_COUNT; task++)
+	{
+		for (int i = 0; i < CONCURRENT_ATOM_COUNT; i++)
+		{
+			mismatches += Equals(GLOBAL_ConcurrentAtoms[0][i], GLOBAL_ConcurrentAtoms[task][i]) ? 0 : 1;
+		}
+	}
+
+	IsZero(mismatches);
+
+	for (int i = 0; i < CONCURRENT_TASK_COUNT; i++)
+	{
+		Tasks.Dispose(at(tasks, i));
+	}
+
+	arrays(Task).Dispose(tasks);
+
+	return true;
+}
+
+TEST_SUITE(RunUnitTests,
+	APPEND_TEST(Intern)
+	APPEND_TEST(ManyAtoms)
+	APPEND_TEST(ConcurrentIntern)
+);
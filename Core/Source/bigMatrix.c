@@ -1,5 +1,3 @@
-#pragma once
-
 #include "core/math/bigMatrix.h"
 
 private BigMatrix Create(ulong rows, ulong columns);
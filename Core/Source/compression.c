@@ -0,0 +1,411 @@
+#include "core/compression.h"
+#include "core/memory.h"
+#include "core/cunit.h"
+#include <string.h>
+
+private ulong Compress(const byte* source, ulong size, byte* destination, ulong destinationSize);
+private bool TryDecompress(const byte* source, ulong size, byte* destination, ulong destinationSize, ulong* out_size);
+private void RunUnitTests();
+
+const struct _compressionMethods Compression = {
+	.Compress = Compress,
+	.TryDecompress = TryDecompress,
+	.RunUnitTests = RunUnitTests
+};
+
+// the shortest match the format can store
+#define MIN_MATCH 4
+// the format requires the last bytes of a block to always be literals
+#define LAST_LITERALS 5
+// matches can't start within this many bytes of the end of the block
+#define MATCH_FIND_LIMIT 12
+// offsets are stored in two bytes
+#define MAX_OFFSET 65535
+#define HASH_BITS 12
+// how quickly the search skips ahead through bytes that don't compress
+#define SKIP_STRENGTH 6
+
+#define RUN_MASK 15
+
+private uint Read32(const byte* bytes)
+{
+	uint value;
+	memcpy(&value, bytes, sizeof(uint));
+	return value;
+}
+
+private uint HashPosition(const byte* bytes)
+{
+	return (Read32(bytes) * 2654435761u) >> (32 - HASH_BITS);
+}
+
+// writes the part of a length that doesn't fit within the token as a run of 255s and the remainder
+private byte* WriteLength(byte* output, ulong length)
+{
+	while (length >= 255)
+	{
+		*output++ = 255;
+		length -= 255;
+	}
+
+	*output++ = (byte)length;
+
+	return output;
+}
+
+private byte* WriteSequence(byte* output, const byte* literals, ulong literalCount, ulong offset, ulong matchLength)
+{
+	byte* token = output++;
+
+	const ulong extraMatch = matchLength - MIN_MATCH;
+
+	*token = (byte)((min(literalCount, RUN_MASK) << 4) | min(extraMatch, RUN_MASK));
+
+	if (literalCount >= RUN_MASK)
+	{
+		output = WriteLength(output, literalCount - RUN_MASK);
+	}
+
+	memcpy(output, literals, literalCount);
+	output += literalCount;
+
+	*output++ = (byte)(offset & 0xFF);
+	*output++ = (byte)(offset >> 8);
+
+	if (extraMatch >= RUN_MASK)
+	{
+		output = WriteLength(output, extraMatch - RUN_MASK);
+	}
+
+	return output;
+}
+
+private ulong Compress(const byte* source, ulong size, byte* destination, ulong destinationSize)
+{
+	if (destinationSize < COMPRESSION_BOUND(size))
+	{
+		return 0;
+	}
+
+	byte* output = destination;
+
+	ulong anchor = 0;
+
+	if (size > MATCH_FIND_LIMIT)
+	{
+		// positions of the last time each hash of four bytes was seen
+		uint table[1 << HASH_BITS] = { 0 };
+
+		const ulong limit = size - MATCH_FIND_LIMIT;
+		const ulong matchLimit = size - LAST_LITERALS;
+
+		ulong position = 1;
+
+		while (position < limit)
+		{
+			const uint hash = HashPosition(source + position);
+
+			ulong candidate = table[hash];
+			table[hash] = (uint)position;
+
+			if (position - candidate > MAX_OFFSET or Read32(source + candidate) isnt Read32(source + position))
+			{
+				position += 1 + ((position - anchor) >> SKIP_STRENGTH);
+				continue;
+			}
+
+			// the match may start before the bytes that were hashed
+			while (position > anchor and candidate > 0 and source[position - 1] is source[candidate - 1])
+			{
+				--position;
+				--candidate;
+			}
+
+			ulong matchEnd = position + MIN_MATCH;
+
+			while (matchEnd < matchLimit and source[matchEnd] is source[candidate + (matchEnd - position)])
+			{
+				++matchEnd;
+			}
+
+			output = WriteSequence(output, source + anchor, position - anchor, position - candidate, matchEnd - position);
+
+			position = anchor = matchEnd;
+
+			if (position < limit)
+			{
+				table[HashPosition(source + position - 2)] = (uint)(position - 2);
+			}
+		}
+	}
+
+	// everything after the last match is stored as literals without a match
+	const ulong literalCount = size - anchor;
+
+	*output++ = (byte)(min(literalCount, RUN_MASK) << 4);
+
+	if (literalCount >= RUN_MASK)
+	{
+		output = WriteLength(output, literalCount - RUN_MASK);
+	}
+
+	memcpy(output, source + anchor, literalCount);
+	output += literalCount;
+
+	return output - destination;
+}
+
+// reads the part of a length that didn't fit within the token
+private bool TryReadLength(const byte* source, ulong size, ulong* position, ulong* length)
+{
+	byte value;
+	do
+	{
+		if (*position >= size)
+		{
+			return false;
+		}
+
+		value = source[(*position)++];
+		*length += value;
+	} while (value is 255);
+
+	return true;
+}
+
+private bool TryDecompress(const byte* source, ulong size, byte* destination, ulong destinationSize, ulong* out_size)
+{
+	*out_size = 0;
+
+	ulong input = 0;
+	ulong output = 0;
+
+	while (input < size)
+	{
+		const byte token = source[input++];
+
+		ulong literalCount = token >> 4;
+
+		if (literalCount is RUN_MASK and TryReadLength(source, size, &input, &literalCount) is false)
+		{
+			return false;
+		}
+
+		if (literalCount > size - input or literalCount > destinationSize - output)
+		{
+			return false;
+		}
+
+		memcpy(destination + output, source + input, literalCount);
+
+		input += literalCount;
+		output += literalCount;
+
+		// the last sequence has no match
+		if (input is size)
+		{
+			break;
+		}
+
+		if (size - input < 2)
+		{
+			return false;
+		}
+
+		const ulong offset = source[input] | ((ulong)source[input + 1] << 8);
+		input += 2;
+
+		if (offset is 0 or offset > output)
+		{
+			return false;
+		}
+
+		ulong matchLength = token & RUN_MASK;
+
+		if (matchLength is RUN_MASK and TryReadLength(source, size, &input, &matchLength) is false)
+		{
+			return false;
+		}
+
+		matchLength += MIN_MATCH;
+
+		if (matchLength > destinationSize - output)
+		{
+			return false;
+		}
+
+		const byte* match = destination + output - offset;
+
+		if (offset >= matchLength)
+		{
+			memcpy(destination + output, match, matchLength);
+		}
+		else
+		{
+			// the match overlaps the bytes it's writing, repeating the last offset bytes
+			for (ulong i = 0; i < matchLength; i++)
+			{
+				destination[output + i] = match[i];
+			}
+		}
+
+		output += matchLength;
+	}
+
+	*out_size = output;
+
+	return true;
+}
+
+private bool RoundTrips(const byte* data, ulong size, ulong* out_compressedSize)
+{
+	const ulong bound = COMPRESSION_BOUND(size);
+
+	byte* compressed = Memory.Alloc(bound, Memory.GenericMemoryBlock);
+	byte* decompressed = Memory.Alloc(size + 1, Memory.GenericMemoryBlock);
+
+	const ulong compressedSize = Compress(data, size, compressed, bound);
+
+	ulong decompressedSize;
+	bool result = TryDecompress(compressed, compressedSize, decompressed, size, &decompressedSize);
+
+	result = result and decompressedSize is size and memcmp(data, decompressed, size) is 0;
+
+	*out_compressedSize = compressedSize;
+
+	Memory.Free(compressed, Memory.GenericMemoryBlock);
+	Memory.Free(decompressed, Memory.GenericMemoryBlock);
+
+	return result;
+}
+
+// text that looks like the material and config files that are packed
+private void FillWithConfigText(byte* data, ulong size)
+{
+	const char* lines[] = {
+		"# the shader used to render the material\n",
+		"shader: assets/shaders/default.shader\n",
+		"color: 1.000000 1.000000 1.000000 1.000000\n",
+		"texture: assets/textures/marble.png\n",
+		"specular: 0.500000\n"
+	};
+
+	ulong written = 0;
+	for (ulong i = 0; written < size; i++)
+	{
+		const char* line = lines[(i * 7) % (sizeof(lines) / sizeof(char*))];
+		const ulong length = min(strlen(line), size - written);
+
+		memcpy(data + written, line, length);
+		written += length;
+	}
+}
+
+TEST(RoundTrip)
+{
+	const ulong sizes[] = { 0, 1, 5, 12, 13, 100, 4096, 70000, 300000 };
+
+	const ulong maxSize = 300000;
+
+	byte* data = Memory.Alloc(maxSize, Memory.GenericMemoryBlock);
+
+	ulong failures = 0;
+	ulong compressedSize;
+
+	for (ulong i = 0; i < sizeof(sizes) / sizeof(ulong); i++)
+	{
+		// incompressible
+		uint state = 0x9E3779B9u;
+		for (ulong j = 0; j < sizes[i]; j++)
+		{
+			state ^= state << 13;
+			state ^= state >> 17;
+			state ^= state << 5;
+			data[j] = (byte)state;
+		}
+
+		failures += RoundTrips(data, sizes[i], &compressedSize) ? 0 : 1;
+
+		// long runs produce matches that overlap themselves
+		memset(data, 'a', sizes[i]);
+		failures += RoundTrips(data, sizes[i], &compressedSize) ? 0 : 1;
+
+		FillWithConfigText(data, sizes[i]);
+		failures += RoundTrips(data, sizes[i], &compressedSize) ? 0 : 1;
+	}
+
+	IsZero(failures);
+
+	// config text compresses well
+	IsTrue(compressedSize < maxSize / 4);
+
+	Memory.Free(data, Memory.GenericMemoryBlock);
+
+	return true;
+}
+
+TEST(CorruptBlocksFail)
+{
+	byte data[1024];
+	FillWithConfigText(data, sizeof(data));
+
+	byte compressed[COMPRESSION_BOUND(1024)];
+	const ulong compressedSize = Compress(data, sizeof(data), compressed, sizeof(compressed));
+
+	byte decompressed[1024];
+	ulong size;
+
+	// too small of a destination
+	IsFalse(TryDecompress(compressed, compressedSize, decompressed, sizeof(decompressed) - 1, &size));
+
+	// truncated, a block cut at the end of a sequence is still valid but can't produce every byte
+	const bool truncatedDecompressed = TryDecompress(compressed, compressedSize / 2, decompressed, sizeof(decompressed), &size) and size is sizeof(decompressed);
+	IsFalse(truncatedDecompressed);
+
+	// an offset that points before the start of the output
+	const byte badOffset[] = { 0x10, 'a', 0xFF, 0x00 };
+	IsFalse(TryDecompress(badOffset, sizeof(badOffset), decompressed, sizeof(decompressed), &size));
+
+	// destination too small for compress
+	IsZero(Compress(data, sizeof(data), compressed, 16));
+
+	return true;
+}
+
+TEST(Benchmark)
+{
+	const ulong size = 16 * 1024 * 1024;
+
+	byte* data = Memory.Alloc(size, Memory.GenericMemoryBlock);
+	byte* compressed = Memory.Alloc(COMPRESSION_BOUND(size), Memory.GenericMemoryBlock);
+	byte* decompressed = Memory.Alloc(size, Memory.GenericMemoryBlock);
+
+	FillWithConfigText(data, size);
+
+	ulong compressedSize = 0;
+
+	fprintf(__test_stream, "\tCompress (%lli MB of config text)"NEWLINE, size / (1024 * 1024));
+	Benchmark(compressedSize = Compress(data, size, compressed, COMPRESSION_BOUND(size)), __test_stream);
+
+	fprintf(__test_stream, "\tcompressed to %lli bytes"NEWLINE, compressedSize);
+
+	ulong decompressedSize = 0;
+
+	fprintf(__test_stream, "\tDecompress (%lli MB of config text)"NEWLINE, size / (1024 * 1024));
+	Benchmark(TryDecompress(compressed, compressedSize, decompressed, size, &decompressedSize), __test_stream);
+
+	IsEqual(size, decompressedSize);
+	IsTrue(memcmp(data, decompressed, size) is 0);
+
+	Memory.Free(data, Memory.GenericMemoryBlock);
+	Memory.Free(compressed, Memory.GenericMemoryBlock);
+	Memory.Free(decompressed, Memory.GenericMemoryBlock);
+
+	return true;
+}
+
+TEST_SUITE(RunUnitTests,
+	APPEND_TEST(RoundTrip)
+	APPEND_TEST(CorruptBlocksFail)
+	APPEND_TEST(Benchmark)
+);
@@ -2,6 +2,14 @@
 #include "core/file.h"
 #include "string.h"
 #include "core/strings.h"
+#include "core/hashing.h"
+#include "core/atomic.h"
+#include "core/packs.h"
+#include "core/memory.h"
+#include "core/parsing.h"
+#include "core/math/vectors.h"
+#include "core/math/floats.h"
+#include "core/cunit.h"
 #include <stdlib.h>
 #include <ctype.h>
 
@@ -9,118 +17,551 @@
 
 static bool TryLoadConfig(const string path, const ConfigDefinition, void* state);
 static bool TryLoadConfigStream(File stream, const ConfigDefinition, void* state);
+static bool TryLoadConfigBuffer(const char* buffer, ulong length, const ConfigDefinition, void* state);
 static void SaveConfigStream(File stream, const ConfigDefinition config, void* state);
 static void SaveConfig(const string path, const ConfigDefinition config, void* state);
+static void Write(string blob, const void* values, ulong size);
+static void WriteString(string blob, const char* value, ulong length);
+static bool TryRead(ConfigReader* reader, void* destination, ulong size);
+static bool TryReadString(ConfigReader* reader, const char** out_value, ulong* out_length);
+static void RunUnitTests();
 
 const struct _configMethods Configs = {
 	.TryLoadConfig = &TryLoadConfig,
 	.TryLoadConfigStream = &TryLoadConfigStream,
+	.TryLoadConfigBuffer = &TryLoadConfigBuffer,
 	.SaveConfig = SaveConfig,
-	.SaveConfigStream = SaveConfigStream
+	.SaveConfigStream = SaveConfigStream,
+	.Write = Write,
+	.WriteString = WriteString,
+	.TryRead = TryRead,
+	.TryReadString = TryReadString,
+	.RunUnitTests = RunUnitTests
 };
 
-static bool TryLoadConfigStream(File stream, const ConfigDefinition config, void* state)
+// the most config definitions that can be loaded, each one gets a token table the first time it's loaded
+#define MAX_CONFIG_DEFINITIONS 64
+// the number of slots within a token table, must be a power of two and at least twice the tokens of any definition
+#define TOKEN_TABLE_SIZE 64
+#define EMPTY_TOKEN_SLOT -1
+// the slot of the abort token, which isn't within the definition's tokens
+#define ABORT_TOKEN_INDEX -2
+
+// the tokens of a definition hashed so each line is dispatched with a single lookup instead
+// of comparing it against every token
+struct _tokenTable {
+	ConfigDefinition Definition;
+	ulong Hashes[TOKEN_TABLE_SIZE];
+	// the index of the token within the definition, or EMPTY_TOKEN_SLOT
+	int Indices[TOKEN_TABLE_SIZE];
+};
+
+static struct _tokenTable GLOBAL_TokenTables[MAX_CONFIG_DEFINITIONS];
+// tables are fully built before the count is incremented so they can be read without the lock
+static volatile long GLOBAL_TokenTableCount = 0;
+static locker GLOBAL_TokenTableLock;
+
+static ulong HashToken(const char* token, ulong length)
 {
-	string buffer = empty_stack_array(byte, BUFFER_SIZE);
+	return Hashing.HashSafe(token, length);
+}
 
-	ulong bufferLength = BUFFER_SIZE;
+static void InsertToken(struct _tokenTable* table, const char* token, ulong length, int index)
+{
+	const ulong hash = HashToken(token, length);
 
-	ulong lineLength;
-	while (buffer->Count = 0, Files.TryReadLine(stream, buffer, 0, &lineLength))
+	ulong slot = hash & (TOKEN_TABLE_SIZE - 1);
+
+	while (table->Indices[slot] isnt EMPTY_TOKEN_SLOT)
 	{
-		if (buffer->Count is 0)
-		{
-			continue;
-		}
+		slot = (slot + 1) & (TOKEN_TABLE_SIZE - 1);
+	}
+
+	table->Hashes[slot] = hash;
+	table->Indices[slot] = index;
+}
 
-		// ignore comments
-		if (at(buffer, 0) is config->CommentCharacter)
+static struct _tokenTable* FindTable(ConfigDefinition config, long count)
+{
+	for (long i = 0; i < count; i++)
+	{
+		if (GLOBAL_TokenTables[i].Definition is config)
 		{
-			continue;
+			return &GLOBAL_TokenTables[i];
 		}
+	}
+
+	return null;
+}
+
+static struct _tokenTable* BuildTableLocked(ConfigDefinition config)
+{
+	// another thread may have built it while this one waited for the lock
+	struct _tokenTable* table = FindTable(config, GLOBAL_TokenTableCount);
+
+	if (table isnt null)
+	{
+		return table;
+	}
+
+	if (GLOBAL_TokenTableCount >= MAX_CONFIG_DEFINITIONS or config->Count >= TOKEN_TABLE_SIZE / 2)
+	{
+		throw(IndexOutOfRangeException);
+	}
+
+	table = &GLOBAL_TokenTables[GLOBAL_TokenTableCount];
 
-		if (config->AbortToken.Token isnt null)
+	table->Definition = config;
+
+	for (ulong i = 0; i < TOKEN_TABLE_SIZE; i++)
+	{
+		table->Indices[i] = EMPTY_TOKEN_SLOT;
+	}
+
+	// token lengths include the nul terminator
+	for (ulong i = 0; i < config->Count; i++)
+	{
+		const struct _configToken* token = &config->Tokens[i];
+
+		InsertToken(table, token->Token, safe_subtract(token->Length, 1), (int)i);
+	}
+
+	if (config->AbortToken.Token isnt null)
+	{
+		InsertToken(table, config->AbortToken.Token, safe_subtract(config->AbortToken.Length, 1), ABORT_TOKEN_INDEX);
+	}
+
+	_InterlockedIncrement(&GLOBAL_TokenTableCount);
+
+	return table;
+}
+
+static struct _tokenTable* GetTable(ConfigDefinition config)
+{
+	struct _tokenTable* table = FindTable(config, GLOBAL_TokenTableCount);
+
+	if (table is null)
+	{
+		lock(GLOBAL_TokenTableLock,
+			table = BuildTableLocked(config);
+		);
+	}
+
+	return table;
+}
+
+// returns the index of the token within the definition, ABORT_TOKEN_INDEX, or EMPTY_TOKEN_SLOT when the line isn't a token
+static int FindToken(const struct _tokenTable* table, const char* token, ulong length)
+{
+	const ulong hash = HashToken(token, length);
+
+	ulong slot = hash & (TOKEN_TABLE_SIZE - 1);
+
+	while (table->Indices[slot] isnt EMPTY_TOKEN_SLOT)
+	{
+		const int index = table->Indices[slot];
+
+		if (table->Hashes[slot] is hash)
 		{
-			const char* token = config->AbortToken.Token;
-			const ulong tokenLength = max(config->AbortToken.Length - 1, 0);
+			const struct _configToken* candidate = index is ABORT_TOKEN_INDEX ? &table->Definition->AbortToken : &table->Definition->Tokens[index];
 
-			if (at(buffer, 0) is token[0])
+			if (safe_subtract(candidate->Length, 1) is length and memcmp(candidate->Token, token, length) is 0)
 			{
-				// compare the whole token, if the abort token was found abort
-				if (memcmp(buffer->Values, token, min(tokenLength, lineLength)) is 0)
-				{
-					break;
-				}
+				return index;
 			}
 		}
 
-		for (ulong i = 0; i < config->Count; i++)
+		slot = (slot + 1) & (TOKEN_TABLE_SIZE - 1);
+	}
+
+	return EMPTY_TOKEN_SLOT;
+}
+
+// dispatches a single line, without its newline, to the token it starts with
+static bool TryDispatchLine(const struct _tokenTable* table, const char* line, ulong length, void* state, bool* out_aborted)
+{
+	ConfigDefinition config = table->Definition;
+
+	// trailing carriage returns from files saved on windows
+	while (length > 0 and line[length - 1] is '\r')
+	{
+		--length;
+	}
+
+	// ignore empty lines and comments
+	if (length is 0 or line[0] is config->CommentCharacter)
+	{
+		return true;
+	}
+
+	const char* colon = memchr(line, ':', length);
+
+	// the abort token is the only token that's matched without a colon
+	if (colon is null)
+	{
+		*out_aborted = FindToken(table, line, length) is ABORT_TOKEN_INDEX;
+
+		// lines that aren't a token are ignored
+		return true;
+	}
+
+	// the token is every character before the colon, "specular :" is the same token as "specular:"
+	ulong tokenLength = colon - line;
+	while (tokenLength > 0 and (line[tokenLength - 1] is ' ' or line[tokenLength - 1] is '\t'))
+	{
+		--tokenLength;
+	}
+
+	const int index = FindToken(table, line, tokenLength);
+
+	if (index is ABORT_TOKEN_INDEX)
+	{
+		*out_aborted = true;
+		return true;
+	}
+
+	// lines that aren't a token are ignored
+	if (index is EMPTY_TOKEN_SLOT)
+	{
+		return true;
+	}
+
+	ulong offset = (colon - line) + 1;
+
+	// skip the whitespace between the colon and the value
+	while (offset < length and (line[offset] is ' ' or line[offset] is '\t'))
+	{
+		++offset;
+	}
+
+	return config->Tokens[index].TokenLoad(line + offset, length - offset, state);
+}
+
+static bool TryLoadConfigBuffer(const char* buffer, ulong length, const ConfigDefinition config, void* state)
+{
+	const struct _tokenTable* table = GetTable(config);
+
+	bool aborted = false;
+
+	ulong position = 0;
+	while (position < length and aborted is false)
+	{
+		const char* line = buffer + position;
+
+		const char* newline = memchr(line, '\n', length - position);
+
+		ulong lineLength = newline isnt null ? (ulong)(newline - line) : length - position;
+
+		// values are handed to the tokens as slices of the buffer, the newline after each line ends the value
+		// for the parsers that read until whitespace, the last line has no newline after it so it's copied
+		// and terminated instead
+		if (newline is null)
 		{
-			// check the first character to avoid comparing whole string
-			const struct _configToken* token = &config->Tokens[i];
+			char lastLine[BUFFER_SIZE];
 
-			const ulong tokenLength = safe_subtract(token->Length, 1);
+			lineLength = min(lineLength, BUFFER_SIZE - 1);
 
-			if (at(buffer, 0) is token->Token[0])
-			{
-				// compare the whole token, if it's valid invoke the callback
-				const int indexOfColon = Strings.IndexOf(buffer->Values, lineLength, ':');
-
-				// a colon is required
-				if (indexOfColon < 0)
-				{
-					// colon not found
-					return false;
-				}
-
-				// specularMap: should not be considered specular:
-				if (indexOfColon > (tokenLength + 1))
-				{
-					continue;
-				}
-
-				if (memcmp(buffer->Values, token->Token, min(tokenLength, lineLength)) is 0)
-				{
-					ulong offset = min(tokenLength + 1, lineLength);
-
-					array(byte) subBuffer = stack_subarray_back(byte, buffer, offset);
-
-					// check if the first character is whitespace, if it is move the subbuffer over
-					// I COULD create a more verstatile solution to this but..
-					if (isspace(at(subBuffer, 0)))
-					{
-						subBuffer = stack_subarray_back(byte, subBuffer, 1);
-					}
-
-					if (token->TokenLoad(subBuffer->Values, subBuffer->Count, state) is false)
-					{
-						return false;
-					}
-
-					// once we have found a valid token and invoked OnTokenFound, break and read next line
-					break;
-				}
-			}
+			memcpy(lastLine, line, lineLength);
+			lastLine[lineLength] = '\0';
+
+			return TryDispatchLine(table, lastLine, lineLength, state, &aborted);
 		}
+
+		if (TryDispatchLine(table, line, lineLength, state, &aborted) is false)
+		{
+			return false;
+		}
+
+		position += lineLength + 1;
 	}
 
 	return true;
 }
 
-static bool TryLoadConfig(const string path, const ConfigDefinition config, void* state)
+static bool TryLoadConfigStream(File stream, const ConfigDefinition config, void* state)
+{
+	const struct _tokenTable* table = GetTable(config);
+
+	// streams are read a line at a time so the stream is left right after the abort token for the caller
+	string buffer = empty_stack_array(byte, BUFFER_SIZE);
+
+	bool aborted = false;
+
+	ulong lineLength;
+	while (aborted is false and (buffer->Count = 0, Files.TryReadLine(stream, buffer, 0, &lineLength)))
+	{
+		if (TryDispatchLine(table, (const char*)buffer->Values, buffer->Count, state, &aborted) is false)
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+static void Write(string blob, const void* values, ulong size)
 {
+	strings.AppendCArray(blob, (const byte*)values, size);
+}
+
+// the length written for null strings
+#define NULL_STRING_LENGTH ((uint)-1)
+
+static void WriteString(string blob, const char* value, ulong length)
+{
+	const uint storedLength = value is null ? NULL_STRING_LENGTH : (uint)length;
+
+	Write(blob, &storedLength, sizeof(uint));
+
+	if (value isnt null)
+	{
+		Write(blob, value, length);
+	}
+}
+
+static bool TryRead(ConfigReader* reader, void* destination, ulong size)
+{
+	if (size > reader->Count - reader->Position)
+	{
+		return false;
+	}
+
+	memcpy(destination, reader->Values + reader->Position, size);
+
+	reader->Position += size;
+
+	return true;
+}
+
+static bool TryReadString(ConfigReader* reader, const char** out_value, ulong* out_length)
+{
+	*out_value = null;
+	*out_length = 0;
+
+	uint length;
+	if (TryRead(reader, &length, sizeof(uint)) is false)
+	{
+		return false;
+	}
+
+	if (length is NULL_STRING_LENGTH)
+	{
+		return true;
+	}
+
+	if (length > reader->Count - reader->Position)
+	{
+		return false;
+	}
+
+	*out_value = (const char*)(reader->Values + reader->Position);
+	*out_length = length;
+
+	reader->Position += length;
+
+	return true;
+}
+
+#ifdef CONFIG_CACHE
+// "CFGC" read as a little endian uint
+#define CONFIG_CACHE_MAGIC 0x43474643
+
+struct _configCacheHeader {
+	uint Magic;
+	// the definition's BinaryVersion
+	uint Version;
+	ulong PathHash;
+	// the hash of the text the cache was written from
+	ulong ContentHash;
+	// the number of bytes written by SaveBinary after the header
+	ulong Size;
+};
+
+static bool HasBinaryLayout(const ConfigDefinition config)
+{
+	return config->SaveBinary isnt null and config->TryLoadBinary isnt null;
+}
+
+static void GetCachePath(const string path, string cachePath)
+{
+	strings.AppendArray(cachePath, path);
+	strings.AppendCArray(cachePath, (const byte*)CONFIG_CACHE_EXTENSION, sizeof(CONFIG_CACHE_EXTENSION) - 1);
+}
+
+// reads the whole cache with a single read, caches that are packed are used in place
+static bool TryReadCache(const string cachePath, const byte** out_values, ulong* out_size, bool* out_allocated)
+{
+	*out_allocated = false;
+
+	PackEntry entry;
+	if (Packs.TryGetEntry(cachePath, &entry))
+	{
+		if (entry.Compressed is false)
+		{
+			*out_values = entry.Values;
+			*out_size = entry.Size;
+			return true;
+		}
+
+		byte* values = Memory.Alloc(entry.Size, Memory.GenericMemoryBlock);
+
+		if (Packs.TryReadEntry(&entry, values) is false)
+		{
+			Memory.Free(values, Memory.GenericMemoryBlock);
+			return false;
+		}
+
+		*out_values = values;
+		*out_size = entry.Size;
+		*out_allocated = true;
+
+		return true;
+	}
+
+	// opened directly, a missing cache is expected and shouldn't be reported as an error
 	File file;
-	if (Files.TryOpen(path, FileModes.ReadBinary, &file) is false)
+	fopen_s(&file, cachePath->Values, FileModes.ReadBinary);
+
+	if (file is null)
+	{
+		return false;
+	}
+
+	_fseeki64(file, 0, SEEK_END);
+	const ulong size = _ftelli64(file);
+	rewind(file);
+
+	byte* values = Memory.Alloc(max(size, 1), Memory.GenericMemoryBlock);
+
+	const bool read = fread(values, sizeof(byte), size, file) is size;
+
+	fclose(file);
+
+	if (read is false)
+	{
+		Memory.Free(values, Memory.GenericMemoryBlock);
+		return false;
+	}
+
+	*out_values = values;
+	*out_size = size;
+	*out_allocated = true;
+
+	return true;
+}
+
+static bool TryLoadCache(const string cachePath, ulong pathHash, ulong contentHash, const ConfigDefinition config, void* state)
+{
+	const byte* values;
+	ulong size;
+	bool allocated;
+
+	if (TryReadCache(cachePath, &values, &size, &allocated) is false)
 	{
 		return false;
 	}
 
-	if (TryLoadConfigStream(file, config, state) is false)
+	struct _configCacheHeader header;
+	ConfigReader reader = { .Values = values, .Count = size, .Position = 0 };
+
+	bool loaded = TryRead(&reader, &header, sizeof(header));
+
+	// the text changed, or the cache was written by a different version of the definition
+	loaded = loaded and header.Magic is CONFIG_CACHE_MAGIC and header.Version is config->BinaryVersion;
+	loaded = loaded and header.PathHash is pathHash and header.ContentHash is contentHash;
+	loaded = loaded and header.Size is size - sizeof(header);
+
+	loaded = loaded and config->TryLoadBinary(&reader, state);
+
+	if (allocated)
+	{
+		Memory.Free((byte*)values, Memory.GenericMemoryBlock);
+	}
+
+	return loaded;
+}
+
+// caches are only an optimization, failing to write one isn't an error
+static void SaveCache(const string cachePath, ulong pathHash, ulong contentHash, const ConfigDefinition config, void* state)
+{
+	string blob = strings.Create(BUFFER_SIZE);
+
+	struct _configCacheHeader header = {
+		.Magic = CONFIG_CACHE_MAGIC,
+		.Version = config->BinaryVersion,
+		.PathHash = pathHash,
+		.ContentHash = contentHash,
+		.Size = 0
+	};
+
+	Write(blob, &header, sizeof(header));
+
+	config->SaveBinary(blob, state);
+
+	header.Size = blob->Count - sizeof(header);
+	memcpy(blob->Values, &header, sizeof(header));
+
+	File file;
+	fopen_s(&file, cachePath->Values, FileModes.Create);
+
+	if (file isnt null)
+	{
+		const bool written = fwrite(blob->Values, sizeof(byte), blob->Count, file) is blob->Count;
+
+		fclose(file);
+
+		// a partial cache would only be rejected later
+		if (written is false)
+		{
+			remove(cachePath->Values);
+		}
+	}
+
+	strings.Dispose(blob);
+}
+#endif
+
+static bool TryLoadConfig(const string path, const ConfigDefinition config, void* state)
+{
+	string view;
+	if (Files.TryMap(path, &view) is false)
 	{
 		return false;
 	}
 
-	return Files.TryClose(file);
+#ifdef CONFIG_CACHE
+	if (HasBinaryLayout(config))
+	{
+		string cachePath = empty_stack_array(byte, _MAX_PATH);
+		GetCachePath(path, cachePath);
+
+		const ulong pathHash = Hashing.HashSafe((const char*)path->Values, path->Count);
+		const ulong contentHash = Hashing.HashSafe((const char*)view->Values, view->Count);
+
+		if (TryLoadCache(cachePath, pathHash, contentHash, config, state))
+		{
+			Files.Unmap(view);
+			return true;
+		}
+
+		const bool parsed = TryLoadConfigBuffer((const char*)view->Values, view->Count, config, state);
+
+		Files.Unmap(view);
+
+		if (parsed)
+		{
+			SaveCache(cachePath, pathHash, contentHash, config, state);
+		}
+
+		return parsed;
+	}
+#endif
+
+	const bool loaded = TryLoadConfigBuffer((const char*)view->Values, view->Count, config, state);
+
+	Files.Unmap(view);
+
+	return loaded;
 }
 
 static void SaveConfigStream(File stream, const ConfigDefinition config, void* state)
@@ -151,4 +592,520 @@ static void SaveConfig(const string path, const ConfigDefinition config, void* s
 	{
 		throw(FailedToCloseFileException);
 	}
-}
\ No newline at end of file
+}
+
+// a definition shaped like a material, each token records the value it was handed
+struct _testConfigState {
+	char Values[6][64];
+	ulong Lengths[6];
+	ulong Loaded;
+	bool Fail;
+};
+
+static bool RecordToken(struct _testConfigState* state, ulong index, const char* buffer, ulong length)
+{
+	memcpy(state->Values[index], buffer, min(length, 63));
+	state->Values[index][min(length, 63)] = '\0';
+	state->Lengths[index] = length;
+	++(state->Loaded);
+
+	return state->Fail is false;
+}
+
+TOKEN_LOAD(shaders, struct _testConfigState*) { return RecordToken(state, 0, buffer, length); }
+TOKEN_SAVE(shaders, struct _testConfigState*) { ignore_unused(stream); ignore_unused(state); }
+TOKEN_LOAD(color, struct _testConfigState*) { return RecordToken(state, 1, buffer, length); }
+TOKEN_SAVE(color, struct _testConfigState*) { ignore_unused(stream); ignore_unused(state); }
+TOKEN_LOAD(specular, struct _testConfigState*) { return RecordToken(state, 2, buffer, length); }
+TOKEN_SAVE(specular, struct _testConfigState*) { ignore_unused(stream); ignore_unused(state); }
+TOKEN_LOAD(specularMap, struct _testConfigState*) { return RecordToken(state, 3, buffer, length); }
+TOKEN_SAVE(specularMap, struct _testConfigState*) { ignore_unused(stream); ignore_unused(state); }
+TOKEN_LOAD(mainTexture, struct _testConfigState*) { return RecordToken(state, 4, buffer, length); }
+TOKEN_SAVE(mainTexture, struct _testConfigState*) { ignore_unused(stream); ignore_unused(state); }
+TOKEN_LOAD(shininess, struct _testConfigState*) { return RecordToken(state, 5, buffer, length); }
+TOKEN_SAVE(shininess, struct _testConfigState*) { ignore_unused(stream); ignore_unused(state); }
+
+TOKENS(6) {
+	TOKEN(shaders, "# the shaders"),
+	TOKEN(color, "# the color"),
+	TOKEN(specular, "# the specular color"),
+	TOKEN(specularMap, "# the specular map"),
+	TOKEN(mainTexture, "# the main texture"),
+	TOKEN(shininess, "# the shininess")
+};
+
+static const struct _configDefinition TestConfigDefinition = {
+	.Tokens = Tokens,
+	.CommentCharacter = '#',
+	.Count = sizeof(Tokens) / sizeof(struct _configToken),
+	.AbortToken = ABORT_TOKEN(transform)
+};
+
+TEST(TokensDispatch)
+{
+	const char config[] =
+		"# specular: a comment that looks like a token\n"
+		"shaders: assets/shaders/default.shader\r\n"
+		"specularMap: assets/textures/specular.png\n"
+		"specular : 0.5 0.5 0.5 1.0\n"
+		"unknown: ignored\n"
+		"\n"
+		"color:1 1 1 1\n"
+		"shininess: 32";
+
+	struct _testConfigState state = { 0 };
+
+	IsTrue(TryLoadConfigBuffer(config, sizeof(config) - 1, &TestConfigDefinition, &state));
+	IsEqual(5ull, state.Loaded);
+
+	// tokens that start with another token aren't confused with it
+	IsTrue(strcmp(state.Values[3], "assets/textures/specular.png") is 0);
+	IsTrue(strcmp(state.Values[2], "0.5 0.5 0.5 1.0") is 0);
+
+	// carriage returns aren't part of the value
+	IsTrue(strcmp(state.Values[0], "assets/shaders/default.shader") is 0);
+
+	IsTrue(strcmp(state.Values[1], "1 1 1 1") is 0);
+
+	// the last line has no newline
+	IsTrue(strcmp(state.Values[5], "32") is 0);
+	IsEqual(2ull, state.Lengths[5]);
+
+	return true;
+}
+
+TEST(AbortTokenStopsLoading)
+{
+	const char config[] =
+		"color: 1 1 1 1\n"
+		"transform:\n"
+		"shininess: 32\n";
+
+	struct _testConfigState state = { 0 };
+
+	IsTrue(TryLoadConfigBuffer(config, sizeof(config) - 1, &TestConfigDefinition, &state));
+	IsEqual(1ull, state.Loaded);
+
+	// tokens that fail stop loading
+	state = (struct _testConfigState){ .Fail = true };
+
+	IsFalse(TryLoadConfigBuffer(config, sizeof(config) - 1, &TestConfigDefinition, &state));
+
+	return true;
+}
+
+#define TEST_MATERIAL_COUNT 10000
+#define TEST_MATERIAL_PATH "config_test.material"
+#define TEST_PACK_PATH "config_test.pack"
+
+#define TEST_MATERIAL \
+	"# path array delimited by ','; the array of shaders that should be loaded for this material\n"\
+	"shaders: assets/shaders/default.shader,assets/shaders/shadow.shader\n"\
+	"# vector4; the material base color\n"\
+	"color: 1.000000 1.000000 1.000000 1.000000\n"\
+	"# vector4; the specular color\n"\
+	"specular: 0.500000 0.500000 0.500000 1.000000\n"\
+	"# path; the specular map\n"\
+	"specularMap: assets/textures/specular.png\n"\
+	"# path; the main texture\n"\
+	"mainTexture: assets/textures/marble.png\n"\
+	"# float; the shininess\n"\
+	"shininess: 32.000000\n"
+
+static ulong ParseMaterials(void)
+{
+	ulong loaded = 0;
+
+	for (ulong i = 0; i < TEST_MATERIAL_COUNT; i++)
+	{
+		struct _testConfigState state = { 0 };
+
+		loaded += TryLoadConfigBuffer(TEST_MATERIAL, sizeof(TEST_MATERIAL) - 1, &TestConfigDefinition, &state) ? state.Loaded : 0;
+	}
+
+	return loaded;
+}
+
+// loads the same material file repeatedly, like loading 10k material files that are already cached
+static ulong LoadMaterials(bool mapped)
+{
+	ulong loaded = 0;
+
+	for (ulong i = 0; i < TEST_MATERIAL_COUNT; i++)
+	{
+		struct _testConfigState state = { 0 };
+
+		bool success;
+
+		if (mapped)
+		{
+			success = TryLoadConfig(stack_string(TEST_MATERIAL_PATH), &TestConfigDefinition, &state);
+		}
+		else
+		{
+			File file = Files.Open(stack_string(TEST_MATERIAL_PATH), FileModes.ReadBinary);
+
+			success = TryLoadConfigStream(file, &TestConfigDefinition, &state);
+
+			Files.Close(file);
+		}
+
+		loaded += success ? state.Loaded : 0;
+	}
+
+	return loaded;
+}
+
+TEST(Benchmark)
+{
+	Files.WriteAll(stack_string(TEST_MATERIAL_PATH), stack_string(TEST_MATERIAL));
+
+	ulong streamed = 0;
+	ulong mapped = 0;
+
+	fprintf(__test_stream, "\tLoading %i materials, streamed a line at a time"NEWLINE, TEST_MATERIAL_COUNT);
+	Benchmark(streamed = LoadMaterials(false), __test_stream);
+
+	fprintf(__test_stream, "\tLoading %i materials, mapped"NEWLINE, TEST_MATERIAL_COUNT);
+	Benchmark(mapped = LoadMaterials(true), __test_stream);
+
+	const ulong expected = TEST_MATERIAL_COUNT * 6;
+	IsEqual(expected, streamed);
+	IsEqual(expected, mapped);
+
+	// without opening a file for every material
+	array(string) paths = stack_array(string, 1, stack_string(TEST_MATERIAL_PATH));
+
+	IsTrue(Packs.TryBuild(paths, stack_string(TEST_PACK_PATH), false));
+
+	Pack pack;
+	IsTrue(Packs.TryMount(stack_string(TEST_PACK_PATH), &pack));
+
+	fprintf(__test_stream, "\tLoading %i materials, from a pack"NEWLINE, TEST_MATERIAL_COUNT);
+	Benchmark(mapped = LoadMaterials(true), __test_stream);
+
+	Packs.Unmount(pack);
+
+	IsEqual(expected, mapped);
+
+	ulong parsed = 0;
+
+	fprintf(__test_stream, "\tParsing %i materials already in memory"NEWLINE, TEST_MATERIAL_COUNT);
+	Benchmark(parsed = ParseMaterials(), __test_stream);
+
+	IsEqual(expected, parsed);
+
+	remove(TEST_MATERIAL_PATH);
+	remove(TEST_PACK_PATH);
+
+	return true;
+}
+
+// a definition that parses its values like a material does, with a binary layout so it can be cached
+struct _testMaterial {
+	char** ShaderPaths;
+	ulong* ShaderPathLengths;
+	ulong ShaderCount;
+	vector4 Color;
+	vector4 Specular;
+	char* SpecularMap;
+	char* MainTexture;
+	float Shininess;
+	bool LoadedFromCache;
+};
+
+static bool TestMaterialShadersLoad(const char* buffer, const ulong length, struct _testMaterial* state)
+{
+	return Parsing.TryGetStrings(buffer, length, &state->ShaderPaths, &state->ShaderPathLengths, &state->ShaderCount);
+}
+
+static bool TestMaterialColorLoad(const char* buffer, const ulong length, struct _testMaterial* state)
+{
+	return Vector4s.TryDeserialize(buffer, length, &state->Color);
+}
+
+static bool TestMaterialSpecularLoad(const char* buffer, const ulong length, struct _testMaterial* state)
+{
+	return Vector4s.TryDeserialize(buffer, length, &state->Specular);
+}
+
+static bool TestMaterialSpecularMapLoad(const char* buffer, const ulong length, struct _testMaterial* state)
+{
+	return Parsing.TryGetString(buffer, length, _MAX_PATH, &state->SpecularMap);
+}
+
+static bool TestMaterialMainTextureLoad(const char* buffer, const ulong length, struct _testMaterial* state)
+{
+	return Parsing.TryGetString(buffer, length, _MAX_PATH, &state->MainTexture);
+}
+
+static bool TestMaterialShininessLoad(const char* buffer, const ulong length, struct _testMaterial* state)
+{
+	return Floats.TryDeserialize(buffer, length, &state->Shininess);
+}
+
+static const struct _configToken TestMaterialTokens[] = {
+	{ .Token = "shaders", .Length = sizeof("shaders"), .TokenLoad = &TestMaterialShadersLoad },
+	{ .Token = "color", .Length = sizeof("color"), .TokenLoad = &TestMaterialColorLoad },
+	{ .Token = "specular", .Length = sizeof("specular"), .TokenLoad = &TestMaterialSpecularLoad },
+	{ .Token = "specularMap", .Length = sizeof("specularMap"), .TokenLoad = &TestMaterialSpecularMapLoad },
+	{ .Token = "mainTexture", .Length = sizeof("mainTexture"), .TokenLoad = &TestMaterialMainTextureLoad },
+	{ .Token = "shininess", .Length = sizeof("shininess"), .TokenLoad = &TestMaterialShininessLoad }
+};
+
+static void DisposeTestMaterial(struct _testMaterial* state)
+{
+	for (ulong i = 0; i < state->ShaderCount; i++)
+	{
+		Memory.Free(state->ShaderPaths[i], Memory.String);
+	}
+
+	Memory.Free(state->ShaderPaths, Memory.String);
+	Memory.Free(state->ShaderPathLengths, Memory.GenericMemoryBlock);
+	Memory.Free(state->SpecularMap, Memory.String);
+	Memory.Free(state->MainTexture, Memory.String);
+
+	*state = (struct _testMaterial){ 0 };
+}
+
+static char* CopyString(const char* value, ulong length)
+{
+	if (value is null)
+	{
+		return null;
+	}
+
+	char* result = Memory.Alloc(length + 1, Memory.String);
+
+	memcpy(result, value, length);
+	result[length] = '\0';
+
+	return result;
+}
+
+static void SaveTestMaterialBinary(string blob, void* material)
+{
+	struct _testMaterial* state = material;
+
+	Write(blob, &state->ShaderCount, sizeof(ulong));
+
+	for (ulong i = 0; i < state->ShaderCount; i++)
+	{
+		WriteString(blob, state->ShaderPaths[i], state->ShaderPathLengths[i]);
+	}
+
+	Write(blob, &state->Color, sizeof(vector4));
+	Write(blob, &state->Specular, sizeof(vector4));
+	WriteString(blob, state->SpecularMap, state->SpecularMap ? strlen(state->SpecularMap) : 0);
+	WriteString(blob, state->MainTexture, state->MainTexture ? strlen(state->MainTexture) : 0);
+	Write(blob, &state->Shininess, sizeof(float));
+}
+
+static bool TryLoadTestMaterialBinary(ConfigReader* reader, void* material)
+{
+	struct _testMaterial* state = material;
+
+	struct _testMaterial loaded = { 0 };
+
+	bool success = TryRead(reader, &loaded.ShaderCount, sizeof(ulong));
+
+	// a corrupt count can't be larger than the blob
+	success = success and loaded.ShaderCount <= reader->Count;
+
+	if (success and loaded.ShaderCount isnt 0)
+	{
+		loaded.ShaderPaths = Memory.Alloc(sizeof(char*) * loaded.ShaderCount, Memory.String);
+		loaded.ShaderPathLengths = Memory.Alloc(sizeof(ulong) * loaded.ShaderCount, Memory.GenericMemoryBlock);
+	}
+
+	for (ulong i = 0; success and i < loaded.ShaderCount; i++)
+	{
+		const char* path;
+		success = TryReadString(reader, &path, &loaded.ShaderPathLengths[i]);
+		loaded.ShaderPaths[i] = success ? CopyString(path, loaded.ShaderPathLengths[i]) : null;
+	}
+
+	const char* specularMap = null;
+	const char* mainTexture = null;
+	ulong specularMapLength;
+	ulong mainTextureLength;
+
+	success = success and TryRead(reader, &loaded.Color, sizeof(vector4));
+	success = success and TryRead(reader, &loaded.Specular, sizeof(vector4));
+	success = success and TryReadString(reader, &specularMap, &specularMapLength);
+	success = success and TryReadString(reader, &mainTexture, &mainTextureLength);
+	success = success and TryRead(reader, &loaded.Shininess, sizeof(float));
+
+	if (success is false)
+	{
+		DisposeTestMaterial(&loaded);
+		return false;
+	}
+
+	loaded.SpecularMap = CopyString(specularMap, specularMapLength);
+	loaded.MainTexture = CopyString(mainTexture, mainTextureLength);
+	loaded.LoadedFromCache = true;
+
+	*state = loaded;
+
+	return true;
+}
+
+static const struct _configDefinition TestMaterialConfigDefinition = {
+	.Tokens = TestMaterialTokens,
+	.CommentCharacter = '#',
+	.Count = sizeof(TestMaterialTokens) / sizeof(struct _configToken),
+	.BinaryVersion = 1,
+	.SaveBinary = &SaveTestMaterialBinary,
+	.TryLoadBinary = &TryLoadTestMaterialBinary
+};
+
+private bool TestMaterialsEqual(struct _testMaterial* left, struct _testMaterial* right)
+{
+	bool equal = left->ShaderCount is right->ShaderCount;
+
+	for (ulong i = 0; equal and i < left->ShaderCount; i++)
+	{
+		equal = left->ShaderPathLengths[i] is right->ShaderPathLengths[i] and strcmp(left->ShaderPaths[i], right->ShaderPaths[i]) is 0;
+	}
+
+	equal = equal and memcmp(&left->Color, &right->Color, sizeof(vector4)) is 0;
+	equal = equal and memcmp(&left->Specular, &right->Specular, sizeof(vector4)) is 0;
+	equal = equal and strcmp(left->SpecularMap, right->SpecularMap) is 0;
+	equal = equal and strcmp(left->MainTexture, right->MainTexture) is 0;
+	equal = equal and left->Shininess is right->Shininess;
+
+	return equal;
+}
+
+#define TEST_CACHE_PATH TEST_MATERIAL_PATH CONFIG_CACHE_EXTENSION
+
+TEST(CacheMatchesText)
+{
+	remove(TEST_CACHE_PATH);
+
+	Files.WriteAll(stack_string(TEST_MATERIAL_PATH), stack_string(TEST_MATERIAL));
+
+	struct _testMaterial parsed = { 0 };
+	IsTrue(TryLoadConfig(stack_string(TEST_MATERIAL_PATH), &TestMaterialConfigDefinition, &parsed));
+	IsFalse(parsed.LoadedFromCache);
+	IsEqual(2ull, parsed.ShaderCount);
+
+	struct _testMaterial cached = { 0 };
+	IsTrue(TryLoadConfig(stack_string(TEST_MATERIAL_PATH), &TestMaterialConfigDefinition, &cached));
+
+#ifdef CONFIG_CACHE
+	IsTrue(cached.LoadedFromCache);
+#endif
+
+	IsTrue(TestMaterialsEqual(&parsed, &cached));
+
+	DisposeTestMaterial(&cached);
+
+	// the text is the source of truth, changing it invalidates the cache
+	Files.WriteAll(stack_string(TEST_MATERIAL_PATH), stack_string(TEST_MATERIAL "shininess: 8\n"));
+
+	IsTrue(TryLoadConfig(stack_string(TEST_MATERIAL_PATH), &TestMaterialConfigDefinition, &cached));
+	IsFalse(cached.LoadedFromCache);
+	IsTrue(cached.Shininess is 8.0f);
+
+	DisposeTestMaterial(&cached);
+
+	// corrupt caches are parsed from the text again
+	Files.WriteAll(stack_string(TEST_CACHE_PATH), stack_string("CFGC but not really a cache"));
+
+	IsTrue(TryLoadConfig(stack_string(TEST_MATERIAL_PATH), &TestMaterialConfigDefinition, &cached));
+	IsFalse(cached.LoadedFromCache);
+	IsTrue(cached.Shininess is 8.0f);
+
+	DisposeTestMaterial(&cached);
+	DisposeTestMaterial(&parsed);
+
+	remove(TEST_MATERIAL_PATH);
+	remove(TEST_CACHE_PATH);
+
+	return true;
+}
+
+static ulong LoadTestMaterials(void)
+{
+	ulong loaded = 0;
+
+	for (ulong i = 0; i < TEST_MATERIAL_COUNT; i++)
+	{
+		struct _testMaterial state = { 0 };
+
+		loaded += TryLoadConfig(stack_string(TEST_MATERIAL_PATH), &TestMaterialConfigDefinition, &state) ? 1 : 0;
+
+		DisposeTestMaterial(&state);
+	}
+
+	return loaded;
+}
+
+static ulong ParseTestMaterials(void)
+{
+	ulong loaded = 0;
+
+	for (ulong i = 0; i < TEST_MATERIAL_COUNT; i++)
+	{
+		struct _testMaterial state = { 0 };
+
+		loaded += TryLoadConfigBuffer(TEST_MATERIAL, sizeof(TEST_MATERIAL) - 1, &TestMaterialConfigDefinition, &state) ? 1 : 0;
+
+		DisposeTestMaterial(&state);
+	}
+
+	return loaded;
+}
+
+TEST(CacheBenchmark)
+{
+	remove(TEST_CACHE_PATH);
+
+	Files.WriteAll(stack_string(TEST_MATERIAL_PATH), stack_string(TEST_MATERIAL));
+
+	ulong loaded = 0;
+
+	fprintf(__test_stream, "\tParsing %i materials from text already in memory"NEWLINE, TEST_MATERIAL_COUNT);
+	Benchmark(loaded = ParseTestMaterials(), __test_stream);
+
+	IsEqual((ulong)TEST_MATERIAL_COUNT, loaded);
+
+#ifdef CONFIG_CACHE
+	// the first load writes the cache
+	fprintf(__test_stream, "\tLoading %i materials from their cache"NEWLINE, TEST_MATERIAL_COUNT);
+	Benchmark(loaded = LoadTestMaterials(), __test_stream);
+
+	IsEqual((ulong)TEST_MATERIAL_COUNT, loaded);
+
+	array(string) paths = stack_array(string, 2, stack_string(TEST_MATERIAL_PATH), stack_string(TEST_CACHE_PATH));
+
+	IsTrue(Packs.TryBuild(paths, stack_string(TEST_PACK_PATH), false));
+
+	Pack pack;
+	IsTrue(Packs.TryMount(stack_string(TEST_PACK_PATH), &pack));
+
+	fprintf(__test_stream, "\tLoading %i materials from their cache within a pack"NEWLINE, TEST_MATERIAL_COUNT);
+	Benchmark(loaded = LoadTestMaterials(), __test_stream);
+
+	Packs.Unmount(pack);
+
+	IsEqual((ulong)TEST_MATERIAL_COUNT, loaded);
+
+	remove(TEST_CACHE_PATH);
+	remove(TEST_PACK_PATH);
+#endif
+
+	remove(TEST_MATERIAL_PATH);
+
+	return true;
+}
+
+TEST_SUITE(RunUnitTests,
+	APPEND_TEST(TokensDispatch)
+	APPEND_TEST(AbortTokenStopsLoading)
+	APPEND_TEST(Benchmark)
+	APPEND_TEST(CacheMatchesText)
+	APPEND_TEST(CacheBenchmark)
+);
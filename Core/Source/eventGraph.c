@@ -0,0 +1,821 @@
+#include "core/eventGraph.h"
+#include "core/jobs.h"
+#include "core/memory.h"
+#include "core/cunit.h"
+#include <stdatomic.h>
+#include <string.h>
+
+private EventGraph Create(void);
+private void Reads(EventGraph, EventMethod method, const char* resource);
+private void Writes(EventGraph, EventMethod method, const char* resource);
+private void DependsOn(EventGraph, EventMethod method, EventMethod dependency);
+private void Run(EventGraph, Array* phases, ulong phaseCount);
+private void Dispose(EventGraph);
+private void RunUnitTests(void);
+
+const struct _eventGraphMethods EventGraphs = {
+	.Create = Create,
+	.Reads = Reads,
+	.Writes = Writes,
+	.DependsOn = DependsOn,
+	.Run = Run,
+	.Dispose = Dispose,
+	.RunUnitTests = RunUnitTests
+};
+
+DEFINE_TYPE_ID(EventGraph);
+
+DEFINE_ARRAY(EventMethod);
+
+typedef struct {
+	EventMethod Method;
+	const char* Resource;
+	bool Write;
+} EventAccess;
+
+DEFINE_ARRAY(EventAccess);
+
+typedef struct {
+	EventMethod Method;
+	EventMethod Dependency;
+} EventDependency;
+
+DEFINE_ARRAY(EventDependency);
+
+// a method within the built graph
+struct _eventNode {
+	EventMethod Method;
+	ulong Phase;
+	// whether the method declared any resources or dependencies, methods that didn't wait on whole phases
+	bool Declared;
+	// the method conflicts with another method in its phase, when the graph is cyclic these run on the calling thread
+	// in the order they were registered
+	bool Serial;
+	// the number of nodes this node waits on
+	int DependencyCount;
+	// the number of nodes this node still waits on this frame
+	_Atomic(int) Pending;
+	// the nodes that wait on this node, indices into the graph's dependents
+	ulong FirstDependent;
+	ulong DependentCount;
+	EventGraph Graph;
+};
+
+// the phases the graph was built from, when they change the graph is rebuilt
+struct _phaseKey {
+	Array Phase;
+	ulong Count;
+	ulong Hash;
+};
+
+struct _eventGraph {
+	array(EventAccess) Accesses;
+	array(EventDependency) Dependencies;
+	// set when a declaration changed since the graph was built
+	bool Dirty;
+	struct _phaseKey Keys[EVENT_GRAPH_MAX_PHASES];
+	ulong PhaseCount;
+	struct _eventNode* Nodes;
+	ulong NodeCount;
+	ulong* Dependents;
+	// the graph has a cycle and runs its phases one after another instead
+	bool Cyclic;
+	// the number of conflicts within the same phase that weren't ordered by a dependency when the graph was built
+	ulong RaceCount;
+	JobCounter* Counter;
+};
+
+private EventGraph Create(void)
+{
+	REGISTER_TYPE(EventGraph);
+
+	EventGraph graph = Memory.Alloc(sizeof(struct _eventGraph), EventGraphTypeId);
+
+	graph->Accesses = dynamic_array(EventAccess, 0);
+	graph->Dependencies = dynamic_array(EventDependency, 0);
+	graph->Dirty = true;
+
+	return graph;
+}
+
+private void Declare(EventGraph graph, EventMethod method, const char* resource, bool write)
+{
+	if (graph is null or method is null or resource is null)
+	{
+		fprintf_red(stderr, "Failed to declare the resource %s, the graph, method or resource was null", resource ? resource : "null");
+		throw(InvalidArgumentException);
+	}
+
+	EventAccess access = {
+		.Method = method,
+		.Resource = resource,
+		.Write = write
+	};
+
+	arrays(EventAccess).Append(graph->Accesses, access);
+
+	graph->Dirty = true;
+}
+
+private void Reads(EventGraph graph, EventMethod method, const char* resource)
+{
+	Declare(graph, method, resource, false);
+}
+
+private void Writes(EventGraph graph, EventMethod method, const char* resource)
+{
+	Declare(graph, method, resource, true);
+}
+
+private void DependsOn(EventGraph graph, EventMethod method, EventMethod dependency)
+{
+	if (graph is null or method is null or dependency is null)
+	{
+		fprintf_red(stderr, "Failed to declare dependency, the graph, method or dependency was null%s", "");
+		throw(InvalidArgumentException);
+	}
+
+	EventDependency value = {
+		.Method = method,
+		.Dependency = dependency
+	};
+
+	arrays(EventDependency).Append(graph->Dependencies, value);
+
+	graph->Dirty = true;
+}
+
+private void Dispose(EventGraph graph)
+{
+	if (graph is null)
+	{
+		return;
+	}
+
+	arrays(EventAccess).Dispose(graph->Accesses);
+	arrays(EventDependency).Dispose(graph->Dependencies);
+
+	if (graph->Nodes)
+	{
+		Memory.Free(graph->Nodes, EventGraphTypeId);
+	}
+
+	if (graph->Dependents)
+	{
+		Memory.Free(graph->Dependents, EventGraphTypeId);
+	}
+
+	Memory.Free(graph, EventGraphTypeId);
+}
+
+private bool IsDeclared(EventGraph graph, EventMethod method)
+{
+	for (ulong i = 0; i < graph->Accesses->Count; i++)
+	{
+		if (at(graph->Accesses, i).Method is method)
+		{
+			return true;
+		}
+	}
+
+	for (ulong i = 0; i < graph->Dependencies->Count; i++)
+	{
+		if (at(graph->Dependencies, i).Method is method)
+		{
+			return true;
+		}
+	}
+
+	return false;
+}
+
+// returns the resource the methods both use when at least one of them writes it, otherwise null
+private const char* FindConflict(EventGraph graph, EventMethod left, EventMethod right)
+{
+	for (ulong i = 0; i < graph->Accesses->Count; i++)
+	{
+		const EventAccess leftAccess = at(graph->Accesses, i);
+
+		if (leftAccess.Method isnt left)
+		{
+			continue;
+		}
+
+		for (ulong j = 0; j < graph->Accesses->Count; j++)
+		{
+			const EventAccess rightAccess = at(graph->Accesses, j);
+
+			if (rightAccess.Method isnt right or (leftAccess.Write or rightAccess.Write) is false)
+			{
+				continue;
+			}
+
+			if (strcmp(leftAccess.Resource, rightAccess.Resource) is 0)
+			{
+				return leftAccess.Resource;
+			}
+		}
+	}
+
+	return null;
+}
+
+// whether there's a path of edges from the node to the target, edges[from * count + to] is set when to waits on from
+private bool IsReachable(const byte* edges, ulong count, ulong from, ulong target, byte* visited)
+{
+	if (from is target)
+	{
+		return true;
+	}
+
+	visited[from] = true;
+
+	for (ulong next = 0; next < count; next++)
+	{
+		if (edges[(from * count) + next] and visited[next] is false and IsReachable(edges, count, next, target, visited))
+		{
+			return true;
+		}
+	}
+
+	return false;
+}
+
+private bool IsOrdered(const byte* edges, ulong count, ulong left, ulong right, byte* visited)
+{
+	memset(visited, 0, count);
+
+	if (IsReachable(edges, count, left, right, visited))
+	{
+		return true;
+	}
+
+	memset(visited, 0, count);
+
+	return IsReachable(edges, count, right, left, visited);
+}
+
+private void Build(EventGraph graph, Array* phases, ulong phaseCount)
+{
+	if (graph->Nodes)
+	{
+		Memory.Free(graph->Nodes, EventGraphTypeId);
+		graph->Nodes = null;
+	}
+
+	if (graph->Dependents)
+	{
+		Memory.Free(graph->Dependents, EventGraphTypeId);
+		graph->Dependents = null;
+	}
+
+	graph->NodeCount = 0;
+	graph->Cyclic = false;
+	graph->RaceCount = 0;
+
+	ulong count = 0;
+	for (ulong phase = 0; phase < phaseCount; phase++)
+	{
+		count += phases[phase]->Count;
+	}
+
+	if (count is 0)
+	{
+		return;
+	}
+
+	graph->Nodes = Memory.Alloc(sizeof(struct _eventNode) * count, EventGraphTypeId);
+	graph->NodeCount = count;
+
+	// nodes are in the order they run without a graph, by phase then by the order they were registered
+	ulong index = 0;
+	for (ulong phase = 0; phase < phaseCount; phase++)
+	{
+		for (ulong i = 0; i < phases[phase]->Count; i++)
+		{
+			struct _eventNode* node = graph->Nodes + index++;
+
+			node->Method = ((EventMethod*)phases[phase]->Values)[i];
+			node->Phase = phase;
+			node->Declared = IsDeclared(graph, node->Method);
+			node->Graph = graph;
+		}
+	}
+
+	// a frame rarely has more than a few dozen events so a matrix is smaller than it sounds
+	byte* edges = Memory.Alloc((count * count) + count, EventGraphTypeId);
+	byte* visited = edges + (count * count);
+
+	for (ulong i = 0; i < graph->Dependencies->Count; i++)
+	{
+		const EventDependency dependency = at(graph->Dependencies, i);
+
+		for (ulong from = 0; from < count; from++)
+		{
+			if (graph->Nodes[from].Method isnt dependency.Dependency)
+			{
+				continue;
+			}
+
+			for (ulong to = 0; to < count; to++)
+			{
+				if (graph->Nodes[to].Method is dependency.Method and to isnt from)
+				{
+					edges[(from * count) + to] = true;
+				}
+			}
+		}
+	}
+
+	// methods that didn't declare what they use may use anything so earlier phases finish before they start and they
+	// finish before later phases start
+	for (ulong from = 0; from < count; from++)
+	{
+		for (ulong to = from + 1; to < count; to++)
+		{
+			const struct _eventNode* left = graph->Nodes + from;
+			const struct _eventNode* right = graph->Nodes + to;
+
+			if (left->Phase < right->Phase and (left->Declared is false or right->Declared is false))
+			{
+				edges[(from * count) + to] = true;
+			}
+		}
+	}
+
+	for (ulong from = 0; from < count; from++)
+	{
+		for (ulong to = from + 1; to < count; to++)
+		{
+			const struct _eventNode* left = graph->Nodes + from;
+			const struct _eventNode* right = graph->Nodes + to;
+
+			if (left->Declared is false or right->Declared is false)
+			{
+				continue;
+			}
+
+			const char* resource = FindConflict(graph, left->Method, right->Method);
+
+			if (resource isnt null and left->Phase is right->Phase)
+			{
+				graph->Nodes[from].Serial = true;
+				graph->Nodes[to].Serial = true;
+			}
+
+			if (resource is null or IsOrdered(edges, count, from, to, visited))
+			{
+				continue;
+			}
+
+			if (left->Phase is right->Phase)
+			{
+				graph->RaceCount++;
+
+				fprintf_yellow(stderr, "Events %p and %p both use %s within the same phase without depending on each other, "
+					"they run in the order they were registered"NEWLINE, (void*)(size_t)left->Method, (void*)(size_t)right->Method, resource);
+			}
+
+			edges[(from * count) + to] = true;
+		}
+	}
+
+	ulong edgeCount = 0;
+	for (ulong from = 0; from < count; from++)
+	{
+		for (ulong to = 0; to < count; to++)
+		{
+			if (edges[(from * count) + to])
+			{
+				graph->Nodes[to].DependencyCount++;
+				graph->Nodes[from].DependentCount++;
+				edgeCount++;
+			}
+		}
+	}
+
+	graph->Dependents = Memory.Alloc(sizeof(ulong) * max(edgeCount, 1), EventGraphTypeId);
+
+	ulong dependent = 0;
+	for (ulong from = 0; from < count; from++)
+	{
+		graph->Nodes[from].FirstDependent = dependent;
+
+		for (ulong to = 0; to < count; to++)
+		{
+			if (edges[(from * count) + to])
+			{
+				graph->Dependents[dependent++] = to;
+			}
+		}
+	}
+
+	// removes nodes that wait on nothing until no nodes are left, anything left over waits on itself
+	ulong* remaining = (ulong*)Memory.Alloc(sizeof(ulong) * count, EventGraphTypeId);
+	ulong* ready = (ulong*)Memory.Alloc(sizeof(ulong) * count, EventGraphTypeId);
+	ulong readyCount = 0;
+	ulong removed = 0;
+
+	for (ulong i = 0; i < count; i++)
+	{
+		remaining[i] = graph->Nodes[i].DependencyCount;
+
+		if (remaining[i] is 0)
+		{
+			ready[readyCount++] = i;
+		}
+	}
+
+	while (readyCount)
+	{
+		const struct _eventNode* node = graph->Nodes + ready[--readyCount];
+
+		removed++;
+
+		for (ulong i = 0; i < node->DependentCount; i++)
+		{
+			const ulong next = graph->Dependents[node->FirstDependent + i];
+
+			if (--remaining[next] is 0)
+			{
+				ready[readyCount++] = next;
+			}
+		}
+	}
+
+	if (removed isnt count)
+	{
+		graph->Cyclic = true;
+
+		fprintf_red(stderr, "The declared event dependencies have a cycle, the phases run one after another until it's fixed, events in or waiting on the cycle:"NEWLINE"%s", "");
+
+		for (ulong i = 0; i < count; i++)
+		{
+			if (remaining[i])
+			{
+				fprintf_red(stderr, "\t%p"NEWLINE, (void*)(size_t)graph->Nodes[i].Method);
+			}
+		}
+	}
+
+	Memory.Free(remaining, EventGraphTypeId);
+	Memory.Free(ready, EventGraphTypeId);
+	Memory.Free(edges, EventGraphTypeId);
+}
+
+private void RunNode(void* state)
+{
+	struct _eventNode* node = state;
+	EventGraph graph = node->Graph;
+
+	node->Method();
+
+	for (ulong i = 0; i < node->DependentCount; i++)
+	{
+		struct _eventNode* dependent = graph->Nodes + graph->Dependents[node->FirstDependent + i];
+
+		// queued before this node's job finishes so the frame's counter never reaches zero early
+		if (atomic_fetch_sub_explicit(&dependent->Pending, 1, memory_order_acq_rel) is 1)
+		{
+			Jobs.Run(RunNode, dependent, graph->Counter);
+		}
+	}
+}
+
+private void RunMethod(void* state)
+{
+	((EventMethod)(size_t)state)();
+}
+
+private bool HasChanged(EventGraph graph, Array* phases, ulong phaseCount)
+{
+	bool changed = graph->Dirty or graph->PhaseCount isnt phaseCount;
+
+	for (ulong i = 0; i < phaseCount; i++)
+	{
+		struct _phaseKey* key = graph->Keys + i;
+
+		const ulong hash = Arrays.Hash(phases[i]);
+
+		if (key->Phase isnt phases[i] or key->Count isnt phases[i]->Count or key->Hash isnt hash)
+		{
+			changed = true;
+		}
+
+		key->Phase = phases[i];
+		key->Count = phases[i]->Count;
+		key->Hash = hash;
+	}
+
+	graph->PhaseCount = phaseCount;
+	graph->Dirty = false;
+
+	return changed;
+}
+
+private void Run(EventGraph graph, Array* phases, ulong phaseCount)
+{
+	if (phaseCount > EVENT_GRAPH_MAX_PHASES)
+	{
+		fprintf_red(stderr, "Failed to run %lli phases, an event graph runs at most %i phases", phaseCount, EVENT_GRAPH_MAX_PHASES);
+		throw(InvalidArgumentException);
+	}
+
+	if (HasChanged(graph, phases, phaseCount))
+	{
+		Build(graph, phases, phaseCount);
+	}
+
+	JobCounter counter = { 0 };
+
+	if (graph->Cyclic)
+	{
+		ulong first = 0;
+		for (ulong phase = 0; phase < phaseCount; phase++)
+		{
+			const ulong last = first + phases[phase]->Count;
+
+			for (ulong i = first; i < last; i++)
+			{
+				if (graph->Nodes[i].Serial is false)
+				{
+					Jobs.Run(RunMethod, (void*)(size_t)graph->Nodes[i].Method, &counter);
+				}
+			}
+
+			// methods that conflict within the phase keep the order they were registered in, like they do in the graph
+			for (ulong i = first; i < last; i++)
+			{
+				if (graph->Nodes[i].Serial)
+				{
+					graph->Nodes[i].Method();
+				}
+			}
+
+			Jobs.Wait(&counter);
+
+			first = last;
+		}
+
+		return;
+	}
+
+	graph->Counter = &counter;
+
+	// every count has to be set before any node runs since nodes decrement the counts of the nodes that wait on them
+	for (ulong i = 0; i < graph->NodeCount; i++)
+	{
+		atomic_store_explicit(&graph->Nodes[i].Pending, graph->Nodes[i].DependencyCount, memory_order_relaxed);
+	}
+
+	for (ulong i = 0; i < graph->NodeCount; i++)
+	{
+		if (graph->Nodes[i].DependencyCount is 0)
+		{
+			Jobs.Run(RunNode, graph->Nodes + i, &counter);
+		}
+	}
+
+	Jobs.Wait(&counter);
+
+	graph->Counter = null;
+}
+
+// the order each test event ran in, 0 when it didn't run
+static _Atomic(int) GLOBAL_TestSequence;
+static _Atomic(int) GLOBAL_TestOrder[6];
+
+private void RecordEvent(int index)
+{
+	atomic_store(&GLOBAL_TestOrder[index], atomic_fetch_add(&GLOBAL_TestSequence, 1) + 1);
+}
+
+private void EventA(void) { RecordEvent(0); }
+private void EventB(void) { RecordEvent(1); }
+private void EventC(void) { RecordEvent(2); }
+private void EventD(void) { RecordEvent(3); }
+private void EventE(void) { RecordEvent(4); }
+private void EventF(void) { RecordEvent(5); }
+
+private void ResetOrder(void)
+{
+	atomic_store(&GLOBAL_TestSequence, 0);
+
+	for (int i = 0; i < 6; i++)
+	{
+		atomic_store(&GLOBAL_TestOrder[i], 0);
+	}
+}
+
+private int OrderOf(int index)
+{
+	return atomic_load(&GLOBAL_TestOrder[index]);
+}
+
+private struct _eventNode* FindNode(EventGraph graph, EventMethod method)
+{
+	for (ulong i = 0; i < graph->NodeCount; i++)
+	{
+		if (graph->Nodes[i].Method is method)
+		{
+			return graph->Nodes + i;
+		}
+	}
+	return null;
+}
+
+TEST(DeclaredEventsOnlyWaitOnConflicts)
+{
+	const bool started = Jobs.Started();
+
+	if (started is false)
+	{
+		Jobs.Start(0);
+	}
+
+	EventGraph graph = Create();
+
+	array(EventMethod) update = dynamic_array(EventMethod, 0);
+	array(EventMethod) afterUpdate = dynamic_array(EventMethod, 0);
+
+	arrays(EventMethod).Append(update, EventA);
+	arrays(EventMethod).Append(update, EventB);
+	arrays(EventMethod).Append(afterUpdate, EventC);
+	arrays(EventMethod).Append(afterUpdate, EventD);
+	arrays(EventMethod).Append(afterUpdate, EventE);
+
+	// A writes the transforms that C reads, B and D don't share anything, E didn't declare anything
+	Writes(graph, EventA, "Transforms");
+	Reads(graph, EventB, "Input");
+	Reads(graph, EventC, "Transforms");
+	Writes(graph, EventD, "Audio");
+
+	Array phases[] = { (Array)update, (Array)afterUpdate };
+
+	for (int frame = 0; frame < 100; frame++)
+	{
+		ResetOrder();
+
+		Run(graph, phases, 2);
+
+		const int a = OrderOf(0);
+		const int b = OrderOf(1);
+		const int c = OrderOf(2);
+		const int d = OrderOf(3);
+		const int e = OrderOf(4);
+
+		IsTrue(a and b and c and d and e);
+		IsTrue(a < c);
+		IsTrue(a < e and b < e);
+	}
+
+	IsFalse(graph->Cyclic);
+	IsZero(graph->RaceCount);
+
+	const int cDependencies = FindNode(graph, EventC)->DependencyCount;
+	const int dDependencies = FindNode(graph, EventD)->DependencyCount;
+	const int eDependencies = FindNode(graph, EventE)->DependencyCount;
+
+	IsEqual(1, cDependencies);
+	IsEqual(0, dDependencies);
+	IsEqual(2, eDependencies);
+
+	// registrations changing rebuilds the graph
+	arrays(EventMethod).Append(afterUpdate, EventF);
+	Writes(graph, EventF, "Audio");
+
+	ResetOrder();
+	Run(graph, phases, 2);
+
+	const int d = OrderOf(3);
+	const int f = OrderOf(5);
+
+	IsTrue(d and f);
+	IsTrue(d < f);
+
+	arrays(EventMethod).Dispose(update);
+	arrays(EventMethod).Dispose(afterUpdate);
+	Dispose(graph);
+
+	if (started is false)
+	{
+		Jobs.Stop();
+	}
+
+	return true;
+}
+
+TEST(ExplicitDependencies)
+{
+	const bool started = Jobs.Started();
+
+	if (started is false)
+	{
+		Jobs.Start(0);
+	}
+
+	EventGraph graph = Create();
+
+	array(EventMethod) update = dynamic_array(EventMethod, 0);
+
+	arrays(EventMethod).Append(update, EventA);
+	arrays(EventMethod).Append(update, EventB);
+	arrays(EventMethod).Append(update, EventC);
+
+	// the reverse of the order they were registered in
+	DependsOn(graph, EventA, EventB);
+	DependsOn(graph, EventB, EventC);
+
+	Array phases[] = { (Array)update };
+
+	for (int frame = 0; frame < 100; frame++)
+	{
+		ResetOrder();
+
+		Run(graph, phases, 1);
+
+		const int a = OrderOf(0);
+		const int b = OrderOf(1);
+		const int c = OrderOf(2);
+
+		IsTrue(c and c < b and b < a);
+	}
+
+	arrays(EventMethod).Dispose(update);
+	Dispose(graph);
+
+	if (started is false)
+	{
+		Jobs.Stop();
+	}
+
+	return true;
+}
+
+TEST(RacesAndCycles)
+{
+	const bool started = Jobs.Started();
+
+	if (started is false)
+	{
+		Jobs.Start(0);
+	}
+
+	EventGraph graph = Create();
+
+	array(EventMethod) update = dynamic_array(EventMethod, 0);
+	array(EventMethod) afterUpdate = dynamic_array(EventMethod, 0);
+
+	arrays(EventMethod).Append(update, EventA);
+	arrays(EventMethod).Append(update, EventB);
+	arrays(EventMethod).Append(afterUpdate, EventC);
+
+	// both write within the same phase without saying which goes first
+	Writes(graph, EventA, "Physics");
+	Writes(graph, EventB, "Physics");
+	Reads(graph, EventC, "Physics");
+
+	Array phases[] = { (Array)update, (Array)afterUpdate };
+
+	ResetOrder();
+	Run(graph, phases, 2);
+
+	const ulong races = graph->RaceCount;
+	IsEqual((ulong)1, races);
+	IsTrue(OrderOf(0) < OrderOf(1));
+	IsTrue(OrderOf(1) < OrderOf(2));
+
+	// an explicit dependency can put a later phase first, but not when both wait on each other
+	DependsOn(graph, EventA, EventC);
+	DependsOn(graph, EventC, EventA);
+
+	ResetOrder();
+	Run(graph, phases, 2);
+
+	IsTrue(graph->Cyclic);
+
+	// cycles fall back to running the phases one after another, still in order where methods conflict
+	const int a = OrderOf(0);
+	const int b = OrderOf(1);
+	const int c = OrderOf(2);
+
+	IsTrue(a and b and c);
+	IsTrue(a < b and b < c);
+
+	arrays(EventMethod).Dispose(update);
+	arrays(EventMethod).Dispose(afterUpdate);
+	Dispose(graph);
+
+	if (started is false)
+	{
+		Jobs.Stop();
+	}
+
+	return true;
+}
+
+TEST_SUITE(RunUnitTests,
+	APPEND_TEST(DeclaredEventsOnlyWaitOnConflicts)
+	APPEND_TEST(ExplicitDependencies)
+	APPEND_TEST(RacesAndCycles)
+);
@@ -5,8 +5,19 @@
 #include <string.h>
 #include <stdlib.h>
 #include "core/os.h"
+#include "core/packs.h"
+#include "core/cunit.h"
+
+#ifdef WIN32
+#include <Windows.h>
+#include <io.h>
+#elif defined(__unix__) || defined(__APPLE__)
+#include <sys/mman.h>
+#define FILES_MMAP
+#endif
 
 private bool TryOpen(const string, FileMode fileMode, File* out_file);
+private bool Exists(const string path);
 private File Open(const string path, FileMode fileMode);
 private ulong GetFileSize(const File file);
 private array(byte) ReadFile(const File file);
@@ -20,6 +31,10 @@ private bool TryClose(File file);
 private void Close(File file);
 private bool TryVerifyCleanup(void);
 private int ReadUntil(const File file, string output, string target);
+private string Map(const string path);
+private bool TryMap(const string path, string* out_view);
+private void Unmap(string view);
+private void RunUnitTests();
 
 
 const struct _fileMethods Files = {
@@ -29,6 +44,7 @@ const struct _fileMethods Files = {
 		stack_string("assets\\")
 	),
 	.TryOpen = &TryOpen,
+	.Exists = Exists,
 	.Open = &Open,
 	.GetFileSize = &GetFileSize,
 	.ReadFile = &ReadFile,
@@ -42,13 +58,17 @@ const struct _fileMethods Files = {
 	.TryClose = &TryClose,
 	.Close = &Close,
 	.Dispose = &Close,
-	.TryVerifyCleanup = &TryVerifyCleanup
+	.TryVerifyCleanup = &TryVerifyCleanup,
+	.Map = Map,
+	.TryMap = TryMap,
+	.Unmap = Unmap,
+	.RunUnitTests = RunUnitTests
 };
 
-// the number of file handles opened using this file
-ulong Global_Files_Opened;
+// the number of file handles opened using this file, files are opened and closed from io and pool threads too
+volatile long long Global_Files_Opened;
 // the number of file handles closed using this file
-ulong Global_Files_Closed;
+volatile long long Global_Files_Closed;
 
 private bool TryOpenInteral(const string path, FileMode fileMode, File* out_file)
 {
@@ -78,14 +98,66 @@ private bool TryOpenInteral(const string path, FileMode fileMode, File* out_file
 
 	*out_file = file;
 
-	++(Global_Files_Opened);
+	_InterlockedIncrement64(&Global_Files_Opened);
 
 	return true;
 }
 
 
+// whether the mode only reads from the file
+private bool IsReadOnly(FileMode fileMode)
+{
+	return fileMode[0] is 'r' and strchr(fileMode, '+') is null;
+}
+
+// opens a stream over an entry within a mounted pack, only entries that are stored uncompressed
+// can be read as streams in place
+private bool TryOpenPackEntry(const string path, FileMode fileMode, File* out_file)
+{
+#ifdef FILES_MMAP
+	PackEntry entry;
+
+	if (IsReadOnly(fileMode) is false or Packs.TryGetEntry(path, &entry) is false)
+	{
+		return false;
+	}
+
+	// fmemopen can't open empty buffers
+	if (entry.Compressed or entry.Size is 0)
+	{
+		return false;
+	}
+
+	File file = fmemopen((void*)entry.Values, entry.Size, "r");
+
+	if (file is null)
+	{
+		return false;
+	}
+
+	*out_file = file;
+
+	_InterlockedIncrement64(&Global_Files_Opened);
+
+	return true;
+#else
+	ignore_unused(path);
+	ignore_unused(fileMode);
+	ignore_unused(out_file);
+	return false;
+#endif
+}
+
 private bool TryOpen(const string path, FileMode fileMode, File* out_file)
 {
+	*out_file = null;
+
+	// mounted packs override the files on disk
+	if (TryOpenPackEntry(path, fileMode, out_file))
+	{
+		return true;
+	}
+
 	if (TryOpenInteral(path, fileMode, out_file))
 	{
 		return true;
@@ -119,6 +191,33 @@ private bool TryOpen(const string path, FileMode fileMode, File* out_file)
 }
 
 
+private bool Exists(const string path)
+{
+	if (path is null or strings.Empty(path))
+	{
+		return false;
+	}
+
+	PackEntry entry;
+	if (Packs.TryGetEntry(path, &entry))
+	{
+		return true;
+	}
+
+	// opened directly instead of with TryOpen so a missing file isn't reported as an error
+	File file;
+	fopen_s(&file, path->Values, FileModes.ReadBinary);
+
+	if (file is null)
+	{
+		return false;
+	}
+
+	fclose(file);
+
+	return true;
+}
+
 private File Open(const string path, FileMode fileMode)
 {
 	Guard(strings.Empty(path) is false);
@@ -161,40 +260,42 @@ private ulong GetFileSize(const File file)
 	return count;
 }
 
-private string ReadFile(const File file)
+// reads the remaining bytes of the file into the string with as few reads as possible, returns false if an error occurred
+private bool TryReadRemaining(const File file, string result)
 {
-	ulong length = GetFileSize(file);
+	while (result->Count < result->Capacity)
+	{
+		const ulong read = fread(result->Values + result->Count, sizeof(byte), result->Capacity - result->Count, file);
 
-	string result = strings.Create(length + 1);
+		result->Count += read;
 
-	unsafe_at(result, length) = '\0'; // add line terminator
+		if (read is 0)
+		{
+			break;
+		}
+	}
 
-	rewind(file);
+	// arrays always reserve one byte past their capacity for the nul terminator
+	unsafe_at(result, result->Count) = '\0';
 
-	for (ulong i = 0; i < length; i++)
-	{
-		int c = fgetc(file);
+	result->Dirty = true;
 
-		if (c is EOF)
-		{
-			// check to see what error we got
-			// if we got 0 then the stream was likely not started at the beginning and we reached EOF early
-			int error = ferror(file);
+	return ferror(file) is 0;
+}
 
-			// if the error we got was actually an error we should return early
-			// only attempt rewinding once
-			if (error != 0)
-			{
-				strings.Dispose(result);
-				fprintf(stderr, "An error occurred while reading the file at ptr: %llix, Error Code %i", (ulong)file, ferror(file));
-				throw(FailedToReadFileException);
-			}
+private string ReadFile(const File file)
+{
+	const ulong length = GetFileSize(file);
 
-			strings.Append(result, '\0');
-			break;
-		}
+	string result = strings.Create(length + 1);
 
-		strings.Append(result, c);
+	rewind(file);
+
+	if (TryReadRemaining(file, result) is false)
+	{
+		strings.Dispose(result);
+		fprintf(stderr, "An error occurred while reading the file at ptr: %llix, Error Code %i", (ulong)file, ferror(file));
+		throw(FailedToReadFileException);
 	}
 
 	return result;
@@ -289,34 +390,14 @@ private bool TryReadFile(const File file, string* out_data)
 
 	const ulong length = GetFileSize(file);
 
-	// array memory blocks are auto-terminated
-	string result = strings.Create(length);
+	string result = strings.Create(length + 1);
 
 	rewind(file);
 
-	for (ulong i = 0; i < length; i++)
+	if (TryReadRemaining(file, result) is false)
 	{
-		int c = fgetc(file);
-
-		if (c is EOF)
-		{
-			// check to see what error we got
-			// if we got 0 then the stream was likely not started at the beginning and we reached EOF early
-			int error = ferror(file);
-
-			// if the error we got was actually an error we should return early
-			// only attempt rewinding once
-			if (error != 0)
-			{
-				strings.Dispose(result);
-				return false;
-			}
-
-			strings.Append(result, '\0');
-			break;
-		}
-
-		strings.Append(result, c);
+		strings.Dispose(result);
+		return false;
 	}
 
 	*out_data = result;
@@ -329,14 +410,9 @@ private void WriteAll(const string path, const string data)
 	File file;
 	if (TryOpen(path, FileModes.Create, &file))
 	{
-		for (int i = 0; i < data->Count; i++)
+		if (fwrite(data->Values, sizeof(byte), data->Count, file) isnt data->Count)
 		{
-			byte c = at(data, i);
-			if (c != fputc(c, file))
-			{
-				throw(FailedToWriteToStreamException);
-			}
-			//fputc(c, stdout);
+			throw(FailedToWriteToStreamException);
 		}
 
 		Close(file);
@@ -346,24 +422,33 @@ private void WriteAll(const string path, const string data)
 	}
 }
 
+// copies a view into a NEW string
+private string CopyView(const string view)
+{
+	string result = strings.Create(view->Count + 1);
+
+	memcpy(result->Values, view->Values, view->Count);
+
+	result->Count = view->Count;
+
+	return result;
+}
+
 private string ReadAll(const string path)
 {
-	File file;
-	if (TryOpen(path, FileModes.Read, &file))
+	string view;
+	if (TryMap(path, &view))
 	{
-		string data = ReadFile(file);
-
-		if (strings.Empty(data))
+		if (view->Count is 0)
 		{
+			Unmap(view);
 			fprintf(stderr, "Failed to read file %s"NEWLINE, path->Values);
 			throw(FailedToReadFileException);
 		}
 
-		if (TryClose(file) is false)
-		{
-			fprintf(stderr, "Failed to close the file %s"NEWLINE, path->Values);
-			throw(FailedToCloseFileException);
-		}
+		string data = CopyView(view);
+
+		Unmap(view);
 
 		return data;
 	}
@@ -377,20 +462,17 @@ private string ReadAll(const string path)
 
 private bool TryReadAll(const string path, string* out_data)
 {
-	File file;
+	*out_data = null;
 
-	if (TryOpen(path, FileModes.Read, &file))
+	string view;
+
+	if (TryMap(path, &view))
 	{
-		string data;
+		*out_data = CopyView(view);
 
-		if (TryReadFile(file, &data))
-		{
-			*out_data = data;
+		Unmap(view);
 
-			return TryClose(file);
-		}
-
-		TryClose(file);
+		return true;
 	}
 
 	return false;
@@ -511,7 +593,7 @@ static bool TryClose(File file)
 		return true;
 	}
 
-	++(Global_Files_Closed);
+	_InterlockedIncrement64(&Global_Files_Closed);
 
 	return fclose(file) != EOF;
 }
@@ -526,10 +608,377 @@ private void Close(File file)
 
 private bool TryVerifyCleanup(void)
 {
-	if (Global_Files_Opened != Global_Files_Closed)
+	const long long opened = Global_Files_Opened;
+	const long long closed = Global_Files_Closed;
+
+	if (opened != closed)
+	{
+		fprintf(stderr, "The number of the files that were opened did not match the number of file handles that were closed: %lli/%lli"NEWLINE, opened, closed);
+	}
+
+	return opened == closed;
+}
+
+// files smaller than this are read into memory instead of mapped, mapping a file costs a few system calls
+// and page faults that outweigh reading a few pages
+#define FILES_MIN_MAP_SIZE (64 * 1024)
+
+DEFINE_TYPE_ID(MappedFile);
+
+// a view of a file returned from Map, the view is the first member so the string handed out can be cast back to the file
+struct _mappedFile {
+	partial_string View;
+	// where the bytes of the view came from, which decides how they're released
+	enum {
+		// mapped from the file
+		MappedFromFile,
+		// read into memory because the file couldn't be mapped, or decompressed from a pack
+		ReadIntoMemory,
+		// a view of an entry within a mounted pack, the pack owns the bytes
+		ViewOfPack
+	} Source;
+};
+
+// maps length bytes of the opened file into memory, returns null when the file can't be mapped
+private byte* MapBytes(const File file, const ulong length)
+{
+#ifdef WIN32
+	HANDLE handle = (HANDLE)_get_osfhandle(_fileno(file));
+
+	HANDLE mapping = CreateFileMappingA(handle, null, PAGE_READONLY, 0, 0, null);
+
+	if (mapping is null)
 	{
-		fprintf(stderr, "The number of the files that were opened did not match the number of file handles that were closed: %lli/%lli"NEWLINE, Global_Files_Opened, Global_Files_Closed);
+		return null;
 	}
 
-	return Global_Files_Opened == Global_Files_Closed;
-}
\ No newline at end of file
+	byte* values = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, length);
+
+	// the view keeps the mapping alive until it's unmapped
+	CloseHandle(mapping);
+
+	return values;
+#elif defined(FILES_MMAP)
+#ifdef MAP_POPULATE
+	// fault every page in up front instead of one at a time as it's read
+	const int flags = MAP_PRIVATE | MAP_POPULATE;
+#else
+	const int flags = MAP_PRIVATE;
+#endif
+
+	void* values = mmap(null, length, PROT_READ, flags, fileno(file), 0);
+
+	if (values is MAP_FAILED)
+	{
+		return null;
+	}
+
+	// files are almost always read front to back once, the advice values are not flags so each needs its own call
+	madvise(values, length, MADV_SEQUENTIAL);
+	madvise(values, length, MADV_WILLNEED);
+
+	return values;
+#else
+	ignore_unused(file);
+	ignore_unused(length);
+	return null;
+#endif
+}
+
+private void UnmapBytes(byte* values, const ulong length)
+{
+#ifdef WIN32
+	ignore_unused(length);
+	UnmapViewOfFile(values);
+#elif defined(FILES_MMAP)
+	munmap(values, length);
+#else
+	ignore_unused(values);
+	ignore_unused(length);
+#endif
+}
+
+private string CreateView(byte* values, const ulong length, int source)
+{
+	struct _mappedFile* result = Memory.Alloc(sizeof(struct _mappedFile), MappedFileTypeId);
+
+	result->Source = source;
+
+	// the view is read only, marking it as a stack object makes modifying or disposing it throw
+	result->View = (partial_string){
+		.Values = values,
+		.Size = length,
+		.ElementSize = sizeof(byte),
+		.Capacity = length,
+		.Count = length,
+		.TypeId = 0,
+		.StackObject = true,
+		.Dirty = true,
+		.Hash = 0,
+		.AutoHash = false
+	};
+
+	return &result->View;
+}
+
+private bool TryMapPackEntry(const string path, string* out_view)
+{
+	PackEntry entry;
+
+	if (Packs.TryGetEntry(path, &entry) is false)
+	{
+		return false;
+	}
+
+	// uncompressed entries are already mapped with the pack
+	if (entry.Compressed is false)
+	{
+		*out_view = CreateView((byte*)entry.Values, entry.Size, ViewOfPack);
+		return true;
+	}
+
+	byte* values = Memory.Alloc(entry.Size + 1, MappedFileTypeId);
+
+	if (Packs.TryReadEntry(&entry, values) is false)
+	{
+		fprintf(stderr, "The entry %s within a pack is corrupt"NEWLINE, path->Values);
+		Memory.Free(values, MappedFileTypeId);
+		return false;
+	}
+
+	*out_view = CreateView(values, entry.Size, ReadIntoMemory);
+
+	return true;
+}
+
+private bool TryMap(const string path, string* out_view)
+{
+	*out_view = null;
+
+	REGISTER_TYPE(MappedFile);
+
+	// mounted packs override the files on disk
+	if (TryMapPackEntry(path, out_view))
+	{
+		return true;
+	}
+
+	File file;
+
+	if (TryOpen(path, FileModes.ReadBinary, &file) is false)
+	{
+		return false;
+	}
+
+	const ulong length = GetFileSize(file);
+
+	// empty files can't be mapped, and small files are faster to read than to map and unmap
+	byte* values = length >= FILES_MIN_MAP_SIZE ? MapBytes(file, length) : null;
+
+	const bool mapped = values isnt null;
+
+	if (mapped is false)
+	{
+		// fall back to reading the whole file at once
+		values = Memory.Alloc(length + 1, MappedFileTypeId);
+
+		rewind(file);
+
+		if (fread(values, sizeof(byte), length, file) isnt length)
+		{
+			Memory.Free(values, MappedFileTypeId);
+			TryClose(file);
+			return false;
+		}
+	}
+
+	// the mapping stays valid after the file is closed
+	if (TryClose(file) is false)
+	{
+		if (mapped)
+		{
+			UnmapBytes(values, length);
+		}
+		else
+		{
+			Memory.Free(values, MappedFileTypeId);
+		}
+
+		return false;
+	}
+
+	*out_view = CreateView(values, length, mapped ? MappedFromFile : ReadIntoMemory);
+
+	return true;
+}
+
+private string Map(const string path)
+{
+	string view;
+	if (TryMap(path, &view))
+	{
+		return view;
+	}
+
+	fprintf(stderr, "Failed to map file %s"NEWLINE, path is null ? "(null)" : (char*)path->Values);
+	throw(FailedToOpenFileException);
+
+	// we shouldn't be able to get here, but it's possible if __debugbreak() is continued
+	return null;
+}
+
+private void Unmap(string view)
+{
+	if (view is null)
+	{
+		return;
+	}
+
+	struct _mappedFile* file = (struct _mappedFile*)view;
+
+	if (file->Source is MappedFromFile)
+	{
+		UnmapBytes(file->View.Values, file->View.Count);
+	}
+	else if (file->Source is ReadIntoMemory)
+	{
+		Memory.Free(file->View.Values, MappedFileTypeId);
+	}
+
+	Memory.Free(file, MappedFileTypeId);
+}
+
+#define TEST_FILE_PATH "file_map_test.bin"
+
+TEST(MapMatchesWrite)
+{
+	string path = stack_string(TEST_FILE_PATH);
+
+	string data = strings.Create(4096 * 3 + 17);
+
+	for (ulong i = 0; i < 4096 * 3 + 17; i++)
+	{
+		strings.Append(data, (byte)(i * 31));
+	}
+
+	WriteAll(path, data);
+
+	string view = Map(path);
+
+	IsTrue(strings.Equals(data, view));
+
+	Unmap(view);
+
+	string copy = ReadAll(path);
+
+	IsTrue(strings.Equals(data, copy));
+	// copies are always nul terminated
+	IsZero(unsafe_at(copy, copy->Count));
+
+	strings.Dispose(copy);
+
+	// empty files can't be mapped and use the fallback instead
+	data->Count = 0;
+	WriteAll(path, data);
+
+	IsTrue(TryMap(path, &view));
+	IsZero(view->Count);
+
+	Unmap(view);
+
+	strings.Dispose(data);
+
+	remove(TEST_FILE_PATH);
+
+	return true;
+}
+
+// reads a file the way ReadFile used to, a byte at a time, to compare against
+private string ReadFileByteByByte(const File file)
+{
+	ulong length = GetFileSize(file);
+
+	string result = strings.Create(length + 1);
+
+	rewind(file);
+
+	for (ulong i = 0; i < length; i++)
+	{
+		int c = fgetc(file);
+
+		if (c is EOF)
+		{
+			break;
+		}
+
+		strings.Append(result, c);
+	}
+
+	return result;
+}
+
+TEST(ReadBenchmark)
+{
+	const ulong size = 100 * 1024 * 1024;
+
+	string path = stack_string(TEST_FILE_PATH);
+
+	// obj like text so the file looks like the assets that are actually loaded
+	string data = strings.Create(size);
+	string line = stack_string("v 0.125000 -1.500000 42.000000\n");
+
+	while (data->Count + line->Count <= size)
+	{
+		strings.AppendArray(data, line);
+	}
+
+	WriteAll(path, data);
+
+	string result = null;
+
+	fprintf(__test_stream, "\tfgetc + Append (%lli MB)"NEWLINE, size / (1024 * 1024));
+	File file = Open(path, FileModes.ReadBinary);
+	Benchmark(result = ReadFileByteByByte(file), __test_stream);
+	Close(file);
+
+	IsTrue(strings.Equals(data, result));
+	strings.Dispose(result);
+
+	fprintf(__test_stream, "\tReadFile, bulk fread (%lli MB)"NEWLINE, size / (1024 * 1024));
+	file = Open(path, FileModes.ReadBinary);
+	Benchmark(result = ReadFile(file), __test_stream);
+	Close(file);
+
+	IsTrue(strings.Equals(data, result));
+	strings.Dispose(result);
+
+	fprintf(__test_stream, "\tReadAll, map and copy (%lli MB)"NEWLINE, size / (1024 * 1024));
+	Benchmark(result = ReadAll(path), __test_stream);
+
+	IsTrue(strings.Equals(data, result));
+	strings.Dispose(result);
+
+	// touch every page so the mapping is actually read
+	ulong newlines = 0;
+
+	fprintf(__test_stream, "\tMap and scan (%lli MB)"NEWLINE, size / (1024 * 1024));
+	Benchmark(
+		result = Map(path);
+		newlines = strings.CountOf(result, '\n');
+		Unmap(result);
+		, __test_stream);
+
+	const ulong lines = data->Count / line->Count;
+	IsEqual(lines, newlines);
+
+	strings.Dispose(data);
+
+	remove(TEST_FILE_PATH);
+
+	return true;
+}
+
+TEST_SUITE(RunUnitTests,
+	APPEND_TEST(MapMatchesWrite)
+	APPEND_TEST(ReadBenchmark)
+);
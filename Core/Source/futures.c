@@ -0,0 +1,817 @@
+#include "core/futures.h"
+#include "core/jobs.h"
+#include "core/tasks.h"
+#include "core/memory.h"
+#include "core/cunit.h"
+#include <string.h>
+
+private Future Create(ulong resultSize);
+private Future FromResult(const void* result, ulong resultSize);
+private Future Run(FutureMethod method, void* state, ulong resultSize, FutureScheduler scheduler);
+private void Complete(Future, const void* result);
+private void Fault(Future);
+private Future Then(Future, FutureMethod method, void* state, ulong resultSize, FutureScheduler scheduler);
+private Future WhenAll(Future* futures, ulong count);
+private Future WhenAny(Future* futures, ulong count);
+private bool IsCompleted(Future);
+private FutureState Wait(Future, ulong milliseconds);
+private ulong Update(void);
+private void Dispose(Future);
+private void RunUnitTests(void);
+
+const struct _futureMethods Futures = {
+	.Create = Create,
+	.FromResult = FromResult,
+	.Run = Run,
+	.Complete = Complete,
+	.Fault = Fault,
+	.Then = Then,
+	.WhenAll = WhenAll,
+	.WhenAny = WhenAny,
+	.IsCompleted = IsCompleted,
+	.Wait = Wait,
+	.Update = Update,
+	.Dispose = Dispose,
+	.RunUnitTests = RunUnitTests
+};
+
+DEFINE_TYPE_ID(Future);
+DEFINE_TYPE_ID(FutureContinuation);
+
+// the futures given to WhenAll or WhenAny, freed once every one of them is no longer pending
+struct _futureGroup {
+	Future Result;
+	_Atomic(long) Remaining;
+	_Atomic(bool) Faulted;
+	// WhenAny completes with the first future that finishes
+	bool Any;
+	_Atomic(bool) Finished;
+};
+
+struct _futureContinuation {
+	// the future that has to finish first, null for Run
+	Future Antecedent;
+	// the future completed with the method's result
+	Future Result;
+	FutureMethod Method;
+	void* State;
+	FutureScheduler Scheduler;
+	// set instead of a method for the continuations of WhenAll and WhenAny
+	struct _futureGroup* Group;
+	ulong Index;
+	struct _futureContinuation* Next;
+};
+
+// continuations that run on the next call to Update, in the order they were scheduled
+static struct {
+	locker Lock;
+	struct _futureContinuation* Head;
+	struct _futureContinuation* Tail;
+} GLOBAL_MainThreadQueue;
+
+private Future Allocate(ulong resultSize, long references)
+{
+	REGISTER_TYPE(Future);
+
+	// the result is stored right after the future
+	Future future = Memory.Alloc(sizeof(struct _future) + resultSize, FutureTypeId);
+
+	future->ResultSize = resultSize;
+	future->Result = resultSize ? (byte*)(future + 1) : null;
+
+	atomic_init(&future->State, FutureStates.Pending);
+	atomic_init(&future->References, references);
+
+	return future;
+}
+
+private void Retain(Future future)
+{
+	atomic_fetch_add_explicit(&future->References, 1, memory_order_relaxed);
+}
+
+private void Release(Future future)
+{
+	if (atomic_fetch_sub_explicit(&future->References, 1, memory_order_acq_rel) is 1)
+	{
+		Memory.Free(future, FutureTypeId);
+	}
+}
+
+private struct _futureContinuation* CreateContinuation(Future antecedent, Future result)
+{
+	REGISTER_TYPE(FutureContinuation);
+
+	struct _futureContinuation* continuation = Memory.Alloc(sizeof(struct _futureContinuation), FutureContinuationTypeId);
+
+	continuation->Antecedent = antecedent;
+	continuation->Result = result;
+
+	if (antecedent)
+	{
+		Retain(antecedent);
+	}
+
+	return continuation;
+}
+
+private void DisposeContinuation(struct _futureContinuation* continuation)
+{
+	if (continuation->Antecedent)
+	{
+		Release(continuation->Antecedent);
+	}
+
+	Memory.Free(continuation, FutureContinuationTypeId);
+}
+
+private void Finish(Future future, FutureState state);
+
+private void FinishGroup(struct _futureContinuation* continuation)
+{
+	struct _futureGroup* group = continuation->Group;
+
+	const bool faulted = atomic_load(&continuation->Antecedent->State) is FutureStates.Faulted;
+
+	if (faulted)
+	{
+		atomic_store(&group->Faulted, true);
+	}
+
+	if (group->Any and atomic_exchange(&group->Finished, true) is false)
+	{
+		*(ulong*)group->Result->Result = continuation->Index;
+		Finish(group->Result, FutureStates.Completed);
+	}
+
+	if (atomic_fetch_sub_explicit(&group->Remaining, 1, memory_order_acq_rel) is 1)
+	{
+		if (group->Any is false)
+		{
+			Finish(group->Result, atomic_load(&group->Faulted) ? FutureStates.Faulted : FutureStates.Completed);
+		}
+
+		Release(group->Result);
+		Memory.Free(group, FutureContinuationTypeId);
+	}
+
+	DisposeContinuation(continuation);
+}
+
+private void RunContinuation(void* state)
+{
+	struct _futureContinuation* continuation = state;
+
+	Future antecedent = continuation->Antecedent;
+	Future result = continuation->Result;
+
+	if (antecedent isnt null and atomic_load(&antecedent->State) is FutureStates.Faulted)
+	{
+		Finish(result, FutureStates.Faulted);
+	}
+	else
+	{
+		const bool succeeded = continuation->Method(antecedent, continuation->State, result->Result);
+
+		Finish(result, succeeded ? FutureStates.Completed : FutureStates.Faulted);
+	}
+
+	Release(result);
+
+	DisposeContinuation(continuation);
+}
+
+private void Schedule(struct _futureContinuation* continuation)
+{
+	// joining futures is only a few atomics, there's no reason to queue it
+	if (continuation->Group)
+	{
+		FinishGroup(continuation);
+		return;
+	}
+
+	if (continuation->Scheduler is FutureSchedulers.MainThread)
+	{
+		continuation->Next = null;
+
+		lock(GLOBAL_MainThreadQueue.Lock,
+			if (GLOBAL_MainThreadQueue.Tail)
+			{
+				GLOBAL_MainThreadQueue.Tail->Next = continuation;
+			}
+			else
+			{
+				GLOBAL_MainThreadQueue.Head = continuation;
+			}
+			GLOBAL_MainThreadQueue.Tail = continuation;
+		);
+
+		return;
+	}
+
+	Jobs.Run(RunContinuation, continuation, null);
+}
+
+private void Finish(Future future, FutureState state)
+{
+	FutureState previous = FutureStates.Pending;
+	struct _futureContinuation* continuations = null;
+
+	lock(future->Lock,
+		previous = atomic_load(&future->State);
+		if (previous is FutureStates.Pending)
+		{
+			atomic_store(&future->State, state);
+			continuations = future->Continuations;
+			future->Continuations = null;
+			future->LastContinuation = null;
+		}
+	);
+
+	if (previous isnt FutureStates.Pending)
+	{
+		fprintf_red(stderr, "Failed to finish future %p, it already finished", (void*)future);
+		throw(InvalidLogicException);
+	}
+
+	Tasks.NotifyAllThreadsAddressChanged((void*)&future->State);
+
+	while (continuations)
+	{
+		struct _futureContinuation* next = continuations->Next;
+
+		Schedule(continuations);
+
+		continuations = next;
+	}
+}
+
+// schedules the continuation once the antecedent is no longer pending, right away if it already isn't
+private void Continue(Future antecedent, struct _futureContinuation* continuation)
+{
+	bool pending = false;
+
+	lock(antecedent->Lock,
+		pending = atomic_load(&antecedent->State) is FutureStates.Pending;
+		if (pending)
+		{
+			continuation->Next = null;
+
+			if (antecedent->LastContinuation)
+			{
+				antecedent->LastContinuation->Next = continuation;
+			}
+			else
+			{
+				antecedent->Continuations = continuation;
+			}
+
+			antecedent->LastContinuation = continuation;
+		}
+	);
+
+	if (pending is false)
+	{
+		Schedule(continuation);
+	}
+}
+
+private Future Create(ulong resultSize)
+{
+	return Allocate(resultSize, 1);
+}
+
+private Future FromResult(const void* result, ulong resultSize)
+{
+	Future future = Allocate(resultSize, 1);
+
+	Complete(future, result);
+
+	return future;
+}
+
+private void Complete(Future future, const void* result)
+{
+	if (result isnt null and future->ResultSize)
+	{
+		memcpy(future->Result, result, future->ResultSize);
+	}
+
+	Finish(future, FutureStates.Completed);
+}
+
+private void Fault(Future future)
+{
+	Finish(future, FutureStates.Faulted);
+}
+
+private Future Run(FutureMethod method, void* state, ulong resultSize, FutureScheduler scheduler)
+{
+	if (method is null)
+	{
+		throw(InvalidArgumentException);
+	}
+
+	// one reference for the caller and one for the continuation that completes it
+	Future result = Allocate(resultSize, 2);
+
+	struct _futureContinuation* continuation = CreateContinuation(null, result);
+
+	continuation->Method = method;
+	continuation->State = state;
+	continuation->Scheduler = scheduler;
+
+	Schedule(continuation);
+
+	return result;
+}
+
+private Future Then(Future future, FutureMethod method, void* state, ulong resultSize, FutureScheduler scheduler)
+{
+	if (future is null or method is null)
+	{
+		throw(InvalidArgumentException);
+	}
+
+	Future result = Allocate(resultSize, 2);
+
+	struct _futureContinuation* continuation = CreateContinuation(future, result);
+
+	continuation->Method = method;
+	continuation->State = state;
+	continuation->Scheduler = scheduler;
+
+	Continue(future, continuation);
+
+	return result;
+}
+
+private Future Join(Future* futures, ulong count, bool any)
+{
+	if (futures is null or count is 0)
+	{
+		throw(InvalidArgumentException);
+	}
+
+	REGISTER_TYPE(FutureContinuation);
+
+	Future result = Allocate(any ? sizeof(ulong) : 0, 2);
+
+	struct _futureGroup* group = Memory.Alloc(sizeof(struct _futureGroup), FutureContinuationTypeId);
+
+	group->Result = result;
+	group->Any = any;
+	atomic_init(&group->Remaining, (long)count);
+	atomic_init(&group->Faulted, false);
+	atomic_init(&group->Finished, false);
+
+	for (ulong i = 0; i < count; i++)
+	{
+		struct _futureContinuation* continuation = CreateContinuation(futures[i], result);
+
+		continuation->Group = group;
+		continuation->Index = i;
+
+		Continue(futures[i], continuation);
+	}
+
+	return result;
+}
+
+private Future WhenAll(Future* futures, ulong count)
+{
+	return Join(futures, count, false);
+}
+
+private Future WhenAny(Future* futures, ulong count)
+{
+	return Join(futures, count, true);
+}
+
+private bool IsCompleted(Future future)
+{
+	return atomic_load(&future->State) isnt FutureStates.Pending;
+}
+
+private FutureState Wait(Future future, ulong milliseconds)
+{
+	const FutureState pending = FutureStates.Pending;
+	const ulong deadline = Tasks.DeadlineAfter(milliseconds);
+	int spins = 0;
+
+	while (atomic_load(&future->State) is pending)
+	{
+		// the future may be waiting on a pool job that only this thread is left to run, like with a single thread
+		if (Jobs.TryRunOne())
+		{
+			spins = 0;
+			continue;
+		}
+
+		if (++spins < JOBS_SPIN_COUNT)
+		{
+			continue;
+		}
+
+		spins = 0;
+
+		if (Tasks.WaitUntil((void*)&future->State, &pending, sizeof(FutureState), deadline) is false)
+		{
+			break;
+		}
+	}
+
+	return atomic_load(&future->State);
+}
+
+private ulong Update(void)
+{
+	struct _futureContinuation* continuations = null;
+
+	// continuations these schedule on the main thread run on the next update
+	lock(GLOBAL_MainThreadQueue.Lock,
+		continuations = GLOBAL_MainThreadQueue.Head;
+		GLOBAL_MainThreadQueue.Head = null;
+		GLOBAL_MainThreadQueue.Tail = null;
+	);
+
+	ulong count = 0;
+
+	while (continuations)
+	{
+		struct _futureContinuation* next = continuations->Next;
+
+		RunContinuation(continuations);
+
+		continuations = next;
+		count++;
+	}
+
+	return count;
+}
+
+private void Dispose(Future future)
+{
+	if (future is null)
+	{
+		return;
+	}
+
+	Release(future);
+}
+
+private bool Square(Future antecedent, void* state, void* out_result)
+{
+	ignore_unused(antecedent);
+
+	const int value = (int)(size_t)state;
+
+	*(int*)out_result = value * value;
+
+	return true;
+}
+
+private bool AddOne(Future antecedent, void* state, void* out_result)
+{
+	ignore_unused(state);
+
+	*(int*)out_result = future_result(int, antecedent) + 1;
+
+	return true;
+}
+
+private bool Double(Future antecedent, void* state, void* out_result)
+{
+	ignore_unused(state);
+
+	*(int*)out_result = future_result(int, antecedent) * 2;
+
+	return true;
+}
+
+private bool Fail(Future antecedent, void* state, void* out_result)
+{
+	ignore_unused(antecedent);
+	ignore_unused(state);
+	ignore_unused(out_result);
+
+	return false;
+}
+
+private bool CountCall(Future antecedent, void* state, void* out_result)
+{
+	ignore_unused(antecedent);
+	ignore_unused(out_result);
+
+	atomic_fetch_add((_Atomic(int)*)state, 1);
+
+	return true;
+}
+
+// the result is the order the continuation ran in
+private bool RecordOrder(Future antecedent, void* state, void* out_result)
+{
+	ignore_unused(antecedent);
+
+	*(int*)out_result = atomic_fetch_add((_Atomic(int)*)state, 1);
+
+	return true;
+}
+
+TEST(ThenChains)
+{
+	const bool started = Jobs.Started();
+
+	if (started is false)
+	{
+		Jobs.Start(0);
+	}
+
+	future(int) squared = Run(Square, (void*)3, sizeof(int), FutureSchedulers.Pool);
+	future(int) added = Then(squared, AddOne, null, sizeof(int), FutureSchedulers.Pool);
+	future(int) doubled = Then(added, Double, null, sizeof(int), FutureSchedulers.Pool);
+
+	const FutureState state = Wait(doubled, Tasks.Forever);
+	const FutureState completed = FutureStates.Completed;
+	IsEqual(completed, state);
+
+	const int result = future_result(int, doubled);
+	IsEqual(20, result);
+
+	// continuing a future that already finished runs right away
+	future(int) again = Then(squared, AddOne, null, sizeof(int), FutureSchedulers.Pool);
+	Wait(again, Tasks.Forever);
+
+	const int againResult = future_result(int, again);
+	IsEqual(10, againResult);
+
+	Dispose(squared);
+	Dispose(added);
+	Dispose(doubled);
+	Dispose(again);
+
+	if (started is false)
+	{
+		Jobs.Stop();
+	}
+
+	return true;
+}
+
+TEST(MainThreadContinuations)
+{
+	// anything left from another test
+	Update();
+
+	future(int) source = Create(sizeof(int));
+	future(int) added = Then(source, AddOne, null, sizeof(int), FutureSchedulers.MainThread);
+	future(int) doubled = Then(added, Double, null, sizeof(int), FutureSchedulers.MainThread);
+
+	const int value = 4;
+	Complete(source, &value);
+
+	// nothing runs until the next update and each step waits for the one after it, like frames
+	IsFalse(IsCompleted(added));
+
+	const ulong first = Update();
+	IsEqual((ulong)1, first);
+	IsTrue(IsCompleted(added));
+	IsFalse(IsCompleted(doubled));
+
+	const ulong second = Update();
+	IsEqual((ulong)1, second);
+	IsTrue(IsCompleted(doubled));
+
+	const int result = future_result(int, doubled);
+	IsEqual(10, result);
+
+	Dispose(source);
+	Dispose(added);
+	Dispose(doubled);
+
+	return true;
+}
+
+TEST(ContinuationsRunInOrder)
+{
+	Update();
+
+	_Atomic(int) order = 0;
+
+	future(int) source = Create(sizeof(int));
+	future(int) first = Then(source, RecordOrder, &order, sizeof(int), FutureSchedulers.MainThread);
+	future(int) second = Then(source, RecordOrder, &order, sizeof(int), FutureSchedulers.MainThread);
+	future(int) third = Then(source, RecordOrder, &order, sizeof(int), FutureSchedulers.MainThread);
+
+	Complete(source, null);
+
+	const ulong ran = Update();
+	IsEqual((ulong)3, ran);
+
+	const int firstOrder = future_result(int, first);
+	const int secondOrder = future_result(int, second);
+	const int thirdOrder = future_result(int, third);
+
+	IsEqual(0, firstOrder);
+	IsEqual(1, secondOrder);
+	IsEqual(2, thirdOrder);
+
+	Dispose(source);
+	Dispose(first);
+	Dispose(second);
+	Dispose(third);
+
+	return true;
+}
+
+TEST(FaultsSkipContinuations)
+{
+	_Atomic(int) calls = 0;
+
+	future(int) failed = Run(Fail, null, sizeof(int), FutureSchedulers.MainThread);
+	future(int) skipped = Then(failed, CountCall, &calls, sizeof(int), FutureSchedulers.MainThread);
+
+	Update();
+	Update();
+
+	const FutureState faulted = FutureStates.Faulted;
+	const FutureState failedState = atomic_load(&failed->State);
+	const FutureState skippedState = atomic_load(&skipped->State);
+
+	IsEqual(faulted, failedState);
+	IsEqual(faulted, skippedState);
+	IsZero(atomic_load(&calls));
+
+	Dispose(failed);
+	Dispose(skipped);
+
+	return true;
+}
+
+// wakes anything waiting on the future about once a millisecond without completing it
+#define TEST_MAX_WAKES 2000
+
+static Future GLOBAL_WokenFuture;
+static _Atomic(int) GLOBAL_StopWaking;
+static _Atomic(int) GLOBAL_Wakes;
+
+private int WakeWithoutCompleting(void* state)
+{
+	const int running = 0;
+
+	while (atomic_load(&GLOBAL_Wakes) < TEST_MAX_WAKES)
+	{
+		atomic_fetch_add(&GLOBAL_Wakes, 1);
+		Tasks.NotifyAllThreadsAddressChanged((void*)&GLOBAL_WokenFuture->State);
+
+		if (Tasks.WaitWhileEqual(&GLOBAL_StopWaking, &running, sizeof(int), 1))
+		{
+			break;
+		}
+	}
+
+	return 0;
+}
+
+TEST(WaitTimesOutWhileWoken)
+{
+	GLOBAL_WokenFuture = Create(sizeof(int));
+	atomic_store(&GLOBAL_StopWaking, 0);
+	atomic_store(&GLOBAL_Wakes, 0);
+
+	Task waker = Tasks.Run(Tasks.Create(WakeWithoutCompleting), null);
+
+	const FutureState state = Wait(GLOBAL_WokenFuture, 20);
+
+	// the wait has to end on its own timeout, not because the wakes ran out
+	const int wakes = atomic_load(&GLOBAL_Wakes);
+
+	atomic_store(&GLOBAL_StopWaking, 1);
+	Tasks.NotifyAllThreadsAddressChanged((void*)&GLOBAL_StopWaking);
+	Tasks.Wait(waker, Tasks.Forever);
+	Tasks.Dispose(waker);
+
+	const FutureState pending = FutureStates.Pending;
+
+	IsEqual(pending, state);
+	IsTrue(wakes < TEST_MAX_WAKES);
+
+	Dispose(GLOBAL_WokenFuture);
+
+	return true;
+}
+
+TEST(WhenAllAndWhenAny)
+{
+	Future futures[3] = { Create(sizeof(int)), Create(sizeof(int)), Create(sizeof(int)) };
+
+	Future all = WhenAll(futures, 3);
+	future(ulong) any = WhenAny(futures, 3);
+
+	const int value = 1;
+	Complete(futures[1], &value);
+
+	IsTrue(IsCompleted(any));
+	IsFalse(IsCompleted(all));
+
+	const ulong first = future_result(ulong, any);
+	IsEqual((ulong)1, first);
+
+	Complete(futures[0], &value);
+	Complete(futures[2], &value);
+
+	const FutureState completed = FutureStates.Completed;
+	const FutureState allState = atomic_load(&all->State);
+	IsEqual(completed, allState);
+
+	// all of them finish before a fault is reported
+	Future failing[2] = { Create(0), Create(0) };
+	Future failed = WhenAll(failing, 2);
+
+	Fault(failing[0]);
+	IsFalse(IsCompleted(failed));
+
+	Complete(failing[1], null);
+
+	const FutureState faulted = FutureStates.Faulted;
+	const FutureState failedState = atomic_load(&failed->State);
+	IsEqual(faulted, failedState);
+
+	for (int i = 0; i < 3; i++)
+	{
+		Dispose(futures[i]);
+	}
+
+	Dispose(failing[0]);
+	Dispose(failing[1]);
+	Dispose(all);
+	Dispose(any);
+	Dispose(failed);
+
+	return true;
+}
+
+#define TEST_CHAIN_COUNT 10000
+
+private bool RunChains(Future* chains, ulong count)
+{
+	for (ulong i = 0; i < count; i++)
+	{
+		Future squared = Run(Square, (void*)(size_t)(i % 100), sizeof(int), FutureSchedulers.Pool);
+
+		chains[i] = Then(squared, AddOne, null, sizeof(int), FutureSchedulers.Pool);
+
+		// the chain keeps what it needs alive
+		Dispose(squared);
+	}
+
+	Future all = WhenAll(chains, count);
+
+	const FutureState state = Wait(all, Tasks.Forever);
+
+	Dispose(all);
+
+	return state is FutureStates.Completed;
+}
+
+TEST(ChainsOnThePool)
+{
+	const bool started = Jobs.Started();
+
+	if (started is false)
+	{
+		Jobs.Start(0);
+	}
+
+	static Future chains[TEST_CHAIN_COUNT];
+
+	fprintf(__test_stream, "\t%i chains of Run, Then and one WhenAll on %i threads"NEWLINE, TEST_CHAIN_COUNT, Jobs.ThreadCount());
+	Benchmark(RunChains(chains, TEST_CHAIN_COUNT), __test_stream);
+
+	ulong wrong = 0;
+	for (ulong i = 0; i < TEST_CHAIN_COUNT; i++)
+	{
+		const int expected = (int)((i % 100) * (i % 100)) + 1;
+		wrong += future_result(int, chains[i]) isnt expected;
+		Dispose(chains[i]);
+	}
+
+	IsZero(wrong);
+
+	if (started is false)
+	{
+		Jobs.Stop();
+	}
+
+	return true;
+}
+
+TEST_SUITE(RunUnitTests,
+	APPEND_TEST(ThenChains)
+	APPEND_TEST(MainThreadContinuations)
+	APPEND_TEST(ContinuationsRunInOrder)
+	APPEND_TEST(FaultsSkipContinuations)
+	APPEND_TEST(WaitTimesOutWhileWoken)
+	APPEND_TEST(WhenAllAndWhenAny)
+	APPEND_TEST(ChainsOnThePool)
+);
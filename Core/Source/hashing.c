@@ -1,70 +1,413 @@
 #include "core/hashing.h"
 #include "core/csharp.h"
+#include "core/memory.h"
+#include "core/cunit.h"
+#include <string.h>
 
 private ulong Hash(const char* bytes);
 private ulong ChainHash(const char* bytes, const ulong previousHash);
 private ulong HashSafe(const char* bytes, ulong size);
 private ulong ChainHashSafe(const char* bytes, const ulong size, const ulong previousHash);
 private ulong ChainHashSingle(const char byte, const ulong previousHash);
+private ulong HashSeeded(const void* bytes, ulong size, ulong seed);
+private hash128 Hash128(const void* bytes, ulong size, ulong seed);
+private void Begin(HashStream* stream, ulong seed);
+private void Update(HashStream* stream, const void* bytes, ulong size);
+private ulong End(const HashStream* stream);
+private void RunUnitTests();
 
 const struct _hashingMethods Hashing = {
 	.Hash = &Hash,
 	.ChainHash = &ChainHash,
 	.HashSafe = HashSafe,
 	.ChainHashSafe = ChainHashSafe,
-	.ChainHashSingle = ChainHashSingle
+	.ChainHashSingle = ChainHashSingle,
+	.HashSeeded = HashSeeded,
+	.Hash128 = Hash128,
+	.Begin = Begin,
+	.Update = Update,
+	.End = End,
+	.RunUnitTests = RunUnitTests
 };
 
-private ulong ChainHashSingle(const char byte, const ulong previousHash)
+// odd constants with roughly half of their bits set, xored into the input so runs of zero bytes
+// still change the state
+#define HASH_SECRET0 0xa0761d6478bd642fULL
+#define HASH_SECRET1 0xe7037ed1a0b428dbULL
+#define HASH_SECRET2 0x8ebc6af09c88c6e3ULL
+#define HASH_SECRET3 0x589965cc75374cc3ULL
+
+// multiplies into 128 bits and folds the halves together, every bit of the inputs affects every bit of the result
+private ulong Mum(ulong left, ulong right)
 {
-	ulong hash = previousHash is 0 ? 5381 : previousHash;
+#ifdef _MSC_VER
+	ulong high;
+	const ulong low = _umul128(left, right, &high);
+	return low ^ high;
+#else
+	const unsigned __int128 product = (unsigned __int128)left * right;
+	return (ulong)product ^ (ulong)(product >> 64);
+#endif
+}
 
-	hash = ((hash << 5) + hash) + byte; /* hash * 33 + c */
+private ulong Read64(const byte* bytes)
+{
+	ulong value;
+	memcpy(&value, bytes, sizeof(ulong));
+	return value;
+}
 
-	return hash;
+private ulong MixBlock(ulong state, const byte* block)
+{
+	return Mum(Read64(block) ^ HASH_SECRET1, Read64(block + sizeof(ulong)) ^ state);
 }
 
-private ulong ChainHashSafe(const char* bytes, const ulong size, const ulong previousHash)
+// mixes the last incomplete block and the length into the state
+private ulong Finish(ulong state, const byte* tail, ulong tailSize, ulong length)
 {
-	// modified djb2 hash
-	/*http://www.cse.yorku.ca/~oz/hash.html*/
+	byte block[HASH_BLOCK_SIZE] = { 0 };
 
-	ulong hash = previousHash is 0 ? 5381 : previousHash;
+	memcpy(block, tail, tailSize);
 
-	for (ulong i = 0; i < size; i++)
+	return Mum(HASH_SECRET1 ^ length, Mum(Read64(block) ^ HASH_SECRET2, Read64(block + sizeof(ulong)) ^ state ^ HASH_SECRET3));
+}
+
+private ulong HashSeeded(const void* bytes, ulong size, ulong seed)
+{
+	const byte* data = bytes;
+
+	ulong state = seed ^ HASH_SECRET0;
+	ulong offset = 0;
+
+	for (; offset + HASH_BLOCK_SIZE <= size; offset += HASH_BLOCK_SIZE)
 	{
-		const int c = bytes[i];
+		state = MixBlock(state, data + offset);
+	}
+
+	return Finish(state, data + offset, size - offset, size);
+}
+
+private hash128 Hash128(const void* bytes, ulong size, ulong seed)
+{
+	const byte* data = bytes;
 
-		hash = ((hash << 5) + hash) + c; /* hash * 33 + c */
+	// two independent states that read the words of each block in opposite order
+	ulong low = seed ^ HASH_SECRET0;
+	ulong high = seed ^ HASH_SECRET3;
+	ulong offset = 0;
+
+	for (; offset + HASH_BLOCK_SIZE <= size; offset += HASH_BLOCK_SIZE)
+	{
+		const ulong first = Read64(data + offset);
+		const ulong second = Read64(data + offset + sizeof(ulong));
+
+		low = Mum(first ^ HASH_SECRET1, second ^ low);
+		high = Mum(second ^ HASH_SECRET2, first ^ high);
 	}
 
-	return hash;
+	byte block[HASH_BLOCK_SIZE] = { 0 };
+
+	memcpy(block, data + offset, size - offset);
+
+	const ulong first = Read64(block);
+	const ulong second = Read64(block + sizeof(ulong));
+
+	return (hash128) {
+		.Low = Mum(HASH_SECRET1 ^ size, Mum(first ^ HASH_SECRET2, second ^ low ^ HASH_SECRET3)),
+		.High = Mum(HASH_SECRET2 ^ size, Mum(second ^ HASH_SECRET3, first ^ high ^ HASH_SECRET0))
+	};
+}
+
+private void Begin(HashStream* stream, ulong seed)
+{
+	stream->State = seed ^ HASH_SECRET0;
+	stream->Length = 0;
+}
+
+private void Update(HashStream* stream, const void* bytes, ulong size)
+{
+	const byte* data = bytes;
+
+	ulong pending = stream->Length % HASH_BLOCK_SIZE;
+
+	stream->Length += size;
+
+	// finish the block that was left incomplete by the last update first
+	if (pending)
+	{
+		const ulong count = min(HASH_BLOCK_SIZE - pending, size);
+
+		memcpy(stream->Pending + pending, data, count);
+
+		data += count;
+		size -= count;
+		pending += count;
+
+		if (pending < HASH_BLOCK_SIZE)
+		{
+			return;
+		}
+
+		stream->State = MixBlock(stream->State, stream->Pending);
+	}
+
+	while (size >= HASH_BLOCK_SIZE)
+	{
+		stream->State = MixBlock(stream->State, data);
+
+		data += HASH_BLOCK_SIZE;
+		size -= HASH_BLOCK_SIZE;
+	}
+
+	memcpy(stream->Pending, data, size);
 }
 
+private ulong End(const HashStream* stream)
+{
+	return Finish(stream->State, stream->Pending, stream->Length % HASH_BLOCK_SIZE, stream->Length);
+}
+
+private ulong ChainHashSingle(const char byte, const ulong previousHash)
+{
+	return HashSeeded(&byte, 1, previousHash);
+}
+
+private ulong ChainHashSafe(const char* bytes, const ulong size, const ulong previousHash)
+{
+	return HashSeeded(bytes, size, previousHash);
+}
 
 private ulong HashSafe(const char* bytes, ulong size)
 {
-	return ChainHashSafe(bytes, size, 0);
+	return HashSeeded(bytes, size, 0);
 }
 
 private ulong ChainHash(const char* bytes, const ulong previousHash)
 {
-	// modified djb2 hash
-	/*http://www.cse.yorku.ca/~oz/hash.html*/
+	return HashSeeded(bytes, strlen(bytes), previousHash);
+}
+
+private ulong Hash(const char* bytes)
+{
+	return HashSeeded(bytes, strlen(bytes), 0);
+}
+
+TEST(Streaming)
+{
+	byte data[256];
+
+	for (ulong i = 0; i < sizeof(data); i++)
+	{
+		data[i] = (byte)(i * 31);
+	}
+
+	// every way of splitting the bytes into two updates has to agree with hashing them at once
+	for (ulong size = 0; size <= sizeof(data); size += 7)
+	{
+		const ulong expected = HashSeeded(data, size, 42);
 
-	ulong hash = previousHash is 0 ? 5381 : previousHash;
+		for (ulong split = 0; split <= size; split += 3)
+		{
+			HashStream stream;
 
-	int c;
+			Begin(&stream, 42);
+			Update(&stream, data, split);
+			Update(&stream, data + split, size - split);
+
+			IsEqual(expected, End(&stream));
+		}
+	}
+
+	// one byte at a time
+	HashStream stream;
+	Begin(&stream, 0);
+
+	for (ulong i = 0; i < sizeof(data); i++)
+	{
+		Update(&stream, data + i, 1);
+	}
 
-#pragma warning (disable : 4706)
-	while (c = *bytes++)
-		hash = ((hash << 5) + hash) + c; /* hash * 33 + c */
-#pragma warning (default : 4706)
+	IsEqual(HashSafe((char*)data, sizeof(data)), End(&stream));
+
+	return true;
+}
+
+TEST(Seeding)
+{
+	const char* path = "assets/materials/default.material";
+
+	IsEqual(Hash(path), HashSafe(path, strlen(path)));
+	IsEqual(Hash(path), ChainHash(path, 0));
+
+	IsTrue(HashSeeded(path, strlen(path), 1) != HashSeeded(path, strlen(path), 2));
+
+	// chaining depends on the order of the pieces
+	IsTrue(ChainHash("b", Hash("a")) != ChainHash("a", Hash("b")));
+
+	// trailing zeros change the length so they change the hash
+	const byte zeros[4] = { 0 };
+	IsTrue(HashSafe((char*)zeros, 3) != HashSafe((char*)zeros, 4));
+
+	const hash128 wide = Hash128(path, strlen(path), 0);
+	const hash128 same = Hash128(path, strlen(path), 0);
+	const hash128 other = Hash128(path, strlen(path) - 1, 0);
+
+	IsTrue(wide.Low == same.Low and wide.High == same.High);
+	IsTrue(wide.Low != other.Low and wide.High != other.High);
+	IsTrue(wide.Low != wide.High);
+
+	return true;
+}
+
+// the hash this module used before, kept to compare against
+private ulong Djb2(const byte* bytes, ulong size)
+{
+	ulong hash = 5381;
+
+	for (ulong i = 0; i < size; i++)
+	{
+		hash = ((hash << 5) + hash) + (char)bytes[i];
+	}
 
 	return hash;
 }
 
-private ulong Hash(const char* bytes)
+#define BENCHMARK_TOTAL_BYTES (256ULL * 1024 * 1024)
+
+private void BenchmarkSize(FILE* stream, const byte* data, ulong size)
+{
+	const ulong iterations = max(BENCHMARK_TOTAL_BYTES / size, 1);
+
+	ulong sink = 0;
+
+	ulong start = __rdtsc();
+
+	for (ulong i = 0; i < iterations; i++)
+	{
+		sink += HashSeeded(data, size, i);
+	}
+
+	const double hashCycles = (double)(__rdtsc() - start);
+
+	start = __rdtsc();
+
+	for (ulong i = 0; i < iterations; i++)
+	{
+		sink += Djb2(data + (i & 1), size - (i & 1));
+	}
+
+	const double djb2Cycles = (double)(__rdtsc() - start);
+
+	const double bytes = (double)size * iterations;
+
+	fprintf(stream, "\t%lli bytes, hash %.2f bytes/cycle djb2 %.2f bytes/cycle [%llx]"NEWLINE, size, bytes / hashCycles, bytes / djb2Cycles, sink & 0xF);
+}
+
+TEST(ThroughputBenchmark)
 {
-	return ChainHash(bytes, 0);
-}
\ No newline at end of file
+	const ulong largest = 16 * 1024 * 1024;
+
+	byte* data = Memory.Alloc(largest, Memory.GenericMemoryBlock);
+
+	for (ulong i = 0; i < largest; i++)
+	{
+		data[i] = (byte)(i * 131);
+	}
+
+	BenchmarkSize(__test_stream, data, 16);
+	BenchmarkSize(__test_stream, data, 256);
+	BenchmarkSize(__test_stream, data, 64 * 1024);
+	BenchmarkSize(__test_stream, data, largest);
+
+	Memory.Free(data, Memory.GenericMemoryBlock);
+
+	return true;
+}
+
+#define COLLISION_TABLE_SIZE 1024
+
+// the number of paths that land in a slot that's already taken, the way the fixed size tables index with hash % size
+private ulong CountSlotCollisions(const ulong* hashes, ulong count)
+{
+	ulong slots[COLLISION_TABLE_SIZE] = { 0 };
+	ulong collisions = 0;
+
+	for (ulong i = 0; i < count; i++)
+	{
+		collisions += slots[hashes[i] % COLLISION_TABLE_SIZE]++ isnt 0;
+	}
+
+	return collisions;
+}
+
+TEST(AssetPathCollisions)
+{
+	static const char* directories[] = { "assets/materials/", "assets/shaders/", "assets/textures/", "assets/models/", "assets/fonts/" };
+	static const char* names[] = { "default", "cube", "shadow", "debug_cubeDepthMap", "skybox", "mountain", "outline", "text", "uv", "marble" };
+	static const char* extensions[] = { ".material", ".vertex", ".fragment", ".png", ".obj" };
+
+	const ulong directoryCount = sizeof(directories) / sizeof(char*);
+	const ulong nameCount = sizeof(names) / sizeof(char*);
+	const ulong extensionCount = sizeof(extensions) / sizeof(char*);
+	const ulong variants = 10;
+	const ulong count = directoryCount * nameCount * extensionCount * variants;
+
+	ulong* hashes = Memory.Alloc(sizeof(ulong) * count, Memory.GenericMemoryBlock);
+	ulong* djb2Hashes = Memory.Alloc(sizeof(ulong) * count, Memory.GenericMemoryBlock);
+
+	char path[_MAX_PATH];
+	ulong index = 0;
+
+	// paths that only differ by a character or two, like the engine's numbered and suffixed assets
+	for (ulong directory = 0; directory < directoryCount; directory++)
+	{
+		for (ulong name = 0; name < nameCount; name++)
+		{
+			for (ulong extension = 0; extension < extensionCount; extension++)
+			{
+				for (ulong variant = 0; variant < variants; variant++)
+				{
+					const int length = sprintf_s(path, _MAX_PATH, "%s%s%lli%s", directories[directory], names[name], variant, extensions[extension]);
+
+					hashes[index] = HashSafe(path, length);
+					djb2Hashes[index] = Djb2((byte*)path, length);
+
+					++index;
+				}
+			}
+		}
+	}
+
+	ulong fullCollisions = 0;
+
+	for (ulong i = 0; i < count; i++)
+	{
+		for (ulong j = i + 1; j < count; j++)
+		{
+			fullCollisions += hashes[i] == hashes[j];
+		}
+	}
+
+	const ulong slotCollisions = CountSlotCollisions(hashes, count);
+	const ulong djb2SlotCollisions = CountSlotCollisions(djb2Hashes, count);
+
+	// a uniform hash puts count - slots * (1 - (1 - 1/slots)^count) paths into taken slots
+	fprintf(__test_stream, "\t%lli paths in %i slots, hash %lli collisions (%.1f%%) djb2 %lli collisions (%.1f%%)"NEWLINE,
+		count, COLLISION_TABLE_SIZE,
+		slotCollisions, 100.0 * slotCollisions / count,
+		djb2SlotCollisions, 100.0 * djb2SlotCollisions / count);
+
+	IsEqual((ulong)0, fullCollisions);
+
+	Memory.Free(hashes, Memory.GenericMemoryBlock);
+	Memory.Free(djb2Hashes, Memory.GenericMemoryBlock);
+
+	return true;
+}
+
+TEST_SUITE(RunUnitTests,
+	APPEND_TEST(Streaming)
+	APPEND_TEST(Seeding)
+	APPEND_TEST(ThroughputBenchmark)
+	APPEND_TEST(AssetPathCollisions)
+);
@@ -1,4 +1,5 @@
 #include "core/math/ints.h"
+#include "core/parsing.h"
 
 static bool TryDeserialize(const char* buffer, ulong bufferLength, ulong* out_value);
 static void Serialize(File stream, ulong value);
@@ -8,14 +9,18 @@ const struct _intMethods Ints = {
 	.Serialize = &Serialize
 };
 
-#pragma warning(disable: 4100) // disable warning for unused bufferLength
 static bool TryDeserialize(const char* buffer, ulong bufferLength, ulong* out_value)
 {
-	int count = sscanf_s(buffer, "%lli", out_value);
+	long long value;
+	if (Parsing.TryGetInt(buffer, bufferLength, &value) is false)
+	{
+		return false;
+	}
 
-	return count == 1;
+	*out_value = (ulong)value;
+
+	return true;
 }
-#pragma warning(default: 4100)
 
 static void Serialize(File stream, ulong value)
 {
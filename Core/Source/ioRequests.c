@@ -0,0 +1,512 @@
+#include "core/ioRequests.h"
+#include "core/memory.h"
+#include "core/file.h"
+#include "core/tasks.h"
+#include "core/atomic.h"
+#include "core/cunit.h"
+#include <string.h>
+
+private IORequest Read(const string path, IOCompletion onCompleted, void* state);
+private IORequest ReadRange(const string path, ulong offset, ulong length, IOCompletion onCompleted, void* state);
+private bool IsCompleted(IORequest);
+private IOStatus Wait(IORequest, ulong milliseconds);
+private ulong Update(void);
+private void Dispose(IORequest);
+private void Start(int threadCount);
+private void Shutdown(void);
+private void RunUnitTests();
+
+const struct _ioRequestMethods IORequests = {
+	.Read = Read,
+	.ReadRange = ReadRange,
+	.IsCompleted = IsCompleted,
+	.Wait = Wait,
+	.Update = Update,
+	.Dispose = Dispose,
+	.Start = Start,
+	.Shutdown = Shutdown,
+	.RunUnitTests = RunUnitTests
+};
+
+// the longest an idle io thread sleeps before checking the queue again, bounds how long a
+// wake up that races with the thread going to sleep can delay a request
+#define IO_IDLE_MILLISECONDS 10
+// the time Wait sleeps between checking a request, for the same reason
+#define IO_WAIT_SLICE_MILLISECONDS 1
+
+// requests waiting for an io thread, oldest first
+static locker GLOBAL_IOQueueLock;
+static IORequest GLOBAL_IOQueueHead = null;
+static IORequest GLOBAL_IOQueueTail = null;
+// incremented every time a request is queued, idle io threads wait for it to change
+static volatile long GLOBAL_IOQueuedCount = 0;
+
+// requests with a completion that finished since the last update, newest first
+static IORequest volatile GLOBAL_IOCompleted = null;
+
+static volatile long GLOBAL_IOStarted = 0;
+static volatile long GLOBAL_IORunningThreads = 0;
+static volatile bool GLOBAL_IOExitFlag = false;
+static array(Task) GLOBAL_IOThreads = null;
+
+DEFINE_TYPE_ID(IORequest);
+
+private IORequest PopLocked(void)
+{
+	IORequest request = GLOBAL_IOQueueHead;
+
+	if (request isnt null)
+	{
+		GLOBAL_IOQueueHead = request->Next;
+
+		if (GLOBAL_IOQueueHead is null)
+		{
+			GLOBAL_IOQueueTail = null;
+		}
+
+		request->Next = null;
+	}
+
+	return request;
+}
+
+private void PushLocked(IORequest request)
+{
+	if (GLOBAL_IOQueueTail is null)
+	{
+		GLOBAL_IOQueueHead = request;
+	}
+	else
+	{
+		GLOBAL_IOQueueTail->Next = request;
+	}
+
+	GLOBAL_IOQueueTail = request;
+}
+
+// reads the requested bytes, the equivalent of a pread using the standard file api so it works on every platform
+private bool TryReadRequest(IORequest request)
+{
+	File file;
+
+	if (Files.TryOpen(request->Path, FileModes.ReadBinary, &file) is false)
+	{
+		return false;
+	}
+
+	const ulong size = Files.GetFileSize(file);
+	const ulong offset = min(request->Offset, size);
+	const ulong length = request->Length is 0 ? size - offset : min(request->Length, size - offset);
+
+	string data = strings.Create(length + 1);
+
+	bool success = _fseeki64(file, offset, SEEK_SET) is 0;
+
+	while (success and data->Count < length)
+	{
+		const ulong read = fread(data->Values + data->Count, sizeof(byte), length - data->Count, file);
+
+		data->Count += read;
+
+		if (read is 0)
+		{
+			success = ferror(file) is 0;
+			break;
+		}
+	}
+
+	success &= Files.TryClose(file);
+
+	if (success is false)
+	{
+		strings.Dispose(data);
+		return false;
+	}
+
+	unsafe_at(data, data->Count) = '\0';
+
+	request->Data = data;
+
+	return true;
+}
+
+private void Complete(IORequest request, bool success)
+{
+	// requests without a completion are owned by whoever waits on them, so the status has to be the last thing written
+	// requests with a completion are disposed by Update as soon as they're queued, so queueing has to be the last access
+	const IOCompletion onCompleted = request->OnCompleted;
+
+	atomic_store(&request->Status, success ? IOStatuses.Completed : IOStatuses.Failed);
+
+	if (onCompleted is null)
+	{
+		Tasks.NotifyAllThreadsAddressChanged((void*)&request->Status);
+		return;
+	}
+
+	// nothing waits on requests with a completion, Dispose refuses them
+	IORequest head;
+	do
+	{
+		head = GLOBAL_IOCompleted;
+		request->Next = head;
+	} while (_InterlockedCompareExchangePointer((void* volatile*)&GLOBAL_IOCompleted, request, head) isnt head);
+}
+
+private int IOThread(void* state)
+{
+	ignore_unused(state);
+
+	while (true)
+	{
+		IORequest request;
+
+		lock(GLOBAL_IOQueueLock,
+			request = PopLocked();
+		);
+
+		if (request is null)
+		{
+			// only exit once every queued request is read
+			if (GLOBAL_IOExitFlag)
+			{
+				break;
+			}
+
+			Tasks.WaitOnAddress(&GLOBAL_IOQueuedCount, sizeof(long), IO_IDLE_MILLISECONDS);
+
+			continue;
+		}
+
+		Complete(request, TryReadRequest(request));
+	}
+
+	_InterlockedDecrement(&GLOBAL_IORunningThreads);
+	Tasks.NotifyAllThreadsAddressChanged((void*)&GLOBAL_IORunningThreads);
+
+	return 0;
+}
+
+private void Start(int threadCount)
+{
+	if (_InterlockedCompareExchange(&GLOBAL_IOStarted, 1, 0) isnt 0)
+	{
+		return;
+	}
+
+	GLOBAL_IOExitFlag = false;
+
+	threadCount = max(threadCount, 1);
+
+	GLOBAL_IOThreads = arrays(Task).Create(threadCount);
+
+	for (int i = 0; i < threadCount; i++)
+	{
+		_InterlockedIncrement(&GLOBAL_IORunningThreads);
+
+		// io threads live until shutdown like the runtime's workers
+		arrays(Task).Append(GLOBAL_IOThreads, Tasks.Run(Tasks.Create(IOThread), null));
+	}
+}
+
+private void Shutdown(void)
+{
+	if (GLOBAL_IOStarted is 0)
+	{
+		return;
+	}
+
+	GLOBAL_IOExitFlag = true;
+	Tasks.NotifyAllThreadsAddressChanged((void*)&GLOBAL_IOQueuedCount);
+
+	while (GLOBAL_IORunningThreads > 0)
+	{
+		Tasks.WaitOnAddress(&GLOBAL_IORunningThreads, sizeof(long), IO_WAIT_SLICE_MILLISECONDS);
+	}
+
+	Tasks.WaitAll(GLOBAL_IOThreads, Tasks.Forever);
+
+	for (ulong i = 0; i < GLOBAL_IOThreads->Count; i++)
+	{
+		Tasks.Dispose(at(GLOBAL_IOThreads, i));
+	}
+
+	arrays(Task).Dispose(GLOBAL_IOThreads);
+	GLOBAL_IOThreads = null;
+
+	GLOBAL_IOStarted = 0;
+}
+
+private IORequest ReadRange(const string path, ulong offset, ulong length, IOCompletion onCompleted, void* state)
+{
+	if (path is null or path->Count is 0)
+	{
+		throw(InvalidArgumentException);
+	}
+
+	REGISTER_TYPE(IORequest);
+
+	Start(IO_DEFAULT_THREAD_COUNT);
+
+	IORequest request = Memory.Alloc(sizeof(struct _ioRequest), IORequestTypeId);
+
+	// copied so the caller's path can be disposed while the request is queued
+	request->Path = strings.Create(path->Count + 1);
+	strings.AppendArray(request->Path, path);
+
+	request->Offset = offset;
+	request->Length = length;
+	request->Data = null;
+	atomic_init(&request->Status, IOStatuses.Pending);
+	request->OnCompleted = onCompleted;
+	request->State = state;
+	request->Next = null;
+
+	lock(GLOBAL_IOQueueLock,
+		PushLocked(request);
+	);
+
+	_InterlockedIncrement(&GLOBAL_IOQueuedCount);
+	Tasks.NotifyAddressChanged((void*)&GLOBAL_IOQueuedCount);
+
+	return request;
+}
+
+private IORequest Read(const string path, IOCompletion onCompleted, void* state)
+{
+	return ReadRange(path, 0, 0, onCompleted, state);
+}
+
+private bool IsCompleted(IORequest request)
+{
+	return atomic_load(&request->Status) isnt IOStatuses.Pending;
+}
+
+private IOStatus Wait(IORequest request, ulong milliseconds)
+{
+	// the deadline is measured against the clock, spurious and early wake ups don't use up the timeout
+	const IOStatus pending = IOStatuses.Pending;
+	const ulong deadline = Tasks.DeadlineAfter(milliseconds);
+
+	while (atomic_load(&request->Status) is pending)
+	{
+		if (Tasks.WaitUntil((volatile void*)&request->Status, &pending, sizeof(IOStatus), deadline) is false)
+		{
+			break;
+		}
+	}
+
+	return atomic_load(&request->Status);
+}
+
+private void DisposeRequest(IORequest request)
+{
+	strings.Dispose(request->Path);
+
+	if (request->Data isnt null)
+	{
+		strings.Dispose(request->Data);
+	}
+
+	Memory.Free(request, IORequestTypeId);
+}
+
+private void Dispose(IORequest request)
+{
+	if (request is null)
+	{
+		return;
+	}
+
+	// pending requests are still being read, and requests with a completion are disposed by Update
+	if (atomic_load(&request->Status) is IOStatuses.Pending or request->OnCompleted isnt null)
+	{
+		throw(InvalidLogicException);
+	}
+
+	DisposeRequest(request);
+}
+
+private ulong Update(void)
+{
+	IORequest completed = _InterlockedExchangePointer((void* volatile*)&GLOBAL_IOCompleted, null);
+
+	// the list is newest first, reverse it so completions are called in the order the requests finished
+	IORequest ordered = null;
+	while (completed isnt null)
+	{
+		IORequest next = completed->Next;
+		completed->Next = ordered;
+		ordered = completed;
+		completed = next;
+	}
+
+	ulong count = 0;
+	while (ordered isnt null)
+	{
+		IORequest next = ordered->Next;
+
+		ordered->OnCompleted(ordered, ordered->State);
+
+		DisposeRequest(ordered);
+
+		ordered = next;
+		++count;
+	}
+
+	return count;
+}
+
+#define TEST_FILE_PATH "io_requests_test.bin"
+#define TEST_FILE_SIZE (64 * 1024 + 3)
+
+private string WriteTestFile(void)
+{
+	string data = strings.Create(TEST_FILE_SIZE);
+
+	for (ulong i = 0; i < TEST_FILE_SIZE; i++)
+	{
+		strings.Append(data, (byte)(i * 7));
+	}
+
+	Files.WriteAll(stack_string(TEST_FILE_PATH), data);
+
+	return data;
+}
+
+TEST(ReadAndWait)
+{
+	string data = WriteTestFile();
+
+	IORequest request = Read(stack_string(TEST_FILE_PATH), null, null);
+
+	const IOStatus completed = IOStatuses.Completed;
+	IsEqual(completed, Wait(request, Tasks.Forever));
+	IsTrue(IsCompleted(request));
+	IsTrue(strings.Equals(data, request->Data));
+
+	Dispose(request);
+
+	// ranges past the end of the file are cut short
+	request = ReadRange(stack_string(TEST_FILE_PATH), TEST_FILE_SIZE - 10, 100, null, null);
+
+	IsEqual(completed, Wait(request, Tasks.Forever));
+	IsTrue(request->Data->Count is 10);
+	IsTrue(memcmp(request->Data->Values, data->Values + TEST_FILE_SIZE - 10, 10) is 0);
+
+	Dispose(request);
+
+	request = Read(stack_string("io_requests_missing.bin"), null, null);
+
+	const IOStatus failed = IOStatuses.Failed;
+	IsEqual(failed, Wait(request, Tasks.Forever));
+	IsNull(request->Data);
+
+	Dispose(request);
+
+	strings.Dispose(data);
+
+	remove(TEST_FILE_PATH);
+
+	return true;
+}
+
+struct _completionCounts {
+	volatile long Called;
+	ulong Bytes;
+	bool OnCallingThread;
+	int ThreadId;
+};
+
+private void CountCompletion(IORequest request, void* state)
+{
+	struct _completionCounts* counts = state;
+
+	++(counts->Called);
+	counts->Bytes += request->Data isnt null ? request->Data->Count : 0;
+	counts->OnCallingThread &= Tasks.ThreadId() is counts->ThreadId;
+}
+
+TEST(CompletionsRunOnUpdate)
+{
+	string data = WriteTestFile();
+
+	struct _completionCounts counts = {
+		.Called = 0,
+		.Bytes = 0,
+		.OnCallingThread = true,
+		.ThreadId = Tasks.ThreadId()
+	};
+
+	const ulong requestCount = 64;
+
+	for (ulong i = 0; i < requestCount; i++)
+	{
+		ReadRange(stack_string(TEST_FILE_PATH), i * 1024, 1024, CountCompletion, &counts);
+	}
+
+	ulong updated = 0;
+	while (updated < requestCount)
+	{
+		updated += Update();
+	}
+
+	const ulong expectedBytes = requestCount * 1024;
+	IsEqual(requestCount, (ulong)counts.Called);
+	IsEqual(expectedBytes, counts.Bytes);
+	IsTrue(counts.OnCallingThread);
+
+	strings.Dispose(data);
+
+	remove(TEST_FILE_PATH);
+
+	return true;
+}
+
+TEST(CompletionRunsOnce)
+{
+	string data = WriteTestFile();
+
+	struct _completionCounts counts = {
+		.Called = 0,
+		.Bytes = 0,
+		.OnCallingThread = true,
+		.ThreadId = Tasks.ThreadId()
+	};
+
+	ReadRange(stack_string(TEST_FILE_PATH), 0, 1024, CountCompletion, &counts);
+
+	ulong updated = 0;
+	while (updated is 0)
+	{
+		updated = Update();
+	}
+
+	const ulong once = 1;
+	IsEqual(once, updated);
+	IsEqual(once, (ulong)counts.Called);
+
+	// the request was disposed by the update that completed it, it's never queued again
+	ulong later = 0;
+	for (int i = 0; i < 16; i++)
+	{
+		Tasks.WaitOnAddress(&counts.Called, sizeof(long), IO_WAIT_SLICE_MILLISECONDS);
+		later += Update();
+	}
+
+	IsZero(later);
+	IsEqual(once, (ulong)counts.Called);
+	IsTrue(counts.OnCallingThread);
+
+	strings.Dispose(data);
+
+	remove(TEST_FILE_PATH);
+
+	return true;
+}
+
+TEST_SUITE(RunUnitTests,
+	APPEND_TEST(ReadAndWait)
+	APPEND_TEST(CompletionsRunOnUpdate)
+	APPEND_TEST(CompletionRunsOnce)
+);
@@ -0,0 +1,699 @@
+#include "core/jobs.h"
+#include "core/tasks.h"
+#include "core/os.h"
+#include "core/atomic.h"
+#include "core/memory.h"
+#include "core/cunit.h"
+#include <string.h>
+
+#if defined(_M_X64) || defined(_M_AMD64) || defined(__x86_64__)
+#include <immintrin.h>
+// tells the core the thread is spinning so it doesn't starve its hyperthread
+#define SpinPause() _mm_pause()
+#else
+#define SpinPause()
+#endif
+
+private void Start(int threadCount);
+private void Stop(void);
+private void Run(JobMethod method, void* state, JobCounter* counter);
+private void Wait(JobCounter* counter);
+private bool TryRunOne(void);
+private bool Started(void);
+private int ThreadCount(void);
+private void RunUnitTests(void);
+
+const struct _jobMethods Jobs = {
+	.Start = Start,
+	.Stop = Stop,
+	.Run = Run,
+	.Wait = Wait,
+	.TryRunOne = TryRunOne,
+	.Started = Started,
+	.ThreadCount = ThreadCount,
+	.RunUnitTests = RunUnitTests
+};
+
+#define QUEUE_MASK (JOBS_QUEUE_CAPACITY - 1)
+#define CACHE_LINE_SIZE 64
+
+typedef struct {
+	JobMethod Method;
+	void* State;
+	JobCounter* Counter;
+} Job;
+
+// the slots of a queue are read by thieves while the owner may be writing them, thieves throw away what they read
+// when they lose the race so the fields only have to be loaded and stored atomically, relaxed is a plain move
+typedef struct {
+	_Atomic(JobMethod) Method;
+	_Atomic(void*) State;
+	_Atomic(JobCounter*) Counter;
+} JobSlot;
+
+// a Chase-Lev deque, the thread that owns it pushes and pops jobs at the bottom while any other thread
+// steals the oldest job from the top
+struct _jobQueue {
+	_Atomic(long long) Top;
+	byte TopPadding[CACHE_LINE_SIZE - sizeof(long long)];
+	_Atomic(long long) Bottom;
+	byte BottomPadding[CACHE_LINE_SIZE - sizeof(long long)];
+	JobSlot Jobs[JOBS_QUEUE_CAPACITY];
+};
+
+// jobs queued by threads that don't run jobs, such as IO threads
+static struct {
+	locker Lock;
+	_Atomic(long long) Count;
+	ulong Head;
+	Job Jobs[JOBS_QUEUE_CAPACITY];
+} GLOBAL_SharedQueue;
+
+static struct _jobQueue* GLOBAL_JobQueues;
+static int GLOBAL_JobThreadCount;
+static array(Task) GLOBAL_JobWorkers;
+static _Atomic(bool) GLOBAL_JobsRunning;
+
+// incremented to wake sleeping workers when there's new work, workers sleep on it
+static _Atomic(long long) GLOBAL_JobsEpoch;
+static _Atomic(long long) GLOBAL_SleepingWorkers;
+
+// the queue the current thread owns, null for threads that don't run jobs
+static _Thread_local struct _jobQueue* GLOBAL_CurrentJobQueue;
+// the queue the current thread steals from first, spreads thieves out over the queues
+static _Thread_local int GLOBAL_NextVictim;
+
+private void StoreJob(JobSlot* slot, const Job* job)
+{
+	atomic_store_explicit(&slot->Method, job->Method, memory_order_relaxed);
+	atomic_store_explicit(&slot->State, job->State, memory_order_relaxed);
+	atomic_store_explicit(&slot->Counter, job->Counter, memory_order_relaxed);
+}
+
+private void LoadJob(JobSlot* slot, Job* out_job)
+{
+	out_job->Method = atomic_load_explicit(&slot->Method, memory_order_relaxed);
+	out_job->State = atomic_load_explicit(&slot->State, memory_order_relaxed);
+	out_job->Counter = atomic_load_explicit(&slot->Counter, memory_order_relaxed);
+}
+
+private bool TryPush(struct _jobQueue* queue, const Job* job)
+{
+	const long long bottom = atomic_load_explicit(&queue->Bottom, memory_order_relaxed);
+	const long long top = atomic_load_explicit(&queue->Top, memory_order_acquire);
+
+	if (bottom - top >= JOBS_QUEUE_CAPACITY)
+	{
+		return false;
+	}
+
+	StoreJob(queue->Jobs + (bottom & QUEUE_MASK), job);
+
+	atomic_store_explicit(&queue->Bottom, bottom + 1, memory_order_release);
+
+	return true;
+}
+
+// only the thread that owns the queue may pop from it, it gets the newest job
+private bool TryPop(struct _jobQueue* queue, Job* out_job)
+{
+	const long long bottom = atomic_load_explicit(&queue->Bottom, memory_order_relaxed) - 1;
+
+	atomic_store_explicit(&queue->Bottom, bottom, memory_order_relaxed);
+
+	atomic_thread_fence(memory_order_seq_cst);
+
+	long long top = atomic_load_explicit(&queue->Top, memory_order_relaxed);
+
+	if (top > bottom)
+	{
+		// empty
+		atomic_store_explicit(&queue->Bottom, bottom + 1, memory_order_relaxed);
+		return false;
+	}
+
+	LoadJob(queue->Jobs + (bottom & QUEUE_MASK), out_job);
+
+	if (top isnt bottom)
+	{
+		return true;
+	}
+
+	// the last job may be stolen at the same time, whoever moves the top first gets it
+	const bool won = atomic_compare_exchange_strong_explicit(&queue->Top, &top, top + 1, memory_order_seq_cst, memory_order_relaxed);
+
+	atomic_store_explicit(&queue->Bottom, bottom + 1, memory_order_relaxed);
+
+	return won;
+}
+
+// any thread may steal from a queue, it gets the oldest job
+private bool TrySteal(struct _jobQueue* queue, Job* out_job)
+{
+	long long top = atomic_load_explicit(&queue->Top, memory_order_acquire);
+
+	atomic_thread_fence(memory_order_seq_cst);
+
+	const long long bottom = atomic_load_explicit(&queue->Bottom, memory_order_acquire);
+
+	if (top >= bottom)
+	{
+		return false;
+	}
+
+	// the owner never overwrites this job until the top moves past it, if another thread moved it first the copy is discarded
+	LoadJob(queue->Jobs + (top & QUEUE_MASK), out_job);
+
+	return atomic_compare_exchange_strong_explicit(&queue->Top, &top, top + 1, memory_order_seq_cst, memory_order_relaxed);
+}
+
+private bool TryPushShared(const Job* job)
+{
+	bool pushed = false;
+
+	lock(GLOBAL_SharedQueue.Lock,
+		const long long count = atomic_load_explicit(&GLOBAL_SharedQueue.Count, memory_order_relaxed);
+		if (count < JOBS_QUEUE_CAPACITY)
+		{
+			GLOBAL_SharedQueue.Jobs[(GLOBAL_SharedQueue.Head + count) & QUEUE_MASK] = *job;
+			atomic_store_explicit(&GLOBAL_SharedQueue.Count, count + 1, memory_order_release);
+			pushed = true;
+		}
+	);
+
+	return pushed;
+}
+
+private bool TryTakeShared(Job* out_job)
+{
+	// most of the time nothing is queued here so avoid the lock
+	if (atomic_load_explicit(&GLOBAL_SharedQueue.Count, memory_order_acquire) is 0)
+	{
+		return false;
+	}
+
+	bool taken = false;
+
+	lock(GLOBAL_SharedQueue.Lock,
+		const long long count = atomic_load_explicit(&GLOBAL_SharedQueue.Count, memory_order_relaxed);
+		if (count > 0)
+		{
+			*out_job = GLOBAL_SharedQueue.Jobs[GLOBAL_SharedQueue.Head & QUEUE_MASK];
+			GLOBAL_SharedQueue.Head++;
+			atomic_store_explicit(&GLOBAL_SharedQueue.Count, count - 1, memory_order_relaxed);
+			taken = true;
+		}
+	);
+
+	return taken;
+}
+
+// looks for a job in the thread's own queue, then the shared queue, then every other thread's queue
+private bool TryGetJob(Job* out_job)
+{
+	struct _jobQueue* queue = GLOBAL_CurrentJobQueue;
+
+	if (queue isnt null and TryPop(queue, out_job))
+	{
+		return true;
+	}
+
+	if (TryTakeShared(out_job))
+	{
+		return true;
+	}
+
+	const int count = GLOBAL_JobThreadCount;
+
+	for (int i = 0; i < count; i++)
+	{
+		const int victim = (GLOBAL_NextVictim + i) % count;
+
+		if (GLOBAL_JobQueues + victim is queue)
+		{
+			continue;
+		}
+
+		if (TrySteal(GLOBAL_JobQueues + victim, out_job))
+		{
+			// the queue that had work probably has more
+			GLOBAL_NextVictim = victim;
+			return true;
+		}
+	}
+
+	return false;
+}
+
+private void Execute(const Job* job)
+{
+	job->Method(job->State);
+
+	JobCounter* counter = job->Counter;
+
+	if (counter isnt null and atomic_fetch_sub_explicit(&counter->Remaining, 1, memory_order_acq_rel) is 1)
+	{
+		// the waiting thread may have gone to sleep
+		Tasks.NotifyAllThreadsAddressChanged((void*)&counter->Remaining);
+	}
+}
+
+private void WakeWorker(void)
+{
+	// the job has to be visible before the sleeping workers are counted, a worker counts itself
+	// as sleeping before it looks for work one last time
+	atomic_thread_fence(memory_order_seq_cst);
+
+	if (atomic_load_explicit(&GLOBAL_SleepingWorkers, memory_order_relaxed) > 0)
+	{
+		atomic_fetch_add_explicit(&GLOBAL_JobsEpoch, 1, memory_order_seq_cst);
+		Tasks.NotifyAddressChanged((void*)&GLOBAL_JobsEpoch);
+	}
+}
+
+private int WorkerMain(void* state)
+{
+	GLOBAL_CurrentJobQueue = state;
+	GLOBAL_NextVictim = (int)(GLOBAL_CurrentJobQueue - GLOBAL_JobQueues) + 1;
+
+	Job job;
+	int spins = 0;
+
+	while (true)
+	{
+		if (TryGetJob(&job))
+		{
+			Execute(&job);
+			spins = 0;
+			continue;
+		}
+
+		// workers only exit once there's nothing left to run
+		if (atomic_load_explicit(&GLOBAL_JobsRunning, memory_order_acquire) is false)
+		{
+			break;
+		}
+
+		if (++spins < JOBS_SPIN_COUNT)
+		{
+			SpinPause();
+			continue;
+		}
+
+		long long epoch = atomic_load_explicit(&GLOBAL_JobsEpoch, memory_order_seq_cst);
+
+		atomic_fetch_add_explicit(&GLOBAL_SleepingWorkers, 1, memory_order_seq_cst);
+
+		// a job queued before this worker counted itself as sleeping wouldn't have woken it
+		if (TryGetJob(&job))
+		{
+			atomic_fetch_sub_explicit(&GLOBAL_SleepingWorkers, 1, memory_order_seq_cst);
+			Execute(&job);
+			spins = 0;
+			continue;
+		}
+
+		if (atomic_load_explicit(&GLOBAL_JobsRunning, memory_order_acquire))
+		{
+			Tasks.WaitWhileEqual((void*)&GLOBAL_JobsEpoch, &epoch, sizeof(long long), Tasks.Forever);
+		}
+
+		atomic_fetch_sub_explicit(&GLOBAL_SleepingWorkers, 1, memory_order_seq_cst);
+
+		spins = 0;
+	}
+
+	GLOBAL_CurrentJobQueue = null;
+
+	return 0;
+}
+
+private void Start(int threadCount)
+{
+	if (atomic_load(&GLOBAL_JobsRunning))
+	{
+		return;
+	}
+
+	if (threadCount <= 0)
+	{
+		threadCount = OperatingSystem.ThreadCount();
+	}
+
+	threadCount = max(1, min(threadCount, JOBS_MAX_THREADS));
+
+	GLOBAL_JobQueues = Memory.Alloc(sizeof(struct _jobQueue) * threadCount, Memory.GenericMemoryBlock);
+
+	for (int i = 0; i < threadCount; i++)
+	{
+		atomic_init(&GLOBAL_JobQueues[i].Top, 0);
+		atomic_init(&GLOBAL_JobQueues[i].Bottom, 0);
+	}
+
+	GLOBAL_JobThreadCount = threadCount;
+
+	// the starting thread owns the first queue
+	GLOBAL_CurrentJobQueue = GLOBAL_JobQueues;
+	GLOBAL_NextVictim = 1;
+
+	atomic_store(&GLOBAL_JobsRunning, true);
+
+	GLOBAL_JobWorkers = arrays(Task).Create(threadCount);
+
+	for (int i = 1; i < threadCount; i++)
+	{
+		arrays(Task).Append(GLOBAL_JobWorkers, Tasks.Run(Tasks.Create(WorkerMain), GLOBAL_JobQueues + i));
+	}
+}
+
+private void Stop(void)
+{
+	if (atomic_load(&GLOBAL_JobsRunning) is false)
+	{
+		return;
+	}
+
+	// run what the workers haven't gotten to yet
+	Job job;
+	while (TryGetJob(&job))
+	{
+		Execute(&job);
+	}
+
+	atomic_store(&GLOBAL_JobsRunning, false);
+
+	atomic_fetch_add(&GLOBAL_JobsEpoch, 1);
+	Tasks.NotifyAllThreadsAddressChanged((void*)&GLOBAL_JobsEpoch);
+
+	Tasks.WaitAll(GLOBAL_JobWorkers, Tasks.Forever);
+
+	for (ulong i = 0; i < GLOBAL_JobWorkers->Count; i++)
+	{
+		Tasks.Dispose(at(GLOBAL_JobWorkers, i));
+	}
+
+	arrays(Task).Dispose(GLOBAL_JobWorkers);
+	GLOBAL_JobWorkers = null;
+
+	GLOBAL_CurrentJobQueue = null;
+	GLOBAL_JobThreadCount = 0;
+
+	Memory.Free(GLOBAL_JobQueues, Memory.GenericMemoryBlock);
+	GLOBAL_JobQueues = null;
+}
+
+private void Run(JobMethod method, void* state, JobCounter* counter)
+{
+	const Job job = {
+		.Method = method,
+		.State = state,
+		.Counter = counter
+	};
+
+	if (counter isnt null)
+	{
+		atomic_fetch_add_explicit(&counter->Remaining, 1, memory_order_relaxed);
+	}
+
+	if (atomic_load_explicit(&GLOBAL_JobsRunning, memory_order_relaxed) is false)
+	{
+		Execute(&job);
+		return;
+	}
+
+	struct _jobQueue* queue = GLOBAL_CurrentJobQueue;
+
+	const bool queued = queue isnt null ? TryPush(queue, &job) : TryPushShared(&job);
+
+	// a full queue means there's already more work than threads to do it
+	if (queued is false)
+	{
+		Execute(&job);
+		return;
+	}
+
+	WakeWorker();
+}
+
+private void Wait(JobCounter* counter)
+{
+	if (counter is null)
+	{
+		return;
+	}
+
+	Job job;
+	int spins = 0;
+
+	while (true)
+	{
+		long long remaining = atomic_load_explicit(&counter->Remaining, memory_order_acquire);
+
+		if (remaining is 0)
+		{
+			return;
+		}
+
+		// help instead of waiting
+		if (TryGetJob(&job))
+		{
+			Execute(&job);
+			spins = 0;
+			continue;
+		}
+
+		if (++spins < JOBS_SPIN_COUNT)
+		{
+			SpinPause();
+			continue;
+		}
+
+		// the remaining jobs are running on other threads
+		Tasks.WaitWhileEqual((void*)&counter->Remaining, &remaining, sizeof(long long), Tasks.Forever);
+
+		spins = 0;
+	}
+}
+
+private bool TryRunOne(void)
+{
+	Job job;
+
+	if (atomic_load_explicit(&GLOBAL_JobsRunning, memory_order_acquire) is false or TryGetJob(&job) is false)
+	{
+		return false;
+	}
+
+	Execute(&job);
+
+	return true;
+}
+
+private bool Started(void)
+{
+	return atomic_load(&GLOBAL_JobsRunning);
+}
+
+private int ThreadCount(void)
+{
+	return max(1, GLOBAL_JobThreadCount);
+}
+
+#define TEST_JOB_COUNT 100000
+// ranges are split in half until they're this small
+#define TEST_SPLIT_SIZE 16
+
+static byte GLOBAL_TestRuns[TEST_JOB_COUNT];
+static JobCounter GLOBAL_TestCounter;
+
+private void MarkIndex(void* state)
+{
+	GLOBAL_TestRuns[(ulong)state]++;
+}
+
+private void* PackRange(ulong begin, ulong end)
+{
+	return (void*)((begin << 32) | end);
+}
+
+// splits the range into two jobs queued with the same counter until it's small enough to mark
+private void SplitRange(void* state)
+{
+	const ulong begin = (ulong)state >> 32;
+	const ulong end = (ulong)state & 0xFFFFFFFF;
+
+	if (end - begin <= TEST_SPLIT_SIZE)
+	{
+		for (ulong i = begin; i < end; i++)
+		{
+			GLOBAL_TestRuns[i]++;
+		}
+		return;
+	}
+
+	const ulong middle = begin + ((end - begin) / 2);
+
+	Run(SplitRange, PackRange(begin, middle), &GLOBAL_TestCounter);
+	Run(SplitRange, PackRange(middle, end), &GLOBAL_TestCounter);
+}
+
+// queues every job from a thread that doesn't run jobs
+private int QueueFromOutside(void* state)
+{
+	ignore_unused(state);
+
+	for (ulong i = 0; i < TEST_JOB_COUNT; i++)
+	{
+		Run(MarkIndex, (void*)i, &GLOBAL_TestCounter);
+	}
+
+	Wait(&GLOBAL_TestCounter);
+
+	return 0;
+}
+
+private ulong CountWrongRuns(void)
+{
+	ulong wrong = 0;
+	for (ulong i = 0; i < TEST_JOB_COUNT; i++)
+	{
+		wrong += GLOBAL_TestRuns[i] isnt 1;
+	}
+	return wrong;
+}
+
+TEST(RunsEveryJobOnce)
+{
+	const bool started = atomic_load(&GLOBAL_JobsRunning);
+	Start(0);
+
+	memset(GLOBAL_TestRuns, 0, sizeof(GLOBAL_TestRuns));
+
+	JobCounter counter = { 0 };
+
+	for (ulong i = 0; i < TEST_JOB_COUNT; i++)
+	{
+		Run(MarkIndex, (void*)i, &counter);
+	}
+
+	Wait(&counter);
+
+	const long long remaining = atomic_load(&counter.Remaining);
+	IsZero(remaining);
+	IsZero(CountWrongRuns());
+
+	if (started is false)
+	{
+		Stop();
+	}
+
+	return true;
+}
+
+TEST(JobsQueueJobs)
+{
+	const bool started = atomic_load(&GLOBAL_JobsRunning);
+	Start(0);
+
+	memset(GLOBAL_TestRuns, 0, sizeof(GLOBAL_TestRuns));
+
+	// children are counted before their parent finishes so the counter can't reach zero early
+	Run(SplitRange, PackRange(0, TEST_JOB_COUNT), &GLOBAL_TestCounter);
+
+	Wait(&GLOBAL_TestCounter);
+
+	IsZero(CountWrongRuns());
+
+	if (started is false)
+	{
+		Stop();
+	}
+
+	return true;
+}
+
+TEST(ThreadsThatDontRunJobs)
+{
+	const bool started = atomic_load(&GLOBAL_JobsRunning);
+	Start(0);
+
+	memset(GLOBAL_TestRuns, 0, sizeof(GLOBAL_TestRuns));
+
+	Task task = Tasks.Run(Tasks.Create(QueueFromOutside), null);
+
+	const WaitStatus signaled = WaitStatuses.Signaled;
+	const WaitStatus status = Tasks.Wait(task, Tasks.Forever);
+	IsEqual(signaled, status);
+
+	Tasks.Dispose(task);
+
+	IsZero(CountWrongRuns());
+
+	if (started is false)
+	{
+		Stop();
+	}
+
+	// without workers jobs run right away
+	memset(GLOBAL_TestRuns, 0, sizeof(GLOBAL_TestRuns));
+
+	if (started is false)
+	{
+		Run(MarkIndex, (void*)0, null);
+		IsEqual(1, GLOBAL_TestRuns[0]);
+	}
+
+	return true;
+}
+
+private void EmptyEvent(void* state)
+{
+	ignore_unused(state);
+}
+
+// runs the same number of events every phase and waits for them, the way the runtime runs a frame phase
+private bool RunPhases(ulong events, ulong phases)
+{
+	for (ulong phase = 0; phase < phases; phase++)
+	{
+		JobCounter counter = { 0 };
+
+		for (ulong i = 0; i < events; i++)
+		{
+			Run(EmptyEvent, null, &counter);
+		}
+
+		Wait(&counter);
+	}
+
+	return true;
+}
+
+TEST(PhaseOverhead)
+{
+	const bool started = atomic_load(&GLOBAL_JobsRunning);
+	Start(0);
+
+	const ulong eventCounts[] = { 1, 100, 10000 };
+	const ulong phaseCounts[] = { 100000, 10000, 100 };
+
+	for (ulong i = 0; i < sizeof(eventCounts) / sizeof(ulong); i++)
+	{
+		fprintf(__test_stream, "\t%lli phases of %lli events on %i threads"NEWLINE, phaseCounts[i], eventCounts[i], ThreadCount());
+		Benchmark(RunPhases(eventCounts[i], phaseCounts[i]), __test_stream);
+	}
+
+	if (started is false)
+	{
+		Stop();
+	}
+
+	return true;
+}
+
+TEST_SUITE(RunUnitTests,
+	APPEND_TEST(RunsEveryJobOnce)
+	APPEND_TEST(JobsQueueJobs)
+	APPEND_TEST(ThreadsThatDontRunJobs)
+	APPEND_TEST(PhaseOverhead)
+);
@@ -0,0 +1,553 @@
+#include "core/map.h"
+#include "core/memory.h"
+#include "core/hashing.h"
+#include "core/array.h"
+#include "core/cunit.h"
+#include <string.h>
+
+#if defined(_M_X64) || defined(_M_AMD64) || defined(__SSE2__)
+#include <emmintrin.h>
+#define MAP_SSE2
+#endif
+
+private Map Create(ulong keySize, ulong valueSize, ulong capacity, ulong typeId, MapHashFunction hash, MapEqualityFunction equals);
+private void Reserve(Map, ulong count);
+private void Set(Map, const void* key, const void* value);
+private void* Get(Map, const void* key);
+private bool TryGetValue(Map, const void* key, void* out_value);
+private bool ContainsKey(Map, const void* key);
+private bool Remove(Map, const void* key);
+private void Clear(Map);
+private void Foreach(Map, void* context, void(*method)(void* context, void* key, void* value));
+private void Dispose(Map);
+private ulong HashBytes(const void* key, ulong keySize);
+private bool BytesEqual(const void* left, const void* right, ulong keySize);
+private ulong HashString(const void* key, ulong keySize);
+private bool StringsEqual(const void* left, const void* right, ulong keySize);
+private void RunUnitTests();
+
+const struct _mapMethods Maps = {
+	.Create = Create,
+	.Reserve = Reserve,
+	.Set = Set,
+	.Get = Get,
+	.TryGetValue = TryGetValue,
+	.ContainsKey = ContainsKey,
+	.Remove = Remove,
+	.Clear = Clear,
+	.Foreach = Foreach,
+	.Dispose = Dispose,
+	.HashBytes = HashBytes,
+	.BytesEqual = BytesEqual,
+	.HashString = HashString,
+	.StringsEqual = StringsEqual,
+	.RunUnitTests = RunUnitTests
+};
+
+// maps grow once they're more than 7/8 full
+#define MAP_MAXIMUM_LOAD(capacity) ((capacity) - ((capacity) >> 3))
+
+private ulong HashBytes(const void* key, ulong keySize)
+{
+	// most keys are ids or pointers, avoid looping over their bytes
+	if (keySize is sizeof(ulong))
+	{
+		return *(const ulong*)key;
+	}
+
+	if (keySize is sizeof(unsigned int))
+	{
+		return *(const unsigned int*)key;
+	}
+
+	return Hashing.HashSafe(key, keySize);
+}
+
+private bool BytesEqual(const void* left, const void* right, ulong keySize)
+{
+	return memcmp(left, right, keySize) is 0;
+}
+
+private ulong HashString(const void* key, ulong keySize)
+{
+	ignore_unused(keySize);
+
+	const string value = *(const string*)key;
+
+	return value is null ? 0 : Hashing.HashSafe(value->Values, value->Count);
+}
+
+private bool StringsEqual(const void* left, const void* right, ulong keySize)
+{
+	ignore_unused(keySize);
+
+	return strings.Equals(*(const string*)left, *(const string*)right);
+}
+
+// spreads the bits of the hash so the slot index and the control byte are independent
+// even when the hash is a small integer or an aligned pointer
+private ulong MixHash(ulong hash)
+{
+	hash ^= hash >> 33;
+	hash *= 0xff51afd7ed558ccdULL;
+	hash ^= hash >> 33;
+	hash *= 0xc4ceb9fe1a85ec53ULL;
+	hash ^= hash >> 33;
+
+	return hash;
+}
+
+private byte ControlByte(ulong hash)
+{
+	return (byte)((hash >> 57) & 0x7F);
+}
+
+private void SetControl(Map map, ulong index, byte control)
+{
+	map->Controls[index] = control;
+
+	// keep the copy of the first group at the end in sync so groups that wrap around
+	// the end of the table can still be loaded at once
+	if (index < MAP_GROUP_SIZE)
+	{
+		map->Controls[map->Capacity + index] = control;
+	}
+}
+
+// returns a bit for every control byte in the group starting at index that equals control
+private unsigned int MatchGroup(const byte* controls, ulong index, byte control)
+{
+#ifdef MAP_SSE2
+	const __m128i group = _mm_loadu_si128((const __m128i*)(controls + index));
+
+	return (unsigned int)_mm_movemask_epi8(_mm_cmpeq_epi8(group, _mm_set1_epi8((char)control)));
+#else
+	unsigned int mask = 0;
+
+	for (unsigned int i = 0; i < MAP_GROUP_SIZE; i++)
+	{
+		mask |= (unsigned int)(controls[index + i] is control) << i;
+	}
+
+	return mask;
+#endif
+}
+
+// returns a bit for every empty slot in the group starting at index
+private unsigned int MatchEmpty(const byte* controls, ulong index)
+{
+#ifdef MAP_SSE2
+	// only empty control bytes have their high bit set
+	return (unsigned int)_mm_movemask_epi8(_mm_loadu_si128((const __m128i*)(controls + index)));
+#else
+	return MatchGroup(controls, index, MAP_EMPTY);
+#endif
+}
+
+private unsigned int LowestBit(unsigned int mask)
+{
+	unsigned long index;
+	_BitScanForward(&index, mask);
+	return (unsigned int)index;
+}
+
+#define KEY_AT(map, index) ((byte*)(map)->Keys + ((index) * (map)->KeySize))
+#define VALUE_AT(map, index) ((byte*)(map)->Values + ((index) * (map)->ValueSize))
+
+// finds the slot that contains key, returns false and sets out_index to the first empty slot of the
+// probe sequence when the key doesn't exist
+private bool FindSlot(Map map, const void* key, ulong hash, ulong* out_index)
+{
+	const ulong mask = map->Capacity - 1;
+	const byte control = ControlByte(hash);
+
+	ulong index = hash & mask;
+
+	while (true)
+	{
+		unsigned int matches = MatchGroup(map->Controls, index, control);
+
+		while (matches)
+		{
+			const ulong slot = (index + LowestBit(matches)) & mask;
+
+			if (map->Equals(KEY_AT(map, slot), key, map->KeySize))
+			{
+				*out_index = slot;
+				return true;
+			}
+
+			// clear the lowest bit
+			matches &= matches - 1;
+		}
+
+		// slots are filled without gaps from the home slot, the first empty slot ends the search
+		const unsigned int empty = MatchEmpty(map->Controls, index);
+
+		if (empty)
+		{
+			*out_index = (index + LowestBit(empty)) & mask;
+			return false;
+		}
+
+		index = (index + MAP_GROUP_SIZE) & mask;
+	}
+}
+
+private void AllocSlots(Map map, ulong capacity)
+{
+	map->Capacity = capacity;
+	map->Count = 0;
+	map->Controls = Memory.Alloc(capacity + MAP_GROUP_SIZE, map->TypeId);
+	map->Keys = Memory.Alloc(capacity * map->KeySize, map->TypeId);
+	map->Values = Memory.Alloc(capacity * map->ValueSize, map->TypeId);
+
+	memset(map->Controls, MAP_EMPTY, capacity + MAP_GROUP_SIZE);
+}
+
+private Map Create(ulong keySize, ulong valueSize, ulong capacity, ulong typeId, MapHashFunction hash, MapEqualityFunction equals)
+{
+	if (keySize is 0 or valueSize is 0 or hash is null or equals is null)
+	{
+		throw(InvalidArgumentException);
+	}
+
+	REGISTER_TYPE(Map);
+
+	Map map = Memory.Alloc(sizeof(struct _map_void_void), MapTypeId);
+
+	map->KeySize = keySize;
+	map->ValueSize = valueSize;
+	map->TypeId = typeId;
+	map->Hash = hash;
+	map->Equals = equals;
+
+	AllocSlots(map, MAP_MINIMUM_CAPACITY);
+
+	Reserve(map, capacity);
+
+	return map;
+}
+
+private void Reserve(Map map, ulong count)
+{
+	if (count <= MAP_MAXIMUM_LOAD(map->Capacity))
+	{
+		return;
+	}
+
+	ulong capacity = map->Capacity;
+
+	while (count > MAP_MAXIMUM_LOAD(capacity))
+	{
+		capacity <<= 1;
+	}
+
+	byte* controls = map->Controls;
+	byte* keys = map->Keys;
+	byte* values = map->Values;
+	const ulong previousCapacity = map->Capacity;
+
+	AllocSlots(map, capacity);
+
+	for (ulong i = 0; i < previousCapacity; i++)
+	{
+		if (controls[i] isnt MAP_EMPTY)
+		{
+			const void* key = keys + (i * map->KeySize);
+			const ulong hash = MixHash(map->Hash(key, map->KeySize));
+
+			ulong slot;
+			FindSlot(map, key, hash, &slot);
+
+			SetControl(map, slot, ControlByte(hash));
+			memcpy(KEY_AT(map, slot), key, map->KeySize);
+			memcpy(VALUE_AT(map, slot), values + (i * map->ValueSize), map->ValueSize);
+
+			++(map->Count);
+		}
+	}
+
+	Memory.Free(controls, map->TypeId);
+	Memory.Free(keys, map->TypeId);
+	Memory.Free(values, map->TypeId);
+}
+
+private void Set(Map map, const void* key, const void* value)
+{
+	const ulong hash = MixHash(map->Hash(key, map->KeySize));
+
+	ulong slot;
+	if (FindSlot(map, key, hash, &slot))
+	{
+		memcpy(VALUE_AT(map, slot), value, map->ValueSize);
+		return;
+	}
+
+	if (map->Count + 1 > MAP_MAXIMUM_LOAD(map->Capacity))
+	{
+		Reserve(map, map->Count + 1);
+
+		FindSlot(map, key, hash, &slot);
+	}
+
+	SetControl(map, slot, ControlByte(hash));
+	memcpy(KEY_AT(map, slot), key, map->KeySize);
+	memcpy(VALUE_AT(map, slot), value, map->ValueSize);
+
+	++(map->Count);
+}
+
+private void* Get(Map map, const void* key)
+{
+	ulong slot;
+	if (FindSlot(map, key, MixHash(map->Hash(key, map->KeySize)), &slot))
+	{
+		return VALUE_AT(map, slot);
+	}
+
+	return null;
+}
+
+private bool TryGetValue(Map map, const void* key, void* out_value)
+{
+	const void* value = Get(map, key);
+
+	if (value is null)
+	{
+		return false;
+	}
+
+	memcpy(out_value, value, map->ValueSize);
+
+	return true;
+}
+
+private bool ContainsKey(Map map, const void* key)
+{
+	return Get(map, key) isnt null;
+}
+
+private bool Remove(Map map, const void* key)
+{
+	ulong hole;
+	if (FindSlot(map, key, MixHash(map->Hash(key, map->KeySize)), &hole) is false)
+	{
+		return false;
+	}
+
+	const ulong mask = map->Capacity - 1;
+
+	// instead of leaving a tombstone shift the rest of the cluster back so lookups
+	// can always stop at the first empty slot
+	ulong next = (hole + 1) & mask;
+
+	while (map->Controls[next] isnt MAP_EMPTY)
+	{
+		const ulong home = MixHash(map->Hash(KEY_AT(map, next), map->KeySize)) & mask;
+
+		// entries can only move towards their home slot, never past it
+		if (((next - home) & mask) >= ((next - hole) & mask))
+		{
+			SetControl(map, hole, map->Controls[next]);
+			memcpy(KEY_AT(map, hole), KEY_AT(map, next), map->KeySize);
+			memcpy(VALUE_AT(map, hole), VALUE_AT(map, next), map->ValueSize);
+
+			hole = next;
+		}
+
+		next = (next + 1) & mask;
+	}
+
+	SetControl(map, hole, MAP_EMPTY);
+
+	--(map->Count);
+
+	return true;
+}
+
+private void Clear(Map map)
+{
+	memset(map->Controls, MAP_EMPTY, map->Capacity + MAP_GROUP_SIZE);
+	map->Count = 0;
+}
+
+private void Foreach(Map map, void* context, void(*method)(void* context, void* key, void* value))
+{
+	for (ulong i = 0; i < map->Capacity; i++)
+	{
+		if (map->Controls[i] isnt MAP_EMPTY)
+		{
+			method(context, KEY_AT(map, i), VALUE_AT(map, i));
+		}
+	}
+}
+
+private void Dispose(Map map)
+{
+	if (map is null)
+	{
+		return;
+	}
+
+	Memory.Free(map->Controls, map->TypeId);
+	Memory.Free(map->Keys, map->TypeId);
+	Memory.Free(map->Values, map->TypeId);
+	Memory.Free(map, MapTypeId);
+}
+
+DEFINE_MAP(int, int);
+DEFINE_MAP(ulong, ulong);
+DEFINE_MAP(string, int);
+
+TEST(SetGetRemove)
+{
+	map(int, int) values = maps(int, int).Create(0);
+
+	for (int i = 0; i < 1000; i++)
+	{
+		maps(int, int).Set(values, i, i * 2);
+	}
+
+	IsEqual((ulong)1000, values->Count);
+
+	for (int i = 0; i < 1000; i++)
+	{
+		int value;
+		IsTrue(maps(int, int).TryGetValue(values, i, &value));
+		IsEqual(i * 2, value);
+	}
+
+	IsFalse(maps(int, int).ContainsKey(values, 1000));
+	IsNull(maps(int, int).Get(values, -1));
+
+	// replacing doesn't add a new entry
+	maps(int, int).Set(values, 10, -10);
+	IsEqual(-10, *maps(int, int).Get(values, 10));
+	IsEqual((ulong)1000, values->Count);
+
+	// remove every other key, the rest have to stay reachable without tombstones
+	for (int i = 0; i < 1000; i += 2)
+	{
+		IsTrue(maps(int, int).Remove(values, i));
+	}
+
+	IsFalse(maps(int, int).Remove(values, 0));
+	IsEqual((ulong)500, values->Count);
+
+	for (int i = 0; i < 1000; i++)
+	{
+		IsEqual(i % 2 is 1, maps(int, int).ContainsKey(values, i));
+	}
+
+	maps(int, int).Clear(values);
+
+	IsEqual((ulong)0, values->Count);
+	IsFalse(maps(int, int).ContainsKey(values, 1));
+
+	maps(int, int).Dispose(values);
+
+	return true;
+}
+
+TEST(Reserve)
+{
+	map(ulong, ulong) values = maps(ulong, ulong).Create(1000);
+
+	const ulong capacity = values->Capacity;
+
+	IsTrue(capacity >= 1000);
+
+	for (ulong i = 0; i < 1000; i++)
+	{
+		maps(ulong, ulong).Set(values, i << 12, i);
+	}
+
+	// reserving means adding never had to grow
+	IsEqual(capacity, values->Capacity);
+	IsEqual((ulong)999, *maps(ulong, ulong).Get(values, 999 << 12));
+
+	maps(ulong, ulong).Dispose(values);
+
+	return true;
+}
+
+TEST(StringKeys)
+{
+	map(string, int) values = maps(string, int).CreateWith(0, Maps.HashString, Maps.StringsEqual);
+
+	string key = dynamic_string("shaders/default.vertex");
+
+	maps(string, int).Set(values, key, 1);
+	maps(string, int).Set(values, stack_string("shaders/default.fragment"), 2);
+
+	// a different string with the same contents finds the same entry
+	IsEqual(1, *maps(string, int).Get(values, stack_string("shaders/default.vertex")));
+	IsFalse(maps(string, int).ContainsKey(values, stack_string("shaders/default")));
+
+	strings.Dispose(key);
+	maps(string, int).Dispose(values);
+
+	return true;
+}
+
+#define BENCHMARK_LOOKUP_COUNT 10000
+
+private void BenchmarkLookups(FILE* stream, int count)
+{
+	map(int, int) values = maps(int, int).Create(count);
+	array(int) keys = arrays(int).Create(count);
+
+	for (int i = 0; i < count; i++)
+	{
+		// spread the keys so they aren't just indices
+		const int key = i * 7919;
+
+		maps(int, int).Set(values, key, i);
+		arrays(int).Append(keys, key);
+	}
+
+	int found = 0;
+
+	fprintf(stream, "\t%i entries, %i lookups, IndexOf ", count, BENCHMARK_LOOKUP_COUNT);
+	Benchmark(
+		for (int i = 0; i < BENCHMARK_LOOKUP_COUNT; i++)
+		{
+			found += arrays(int).IndexOf(keys, ((i * 31) % count) * 7919) isnt -1;
+		}, stream
+	);
+
+	fprintf(stream, " map ");
+	Benchmark(
+		for (int i = 0; i < BENCHMARK_LOOKUP_COUNT; i++)
+		{
+			found += maps(int, int).ContainsKey(values, ((i * 31) % count) * 7919);
+		}, stream
+	);
+
+	fprintf(stream, NEWLINE);
+
+	if (found isnt BENCHMARK_LOOKUP_COUNT * 2)
+	{
+		throw(InvalidLogicException);
+	}
+
+	arrays(int).Dispose(keys);
+	maps(int, int).Dispose(values);
+}
+
+TEST(LookupBenchmark)
+{
+	BenchmarkLookups(__test_stream, 10);
+	BenchmarkLookups(__test_stream, 1000);
+	BenchmarkLookups(__test_stream, 100000);
+
+	return true;
+}
+
+TEST_SUITE(RunUnitTests,
+	APPEND_TEST(SetGetRemove)
+	APPEND_TEST(Reserve)
+	APPEND_TEST(StringKeys)
+	APPEND_TEST(LookupBenchmark)
+);
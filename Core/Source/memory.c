@@ -2,26 +2,52 @@
 #include <stdlib.h>
 #include <string.h>
 #include <stdio.h>
+#include <stdatomic.h>
 #include "core/memory.h"
 #include "core/csharp.h"
 #include "core/hashing.h"
+#include "core/simd.h"
 
 static char GetByteGrouping(ulong value);
 static void PrintGroupedNumber(FILE* stream, ulong value);
 
 static void* SafeAlloc(ulong size, ulong typeID);
+private void* AllocFrom(ulong size, ulong typeID, void* callSite);
+private void* DuplicateFrom(const void* address, const ulong length, const ulong newLength, ulong typeID, void* callSite);
 static void* SafeCalloc(ulong nitems, ulong size, ulong typeID);
 static void* SafeAllocAligned(ulong alignment, ulong size, ulong typeID);
+private void* AllocAlignedFrom(ulong alignment, ulong size, ulong typeID, void* callSite);
+private void* AllocZeroedAligned(ulong alignment, ulong size);
 static void SafeFree(void* address, ulong typeID);
-static bool TryRealloc(void* address, const ulong previousSize, const ulong newSize, void** out_address);
+static bool TryRealloc(void* address, const ulong previousSize, const ulong newSize, ulong typeID, void** out_address);
 static void ZeroArray(void* address, const ulong size);
 static void* DuplicateAddress(const void* address, const  ulong length, const  ulong newLength, ulong typeID);
 static bool ReallocOrCopy(void** address, const ulong previousLength, const ulong newLength, ulong typeID);
 static void RegisterTypeName(const char* name, ulong* out_typeId);
+static void RegisterSlabTypeName(const char* name, ulong elementSize, ulong* out_typeId);
+static void RegisterAlignedTypeName(const char* name, ulong alignment, ulong* out_typeId);
 private void PrintAlloc(FILE* stream);
 private void PrintFree(FILE* stream);
+private void CollectStatistics(void);
 private int CompareMemoryAndHash(const char* left, ulong leftSize, const char* right, ulong rightSize, ulong* out_leftHash, ulong* out_rightHash);
 
+private Arena CreateArena(ulong size, ulong typeID);
+private void* ArenaAlloc(Arena arena, ulong size);
+private void* ArenaAllocAligned(Arena arena, ulong alignment, ulong size);
+private ArenaMark ArenaMarkPosition(Arena arena);
+private void ArenaRewind(Arena arena, ArenaMark mark);
+private void ArenaReset(Arena arena);
+private Arena FrameArena(void);
+private void ResetFrameArena(void);
+private void DisposeArena(Arena arena);
+
+private void StartProfiler(void);
+private void StopProfiler(void);
+private MemorySnapshot TakeSnapshot(void);
+private void PrintSnapshot(FILE* stream, MemorySnapshot snapshot, ulong count);
+private void PrintGrowth(FILE* stream, MemorySnapshot previous, MemorySnapshot current, ulong count);
+private bool TrySaveSnapshot(const char* path, MemorySnapshot previous, MemorySnapshot current, ulong count);
+private void DisposeSnapshot(MemorySnapshot snapshot);
 
 struct _memoryMethods Memory = {
 	.AllocSize = 0,
@@ -31,19 +57,82 @@ struct _memoryMethods Memory = {
 	.Alloc = &SafeAlloc,
 	.Free = &SafeFree,
 	.Calloc = &SafeCalloc,
+	.AllocAligned = &SafeAllocAligned,
 	.TryRealloc = &TryRealloc,
 	.ZeroArray = &ZeroArray,
 	.DuplicateAddress = &DuplicateAddress,
 	.ReallocOrCopy = &ReallocOrCopy,
 	.RegisterTypeName = &RegisterTypeName,
+	.RegisterSlabTypeName = &RegisterSlabTypeName,
+	.RegisterAlignedTypeName = &RegisterAlignedTypeName,
 	.PrintAlloc = PrintAlloc,
 	.PrintFree = PrintFree,
-	.CompareMemoryAndHash = CompareMemoryAndHash
+	.CollectStatistics = CollectStatistics,
+	.CompareMemoryAndHash = CompareMemoryAndHash,
+	.Arena = {
+		.FrameSize = 4 * 1024 * 1024,
+		.Create = CreateArena,
+		.Alloc = ArenaAlloc,
+		.AllocAligned = ArenaAllocAligned,
+		.Mark = ArenaMarkPosition,
+		.Rewind = ArenaRewind,
+		.Reset = ArenaReset,
+		.Frame = FrameArena,
+		.ResetFrame = ResetFrameArena,
+		.Dispose = DisposeArena
+	},
+	.Profiler = {
+		.Start = StartProfiler,
+		.Stop = StopProfiler,
+		.Snapshot = TakeSnapshot,
+		.Print = PrintSnapshot,
+		.PrintGrowth = PrintGrowth,
+		.TrySave = TrySaveSnapshot,
+		.DisposeSnapshot = DisposeSnapshot
+	}
 };
 
 #define MAX_TYPENAME_LENGTH 1024
 #define MAX_REGISTERED_TYPENAMES 1024
 
+// the minimum size of each block of memory a slab carves elements out of
+#define SLAB_CHUNK_SIZE (64 * 1024)
+// slab elements are aligned to this so types containing matrices/vector4s stay aligned
+#define SLAB_ALIGNMENT 16
+#define MAX_SLABS 64
+
+// chunks are aligned to and sized in whole pages so the page of an address alone says which slab owns it
+#define SLAB_PAGE_SHIFT 12
+#define SLAB_PAGE_SIZE ((ulong)1 << SLAB_PAGE_SHIFT)
+// the page map covers 48 bit addresses with one lazily allocated leaf per 4GB
+#define SLAB_MAP_LEAF_SHIFT 32
+#define SLAB_MAP_LEAF_COUNT ((ulong)1 << (48 - SLAB_MAP_LEAF_SHIFT))
+#define SLAB_MAP_LEAF_LENGTH ((ulong)1 << (SLAB_MAP_LEAF_SHIFT - SLAB_PAGE_SHIFT))
+
+// a pool of fixed size elements for a single registered type
+struct _slab {
+	// the size requested by Alloc() that should be served from this slab
+	ulong ElementSize;
+	// the distance in bytes between elements, ElementSize rounded up to SLAB_ALIGNMENT
+	ulong Stride;
+	ulong ElementsPerChunk;
+	// ElementsPerChunk * Stride rounded up to whole pages
+	ulong ChunkSize;
+	// singly linked list threaded through the first bytes of every free element
+	// Free() pushes without the lock, Alloc() pops while holding it
+	_Atomic(void*) FreeList;
+	// the position of this slab in GLOBAL_Slabs
+	byte Index;
+	locker Lock;
+};
+
+static struct _slab* GLOBAL_Slabs[MAX_SLABS];
+static ulong GLOBAL_SlabCount;
+static locker GLOBAL_SlabRegistrationLock;
+// the GLOBAL_Slabs index + 1 of the slab that owns every page, 0 for pages that aren't part of a slab chunk
+// chunks are never released so entries are only ever set, which lets Free() read them without a lock
+static byte* volatile GLOBAL_SlabPageMap[SLAB_MAP_LEAF_COUNT];
+
 struct _typeName {
 	ulong Id;
 	const char Name[MAX_TYPENAME_LENGTH];
@@ -53,6 +142,15 @@ struct _typeName {
 	ulong Freed;
 	// Whether or not this block of the hash table is used
 	bool Used;
+	// the combined size of all arenas created with this type
+	ulong ArenaSize;
+	// the largest amount of memory used at once by any arena created with this type
+	ulong ArenaHighWaterMark;
+	// the slab allocations of this type are served from, null when allocated from the heap
+	struct _slab* Slab;
+	// the alignment every allocation of this type is made with, 0 when they're made with malloc, blocks made
+	// with _aligned_malloc have to be released with _aligned_free
+	ulong Alignment;
 };
 
 struct _typeName RegisteredTypeNames[MAX_REGISTERED_TYPENAMES] =
@@ -73,42 +171,613 @@ struct _typeName RegisteredTypeNames[MAX_REGISTERED_TYPENAMES] =
 	}
 };
 
-private int CompareMemoryAndHash(const char* left, ulong leftSize, const char* right, ulong rightSize, ulong* out_leftHash, ulong* out_rightHash)
+#ifdef MEMORY_TRACKING
+
+// allocation statistics for a single thread, threads only ever write to their own shard
+// so the hot path is a plain increment with no lock and no shared cache lines
+struct _allocationShard {
+	ulong AllocCount;
+	ulong AllocSize;
+	ulong FreeCount;
+	// the number of allocations made for each registered type, indexed the same as RegisteredTypeNames
+	ulong Active[MAX_REGISTERED_TYPENAMES];
+	// the number of frees made for each registered type, indexed the same as RegisteredTypeNames
+	ulong Freed[MAX_REGISTERED_TYPENAMES];
+	struct _allocationShard* Next;
+};
+
+#define SHARD_ALIGNMENT 64
+
+static _Thread_local struct _allocationShard* LocalShard;
+// every shard ever created, shards outlive their threads so their statistics aren't lost
+static struct _allocationShard* volatile GLOBAL_Shards;
+
+private struct _allocationShard* CurrentShard(void)
+{
+	struct _allocationShard* shard = LocalShard;
+
+	if (shard isnt null)
+	{
+		return shard;
+	}
+
+	// aligned so two threads' shards never share a cache line
+	shard = _aligned_malloc(sizeof(struct _allocationShard), SHARD_ALIGNMENT);
+
+	if (shard is null)
+	{
+		throw(OutOfMemoryException);
+	}
+
+	memset(shard, 0, sizeof(struct _allocationShard));
+
+	// push the shard onto the list of shards without a lock
+	struct _allocationShard* head;
+	do
+	{
+		head = GLOBAL_Shards;
+		shard->Next = head;
+	} while (_InterlockedCompareExchangePointer((void* volatile*)&GLOBAL_Shards, shard, head) isnt head);
+
+	LocalShard = shard;
+
+	return shard;
+}
+
+private void TrackAlloc(ulong typeID, ulong size)
+{
+	struct _allocationShard* shard = CurrentShard();
+
+	shard->AllocSize += size;
+	++(shard->AllocCount);
+	++(shard->Active[typeID % MAX_REGISTERED_TYPENAMES]);
+}
+
+private void TrackFree(ulong typeID)
+{
+	struct _allocationShard* shard = CurrentShard();
+
+	++(shard->FreeCount);
+	++(shard->Freed[typeID % MAX_REGISTERED_TYPENAMES]);
+}
+
+private void CollectStatistics(void)
+{
+	ulong allocCount = 0;
+	ulong allocSize = 0;
+	ulong freeCount = 0;
+
+	for (ulong i = 0; i < MAX_REGISTERED_TYPENAMES; i++)
+	{
+		RegisteredTypeNames[i].Active = 0;
+		RegisteredTypeNames[i].Freed = 0;
+	}
+
+	// other threads may still be writing to their shards, the totals are only a snapshot
+	for (const struct _allocationShard* shard = GLOBAL_Shards; shard isnt null; shard = shard->Next)
+	{
+		allocCount += shard->AllocCount;
+		allocSize += shard->AllocSize;
+		freeCount += shard->FreeCount;
+
+		for (ulong i = 0; i < MAX_REGISTERED_TYPENAMES; i++)
+		{
+			RegisteredTypeNames[i].Active += shard->Active[i];
+			RegisteredTypeNames[i].Freed += shard->Freed[i];
+		}
+	}
+
+	Memory.AllocCount = allocCount;
+	Memory.AllocSize = allocSize;
+	Memory.FreeCount = freeCount;
+}
+
+#else
+
+#define TrackAlloc(typeID, size)
+#define TrackFree(typeID)
+
+private void CollectStatistics(void)
+{
+	// nothing is tracked
+}
+
+#endif // MEMORY_TRACKING
+
+// a block recorded by the profiler
+struct _profiledBlock {
+	// null when this entry of the table is empty
+	void* Address;
+	// the return address of the Alloc() call that allocated the block
+	void* CallSite;
+	ulong Size;
+	ulong TypeId;
+};
+
+// the bytes held by every block allocated from a single call site for a single type
+struct _callSiteUsage {
+	void* CallSite;
+	ulong TypeId;
+	ulong Size;
+	ulong Count;
+};
+
+struct _memorySnapshot {
+	ulong Size;
+	ulong Count;
+	// indexed the same as RegisteredTypeNames
+	ulong TypeSize[MAX_REGISTERED_TYPENAMES];
+	ulong TypeCount[MAX_REGISTERED_TYPENAMES];
+	// sorted by call site then type id so two snapshots can be compared in a single pass
+	struct _callSiteUsage* CallSites;
+	ulong CallSiteCount;
+};
+
+// the table of live blocks starts with this many entries and doubles when it's over half full
+#define PROFILER_MINIMUM_CAPACITY 4096
+
+static volatile bool GLOBAL_Profiling;
+static locker GLOBAL_ProfilerLock;
+// open addressing table of every live block keyed by address, the profiler uses the crt directly
+// so it never records its own allocations
+static struct _profiledBlock* GLOBAL_ProfiledBlocks;
+static ulong GLOBAL_ProfiledBlockCount;
+static ulong GLOBAL_ProfiledBlockCapacity;
+
+#ifdef MEMORY_TRACKING
+
+private ulong HashAddress(const void* address)
 {
-	ulong leftHash = 0;
-	ulong rightHash = 0;
+	// the low bits of heap addresses are almost always zero
+	return (ulong)(((size_t)address >> 4) * 0x9E3779B97F4A7C15ULL);
+}
+
+// inserts the block into the table without growing it, the caller must hold the profiler lock
+private void InsertProfiledBlock(struct _profiledBlock* blocks, ulong capacity, const struct _profiledBlock* block)
+{
+	const ulong mask = capacity - 1;
+
+	ulong index = HashAddress(block->Address) & mask;
+
+	while (blocks[index].Address isnt null and blocks[index].Address isnt block->Address)
+	{
+		index = (index + 1) & mask;
+	}
+
+	blocks[index] = *block;
+}
+
+// doubles the size of the table, the caller must hold the profiler lock
+private void GrowProfiledBlocks(void)
+{
+	const ulong capacity = max(GLOBAL_ProfiledBlockCapacity << 1, PROFILER_MINIMUM_CAPACITY);
+
+	struct _profiledBlock* blocks = calloc(capacity, sizeof(struct _profiledBlock));
 
-	const int length = min(leftSize, rightSize);
+	if (blocks is null)
+	{
+		throw(OutOfMemoryException);
+	}
 
-	for (ulong i = 0; i < length; i++)
+	for (ulong i = 0; i < GLOBAL_ProfiledBlockCapacity; i++)
 	{
-		const char leftByte = left[i];
-		const char rightByte = right[i];
+		if (GLOBAL_ProfiledBlocks[i].Address isnt null)
+		{
+			InsertProfiledBlock(blocks, capacity, &GLOBAL_ProfiledBlocks[i]);
+		}
+	}
 
-		leftHash = Hashing.ChainHashSingle(leftByte, leftHash);
-		rightHash = Hashing.ChainHashSingle(rightByte, rightHash);
+	free(GLOBAL_ProfiledBlocks);
+
+	GLOBAL_ProfiledBlocks = blocks;
+	GLOBAL_ProfiledBlockCapacity = capacity;
+}
 
-		if (leftByte != rightByte)
+private void ProfileInsert(const struct _profiledBlock* block)
+{
+	lock(GLOBAL_ProfilerLock,
+		if (GLOBAL_Profiling)
 		{
-			*out_leftHash = leftHash;
-			*out_rightHash = rightHash;
+			if ((GLOBAL_ProfiledBlockCount + 1) << 1 > GLOBAL_ProfiledBlockCapacity)
+			{
+				GrowProfiledBlocks();
+			}
 
-			return leftByte > rightByte ? 1 : -1;
+			InsertProfiledBlock(GLOBAL_ProfiledBlocks, GLOBAL_ProfiledBlockCapacity, block);
+			++GLOBAL_ProfiledBlockCount;
 		}
+	);
+}
+
+private void ProfileAlloc(void* address, ulong size, ulong typeID, void* callSite)
+{
+	if (GLOBAL_Profiling is false)
+	{
+		return;
+	}
+
+	const struct _profiledBlock block = {
+		.Address = address,
+		.CallSite = callSite,
+		.Size = size,
+		.TypeId = typeID
+	};
+
+	ProfileInsert(&block);
+}
+
+// removes the block with the provided address from the table, returns false if the address wasn't recorded
+private bool ProfileTake(const void* address, struct _profiledBlock* out_block)
+{
+	if (GLOBAL_Profiling is false)
+	{
+		return false;
 	}
 
-	*out_leftHash = leftHash;
-	*out_rightHash = rightHash;
+	bool found = false;
+
+	lock(GLOBAL_ProfilerLock,
+		if (GLOBAL_ProfiledBlockCount isnt 0)
+		{
+			const ulong mask = GLOBAL_ProfiledBlockCapacity - 1;
+
+			ulong index = HashAddress(address) & mask;
+
+			while (GLOBAL_ProfiledBlocks[index].Address isnt null)
+			{
+				if (GLOBAL_ProfiledBlocks[index].Address is address)
+				{
+					found = true;
+					break;
+				}
+
+				index = (index + 1) & mask;
+			}
+
+			if (found)
+			{
+				*out_block = GLOBAL_ProfiledBlocks[index];
+				--GLOBAL_ProfiledBlockCount;
+
+				// shift the following entries of the cluster back so lookups never need tombstones
+				ulong hole = index;
+				ulong next = (index + 1) & mask;
+
+				while (GLOBAL_ProfiledBlocks[next].Address isnt null)
+				{
+					const ulong home = HashAddress(GLOBAL_ProfiledBlocks[next].Address) & mask;
+
+					// move the entry into the hole when its home slot isn't between the hole and where it is now
+					if (((next - home) & mask) >= ((next - hole) & mask))
+					{
+						GLOBAL_ProfiledBlocks[hole] = GLOBAL_ProfiledBlocks[next];
+						hole = next;
+					}
+
+					next = (next + 1) & mask;
+				}
+
+				GLOBAL_ProfiledBlocks[hole].Address = null;
+			}
+		}
+	);
+
+	return found;
+}
+
+private void ProfileFree(const void* address)
+{
+	struct _profiledBlock block;
+	ProfileTake(address, &block);
+}
+
+#else
+
+#define ProfileInsert(block)
+#define ProfileAlloc(address, size, typeID, callSite)
+#define ProfileTake(address, out_block) false
+#define ProfileFree(address)
+
+#endif // MEMORY_TRACKING
+
+private void StartProfiler(void)
+{
+	// nothing is recorded, so the table is never allocated and snapshots are always empty
+#ifdef MEMORY_TRACKING
+	lock(GLOBAL_ProfilerLock,
+		if (GLOBAL_ProfiledBlocks is null)
+		{
+			GrowProfiledBlocks();
+		}
+
+		GLOBAL_Profiling = true;
+	);
+#endif
+}
+
+private void StopProfiler(void)
+{
+	lock(GLOBAL_ProfilerLock,
+		GLOBAL_Profiling = false;
+
+		free(GLOBAL_ProfiledBlocks);
+
+		GLOBAL_ProfiledBlocks = null;
+		GLOBAL_ProfiledBlockCount = 0;
+		GLOBAL_ProfiledBlockCapacity = 0;
+	);
+}
+
+private int CompareCallSites(const struct _callSiteUsage* left, const struct _callSiteUsage* right)
+{
+	if (left->CallSite isnt right->CallSite)
+	{
+		return (size_t)left->CallSite > (size_t)right->CallSite ? 1 : -1;
+	}
+
+	if (left->TypeId isnt right->TypeId)
+	{
+		return left->TypeId > right->TypeId ? 1 : -1;
+	}
 
 	return 0;
 }
 
+private int CompareCallSiteKeys(const void* left, const void* right)
+{
+	return CompareCallSites(left, right);
+}
+
+// sorts the largest size first
+private int CompareCallSiteSizes(const void* left, const void* right)
+{
+	const long leftSize = (long)((const struct _callSiteUsage*)left)->Size;
+	const long rightSize = (long)((const struct _callSiteUsage*)right)->Size;
+
+	return leftSize < rightSize ? 1 : (leftSize > rightSize ? -1 : 0);
+}
+
+private MemorySnapshot TakeSnapshot(void)
+{
+	MemorySnapshot snapshot = calloc(1, sizeof(struct _memorySnapshot));
+
+	if (snapshot is null)
+	{
+		throw(OutOfMemoryException);
+	}
+
+	lock(GLOBAL_ProfilerLock,
+		snapshot->CallSites = calloc(max(GLOBAL_ProfiledBlockCount, 1), sizeof(struct _callSiteUsage));
+
+		if (snapshot->CallSites is null)
+		{
+			throw(OutOfMemoryException);
+		}
+
+		for (ulong i = 0; i < GLOBAL_ProfiledBlockCapacity; i++)
+		{
+			const struct _profiledBlock* block = &GLOBAL_ProfiledBlocks[i];
+
+			if (block->Address isnt null)
+			{
+				struct _callSiteUsage* usage = &snapshot->CallSites[snapshot->CallSiteCount++];
+
+				usage->CallSite = block->CallSite;
+				usage->TypeId = block->TypeId;
+				usage->Size = block->Size;
+				usage->Count = 1;
+			}
+		}
+	);
+
+	// group the blocks by call site and type
+	qsort(snapshot->CallSites, snapshot->CallSiteCount, sizeof(struct _callSiteUsage), CompareCallSiteKeys);
+
+	ulong count = 0;
+	for (ulong i = 0; i < snapshot->CallSiteCount; i++)
+	{
+		const struct _callSiteUsage* usage = &snapshot->CallSites[i];
+
+		const ulong index = usage->TypeId % MAX_REGISTERED_TYPENAMES;
+
+		snapshot->TypeSize[index] += usage->Size;
+		++(snapshot->TypeCount[index]);
+		snapshot->Size += usage->Size;
+		++(snapshot->Count);
+
+		if (count isnt 0 and CompareCallSites(&snapshot->CallSites[count - 1], usage) is 0)
+		{
+			snapshot->CallSites[count - 1].Size += usage->Size;
+			++(snapshot->CallSites[count - 1].Count);
+		}
+		else
+		{
+			snapshot->CallSites[count++] = *usage;
+		}
+	}
+
+	snapshot->CallSiteCount = count;
+
+	return snapshot;
+}
+
+private void DisposeSnapshot(MemorySnapshot snapshot)
+{
+	if (snapshot is null)
+	{
+		return;
+	}
+
+	free(snapshot->CallSites);
+	free(snapshot);
+}
+
+private void PrintCallSiteUsage(FILE* stream, const struct _callSiteUsage* usage, const char* sizeLabel)
+{
+	fprintf(stream, "Site: %p	Type: %-32s	%s: ", usage->CallSite, RegisteredTypeNames[usage->TypeId % MAX_REGISTERED_TYPENAMES].Name, sizeLabel);
+	PrintGroupedNumber(stream, usage->Size);
+	fprintf(stream, " (%lli)	Blocks: %lli\n", (long)usage->Size, (long)usage->Count);
+}
+
+private void PrintSnapshot(FILE* stream, MemorySnapshot snapshot, ulong count)
+{
+	if (snapshot is null)
+	{
+		throw(NullReferenceException);
+	}
+
+	// absolute call sites can be converted into offsets within the image using this address
+	fprintf(stream, "Profiled ");
+	PrintGroupedNumber(stream, snapshot->Size);
+	fprintf(stream, " (%lli) in %lli blocks, Memory.Alloc at %p\n", snapshot->Size, snapshot->Count, (void*)&SafeAlloc);
+
+	for (ulong i = 0; i < MAX_REGISTERED_TYPENAMES; i++)
+	{
+		if (snapshot->TypeCount[i] isnt 0)
+		{
+			fprintf(stream, "Type: %-32s	Size: ", RegisteredTypeNames[i].Name);
+			PrintGroupedNumber(stream, snapshot->TypeSize[i]);
+			fprintf(stream, " (%lli)	Blocks: %lli\n", snapshot->TypeSize[i], snapshot->TypeCount[i]);
+		}
+	}
+
+	if (snapshot->CallSiteCount is 0)
+	{
+		return;
+	}
+
+	struct _callSiteUsage* sites = malloc(snapshot->CallSiteCount * sizeof(struct _callSiteUsage));
+
+	if (sites is null)
+	{
+		throw(OutOfMemoryException);
+	}
+
+	memcpy(sites, snapshot->CallSites, snapshot->CallSiteCount * sizeof(struct _callSiteUsage));
+
+	qsort(sites, snapshot->CallSiteCount, sizeof(struct _callSiteUsage), CompareCallSiteSizes);
+
+	fprintf(stream, "Largest call sites\n");
+
+	for (ulong i = 0; i < min(count, snapshot->CallSiteCount); i++)
+	{
+		PrintCallSiteUsage(stream, &sites[i], "Size");
+	}
+
+	free(sites);
+}
+
+private void PrintGrowth(FILE* stream, MemorySnapshot previous, MemorySnapshot current, ulong count)
+{
+	if (previous is null or current is null)
+	{
+		throw(NullReferenceException);
+	}
+
+	// every call site in the current snapshot could have grown
+	struct _callSiteUsage* growth = malloc(max(current->CallSiteCount, 1) * sizeof(struct _callSiteUsage));
+
+	if (growth is null)
+	{
+		throw(OutOfMemoryException);
+	}
+
+	ulong growthCount = 0;
+	ulong previousIndex = 0;
+
+	// both snapshots are sorted by call site so they can be joined in a single pass
+	for (ulong i = 0; i < current->CallSiteCount; i++)
+	{
+		const struct _callSiteUsage* usage = &current->CallSites[i];
+
+		while (previousIndex < previous->CallSiteCount and CompareCallSites(&previous->CallSites[previousIndex], usage) < 0)
+		{
+			++previousIndex;
+		}
+
+		ulong previousSize = 0;
+		ulong previousCount = 0;
+
+		if (previousIndex < previous->CallSiteCount and CompareCallSites(&previous->CallSites[previousIndex], usage) is 0)
+		{
+			previousSize = previous->CallSites[previousIndex].Size;
+			previousCount = previous->CallSites[previousIndex].Count;
+		}
+
+		if (usage->Size > previousSize)
+		{
+			growth[growthCount++] = (struct _callSiteUsage){
+				.CallSite = usage->CallSite,
+				.TypeId = usage->TypeId,
+				.Size = usage->Size - previousSize,
+				.Count = usage->Count > previousCount ? usage->Count - previousCount : 0
+			};
+		}
+	}
+
+	qsort(growth, growthCount, sizeof(struct _callSiteUsage), CompareCallSiteSizes);
+
+	fprintf(stream, "Grew by ");
+	PrintGroupedNumber(stream, current->Size > previous->Size ? current->Size - previous->Size : 0);
+	fprintf(stream, " (%lli bytes, %lli blocks)\n", (long)(current->Size - previous->Size), (long)(current->Count - previous->Count));
+
+	for (ulong i = 0; i < min(count, growthCount); i++)
+	{
+		PrintCallSiteUsage(stream, &growth[i], "Growth");
+	}
+
+	free(growth);
+}
+
+private bool TrySaveSnapshot(const char* path, MemorySnapshot previous, MemorySnapshot current, ulong count)
+{
+	FILE* file;
+	if (fopen_s(&file, path, "w") isnt 0 or file is null)
+	{
+		return false;
+	}
+
+	PrintSnapshot(file, current, count);
+
+	if (previous isnt null)
+	{
+		PrintGrowth(file, previous, current, count);
+	}
+
+	fclose(file);
+
+	return true;
+}
+
+private int CompareMemoryAndHash(const char* left, ulong leftSize, const char* right, ulong rightSize, ulong* out_leftHash, ulong* out_rightHash)
+{
+	// the hash consumes whole blocks at a time so it can't be built one byte at a time alongside the compare anymore,
+	// both passes run a register at a time instead
+	*out_leftHash = Hashing.HashSafe(left, leftSize);
+	*out_rightHash = Hashing.HashSafe(right, rightSize);
+
+	const ulong index = Simd.Mismatch(left, right, min(leftSize, rightSize));
+
+	if (index is SIMD_NOT_FOUND)
+	{
+		return 0;
+	}
+
+	return left[index] > right[index] ? 1 : -1;
+}
+
 /// <summary>
 /// Prints the current allocation statistics to the provided stream
 /// </summary>
 /// <param name="stream"></param>
 private void PrintAlloc(FILE* stream)
 {
+#ifndef MEMORY_TRACKING
+	fprintf(stream, "Allocation tracking disabled, define MEMORY_TRACKING to enable it\n");
+#endif
+
+	CollectStatistics();
+
 	// determine how to shorten the number of bytes
 	fprintf(stream, "Allocated ");
 	PrintGroupedNumber(stream, Memory.AllocSize);
@@ -121,7 +790,18 @@ private void PrintAlloc(FILE* stream)
 
 		if (typeName->Used)
 		{
-			fprintf(stream, "Type: %-32s	Active: %-16lli	Freed: %-16lli\n", typeName->Name, typeName->Active, typeName->Freed);
+			fprintf(stream, "Type: %-32s	Active: %-16lli	Freed: %-16lli", typeName->Name, typeName->Active, typeName->Freed);
+
+			if (typeName->ArenaSize)
+			{
+				fprintf(stream, "	Arena: ");
+				PrintGroupedNumber(stream, typeName->ArenaHighWaterMark);
+				fprintf(stream, " / ");
+				PrintGroupedNumber(stream, typeName->ArenaSize);
+				fprintf(stream, " (%lli / %lli)", typeName->ArenaHighWaterMark, typeName->ArenaSize);
+			}
+
+			fprintf(stream, "\n");
 		}
 	}
 }
@@ -132,6 +812,8 @@ private void PrintAlloc(FILE* stream)
 /// <param name="stream"></param>
 private void PrintFree(FILE* stream)
 {
+	CollectStatistics();
+
 	fprintf(stream, "Free Count (%lli) ", Memory.FreeCount);
 }
 
@@ -143,24 +825,263 @@ private void PrintFree(FILE* stream)
 /// <returns>This function returns a pointer to the allocated memory, or NULL if the request fails.</returns>
 static void* SafeCalloc(ulong nitems, ulong size, ulong typeID)
 {
-	void* ptr = calloc(nitems, size);
+	const ulong alignment = RegisteredTypeNames[typeID % MAX_REGISTERED_TYPENAMES].Alignment;
+
+	void* ptr = alignment isnt 0 ? AllocZeroedAligned(alignment, nitems * size) : calloc(nitems, size);
 
 	if (ptr is null)
 	{
 		throw(OutOfMemoryException);
 	}
 
-	Memory.AllocSize += nitems * size;
+	TrackAlloc(typeID, nitems * size);
+	ProfileAlloc(ptr, nitems * size, typeID, _ReturnAddress());
 
-	++Memory.AllocCount;
+	return ptr;
+}
 
-	const ulong index = typeID % MAX_REGISTERED_TYPENAMES;
+// _aligned_malloc has no calloc equivalent, returns null when the block couldn't be allocated
+private void* AllocZeroedAligned(ulong alignment, ulong size)
+{
+	void* ptr = _aligned_malloc(size, alignment);
 
-	++(RegisteredTypeNames[index].Active);
+	if (ptr isnt null)
+	{
+		memset(ptr, 0, size);
+	}
 
 	return ptr;
 }
 
+// returns the slab whose chunk holds the address, or null when it didn't come from a slab
+private struct _slab* SlabOwner(const void* address)
+{
+	const ulong page = (ulong)address >> SLAB_PAGE_SHIFT;
+	const ulong leafIndex = page >> (SLAB_MAP_LEAF_SHIFT - SLAB_PAGE_SHIFT);
+
+	if (leafIndex >= SLAB_MAP_LEAF_COUNT)
+	{
+		return null;
+	}
+
+	const byte* leaf = GLOBAL_SlabPageMap[leafIndex];
+
+	if (leaf is null)
+	{
+		return null;
+	}
+
+	const byte entry = ((const volatile byte*)leaf)[page & (SLAB_MAP_LEAF_LENGTH - 1)];
+
+	return entry is 0 ? null : GLOBAL_Slabs[entry - 1];
+}
+
+// marks every page of the chunk as owned by the slab
+private void MapSlabChunk(const struct _slab* slab, const byte* chunk)
+{
+	const ulong firstPage = (ulong)chunk >> SLAB_PAGE_SHIFT;
+	const ulong lastPage = ((ulong)chunk + slab->ChunkSize - 1) >> SLAB_PAGE_SHIFT;
+
+	for (ulong page = firstPage; page <= lastPage; page++)
+	{
+		const ulong leafIndex = page >> (SLAB_MAP_LEAF_SHIFT - SLAB_PAGE_SHIFT);
+
+		if (leafIndex >= SLAB_MAP_LEAF_COUNT)
+		{
+			fprintf_red(stderr, "Slab chunk at %p lies outside of the addresses the slab page map covers"NEWLINE, chunk);
+			throw(OutOfMemoryException);
+		}
+
+		byte* leaf = GLOBAL_SlabPageMap[leafIndex];
+
+		// slabs of other types may be adding the first chunk within the same leaf at the same time
+		if (leaf is null)
+		{
+			byte* created = calloc(SLAB_MAP_LEAF_LENGTH, sizeof(byte));
+
+			if (created is null)
+			{
+				throw(OutOfMemoryException);
+			}
+
+			leaf = _InterlockedCompareExchangePointer((void* volatile*)&GLOBAL_SlabPageMap[leafIndex], created, null);
+
+			if (leaf is null)
+			{
+				leaf = created;
+			}
+			else
+			{
+				free(created);
+			}
+		}
+
+		((volatile byte*)leaf)[page & (SLAB_MAP_LEAF_LENGTH - 1)] = slab->Index + 1;
+	}
+}
+
+// pushes the linked elements first through last onto the slab's free list
+private void SlabPush(struct _slab* slab, void* first, void* last)
+{
+	void* head = atomic_load_explicit(&slab->FreeList, memory_order_relaxed);
+	do
+	{
+		*(void**)last = head;
+	} while (atomic_compare_exchange_weak_explicit(&slab->FreeList, &head, first, memory_order_release, memory_order_relaxed) is false);
+}
+
+// carves a new chunk into elements, returns the first and frees the rest, the caller must hold the slab's lock
+private void* AddSlabChunk(struct _slab* slab)
+{
+	byte* chunk = _aligned_malloc(slab->ChunkSize, SLAB_PAGE_SIZE);
+
+	if (chunk is null)
+	{
+		throw(OutOfMemoryException);
+	}
+
+	MapSlabChunk(slab, chunk);
+
+	// link the elements in address order so they're handed out in address order
+	for (ulong i = 1; i < slab->ElementsPerChunk - 1; i++)
+	{
+		*(void**)(chunk + (i * slab->Stride)) = chunk + ((i + 1) * slab->Stride);
+	}
+
+	SlabPush(slab, chunk + slab->Stride, chunk + ((slab->ElementsPerChunk - 1) * slab->Stride));
+
+	return chunk;
+}
+
+private void* SlabAlloc(struct _slab* slab)
+{
+	void* element;
+
+	// pushes can land at any time but only one thread pops at once, so the head we read can't be
+	// popped and pushed back before our exchange
+	lock(slab->Lock,
+		element = atomic_load_explicit(&slab->FreeList, memory_order_acquire);
+
+		while (element isnt null and atomic_compare_exchange_weak_explicit(&slab->FreeList, &element, *(void**)element, memory_order_acquire, memory_order_acquire) is false)
+		{
+			// a failed exchange reloads the head into element
+		}
+
+		if (element is null)
+		{
+			element = AddSlabChunk(slab);
+		}
+	);
+
+	// Alloc() always returns zeroed memory
+	memset(element, 0, slab->ElementSize);
+
+	return element;
+}
+
+// returns true when the address belonged to the slab and was returned to it
+private bool SlabTryFree(struct _slab* slab, void* address)
+{
+	if (SlabOwner(address) isnt slab)
+	{
+		return false;
+	}
+
+	SlabPush(slab, address, address);
+
+	return true;
+}
+
+// returns true if the address was allocated from the slab
+private bool SlabOwnsAddress(struct _slab* slab, void* address)
+{
+	return SlabOwner(address) is slab;
+}
+
+static void RegisterSlabTypeName(const char* name, ulong elementSize, ulong* out_typeId)
+{
+	if (*out_typeId != 0)
+	{
+		return;
+	}
+
+	if (elementSize is 0)
+	{
+		throw(InvalidArgumentException);
+	}
+
+	RegisterTypeName(name, out_typeId);
+
+	struct _typeName* typeName = &RegisteredTypeNames[*out_typeId % MAX_REGISTERED_TYPENAMES];
+
+	if (typeName->Alignment isnt 0)
+	{
+		fprintf_red(stderr, "%s was already registered as an aligned type, it can't also be allocated from a slab"NEWLINE, name);
+		throw(InvalidArgumentException);
+	}
+
+	lock(GLOBAL_SlabRegistrationLock,
+		if (typeName->Slab is null)
+		{
+			if (GLOBAL_SlabCount >= MAX_SLABS)
+			{
+				fprintf_red(stderr, "Failed to create a slab for %s, too many slab types, it will be allocated from the heap"NEWLINE, name);
+			}
+			else
+			{
+				struct _slab* slab = calloc(1, sizeof(struct _slab));
+
+				if (slab is null)
+				{
+					throw(OutOfMemoryException);
+				}
+
+				// every free element stores the next pointer of the free list
+				slab->ElementSize = elementSize;
+				slab->Stride = (max(elementSize, sizeof(void*)) + (SLAB_ALIGNMENT - 1)) & ~((ulong)SLAB_ALIGNMENT - 1);
+				slab->ChunkSize = ((max(SLAB_CHUNK_SIZE / slab->Stride, 16) * slab->Stride) + (SLAB_PAGE_SIZE - 1)) & ~(SLAB_PAGE_SIZE - 1);
+				slab->ElementsPerChunk = slab->ChunkSize / slab->Stride;
+				slab->Index = (byte)GLOBAL_SlabCount;
+
+				GLOBAL_Slabs[GLOBAL_SlabCount++] = slab;
+				typeName->Slab = slab;
+			}
+		}
+		else if (typeName->Slab->ElementSize isnt elementSize)
+		{
+			fprintf_red(stderr, "%s was already registered with a slab of %lli bytes, allocations of %lli bytes will be allocated from the heap"NEWLINE,
+				name, typeName->Slab->ElementSize, elementSize);
+		}
+	);
+}
+
+static void RegisterAlignedTypeName(const char* name, ulong alignment, ulong* out_typeId)
+{
+	if (*out_typeId != 0)
+	{
+		return;
+	}
+
+	// _aligned_malloc only accepts powers of two
+	if (alignment is 0 or (alignment & (alignment - 1)) isnt 0)
+	{
+		throw(InvalidArgumentException);
+	}
+
+	RegisterTypeName(name, out_typeId);
+
+	struct _typeName* typeName = &RegisteredTypeNames[*out_typeId % MAX_REGISTERED_TYPENAMES];
+
+	if (typeName->Slab isnt null)
+	{
+		fprintf_red(stderr, "%s was already registered with a slab, it can't also be an aligned type"NEWLINE, name);
+		throw(InvalidArgumentException);
+	}
+
+	// blocks of a smaller alignment that are already alive were still made with _aligned_malloc
+	typeName->Alignment = max(typeName->Alignment, alignment);
+}
+
 static void RegisterTypeName(const char* name, ulong* out_typeId)
 {
 	if (*out_typeId != 0)
@@ -215,46 +1136,71 @@ static void RegisterTypeName(const char* name, ulong* out_typeId)
 }
 
 static void* SafeAlloc(ulong size, ulong typeID)
+{
+	return AllocFrom(size, typeID, _ReturnAddress());
+}
+
+// allocates size bytes for the provided type, callSite is recorded by the profiler as where the block was allocated
+private void* AllocFrom(ulong size, ulong typeID, void* callSite)
 {
 	if (size is 0)
 	{
 		return null;
 	}
 
-	void* ptr = calloc(1, size);
+	const ulong index = typeID % MAX_REGISTERED_TYPENAMES;
+
+	struct _slab* slab = RegisteredTypeNames[index].Slab;
+	const ulong alignment = RegisteredTypeNames[index].Alignment;
+
+	void* ptr;
+
+	if (alignment isnt 0)
+	{
+		ptr = AllocZeroedAligned(alignment, size);
+	}
+	else
+	{
+		ptr = (slab isnt null and slab->ElementSize is size) ? SlabAlloc(slab) : calloc(1, size);
+	}
 
 	if (ptr is null)
 	{
 		throw(OutOfMemoryException);
 	}
 
-	Memory.AllocSize += size;
-
-	++Memory.AllocCount;
-
-	const ulong index = typeID % MAX_REGISTERED_TYPENAMES;
-
-	++(RegisteredTypeNames[index].Active);
+	TrackAlloc(typeID, size);
+	ProfileAlloc(ptr, size, typeID, callSite);
 
 	return ptr;
 }
 
 static void* SafeAllocAligned(ulong alignment, ulong size, ulong typeID)
 {
-	void* ptr = _aligned_malloc(alignment, size);
+	const struct _typeName* typeName = &RegisteredTypeNames[typeID % MAX_REGISTERED_TYPENAMES];
 
-	if (ptr is null)
+	// Free() releases the block using the type, so it has to know the block was made with _aligned_malloc
+	if (typeName->Alignment is 0)
 	{
-		throw(OutOfMemoryException);
+		fprintf_red(stderr, "%s wasn't registered with REGISTER_ALIGNED_TYPE, it can't be allocated aligned"NEWLINE, typeName->Name);
+		throw(InvalidArgumentException);
 	}
 
-	Memory.AllocSize += size;
+	return AllocAlignedFrom(max(alignment, typeName->Alignment), size, typeID, _ReturnAddress());
+}
 
-	++Memory.AllocCount;
+// allocates a block that has to be released with _aligned_free, the caller is responsible for making sure it is
+private void* AllocAlignedFrom(ulong alignment, ulong size, ulong typeID, void* callSite)
+{
+	void* ptr = _aligned_malloc(size, alignment);
 
-	const ulong index = typeID % MAX_REGISTERED_TYPENAMES;
+	if (ptr is null)
+	{
+		throw(OutOfMemoryException);
+	}
 
-	++(RegisteredTypeNames[index].Active);
+	TrackAlloc(typeID, size);
+	ProfileAlloc(ptr, size, typeID, callSite);
 
 	return ptr;
 }
@@ -266,20 +1212,56 @@ static void SafeFree(void* address, ulong typeID)
 		return;
 	}
 
-	free(address);
+	const ulong index = typeID % MAX_REGISTERED_TYPENAMES;
 
-	++Memory.FreeCount;
+	// forget the block before it's freed so the address can't be recorded again by another thread first
+	ProfileFree(address);
 
-	const ulong index = typeID % MAX_REGISTERED_TYPENAMES;
+	struct _slab* slab = RegisteredTypeNames[index].Slab;
+
+	if (RegisteredTypeNames[index].Alignment isnt 0)
+	{
+		_aligned_free(address);
+	}
+	// allocations of a slab type that weren't the slab's element size came from the heap
+	else if (slab is null or SlabTryFree(slab, address) is false)
+	{
+		free(address);
+	}
 
-	++(RegisteredTypeNames[index].Freed);
+	TrackFree(typeID);
 }
 
-static bool TryRealloc(void* address, const ulong previousSize, const ulong newSize, void** out_address)
+static bool TryRealloc(void* address, const ulong previousSize, const ulong newSize, ulong typeID, void** out_address)
 {
+	const struct _typeName* typeName = &RegisteredTypeNames[typeID % MAX_REGISTERED_TYPENAMES];
+
+	// only the type's own slab can own the address
+	struct _slab* slab = typeName->Slab;
+
+	// slab elements and aligned blocks can't be resized by realloc, the caller has to copy them
+	if (address isnt null and (typeName->Alignment isnt 0 or (slab isnt null and SlabOwnsAddress(slab, address))))
+	{
+		*out_address = address;
+		return false;
+	}
+
+	// the profiled block is taken out of the table before realloc so the address can't be reused under it
+	struct _profiledBlock block;
+	const bool profiled = address isnt null and ProfileTake(address, &block);
+
 	void* newAddress = realloc(address, newSize);
 
-	*out_address = newAddress;
+	// realloc leaves the original block untouched when it fails
+	*out_address = newAddress isnt null ? newAddress : address;
+
+	if (profiled)
+	{
+		block.Address = *out_address;
+		block.Size = newAddress isnt null ? newSize : block.Size;
+
+		ProfileInsert(&block);
+	}
 
 
 	if (newAddress isnt null)
@@ -303,6 +1285,11 @@ static void ZeroArray(void* address, const ulong size)
 }
 
 static void* DuplicateAddress(const void* address, const  ulong length, const  ulong newLength, ulong typeID)
+{
+	return DuplicateFrom(address, length, newLength, typeID, _ReturnAddress());
+}
+
+private void* DuplicateFrom(const void* address, const ulong length, const ulong newLength, ulong typeID, void* callSite)
 {
 	if (address is null)
 	{
@@ -315,7 +1302,7 @@ static void* DuplicateAddress(const void* address, const  ulong length, const  u
 		throw(InvalidLogicException);
 	}
 
-	void* newAddress = SafeAlloc(newLength, typeID);
+	void* newAddress = AllocFrom(newLength, typeID, callSite);
 
 	memcpy(newAddress, address, min(length, newLength));
 
@@ -326,18 +1313,18 @@ static bool ReallocOrCopy(void** address, const ulong previousLength, const ulon
 {
 	if (*address is null)
 	{
-		*address = SafeAlloc(newLength, typeID);
+		*address = AllocFrom(newLength, typeID, _ReturnAddress());
 
 		return true;
 	}
 
-	if (TryRealloc(*address, previousLength, newLength, address))
+	if (TryRealloc(*address, previousLength, newLength, typeID, address))
 	{
 		return true;
 	}
 
 	// since we couldn't realloc to the right size alloc new space and copy the bytes
-	void* newAddress = DuplicateAddress(*address, previousLength, newLength, typeID);
+	void* newAddress = DuplicateFrom(*address, previousLength, newLength, typeID, _ReturnAddress());
 
 	// free the old address
 	SafeFree(*address, typeID);
@@ -347,6 +1334,175 @@ static bool ReallocOrCopy(void** address, const ulong previousLength, const ulon
 	return false;
 }
 
+DEFINE_TYPE_ID(FrameArena);
+
+static Arena volatile GLOBAL_FrameArena;
+
+private Arena CreateArena(ulong size, ulong typeID)
+{
+	if (size is 0)
+	{
+		throw(InvalidArgumentException);
+	}
+
+	Arena arena = SafeAlloc(sizeof(struct _arena), typeID);
+
+	// the backing block is never zeroed again after it's created
+	// callers are expected to initialize what they alloc
+	// released with _aligned_free by DisposeArena, so the arena's type doesn't have to be an aligned type
+	arena->Values = AllocAlignedFrom(sizeof(void*) << 1, size, typeID, _ReturnAddress());
+	arena->Size = size;
+	arena->Offset = 0;
+	arena->HighWaterMark = 0;
+	arena->TypeId = typeID;
+
+	RegisteredTypeNames[typeID % MAX_REGISTERED_TYPENAMES].ArenaSize += size;
+
+	return arena;
+}
+
+private void* ArenaAllocAligned(Arena arena, ulong alignment, ulong size)
+{
+	if (arena is null)
+	{
+		throw(NullReferenceException);
+	}
+
+	// alignment must be a power of two
+	if (alignment is 0 or (alignment & (alignment - 1)) isnt 0)
+	{
+		throw(InvalidArgumentException);
+	}
+
+	// bump the offset with a CAS so worker threads can share the frame arena without a lock
+	ulong offset;
+	ulong alignedOffset;
+	ulong newOffset;
+	do
+	{
+		offset = arena->Offset;
+
+		const ulong address = (ulong)arena->Values + offset;
+		const ulong alignedAddress = (address + (alignment - 1)) & ~(alignment - 1);
+
+		alignedOffset = offset + (alignedAddress - address);
+		newOffset = safe_add(alignedOffset, size);
+
+		if (newOffset > arena->Size)
+		{
+			fprintf_red(stderr, "Arena exhausted, requested %lli bytes with %lli of %lli bytes used, consider increasing the arena size"NEWLINE,
+				size, offset, arena->Size);
+			throw(OutOfMemoryException);
+		}
+	} while ((ulong)_InterlockedCompareExchange64((volatile long long*)&arena->Offset, newOffset, offset) isnt offset);
+
+	return arena->Values + alignedOffset;
+}
+
+private void* ArenaAlloc(Arena arena, ulong size)
+{
+	return ArenaAllocAligned(arena, sizeof(void*), size);
+}
+
+private ArenaMark ArenaMarkPosition(Arena arena)
+{
+	return arena->Offset;
+}
+
+private void RecordHighWaterMark(Arena arena)
+{
+	const ulong offset = arena->Offset;
+
+	if (offset > arena->HighWaterMark)
+	{
+		arena->HighWaterMark = offset;
+	}
+
+	struct _typeName* typeName = &RegisteredTypeNames[arena->TypeId % MAX_REGISTERED_TYPENAMES];
+
+	if (offset > typeName->ArenaHighWaterMark)
+	{
+		typeName->ArenaHighWaterMark = offset;
+	}
+}
+
+private void ArenaRewind(Arena arena, ArenaMark mark)
+{
+	if (mark > arena->Offset)
+	{
+		throw(IndexOutOfRangeException);
+	}
+
+	RecordHighWaterMark(arena);
+
+	arena->Offset = mark;
+}
+
+private void ArenaReset(Arena arena)
+{
+	ArenaRewind(arena, 0);
+}
+
+private Arena FrameArena(void)
+{
+	Arena arena = GLOBAL_FrameArena;
+
+	if (arena is null)
+	{
+		REGISTER_TYPE(FrameArena);
+
+		Arena created = CreateArena(Memory.Arena.FrameSize, FrameArenaTypeId);
+
+		// job threads can ask for the frame arena at the same time, only the first arena that's published is kept
+		arena = _InterlockedCompareExchangePointer((void* volatile*)&GLOBAL_FrameArena, created, null);
+
+		if (arena is null)
+		{
+			arena = created;
+		}
+		else
+		{
+			DisposeArena(created);
+		}
+	}
+
+	return arena;
+}
+
+private void ResetFrameArena(void)
+{
+	// nothing was ever allocated this frame
+	if (GLOBAL_FrameArena is null)
+	{
+		return;
+	}
+
+	ArenaReset(GLOBAL_FrameArena);
+}
+
+private void DisposeArena(Arena arena)
+{
+	if (arena is null)
+	{
+		return;
+	}
+
+	RecordHighWaterMark(arena);
+
+	RegisteredTypeNames[arena->TypeId % MAX_REGISTERED_TYPENAMES].ArenaSize -= arena->Size;
+
+	if (arena is GLOBAL_FrameArena)
+	{
+		GLOBAL_FrameArena = null;
+	}
+
+	ProfileFree(arena->Values);
+	_aligned_free(arena->Values);
+	TrackFree(arena->TypeId);
+
+	SafeFree(arena, arena->TypeId);
+}
+
 static void PrintGroupedNumber(FILE* stream, ulong value)
 {
 
@@ -1,9 +1,22 @@
 #include "core/modules.h"
 #include "core/csharp.h"
 #include "core/array.h"
-#include <windows.h>
 #include <core/os.h>
 
+#ifdef _WIN32
+#include <windows.h>
+
+#define PLUGIN_DIRECTORY "assets\\plugins\\"
+#else
+#include <dlfcn.h>
+
+#define LoadLibrary(path) dlopen((path), RTLD_NOW)
+#define GetProcAddress(handle, name) dlsym((handle), (name))
+#define FreeLibrary(handle) dlclose(handle)
+
+#define PLUGIN_DIRECTORY "assets/plugins/"
+#endif
+
 #define MAX_PATH_LENGTH 2048
 
 private void* GetMethod(Module, string);
@@ -15,7 +28,7 @@ struct _modulesMethods Modules = {
 	.Load = Load,
 	.Find = GetMethod,
 	.ModuleLocations = nested_stack_array(string,
-		stack_string("assets\\plugins\\")
+		stack_string(PLUGIN_DIRECTORY)
 	),
 	.Dispose = Dispose
 };
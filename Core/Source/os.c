@@ -1,29 +1,47 @@
 #include "core/os.h"
 
+#ifdef _WIN32
 // problematic fucker
 #include "windows.h"
 // >:(
+#else
+#include <dirent.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
 
 private string ExecutableDirectory(void);
-private string ExecutableDirectorylINUX(void);
 
 private array(string) GetFilesInDirectory(string path, bool recursive);
 private bool IsDirectory(string path);
 private int ThreadCount();
 private void PrintLastError(void* stream);
 
-extern const struct _osMethods OperatingSystem = {
-#ifdef LINUX
-	.ExecutableDirectory = ExecutableDirectoryLINUX
-#else
+const struct _osMethods OperatingSystem = {
 	.ExecutableDirectory = ExecutableDirectory,
 	.GetFilesInDirectory = GetFilesInDirectory,
 	.IsDirectory = IsDirectory,
 	.ThreadCount = ThreadCount,
 	.PrintLastError = PrintLastError
-#endif
 };
 
+private string MaybeAppendCharacter(string path, byte c)
+{
+	if (path->Count is 0)
+	{
+		strings.Append(path, c);
+		return path;
+	}
+
+	if (at(path, path->Count - 1) isnt c)
+	{
+		strings.Append(path, c);
+	}
+
+	return path;
+}
+
+#ifdef _WIN32
 array(byte) ExecutableDirectory(void)
 {
 	char buffer[MAX_PATH];
@@ -41,9 +59,6 @@ array(byte) ExecutableDirectory(void)
 
 private void PrintError(int error)
 {
-#ifdef LINUX
-	/* Do nothing for now */
-#else
 	switch (error)
 	{
 	case 0x7B /* 123 */:
@@ -51,14 +66,10 @@ private void PrintError(int error)
 	default:
 		fprintf(stderr, "Error reading file attributes. Error code: %d\n", GetLastError());
 	}
-#endif
 }
 
 private bool IsDirectory(const string path)
 {
-#ifdef LINUX
-	/* Do nothing for now */
-#else
 	DWORD attributes = GetFileAttributes(path->Values);
 
 	if (attributes == INVALID_FILE_ATTRIBUTES) {
@@ -67,23 +78,6 @@ private bool IsDirectory(const string path)
 	}
 
 	return (attributes & FILE_ATTRIBUTE_DIRECTORY);
-#endif
-}
-
-private string MaybeAppendCharacter(string path, byte c)
-{
-	if (path->Count is 0)
-	{
-		strings.Append(path, c);
-		return path;
-	}
-
-	if (at(path, path->Count - 1) isnt c)
-	{
-		strings.Append(path, c);
-	}
-
-	return path;
 }
 
 private array(string) GetFilesInDirectory(string path, bool recursive)
@@ -192,4 +186,98 @@ private void PrintLastError(void* stream)
 	if (messageBuffer) {
 		LocalFree(messageBuffer);
 	}
-}
\ No newline at end of file
+}
+#else
+array(byte) ExecutableDirectory(void)
+{
+	char buffer[PATH_MAX];
+	const ssize_t length = readlink("/proc/self/exe", buffer, sizeof(buffer));
+
+	array(byte) result = arrays(byte).Create(length > 0 ? length : 0);
+
+	if (length > 0)
+	{
+		memcpy(result->Values, buffer, length);
+	}
+
+	return result;
+}
+
+private bool IsDirectory(const string path)
+{
+	struct stat attributes;
+
+	if (stat(path->Values, &attributes) isnt 0)
+	{
+		PrintLastError(stderr);
+		throw(FailedToOpenFileException);
+	}
+
+	return S_ISDIR(attributes.st_mode);
+}
+
+private array(string) GetFilesInDirectory(string path, bool recursive)
+{
+	array(string) result = arrays(string).Create(0);
+
+	if (!IsDirectory(path))
+	{
+		return result;
+	}
+
+	DIR* directory = opendir(path->Values);
+
+	if (directory is null)
+	{
+		PrintLastError(stderr);
+		throw(FailedToReadFileException);
+	}
+
+	struct dirent* entry;
+	while ((entry = readdir(directory)) isnt null)
+	{
+		if (strcmp(entry->d_name, ".") is 0 or strcmp(entry->d_name, "..") is 0)
+		{
+			continue;
+		}
+
+		string fileOrDir = empty_stack_array(byte, PATH_MAX);
+
+		strings.AppendArray(fileOrDir, path);
+		MaybeAppendCharacter(fileOrDir, '/');
+		strings.AppendCArray(fileOrDir, entry->d_name, strlen(entry->d_name));
+
+		if (recursive and IsDirectory(fileOrDir))
+		{
+			array(string) recursiveResults = GetFilesInDirectory(fileOrDir, recursive);
+			arrays(string).AppendArray(result, recursiveResults);
+			arrays(string).Dispose(recursiveResults);
+		}
+		else
+		{
+			arrays(string).Append(result, strings.Clone(fileOrDir));
+		}
+	}
+
+	closedir(directory);
+
+	return result;
+}
+
+private int ThreadCount()
+{
+	const long count = sysconf(_SC_NPROCESSORS_ONLN);
+
+	return count > 0 ? (int)count : 1;
+}
+
+private void PrintLastError(void* stream)
+{
+	if (errno is 0)
+	{
+		return;
+	}
+
+	fprintf(stream, "Error: %s\n", strerror(errno));
+}
+#endif
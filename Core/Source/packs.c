@@ -0,0 +1,674 @@
+#include "core/packs.h"
+#include "core/file.h"
+#include "core/memory.h"
+#include "core/hashing.h"
+#include "core/compression.h"
+#include "core/os.h"
+#include "core/cunit.h"
+#include <string.h>
+#include <stddef.h>
+
+private bool TryMount(const string path, Pack* out_pack);
+private void Unmount(Pack);
+private bool TryGetEntry(const string path, PackEntry* out_entry);
+private bool TryReadEntry(const PackEntry* entry, byte* destination);
+private bool TryBuild(const array(string) paths, const string outputPath, bool compress);
+private bool TryBuildDirectory(const string directory, const string outputPath, bool compress);
+private void RunUnitTests();
+
+const struct _packMethods Packs = {
+	.TryMount = TryMount,
+	.Unmount = Unmount,
+	.TryGetEntry = TryGetEntry,
+	.TryReadEntry = TryReadEntry,
+	.TryBuild = TryBuild,
+	.TryBuildDirectory = TryBuildDirectory,
+	.RunUnitTests = RunUnitTests
+};
+
+// the longest path that can be looked up within a pack
+#define PACK_MAX_PATH 1024
+
+#define PACK_ENTRY_COMPRESSED 1
+
+// the layout of a pack is the header, the entries sorted by the hash of their path, the paths,
+// then the bytes of every entry each starting on an PACK_ALIGNMENT boundary
+struct _packHeader {
+	uint Magic;
+	uint Version;
+	uint EntryCount;
+	uint Alignment;
+	ulong EntriesOffset;
+	ulong PathsOffset;
+	ulong PathsSize;
+};
+
+struct _packEntry {
+	// Hashing.HashSafe of the normalized path
+	ulong Hash;
+	ulong Offset;
+	ulong Size;
+	ulong StoredSize;
+	uint PathOffset;
+	uint PathLength;
+	uint Flags;
+	uint Reserved;
+};
+
+struct _pack {
+	// the mapped pack
+	string View;
+	const struct _packHeader* Header;
+	const struct _packEntry* Entries;
+	const char* Paths;
+};
+
+DEFINE_TYPE_ID(Pack);
+
+// packs are mounted at startup, mounting while other threads are resolving paths isn't supported
+static Pack GLOBAL_MountedPacks[PACK_MAX_MOUNTED];
+static int GLOBAL_MountedPackCount = 0;
+
+// paths are stored lowercase with forward slashes so lookups match however the path was written
+private bool TryNormalize(const char* path, ulong length, char* buffer, ulong* out_length)
+{
+	// relative paths that start at the current directory are the same path
+	while (length >= 2 and path[0] is '.' and (path[1] is '/' or path[1] is '\\'))
+	{
+		path += 2;
+		length -= 2;
+	}
+
+	if (length > PACK_MAX_PATH)
+	{
+		return false;
+	}
+
+	for (ulong i = 0; i < length; i++)
+	{
+		const char c = path[i];
+
+		buffer[i] = c is '\\' ? '/' : (c >= 'A' and c <= 'Z') ? (char)(c - 'A' + 'a') : c;
+	}
+
+	*out_length = length;
+
+	return true;
+}
+
+private bool TryValidate(Pack pack)
+{
+	const ulong size = pack->View->Count;
+
+	if (size < sizeof(struct _packHeader))
+	{
+		return false;
+	}
+
+	const struct _packHeader* header = pack->Header;
+
+	if (header->Magic isnt PACK_MAGIC or header->Version isnt PACK_VERSION)
+	{
+		return false;
+	}
+
+	const ulong entriesSize = (ulong)header->EntryCount * sizeof(struct _packEntry);
+
+	if (header->EntriesOffset > size or entriesSize > size - header->EntriesOffset or
+		header->PathsOffset > size or header->PathsSize > size - header->PathsOffset)
+	{
+		return false;
+	}
+
+	pack->Entries = (const struct _packEntry*)(pack->View->Values + header->EntriesOffset);
+	pack->Paths = (const char*)(pack->View->Values + header->PathsOffset);
+
+	for (uint i = 0; i < header->EntryCount; i++)
+	{
+		const struct _packEntry* entry = &pack->Entries[i];
+
+		if (entry->Offset > size or entry->StoredSize > size - entry->Offset or
+			(ulong)entry->PathOffset + entry->PathLength > header->PathsSize)
+		{
+			return false;
+		}
+
+		// uncompressed entries are read and mapped using their size, so it has to be the size that's stored
+		if ((entry->Flags & PACK_ENTRY_COMPRESSED) is 0 and (entry->Size isnt entry->StoredSize or entry->Size > size - entry->Offset))
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+private bool TryMount(const string path, Pack* out_pack)
+{
+	*out_pack = null;
+
+	if (GLOBAL_MountedPackCount >= PACK_MAX_MOUNTED)
+	{
+		return false;
+	}
+
+	string view;
+	if (Files.TryMap(path, &view) is false)
+	{
+		return false;
+	}
+
+	REGISTER_TYPE(Pack);
+
+	Pack pack = Memory.Alloc(sizeof(struct _pack), PackTypeId);
+
+	pack->View = view;
+	pack->Header = (const struct _packHeader*)view->Values;
+
+	if (TryValidate(pack) is false)
+	{
+		fprintf(stderr, "The pack %s is corrupt or was built by a different version"NEWLINE, path->Values);
+
+		Files.Unmap(view);
+		Memory.Free(pack, PackTypeId);
+
+		return false;
+	}
+
+	GLOBAL_MountedPacks[GLOBAL_MountedPackCount++] = pack;
+
+	*out_pack = pack;
+
+	return true;
+}
+
+private void Unmount(Pack pack)
+{
+	if (pack is null)
+	{
+		return;
+	}
+
+	for (int i = 0; i < GLOBAL_MountedPackCount; i++)
+	{
+		if (GLOBAL_MountedPacks[i] is pack)
+		{
+			memmove(&GLOBAL_MountedPacks[i], &GLOBAL_MountedPacks[i + 1], sizeof(Pack) * (GLOBAL_MountedPackCount - i - 1));
+			--GLOBAL_MountedPackCount;
+			break;
+		}
+	}
+
+	Files.Unmap(pack->View);
+	Memory.Free(pack, PackTypeId);
+}
+
+private bool TryFindEntry(Pack pack, const char* path, ulong length, ulong hash, PackEntry* out_entry)
+{
+	const struct _packEntry* entries = pack->Entries;
+
+	// the first entry whose hash isn't less than the hash
+	ulong low = 0;
+	ulong high = pack->Header->EntryCount;
+
+	while (low < high)
+	{
+		const ulong middle = low + ((high - low) >> 1);
+
+		if (entries[middle].Hash < hash)
+		{
+			low = middle + 1;
+		}
+		else
+		{
+			high = middle;
+		}
+	}
+
+	for (ulong i = low; i < pack->Header->EntryCount and entries[i].Hash is hash; i++)
+	{
+		const struct _packEntry* entry = &entries[i];
+
+		if (entry->PathLength is length and memcmp(pack->Paths + entry->PathOffset, path, length) is 0)
+		{
+			*out_entry = (PackEntry){
+				.Values = pack->View->Values + entry->Offset,
+				.Size = entry->Size,
+				.StoredSize = entry->StoredSize,
+				.Compressed = (entry->Flags & PACK_ENTRY_COMPRESSED) isnt 0
+			};
+
+			return true;
+		}
+	}
+
+	return false;
+}
+
+private bool TryGetEntry(const string path, PackEntry* out_entry)
+{
+	if (GLOBAL_MountedPackCount is 0 or path is null)
+	{
+		return false;
+	}
+
+	char normalized[PACK_MAX_PATH];
+	ulong length;
+
+	if (TryNormalize((const char*)path->Values, path->Count, normalized, &length) is false)
+	{
+		return false;
+	}
+
+	const ulong hash = Hashing.HashSafe(normalized, length);
+
+	// packs mounted later override the packs before them
+	for (int i = GLOBAL_MountedPackCount; i-- > 0;)
+	{
+		if (TryFindEntry(GLOBAL_MountedPacks[i], normalized, length, hash, out_entry))
+		{
+			return true;
+		}
+	}
+
+	return false;
+}
+
+private bool TryReadEntry(const PackEntry* entry, byte* destination)
+{
+	if (entry->Compressed is false)
+	{
+		memcpy(destination, entry->Values, entry->Size);
+		return true;
+	}
+
+	ulong size;
+	return Compression.TryDecompress(entry->Values, entry->StoredSize, destination, entry->Size, &size) and size is entry->Size;
+}
+
+// an entry that is being written to a new pack
+typedef struct {
+	struct _packEntry Entry;
+	// the bytes that are written, either the file or the compressed file
+	byte* Values;
+	bool OwnsValues;
+	string Data;
+	char Path[PACK_MAX_PATH];
+} PackBuildEntry;
+
+DEFINE_ARRAY(PackBuildEntry);
+
+private ulong AlignUp(ulong value, ulong alignment)
+{
+	return (value + alignment - 1) & ~(alignment - 1);
+}
+
+private void DisposeBuildEntries(array(PackBuildEntry) entries)
+{
+	for (ulong i = 0; i < entries->Count; i++)
+	{
+		PackBuildEntry* entry = &entries->Values[i];
+
+		if (entry->OwnsValues)
+		{
+			Memory.Free(entry->Values, PackTypeId);
+		}
+
+		strings.Dispose(entry->Data);
+	}
+
+	arrays(PackBuildEntry).Dispose(entries);
+}
+
+private bool TryWritePadding(File file, ulong count)
+{
+	static const byte zeros[PACK_ALIGNMENT] = { 0 };
+
+	return fwrite(zeros, sizeof(byte), count, file) is count;
+}
+
+private bool TryWritePack(File file, array(PackBuildEntry) entries)
+{
+	const ulong entriesOffset = sizeof(struct _packHeader);
+	const ulong pathsOffset = entriesOffset + entries->Count * sizeof(struct _packEntry);
+
+	ulong pathsSize = 0;
+	for (ulong i = 0; i < entries->Count; i++)
+	{
+		entries->Values[i].Entry.PathOffset = (uint)pathsSize;
+		pathsSize += entries->Values[i].Entry.PathLength;
+	}
+
+	ulong offset = AlignUp(pathsOffset + pathsSize, PACK_ALIGNMENT);
+
+	for (ulong i = 0; i < entries->Count; i++)
+	{
+		entries->Values[i].Entry.Offset = offset;
+		offset = AlignUp(offset + entries->Values[i].Entry.StoredSize, PACK_ALIGNMENT);
+	}
+
+	const struct _packHeader header = {
+		.Magic = PACK_MAGIC,
+		.Version = PACK_VERSION,
+		.EntryCount = (uint)entries->Count,
+		.Alignment = PACK_ALIGNMENT,
+		.EntriesOffset = entriesOffset,
+		.PathsOffset = pathsOffset,
+		.PathsSize = pathsSize
+	};
+
+	bool success = fwrite(&header, sizeof(header), 1, file) is 1;
+
+	for (ulong i = 0; success and i < entries->Count; i++)
+	{
+		success = fwrite(&entries->Values[i].Entry, sizeof(struct _packEntry), 1, file) is 1;
+	}
+
+	for (ulong i = 0; success and i < entries->Count; i++)
+	{
+		success = fwrite(entries->Values[i].Path, sizeof(char), entries->Values[i].Entry.PathLength, file) is entries->Values[i].Entry.PathLength;
+	}
+
+	ulong written = pathsOffset + pathsSize;
+
+	for (ulong i = 0; success and i < entries->Count; i++)
+	{
+		const PackBuildEntry* entry = &entries->Values[i];
+
+		success = TryWritePadding(file, entry->Entry.Offset - written);
+		success = success and fwrite(entry->Values, sizeof(byte), entry->Entry.StoredSize, file) is entry->Entry.StoredSize;
+
+		written = entry->Entry.Offset + entry->Entry.StoredSize;
+	}
+
+	return success;
+}
+
+private bool TryBuild(const array(string) paths, const string outputPath, bool compress)
+{
+	REGISTER_TYPE(Pack);
+
+	array(PackBuildEntry) entries = arrays(PackBuildEntry).Create(paths->Count);
+
+	bool success = true;
+
+	for (ulong i = 0; success and i < paths->Count; i++)
+	{
+		const string path = paths->Values[i];
+
+		PackBuildEntry entry = { 0 };
+
+		ulong length;
+		success = TryNormalize((const char*)path->Values, path->Count, entry.Path, &length);
+
+		if (success is false)
+		{
+			fprintf(stderr, "The path %s is too long to pack"NEWLINE, path->Values);
+			break;
+		}
+
+		success = Files.TryReadAll(path, &entry.Data);
+
+		if (success is false)
+		{
+			fprintf(stderr, "Failed to read %s"NEWLINE, path->Values);
+			break;
+		}
+
+		entry.Entry.Hash = Hashing.HashSafe(entry.Path, length);
+		entry.Entry.PathLength = (uint)length;
+		entry.Entry.Size = entry.Data->Count;
+		entry.Entry.StoredSize = entry.Data->Count;
+		entry.Values = entry.Data->Values;
+
+		if (compress and entry.Data->Count > 0)
+		{
+			const ulong bound = COMPRESSION_BOUND(entry.Data->Count);
+
+			byte* compressed = Memory.Alloc(bound, PackTypeId);
+
+			const ulong compressedSize = Compression.Compress(entry.Data->Values, entry.Data->Count, compressed, bound);
+
+			// only keep the compressed bytes when they're smaller
+			if (compressedSize isnt 0 and compressedSize < entry.Data->Count)
+			{
+				entry.Values = compressed;
+				entry.OwnsValues = true;
+				entry.Entry.StoredSize = compressedSize;
+				entry.Entry.Flags |= PACK_ENTRY_COMPRESSED;
+			}
+			else
+			{
+				Memory.Free(compressed, PackTypeId);
+			}
+		}
+
+		arrays(PackBuildEntry).Append(entries, entry);
+	}
+
+	if (success)
+	{
+		// sorted by hash so lookups can binary search
+		arrays(PackBuildEntry).RadixSort(entries, RadixKeyUlong, offsetof(PackBuildEntry, Entry.Hash), null);
+
+		File file;
+		success = Files.TryOpen(outputPath, FileModes.Create, &file);
+
+		if (success)
+		{
+			success = TryWritePack(file, entries);
+			success &= Files.TryClose(file);
+		}
+	}
+
+	DisposeBuildEntries(entries);
+
+	return success;
+}
+
+private bool TryBuildDirectory(const string directory, const string outputPath, bool compress)
+{
+	array(string) paths = OperatingSystem.GetFilesInDirectory(directory, true);
+
+	const bool success = TryBuild(paths, outputPath, compress);
+
+	for (ulong i = 0; i < paths->Count; i++)
+	{
+		strings.Dispose(paths->Values[i]);
+	}
+
+	arrays(string).Dispose(paths);
+
+	return success;
+}
+
+#define TEST_PACK_PATH "pack_test.pack"
+#define TEST_FILE_COUNT 500
+
+private void TestFilePath(string path, ulong index)
+{
+	char name[64];
+	const int length = snprintf(name, sizeof(name), "pack_test_%lli.material", index);
+
+	strings.Clear(path);
+	strings.AppendCArray(path, (const byte*)name, length);
+}
+
+private void TestFileContents(string data, ulong index)
+{
+	char line[128];
+
+	strings.Clear(data);
+
+	// a few hundred bytes like the material files, the first has no contents at all
+	for (ulong i = 0; i < (index % 8) * 4; i++)
+	{
+		const int length = snprintf(line, sizeof(line), "# material %lli\ncolor: 1.000000 0.%lli 1.000000 1.000000\n", index, i);
+		strings.AppendCArray(data, (const byte*)line, length);
+	}
+}
+
+private array(string) WriteTestFiles(void)
+{
+	array(string) paths = arrays(string).Create(TEST_FILE_COUNT);
+
+	string data = strings.Create(1024);
+
+	for (ulong i = 0; i < TEST_FILE_COUNT; i++)
+	{
+		string path = strings.Create(64);
+
+		TestFilePath(path, i);
+		TestFileContents(data, i);
+
+		Files.WriteAll(path, data);
+
+		arrays(string).Append(paths, path);
+	}
+
+	strings.Dispose(data);
+
+	return paths;
+}
+
+private void RemoveTestFiles(array(string) paths)
+{
+	for (ulong i = 0; i < paths->Count; i++)
+	{
+		remove((const char*)paths->Values[i]->Values);
+		strings.Dispose(paths->Values[i]);
+	}
+
+	arrays(string).Dispose(paths);
+
+	remove(TEST_PACK_PATH);
+}
+
+private ulong VerifyTestFiles(void)
+{
+	ulong failures = 0;
+
+	string path = strings.Create(64);
+	string expected = strings.Create(1024);
+
+	for (ulong i = 0; i < TEST_FILE_COUNT; i++)
+	{
+		TestFilePath(path, i);
+		TestFileContents(expected, i);
+
+		string data;
+		if (Files.TryReadAll(path, &data) is false)
+		{
+			++failures;
+			continue;
+		}
+
+		failures += strings.Equals(expected, data) ? 0 : 1;
+
+		strings.Dispose(data);
+	}
+
+	strings.Dispose(path);
+	strings.Dispose(expected);
+
+	return failures;
+}
+
+TEST(BuildAndMount)
+{
+	array(string) paths = WriteTestFiles();
+
+	for (int compress = 0; compress < 2; compress++)
+	{
+		IsTrue(TryBuild(paths, stack_string(TEST_PACK_PATH), compress));
+
+		Pack pack;
+		IsTrue(TryMount(stack_string(TEST_PACK_PATH), &pack));
+
+		// every entry starts on a page so it can be mapped on its own
+		PackEntry entry;
+		IsTrue(TryGetEntry(stack_string("pack_test_7.material"), &entry));
+		IsZero((ulong)(entry.Values - pack->View->Values) % PACK_ALIGNMENT);
+		IsTrue(entry.Compressed is (bool)compress);
+
+		// separators, case and the current directory don't matter
+		IsTrue(TryGetEntry(stack_string(".\\PACK_TEST_7.material"), &entry));
+		IsFalse(TryGetEntry(stack_string("pack_test_7.materia"), &entry));
+
+		IsZero(VerifyTestFiles());
+
+		Unmount(pack);
+
+		IsFalse(TryGetEntry(stack_string("pack_test_7.material"), &entry));
+	}
+
+	RemoveTestFiles(paths);
+
+	return true;
+}
+
+TEST(CorruptPacksDontMount)
+{
+	string data = dynamic_string("FPAK but not really a pack");
+
+	Files.WriteAll(stack_string(TEST_PACK_PATH), data);
+
+	Pack pack;
+	IsFalse(TryMount(stack_string(TEST_PACK_PATH), &pack));
+	IsNull(pack);
+
+	strings.Dispose(data);
+
+	// an uncompressed entry that claims to be larger than what's stored would be read past the end of the pack
+	array(string) paths = WriteTestFiles();
+
+	IsTrue(TryBuild(paths, stack_string(TEST_PACK_PATH), false));
+	IsTrue(Files.TryReadAll(stack_string(TEST_PACK_PATH), &data));
+
+	const struct _packHeader* header = (const struct _packHeader*)data->Values;
+	struct _packEntry* entries = (struct _packEntry*)(data->Values + header->EntriesOffset);
+
+	entries[header->EntryCount - 1].Size = data->Count;
+
+	Files.WriteAll(stack_string(TEST_PACK_PATH), data);
+
+	IsFalse(TryMount(stack_string(TEST_PACK_PATH), &pack));
+
+	strings.Dispose(data);
+
+	RemoveTestFiles(paths);
+
+	return true;
+}
+
+TEST(Benchmark)
+{
+	array(string) paths = WriteTestFiles();
+
+	IsTrue(TryBuild(paths, stack_string(TEST_PACK_PATH), false));
+
+	ulong failures = 0;
+
+	fprintf(__test_stream, "\tReading %i loose files"NEWLINE, TEST_FILE_COUNT);
+	Benchmark(failures += VerifyTestFiles(), __test_stream);
+
+	Pack pack;
+	IsTrue(TryMount(stack_string(TEST_PACK_PATH), &pack));
+
+	fprintf(__test_stream, "\tReading %i files from a pack"NEWLINE, TEST_FILE_COUNT);
+	Benchmark(failures += VerifyTestFiles(), __test_stream);
+
+	Unmount(pack);
+
+	IsZero(failures);
+
+	RemoveTestFiles(paths);
+
+	return true;
+}
+
+TEST_SUITE(RunUnitTests,
+	APPEND_TEST(BuildAndMount)
+	APPEND_TEST(CorruptPacksDontMount)
+	APPEND_TEST(Benchmark)
+);
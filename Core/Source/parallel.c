@@ -0,0 +1,555 @@
+#include "core/parallel.h"
+#include "core/jobs.h"
+#include "core/os.h"
+#include "core/memory.h"
+#include "core/cunit.h"
+#include <stdatomic.h>
+#include <string.h>
+#include <math.h>
+
+private void For(ulong begin, ulong end, ulong grain, ParallelMethod method, void* context);
+private void ForeachArray(Array array, void(*method)(void* item));
+private void ForeachArrayWithContext(Array array, void* context, void(*method)(void* context, void* item));
+private void Reduce(ulong begin, ulong end, ulong grain,
+	const void* identity, ulong resultSize,
+	ParallelReduceMethod method,
+	ParallelCombineMethod combine,
+	void* context,
+	void* out_result);
+private void RunUnitTests(void);
+
+const struct _parallelMethods Parallel = {
+	.For = For,
+	.ForeachArray = ForeachArray,
+	.ForeachArrayWithContext = ForeachArrayWithContext,
+	.Reduce = Reduce,
+	.RunUnitTests = RunUnitTests
+};
+
+// partial results that fit within this many bytes are kept on the stack
+#define REDUCE_STACK_SIZE 4096
+
+// a loop split into ranges, every job takes the next range until there are none left so threads that finish
+// early keep taking ranges from the threads that haven't
+struct _parallelLoop {
+	ulong Begin;
+	ulong End;
+	ulong Grain;
+	ulong RangeCount;
+	_Atomic(ulong) NextRange;
+	ParallelMethod Method;
+	ParallelReduceMethod ReduceMethod;
+	const void* Identity;
+	ulong ResultSize;
+	byte* Partials;
+	void* Context;
+};
+
+private void RunRanges(void* state)
+{
+	struct _parallelLoop* loop = state;
+
+	while (true)
+	{
+		const ulong range = atomic_fetch_add_explicit(&loop->NextRange, 1, memory_order_relaxed);
+
+		if (range >= loop->RangeCount)
+		{
+			return;
+		}
+
+		const ulong begin = loop->Begin + (range * loop->Grain);
+		const ulong end = min(begin + loop->Grain, loop->End);
+
+		if (loop->ReduceMethod)
+		{
+			// each range has its own partial result so they can be combined in order afterwards
+			void* partial = loop->Partials + (range * loop->ResultSize);
+
+			memcpy(partial, loop->Identity, loop->ResultSize);
+
+			loop->ReduceMethod(loop->Context, begin, end, partial);
+		}
+		else
+		{
+			loop->Method(loop->Context, begin, end);
+		}
+	}
+}
+
+private void RunLoop(struct _parallelLoop* loop)
+{
+	loop->RangeCount = ((loop->End - loop->Begin) + loop->Grain - 1) / loop->Grain;
+
+	atomic_init(&loop->NextRange, 0);
+
+	// there's no reason to queue more jobs than there are threads, or ranges
+	const ulong jobCount = min(loop->RangeCount, (ulong)Jobs.ThreadCount());
+
+	JobCounter counter = { 0 };
+
+	for (ulong i = 1; i < jobCount; i++)
+	{
+		Jobs.Run(RunRanges, loop, &counter);
+	}
+
+	// the calling thread takes ranges too
+	RunRanges(loop);
+
+	Jobs.Wait(&counter);
+}
+
+private void For(ulong begin, ulong end, ulong grain, ParallelMethod method, void* context)
+{
+	if (end <= begin)
+	{
+		return;
+	}
+
+	const ulong count = end - begin;
+	const ulong threads = (ulong)Jobs.ThreadCount();
+
+	if (grain is 0)
+	{
+		if (threads is 1)
+		{
+			method(context, begin, end);
+			return;
+		}
+
+		grain = max((count + (threads * PARALLEL_RANGES_PER_THREAD) - 1) / (threads * PARALLEL_RANGES_PER_THREAD), 1);
+	}
+
+	struct _parallelLoop loop = {
+		.Begin = begin,
+		.End = end,
+		.Grain = grain,
+		.Method = method,
+		.Context = context
+	};
+
+	RunLoop(&loop);
+}
+
+struct _foreachState {
+	Array Array;
+	void* Context;
+	void(*Method)(void* item);
+	void(*MethodWithContext)(void* context, void* item);
+};
+
+private void ForeachRange(void* context, ulong begin, ulong end)
+{
+	struct _foreachState* state = context;
+
+	byte* values = (byte*)state->Array->Values;
+	const ulong elementSize = state->Array->ElementSize;
+
+	for (ulong i = begin; i < end; i++)
+	{
+		state->Method(values + (i * elementSize));
+	}
+}
+
+private void ForeachRangeWithContext(void* context, ulong begin, ulong end)
+{
+	struct _foreachState* state = context;
+
+	byte* values = (byte*)state->Array->Values;
+	const ulong elementSize = state->Array->ElementSize;
+
+	for (ulong i = begin; i < end; i++)
+	{
+		state->MethodWithContext(state->Context, values + (i * elementSize));
+	}
+}
+
+private void ForeachArray(Array array, void(*method)(void* item))
+{
+	struct _foreachState state = {
+		.Array = array,
+		.Method = method
+	};
+
+	For(0, array->Count, 0, ForeachRange, &state);
+}
+
+private void ForeachArrayWithContext(Array array, void* context, void(*method)(void* context, void* item))
+{
+	struct _foreachState state = {
+		.Array = array,
+		.Context = context,
+		.MethodWithContext = method
+	};
+
+	For(0, array->Count, 0, ForeachRangeWithContext, &state);
+}
+
+private void Reduce(ulong begin, ulong end, ulong grain,
+	const void* identity, ulong resultSize,
+	ParallelReduceMethod method,
+	ParallelCombineMethod combine,
+	void* context,
+	void* out_result)
+{
+	memcpy(out_result, identity, resultSize);
+
+	if (end <= begin)
+	{
+		return;
+	}
+
+	const ulong count = end - begin;
+
+	if (grain is 0)
+	{
+		// never depends on the number of threads, otherwise floating point results would change with the machine
+		grain = max((count + PARALLEL_REDUCE_RANGES - 1) / PARALLEL_REDUCE_RANGES, 1);
+	}
+
+	const ulong rangeCount = (count + grain - 1) / grain;
+	const ulong partialsSize = rangeCount * resultSize;
+
+	// the partials are results of any type, aligned like the heap would align them so vectors can be reduced too
+	_Alignas(16) byte stackPartials[REDUCE_STACK_SIZE];
+	byte* partials = partialsSize <= REDUCE_STACK_SIZE ? stackPartials : Memory.Alloc(partialsSize, Memory.GenericMemoryBlock);
+
+	struct _parallelLoop loop = {
+		.Begin = begin,
+		.End = end,
+		.Grain = grain,
+		.ReduceMethod = method,
+		.Identity = identity,
+		.ResultSize = resultSize,
+		.Partials = partials,
+		.Context = context
+	};
+
+	RunLoop(&loop);
+
+	// combined from the first range to the last no matter which thread finished first
+	for (ulong i = 0; i < rangeCount; i++)
+	{
+		combine(context, out_result, partials + (i * resultSize));
+	}
+
+	if (partials isnt stackPartials)
+	{
+		Memory.Free(partials, Memory.GenericMemoryBlock);
+	}
+}
+
+#define TEST_COUNT 1000000
+// rows and columns of the grid that's filled with nested loops
+#define TEST_GRID_SIZE 512
+
+static byte GLOBAL_TestVisits[TEST_COUNT];
+static float GLOBAL_TestValues[TEST_COUNT];
+static float GLOBAL_TestResults[TEST_COUNT];
+
+private void MarkRange(void* context, ulong begin, ulong end)
+{
+	ignore_unused(context);
+
+	for (ulong i = begin; i < end; i++)
+	{
+		GLOBAL_TestVisits[i]++;
+	}
+}
+
+private ulong CountWrongVisits(ulong begin, ulong end)
+{
+	ulong wrong = 0;
+	for (ulong i = 0; i < TEST_COUNT; i++)
+	{
+		const byte expected = i >= begin and i < end;
+		wrong += GLOBAL_TestVisits[i] isnt expected;
+	}
+	return wrong;
+}
+
+private void MarkRow(void* context, ulong begin, ulong end)
+{
+	ignore_unused(context);
+
+	for (ulong row = begin; row < end; row++)
+	{
+		For(row * TEST_GRID_SIZE, (row + 1) * TEST_GRID_SIZE, 0, MarkRange, null);
+	}
+}
+
+private void Double(void* item)
+{
+	*(int*)item *= 2;
+}
+
+private void AddContext(void* context, void* item)
+{
+	*(int*)item += *(int*)context;
+}
+
+private void SumFloats(void* context, ulong begin, ulong end, void* result)
+{
+	ignore_unused(context);
+
+	float sum = *(float*)result;
+
+	for (ulong i = begin; i < end; i++)
+	{
+		sum += GLOBAL_TestValues[i];
+	}
+
+	*(float*)result = sum;
+}
+
+private void CombineFloats(void* context, void* result, const void* partial)
+{
+	ignore_unused(context);
+
+	*(float*)result += *(const float*)partial;
+}
+
+private void SumIndices(void* context, ulong begin, ulong end, void* result)
+{
+	ignore_unused(context);
+
+	ulong sum = *(ulong*)result;
+
+	for (ulong i = begin; i < end; i++)
+	{
+		sum += i;
+	}
+
+	*(ulong*)result = sum;
+}
+
+private void CombineUlongs(void* context, void* result, const void* partial)
+{
+	ignore_unused(context);
+
+	*(ulong*)result += *(const ulong*)partial;
+}
+
+private void FillTestValues(void)
+{
+	// values that lose precision when added in a different order
+	for (ulong i = 0; i < TEST_COUNT; i++)
+	{
+		GLOBAL_TestValues[i] = 1.0f / (float)(1 + (i % 977)) + (float)(i % 3) * 1000.0f;
+	}
+}
+
+private float SumFloatsWithThreads(int threads)
+{
+	const bool started = Jobs.Started();
+
+	if (started is false)
+	{
+		Jobs.Start(threads);
+	}
+
+	const float identity = 0;
+	float sum = 0;
+
+	Reduce(0, TEST_COUNT, 0, &identity, sizeof(float), SumFloats, CombineFloats, null, &sum);
+
+	if (started is false)
+	{
+		Jobs.Stop();
+	}
+
+	return sum;
+}
+
+TEST(ForVisitsEveryIndexOnce)
+{
+	const bool started = Jobs.Started();
+
+	if (started is false)
+	{
+		Jobs.Start(0);
+	}
+
+	const ulong grains[] = { 0, 1, 7, 1000, TEST_COUNT + 5 };
+
+	for (ulong i = 0; i < sizeof(grains) / sizeof(ulong); i++)
+	{
+		memset(GLOBAL_TestVisits, 0, sizeof(GLOBAL_TestVisits));
+
+		For(13, TEST_COUNT, grains[i], MarkRange, null);
+
+		IsZero(CountWrongVisits(13, TEST_COUNT));
+	}
+
+	// nothing to visit
+	memset(GLOBAL_TestVisits, 0, sizeof(GLOBAL_TestVisits));
+	For(20, 20, 0, MarkRange, null);
+	For(20, 10, 0, MarkRange, null);
+	IsZero(CountWrongVisits(0, 0));
+
+	// loops within loops help run each other's ranges instead of blocking
+	memset(GLOBAL_TestVisits, 0, sizeof(GLOBAL_TestVisits));
+	For(0, TEST_GRID_SIZE, 1, MarkRow, null);
+	IsZero(CountWrongVisits(0, TEST_GRID_SIZE * TEST_GRID_SIZE));
+
+	if (started is false)
+	{
+		Jobs.Stop();
+	}
+
+	return true;
+}
+
+TEST(ForeachArray)
+{
+	const bool started = Jobs.Started();
+
+	if (started is false)
+	{
+		Jobs.Start(0);
+	}
+
+	array(int) values = dynamic_array(int, 10000);
+
+	for (int i = 0; i < 10000; i++)
+	{
+		arrays(int).Append(values, i);
+	}
+
+	ForeachArray((Array)values, Double);
+
+	int added = 3;
+	ForeachArrayWithContext((Array)values, &added, AddContext);
+
+	ulong wrong = 0;
+	for (int i = 0; i < 10000; i++)
+	{
+		wrong += at(values, i) isnt (i * 2) + 3;
+	}
+
+	IsZero(wrong);
+
+	arrays(int).Dispose(values);
+
+	if (started is false)
+	{
+		Jobs.Stop();
+	}
+
+	return true;
+}
+
+TEST(ReduceIsDeterministic)
+{
+	const ulong identity = 0;
+	ulong indexSum = 0;
+
+	Reduce(0, TEST_COUNT, 0, &identity, sizeof(ulong), SumIndices, CombineUlongs, null, &indexSum);
+
+	const ulong expectedIndexSum = ((ulong)TEST_COUNT * (TEST_COUNT - 1)) / 2;
+	IsEqual(expectedIndexSum, indexSum);
+
+	// a grain that needs more partial results than fit on the stack
+	indexSum = 0;
+	Reduce(0, TEST_COUNT, 100, &identity, sizeof(ulong), SumIndices, CombineUlongs, null, &indexSum);
+	IsEqual(expectedIndexSum, indexSum);
+
+	FillTestValues();
+
+	// the same ranges combined in the same order serially
+	const ulong grain = (TEST_COUNT + PARALLEL_REDUCE_RANGES - 1) / PARALLEL_REDUCE_RANGES;
+	float expected = 0;
+	for (ulong begin = 0; begin < TEST_COUNT; begin += grain)
+	{
+		float partial = 0;
+		SumFloats(null, begin, min(begin + grain, TEST_COUNT), &partial);
+		expected += partial;
+	}
+
+	const float single = SumFloatsWithThreads(1);
+	const float multiple = SumFloatsWithThreads(0);
+
+	IsTrue(memcmp(&expected, &single, sizeof(float)) is 0);
+	IsTrue(memcmp(&expected, &multiple, sizeof(float)) is 0);
+
+	return true;
+}
+
+private void Transform(void* context, ulong begin, ulong end)
+{
+	ignore_unused(context);
+
+	for (ulong i = begin; i < end; i++)
+	{
+		GLOBAL_TestResults[i] = sqrtf(GLOBAL_TestValues[i]) * 2.0f + 1.0f;
+	}
+}
+
+private bool RunTransforms(ulong count)
+{
+	for (ulong i = 0; i < count; i++)
+	{
+		For(0, TEST_COUNT, 0, Transform, null);
+	}
+	return true;
+}
+
+private bool RunSums(ulong count)
+{
+	const float identity = 0;
+	float sum = 0;
+
+	for (ulong i = 0; i < count; i++)
+	{
+		Reduce(0, TEST_COUNT, 0, &identity, sizeof(float), SumFloats, CombineFloats, null, &sum);
+	}
+
+	return sum > 0;
+}
+
+TEST(Scaling)
+{
+	FillTestValues();
+
+	const bool started = Jobs.Started();
+
+	// the workers can't be restarted with a different number of threads while something else uses them
+	const int maxThreads = started ? Jobs.ThreadCount() : OperatingSystem.ThreadCount();
+
+	int threads = started ? maxThreads : 1;
+
+	while (true)
+	{
+		if (started is false)
+		{
+			Jobs.Start(threads);
+		}
+
+		fprintf(__test_stream, "\t100 transforms of %i floats on %i threads"NEWLINE, TEST_COUNT, Jobs.ThreadCount());
+		Benchmark(RunTransforms(100), __test_stream);
+
+		fprintf(__test_stream, "\t100 sums of %i floats on %i threads"NEWLINE, TEST_COUNT, Jobs.ThreadCount());
+		Benchmark(RunSums(100), __test_stream);
+
+		if (started is false)
+		{
+			Jobs.Stop();
+		}
+
+		if (threads >= maxThreads)
+		{
+			break;
+		}
+
+		threads = min(threads * 2, maxThreads);
+	}
+
+	return true;
+}
+
+TEST_SUITE(RunUnitTests,
+	APPEND_TEST(ForVisitsEveryIndexOnce)
+	APPEND_TEST(ForeachArray)
+	APPEND_TEST(ReduceIsDeterministic)
+	APPEND_TEST(Scaling)
+);
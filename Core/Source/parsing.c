@@ -2,6 +2,8 @@
 #include <ctype.h>
 #include <stdlib.h>
 #include <string.h>
+#include <float.h>
+#include <limits.h>
 #include "core/memory.h"
 #include "core/strings.h"
 #include "core/cunit.h"
@@ -12,6 +14,16 @@ private bool TryParseBoolean(const char* buffer, const ulong bufferLength, bool*
 private bool TryParseLine(const char* buffer, const ulong bufferLength, const ulong maxStringLength, char** out_string);
 private bool TryParseString(const char* buffer, const ulong bufferLength, const ulong maxStringLength, char** out_string);
 private bool TryParseStringArray(const char* buffer, const ulong bufferLength, char*** out_array, ulong** out_lengths, ulong* out_count);
+private bool TryReadFloat(const char** position, const char* end, float* out_value);
+private bool TryReadInt(const char** position, const char* end, long long* out_value);
+private bool TryReadHex(const char** position, const char* end, unsigned long long* out_value);
+private bool TryParseFloat(const char* buffer, const ulong bufferLength, float* out_value);
+private bool TryParseInt(const char* buffer, const ulong bufferLength, long long* out_value);
+private bool TryParseHex(const char* buffer, const ulong bufferLength, unsigned long long* out_value);
+private bool TryParseFloats(const char* buffer, const ulong bufferLength, float* out_values, const ulong count);
+private bool TryParseStringSlice(const char* buffer, const ulong bufferLength, slice* out_slice);
+private bool TryParseLineSlice(const char* buffer, const ulong bufferLength, slice* out_slice);
+private ulong GetStringSlices(const char* buffer, const ulong bufferLength, slice* out_slices, const ulong capacity);
 private void RunParsingUnitTests();
 
 const struct _parsing Parsing = {
@@ -19,6 +31,16 @@ const struct _parsing Parsing = {
 	.TryGetLine = TryParseLine,
 	.TryGetString = TryParseString,
 	.TryGetStrings = TryParseStringArray,
+	.TryReadFloat = TryReadFloat,
+	.TryReadInt = TryReadInt,
+	.TryReadHex = TryReadHex,
+	.TryGetFloat = TryParseFloat,
+	.TryGetInt = TryParseInt,
+	.TryGetHex = TryParseHex,
+	.TryGetFloats = TryParseFloats,
+	.TryGetStringSlice = TryParseStringSlice,
+	.TryGetLineSlice = TryParseLineSlice,
+	.GetStringSlices = GetStringSlices,
 	.RunParsingUnitTests = &RunParsingUnitTests
 };
 
@@ -48,9 +70,26 @@ private bool TryParseBoolean(const char* buffer, const ulong bufferLength, bool*
 
 	char copiedString[11];
 
-	copiedString[10] = '\0';
+	// values can point into a mapped file so the buffer isn't always terminated, copy the first word up to its length
+	ulong start = 0;
+	while (start < bufferLength and isspace((byte)buffer[start]))
+	{
+		start++;
+	}
+
+	ulong copied = 0;
+	while (copied < 10 and start + copied < bufferLength and buffer[start + copied] isnt '\0' and isspace((byte)buffer[start + copied]) is false)
+	{
+		copiedString[copied] = buffer[start + copied];
+		copied++;
+	}
 
-	sscanf_s(buffer, "%10s", &copiedString, 10);
+	copiedString[copied] = '\0';
+
+	if (copied is 0)
+	{
+		return false;
+	}
 
 	ulong length = strlen(copiedString) - 1;
 
@@ -200,7 +239,9 @@ private bool TryParseStringArray(const char* buffer, const ulong bufferLength, c
 	// loop until we either found the end of the buffer, exceed the buffer length or we move to the next line
 	do
 	{
-		c = buffer[index++];
+		// the end of the buffer counts as a delimiter, it isn't always terminated
+		c = index < bufferLength ? buffer[index] : '\0';
+		index++;
 
 		// if we found the end to a string we should record the position and previouslength
 		if (c is ';' or c is ',' or c is '\0' or c is '\n' or c is '\r')
@@ -264,6 +305,394 @@ private bool TryParseStringArray(const char* buffer, const ulong bufferLength, c
 	return true;
 }
 
+// mantissas with more significant digits than this can't be held by a ulong
+#define MAX_FAST_DIGITS 19
+// integers up to this are exactly representable as doubles
+#define MAX_EXACT_MANTISSA (1ull << 53)
+// the largest power of ten that is exactly representable as a double
+#define MAX_EXACT_POWER 22
+// the bits a double has that a float doesn't
+#define DOUBLE_TO_FLOAT_BITS 29
+// floats longer than this are parsed by strtof only up to this many characters
+#define MAX_FALLBACK_LENGTH 64
+
+static const double PowersOfTen[MAX_EXACT_POWER + 1] = {
+	1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+	1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+};
+
+private bool IsDigit(const char c)
+{
+	return c >= '0' and c <= '9';
+}
+
+// isspace without the locale lookup, and safe for negative chars
+private bool IsWhitespace(const char c)
+{
+	return c is ' ' or c is '\t' or c is '\n' or c is '\r' or c is '\v' or c is '\f';
+}
+
+private const char* SkipWhitespace(const char* position, const char* end)
+{
+	while (position < end and IsWhitespace(*position))
+	{
+		++position;
+	}
+
+	return position;
+}
+
+// parses the float with strtof, for the inputs the fast path can't round correctly, infinities, nans and hex floats
+private bool TryReadFloatSlow(const char** position, const char* start, const char* end, float* out_value)
+{
+	char copy[MAX_FALLBACK_LENGTH];
+
+	const ulong length = min((ulong)(end - start), MAX_FALLBACK_LENGTH - 1);
+
+	memcpy(copy, start, length);
+	copy[length] = '\0';
+
+	char* stop;
+	const float value = strtof(copy, &stop);
+
+	if (stop is copy)
+	{
+		return false;
+	}
+
+	*position = start + (stop - copy);
+	*out_value = value;
+
+	return true;
+}
+
+private bool TryReadFloat(const char** position, const char* end, float* out_value)
+{
+	const char* start = SkipWhitespace(*position, end);
+	const char* cursor = start;
+
+	bool negative = false;
+	if (cursor < end and (*cursor is '-' or *cursor is '+'))
+	{
+		negative = *cursor is '-';
+		++cursor;
+	}
+
+	ulong mantissa = 0;
+	int significantDigits = 0;
+	int exponent = 0;
+	bool anyDigits = false;
+	// true when a non-zero digit didn't fit within the mantissa
+	bool truncated = false;
+
+	while (cursor < end and IsDigit(*cursor))
+	{
+		const int digit = *cursor++ - '0';
+		anyDigits = true;
+
+		if (significantDigits < MAX_FAST_DIGITS)
+		{
+			mantissa = mantissa * 10 + digit;
+			// leading zeros aren't significant
+			significantDigits += mantissa isnt 0;
+		}
+		else
+		{
+			++exponent;
+			truncated = truncated or digit isnt 0;
+		}
+	}
+
+	if (cursor < end and *cursor is '.')
+	{
+		++cursor;
+
+		while (cursor < end and IsDigit(*cursor))
+		{
+			const int digit = *cursor++ - '0';
+			anyDigits = true;
+
+			if (significantDigits < MAX_FAST_DIGITS)
+			{
+				mantissa = mantissa * 10 + digit;
+				significantDigits += mantissa isnt 0;
+				--exponent;
+			}
+			else
+			{
+				truncated = truncated or digit isnt 0;
+			}
+		}
+	}
+
+	// inf, nan, or not a number at all
+	if (anyDigits is false)
+	{
+		return TryReadFloatSlow(position, start, end, out_value);
+	}
+
+	// the exponent is only part of the number when it has digits, "1e" is 1 followed by an e
+	if (cursor < end and (*cursor is 'e' or *cursor is 'E'))
+	{
+		const char* exponentCursor = cursor + 1;
+
+		bool negativeExponent = false;
+		if (exponentCursor < end and (*exponentCursor is '-' or *exponentCursor is '+'))
+		{
+			negativeExponent = *exponentCursor is '-';
+			++exponentCursor;
+		}
+
+		if (exponentCursor < end and IsDigit(*exponentCursor))
+		{
+			int value = 0;
+			while (exponentCursor < end and IsDigit(*exponentCursor))
+			{
+				// anything larger is infinity or zero, either way strtof handles it
+				if (value < 100000)
+				{
+					value = value * 10 + (*exponentCursor - '0');
+				}
+				++exponentCursor;
+			}
+
+			exponent += negativeExponent ? -value : value;
+			cursor = exponentCursor;
+		}
+	}
+
+	// hex floats
+	if (cursor < end and (*cursor is 'x' or *cursor is 'X'))
+	{
+		return TryReadFloatSlow(position, start, end, out_value);
+	}
+
+	if (truncated or mantissa > MAX_EXACT_MANTISSA or exponent < -MAX_EXACT_POWER or exponent > MAX_EXACT_POWER)
+	{
+		return TryReadFloatSlow(position, start, end, out_value);
+	}
+
+	// both the mantissa and power are exact so the double is correctly rounded
+	double value = (double)mantissa;
+	value = exponent < 0 ? value / PowersOfTen[-exponent] : value * PowersOfTen[exponent];
+
+	if (value isnt 0.0)
+	{
+		unsigned long long bits;
+		memcpy(&bits, &value, sizeof(double));
+
+		const unsigned long long halfway = 1ull << (DOUBLE_TO_FLOAT_BITS - 1);
+		const unsigned long long droppedBits = bits & ((1ull << DOUBLE_TO_FLOAT_BITS) - 1);
+
+		// rounding to a double then to a float can round twice when the double lands halfway between two floats,
+		// subnormal floats have fewer bits and overflow has to set errno the same as strtof
+		if (droppedBits is halfway or value < FLT_MIN or value > FLT_MAX)
+		{
+			return TryReadFloatSlow(position, start, end, out_value);
+		}
+	}
+
+	const float result = (float)value;
+
+	*out_value = negative ? -result : result;
+	*position = cursor;
+
+	return true;
+}
+
+private bool TryReadInt(const char** position, const char* end, long long* out_value)
+{
+	const char* cursor = SkipWhitespace(*position, end);
+
+	bool negative = false;
+	if (cursor < end and (*cursor is '-' or *cursor is '+'))
+	{
+		negative = *cursor is '-';
+		++cursor;
+	}
+
+	if (cursor >= end or IsDigit(*cursor) is false)
+	{
+		return false;
+	}
+
+	// the magnitude of LLONG_MIN is one larger than LLONG_MAX
+	const unsigned long long limit = negative ? (unsigned long long)LLONG_MAX + 1 : (unsigned long long)LLONG_MAX;
+
+	unsigned long long value = 0;
+	while (cursor < end and IsDigit(*cursor))
+	{
+		const unsigned long long digit = *cursor++ - '0';
+
+		if (value > (limit - digit) / 10)
+		{
+			return false;
+		}
+
+		value = value * 10 + digit;
+	}
+
+	*out_value = negative ? (long long)(0 - value) : (long long)value;
+	*position = cursor;
+
+	return true;
+}
+
+// the value of the hex digit, -1 when it isn't one
+private int HexDigit(const char c)
+{
+	if (c >= '0' and c <= '9')
+	{
+		return c - '0';
+	}
+
+	if (c >= 'a' and c <= 'f')
+	{
+		return c - 'a' + 10;
+	}
+
+	if (c >= 'A' and c <= 'F')
+	{
+		return c - 'A' + 10;
+	}
+
+	return -1;
+}
+
+private bool TryReadHex(const char** position, const char* end, unsigned long long* out_value)
+{
+	const char* cursor = SkipWhitespace(*position, end);
+
+	// the prefix is optional, like %x
+	if (end - cursor > 2 and cursor[0] is '0' and (cursor[1] is 'x' or cursor[1] is 'X') and HexDigit(cursor[2]) isnt -1)
+	{
+		cursor += 2;
+	}
+
+	if (cursor >= end or HexDigit(*cursor) is -1)
+	{
+		return false;
+	}
+
+	unsigned long long value = 0;
+	while (cursor < end and HexDigit(*cursor) isnt -1)
+	{
+		if (value > (ULLONG_MAX >> 4))
+		{
+			return false;
+		}
+
+		value = (value << 4) | (unsigned long long)HexDigit(*cursor++);
+	}
+
+	*out_value = value;
+	*position = cursor;
+
+	return true;
+}
+
+private bool TryParseFloat(const char* buffer, const ulong bufferLength, float* out_value)
+{
+	const char* position = buffer;
+	return TryReadFloat(&position, buffer + bufferLength, out_value);
+}
+
+private bool TryParseInt(const char* buffer, const ulong bufferLength, long long* out_value)
+{
+	const char* position = buffer;
+	return TryReadInt(&position, buffer + bufferLength, out_value);
+}
+
+private bool TryParseHex(const char* buffer, const ulong bufferLength, unsigned long long* out_value)
+{
+	const char* position = buffer;
+	return TryReadHex(&position, buffer + bufferLength, out_value);
+}
+
+private bool TryParseFloats(const char* buffer, const ulong bufferLength, float* out_values, const ulong count)
+{
+	const char* position = buffer;
+	const char* end = buffer + bufferLength;
+
+	for (ulong i = 0; i < count; i++)
+	{
+		if (TryReadFloat(&position, end, out_values + i) is false)
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+private bool TryParseStringSlice(const char* buffer, const ulong bufferLength, slice* out_slice)
+{
+	const char* end = buffer + bufferLength;
+	const char* start = SkipWhitespace(buffer, end);
+
+	const char* cursor = start;
+	while (cursor < end and *cursor isnt '\0' and IsWhitespace(*cursor) is false)
+	{
+		++cursor;
+	}
+
+	*out_slice = (slice){ .Values = start, .Length = cursor - start };
+
+	return cursor isnt start;
+}
+
+private bool TryParseLineSlice(const char* buffer, const ulong bufferLength, slice* out_slice)
+{
+	const char* end = buffer + bufferLength;
+	const char* start = SkipWhitespace(buffer, end);
+
+	const char* cursor = start;
+	while (cursor < end and *cursor isnt '\0')
+	{
+		++cursor;
+	}
+
+	*out_slice = (slice){ .Values = start, .Length = cursor - start };
+
+	return cursor isnt start;
+}
+
+private ulong GetStringSlices(const char* buffer, const ulong bufferLength, slice* out_slices, const ulong capacity)
+{
+	if (bufferLength is 0)
+	{
+		return 0;
+	}
+
+	ulong count = 0;
+	ulong start = 0;
+
+	// the end of the buffer ends the last slice
+	for (ulong index = 0; index <= bufferLength; index++)
+	{
+		const char c = index < bufferLength ? buffer[index] : '\0';
+
+		if (c is ';' or c is ',' or c is '\0' or c is '\n' or c is '\r')
+		{
+			if (count < capacity)
+			{
+				out_slices[count] = (slice){ .Values = buffer + start, .Length = index - start };
+			}
+
+			++count;
+			start = index + 1;
+
+			// a nul ends the buffer as well
+			if (c is '\0')
+			{
+				break;
+			}
+		}
+	}
+
+	return count;
+}
+
 private bool Test_Helper_TryParseBoolean(File __test_stream, char* data, bool shouldParse, bool expected)
 {
 	bool actual;
@@ -304,8 +733,10 @@ TEST(Test_TryParseBoolean)
 
 TEST(Test_TryParseStringArray)
 {
-	Memory.AllocCount = 0;
-	Memory.AllocSize = 0;
+	Memory.CollectStatistics();
+
+	const ulong previousAllocCount = Memory.AllocCount;
+	const ulong previousFreeCount = Memory.FreeCount;
 
 	char* data = "this, should, be a, string, array";
 	ulong dataLength = strlen(data);
@@ -362,12 +793,267 @@ TEST(Test_TryParseStringArray)
 	Memory.Free(strings, Memory.String);
 
 	// ensure no memory leak
-	Assert(Memory.AllocCount <= Memory.FreeCount);
+	Memory.CollectStatistics();
+
+	Assert(Memory.AllocCount - previousAllocCount <= Memory.FreeCount - previousFreeCount);
+
+	return true;
+}
+private bool FloatMatchesStrtof(const char* text)
+{
+	char* stop;
+	const float expected = strtof(text, &stop);
+
+	const char* position = text;
+	float actual;
+	const bool parsed = TryReadFloat(&position, text + strlen(text), &actual);
+
+	if (stop is text)
+	{
+		return parsed is false;
+	}
+
+	// compare the bits so signed zeros and nans are compared exactly
+	return parsed and position is stop and memcmp(&expected, &actual, sizeof(float)) is 0;
+}
+
+TEST(Test_TryReadFloat)
+{
+	const char* cases[] = {
+		"0", "-0", "+0", "1", "-1", "0.5", ".5", "5.", "3.14159265358979", "  \t 42.25",
+		"1e10", "1E-10", "1e", "1e+", "2.5e+3", "-7.125e-2", "1e38", "3.4028235e38", "3.5e38", "1e39",
+		"1e-38", "1.17549435e-38", "1e-40", "1e-45", "1e-46", "123456789012345678901234567890",
+		"0.000000000000000000000000000001", "16777217", "16777216.5", "33554435", "8388609.5",
+		"0.1", "0.2", "0.30000001192092896", "inf", "-infinity", "nan", "0x1p3", "abc", "-", ".", "",
+		"1.000000 0.500000", "12abc", "1,5"
+	};
+
+	ulong failures = 0;
+	for (ulong i = 0; i < sizeof(cases) / sizeof(char*); i++)
+	{
+		if (FloatMatchesStrtof(cases[i]) is false)
+		{
+			fprintf(__test_stream, "\tfailed to parse %s the same as strtof"NEWLINE, cases[i]);
+			++failures;
+		}
+	}
+
+	// random floats written the ways floats are written to files
+	char buffer[64];
+	uint state = 0x9E3779B9u;
+	for (ulong i = 0; i < 100000; i++)
+	{
+		state ^= state << 13;
+		state ^= state >> 17;
+		state ^= state << 5;
+
+		float value;
+		memcpy(&value, &state, sizeof(float));
+
+		if (value isnt value)
+		{
+			continue;
+		}
+
+		switch (i % 3)
+		{
+		case 0:
+			snprintf(buffer, sizeof(buffer), "%.9g", value);
+			break;
+		case 1:
+			snprintf(buffer, sizeof(buffer), "%.*e", (int)(i % 10), value);
+			break;
+		default:
+			snprintf(buffer, sizeof(buffer), "%f", (double)(state % 2000000) / (double)(1 + i % 1000));
+			break;
+		}
+
+		failures += FloatMatchesStrtof(buffer) ? 0 : 1;
+	}
+
+	IsZero(failures);
+
+	// never reads past the end of the buffer
+	const char* unterminated = "12.5678";
+	float value;
+	Assert(TryParseFloat(unterminated, 4, &value));
+	IsEqual(12.5f, value);
+
+	IsFalse(TryParseFloat(unterminated, 0, &value));
+
+	return true;
+}
+
+TEST(Test_TryGetFloats)
+{
+	const char* data = "1.000000 -0.500000\t2.25e1  4";
+	const ulong dataLength = strlen(data);
+
+	float values[5];
+
+	Assert(TryParseFloats(data, dataLength, values, 4));
+
+	IsEqual(1.0f, values[0]);
+	IsEqual(-0.5f, values[1]);
+	IsEqual(22.5f, values[2]);
+	IsEqual(4.0f, values[3]);
+
+	IsFalse(TryParseFloats(data, dataLength, values, 5));
+
+	return true;
+}
+
+TEST(Test_TryReadInt)
+{
+	long long value;
+
+	Assert(TryParseInt(" 42", 3, &value));
+	IsEqual(42ll, value);
+
+	Assert(TryParseInt("-9223372036854775808", 20, &value));
+	IsEqual(LLONG_MIN, value);
+
+	Assert(TryParseInt("9223372036854775807", 19, &value));
+	IsEqual(LLONG_MAX, value);
+
+	IsFalse(TryParseInt("9223372036854775808", 19, &value));
+	IsFalse(TryParseInt("abc", 3, &value));
+	IsFalse(TryParseInt("-", 1, &value));
+
+	// stops at the first character that isn't a digit
+	const char* face = "12/7/3";
+	const char* position = face;
+
+	Assert(TryReadInt(&position, face + strlen(face), &value));
+	IsEqual(12ll, value);
+	IsEqual('/', *position);
+
+	return true;
+}
+
+TEST(Test_TryReadHex)
+{
+	unsigned long long value;
+
+	Assert(TryParseHex("ffui", 4, &value));
+	IsEqual(255ull, value);
+
+	Assert(TryParseHex(" 0x1F", 5, &value));
+	IsEqual(31ull, value);
+
+	Assert(TryParseHex("ffffffffffffffff", 16, &value));
+	IsEqual(ULLONG_MAX, value);
+
+	IsFalse(TryParseHex("10000000000000000", 17, &value));
+	IsFalse(TryParseHex("ui", 2, &value));
+
+	// never reads past the length even when the digits keep going
+	Assert(TryParseHex("12ff", 2, &value));
+	IsEqual(18ull, value);
+
+	return true;
+}
+
+TEST(Test_StringSlices)
+{
+	const char* data = "  this, should, be a, string, array";
+	const ulong dataLength = strlen(data);
+
+	slice word;
+
+	Assert(TryParseStringSlice(data, dataLength, &word));
+	IsEqual((ulong)5, word.Length);
+	IsEqual(0, memcmp(word.Values, "this,", word.Length));
+
+	Assert(TryParseLineSlice(data, dataLength, &word));
+	IsEqual(dataLength - 2, word.Length);
+
+	IsFalse(TryParseStringSlice("   ", 3, &word));
+
+	slice slices[4];
+
+	const ulong count = GetStringSlices(data, dataLength, slices, 4);
+
+	// the count is the number of slices even when there wasn't room for them all
+	IsEqual((ulong)5, count);
+	IsEqual((ulong)6, slices[0].Length);
+	IsEqual(0, memcmp(slices[0].Values, "  this", slices[0].Length));
+	IsEqual((ulong)5, slices[2].Length);
+	IsEqual(0, memcmp(slices[2].Values, " be a", slices[2].Length));
+
+	IsEqual((ulong)0, GetStringSlices(data, 0, slices, 4));
+
+	// delimiters at the end leave empty slices the same as TryGetStrings
+	IsEqual((ulong)3, GetStringSlices("a,b,", 4, slices, 4));
+	IsEqual((ulong)0, slices[2].Length);
 
 	return true;
 }
+
+// parses lines written the way vectors are saved
+private bool SscanfVectors(const char* data, ulong lines, ulong lineLength, float* out_values)
+{
+	bool result = true;
+	for (ulong i = 0; i < lines; i++)
+	{
+		float* vector = out_values + (i * 4);
+		result = result and sscanf_s(data + (i * lineLength), "%f %f %f %f", vector, vector + 1, vector + 2, vector + 3) is 4;
+	}
+	return result;
+}
+
+private bool ParseVectors(const char* data, ulong lines, ulong lineLength, float* out_values)
+{
+	bool result = true;
+	for (ulong i = 0; i < lines; i++)
+	{
+		result = result and TryParseFloats(data + (i * lineLength), lineLength, out_values + (i * 4), 4);
+	}
+	return result;
+}
+
+TEST(Benchmark)
+{
+	const ulong lines = 100000;
+	const ulong lineLength = 48;
+
+	char* data = Memory.Alloc(lines * lineLength, Memory.String);
+	float* expected = Memory.Alloc(sizeof(float) * 4 * lines, Memory.GenericMemoryBlock);
+	float* actual = Memory.Alloc(sizeof(float) * 4 * lines, Memory.GenericMemoryBlock);
+
+	for (ulong i = 0; i < lines; i++)
+	{
+		snprintf(data + (i * lineLength), lineLength, "%f %f %f %f", i * 0.25f, -(float)(i % 1000) / 7.0f, 1.0f / (1 + i), 1.0f);
+	}
+
+	bool sscanfParsed = false;
+	bool parsed = false;
+
+	fprintf(__test_stream, "\tsscanf_s (%lli vector4s)"NEWLINE, lines);
+	Benchmark(sscanfParsed = SscanfVectors(data, lines, lineLength, expected), __test_stream);
+
+	fprintf(__test_stream, "\tTryGetFloats (%lli vector4s)"NEWLINE, lines);
+	Benchmark(parsed = ParseVectors(data, lines, lineLength, actual), __test_stream);
+
+	IsTrue(sscanfParsed);
+	IsTrue(parsed);
+	IsTrue(memcmp(expected, actual, sizeof(float) * 4 * lines) is 0);
+
+	Memory.Free(data, Memory.String);
+	Memory.Free(expected, Memory.GenericMemoryBlock);
+	Memory.Free(actual, Memory.GenericMemoryBlock);
+
+	return true;
+}
+
 TEST_SUITE(
 	RunParsingUnitTests,
 	APPEND_TEST(Test_TryParseStringArray)
 	APPEND_TEST(Test_TryParseBoolean)
+	APPEND_TEST(Test_TryReadFloat)
+	APPEND_TEST(Test_TryGetFloats)
+	APPEND_TEST(Test_TryReadInt)
+	APPEND_TEST(Test_TryReadHex)
+	APPEND_TEST(Test_StringSlices)
+	APPEND_TEST(Benchmark)
 )
\ No newline at end of file
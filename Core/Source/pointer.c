@@ -17,7 +17,7 @@ DEFINE_TYPE_ID(voidPointer);
 
 private Pointer(void) Create(void* resourceToInstance)
 {
-	REGISTER_TYPE(voidPointer);
+	REGISTER_SLAB_TYPE(voidPointer, sizeof(struct _pointer_void));
 
 	Pointer(void) resource = Memory.Alloc(sizeof(struct _pointer_void), typeid(voidPointer));
 
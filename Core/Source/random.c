@@ -1,5 +1,3 @@
-#pragma once
-
 #include "core/random.h"
 #include <float.h>
 //#include "core/time.h"
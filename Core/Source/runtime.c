@@ -1,11 +1,13 @@
-#pragma once
-
 #include "core/runtime.h"
 #include "core/csharp.h"
 #include "core/math/floats.h"
-#include "core/tasks.h"
+#include "core/jobs.h"
+#include "core/eventGraph.h"
 #include "core/os.h"
 #include "core/atomic.h"
+#include "core/memory.h"
+#include "core/ioRequests.h"
+#include "core/futures.h"
 
 private void Close(void);
 private void Start(void);
@@ -15,6 +17,9 @@ private void RemoveEvent(RuntimeEventType, void(*Method)(void));
 private void SetParentApplication(struct _Application* parent);
 private array(array(_VoidMethod)) GlobalEvents();
 private void InitializeThreadedEvents();
+private void Reads(void(*Method)(void), const char* resource);
+private void Writes(void(*Method)(void), const char* resource);
+private void DependsOn(void(*Method)(void), void(*Dependency)(void));
 
 struct _Application Application =
 {
@@ -26,6 +31,9 @@ struct _Application Application =
 	.RemoveEvent = RemoveEvent,
 	.SetParentApplication = SetParentApplication,
 	.InitializeThreadedEvents = InitializeThreadedEvents,
+	.Reads = Reads,
+	.Writes = Writes,
+	.DependsOn = DependsOn,
 	.InternalState = {
 		.CloseApplicationFlag = 0,
 		.PreviousTime = 0.0,
@@ -60,11 +68,9 @@ array(_VoidMethod) GLOBAL_AfterRenderEvents;
 
 array(array(_VoidMethod)) GLOBAL_Events = empty_stack_array(array(_VoidMethod), sizeof(RuntimeEventTypes) / sizeof(RuntimeEventType));
 
-array(_VoidMethod) GLOBAL_EventStack;
-array(Task) GLOBAL_Workers;
-locker GLOBAL_WorkerLock;
-bool GLOBAL_NewWorkSignal = false;
-long GLOBAL_WorkersWorkingCount = 0;
+// the threaded events of a frame with and without the fixed update, each is only rebuilt when the events or declarations change
+EventGraph GLOBAL_UpdateGraph;
+EventGraph GLOBAL_FixedUpdateGraph;
 
 private array(array(_VoidMethod)) GlobalEvents()
 {
@@ -150,65 +156,58 @@ private void RemoveEvent(RuntimeEventType eventType, void(*Method)(void))
 	arrays(_VoidMethod).RemoveIndex(eventArray, index);
 }
 
-// this is the work that all the runtime threads should do
-private int WorkerJob(void* state)
+private void Reads(void(*Method)(void), const char* resource)
 {
-	ignore_unused(state);
-
-	// wait for new work
-	Task task = Tasks.CurrentTask();
-
-	// exit when asked
-	while (task->RequestExitFlag is false)
+	if (Application.InternalState.ParentProcessApplication)
 	{
-		while (GLOBAL_EventStack->Count)
-		{
-			_VoidMethod method = null;
-
-
-
-			lock(GLOBAL_WorkerLock,
-				if (GLOBAL_EventStack->Count)
-				{
-					method = arrays(_VoidMethod).Pop(GLOBAL_EventStack);
-					_InterlockedIncrement(&GLOBAL_WorkersWorkingCount);
-
-					/*fprintf_yellow(stdout, "Got work, workers active: %i Total Tasks:%lli [%i]\n",
-						GLOBAL_WorkersWorkingCount,
-						GLOBAL_EventStack->Count,
-						Tasks.ThreadId());*/
-
-				}
-			);
-
-			if (method)
-			{
-				method();
-
-				/*fprintf_yellow(stdout, "Finshed work, workers active: %i Total Tasks:%lli [%i]\n",
-					GLOBAL_WorkersWorkingCount,
-					GLOBAL_EventStack->Count,
-					Tasks.ThreadId());*/
+		Application.InternalState.ParentProcessApplication->Reads(Method, resource);
+		return;
+	}
 
+	if (Application.InternalState.RuntimeStarted is false)
+	{
+		fprintf_red(stderr, "Failed to declare resource %s, runtime not started", resource);
+		throw(InvalidArgumentException);
+	}
 
-				_InterlockedDecrement(&GLOBAL_WorkersWorkingCount);
-				Tasks.NotifyAllThreadsAddressChanged(&GLOBAL_WorkersWorkingCount);
-			}
+	EventGraphs.Reads(GLOBAL_UpdateGraph, Method, resource);
+	EventGraphs.Reads(GLOBAL_FixedUpdateGraph, Method, resource);
+}
 
-		}
+private void Writes(void(*Method)(void), const char* resource)
+{
+	if (Application.InternalState.ParentProcessApplication)
+	{
+		Application.InternalState.ParentProcessApplication->Writes(Method, resource);
+		return;
+	}
 
-		Tasks.WaitOnAddress(&GLOBAL_NewWorkSignal, sizeof(bool), Tasks.Forever);
+	if (Application.InternalState.RuntimeStarted is false)
+	{
+		fprintf_red(stderr, "Failed to declare resource %s, runtime not started", resource);
+		throw(InvalidArgumentException);
 	}
 
-	return 0;
+	EventGraphs.Writes(GLOBAL_UpdateGraph, Method, resource);
+	EventGraphs.Writes(GLOBAL_FixedUpdateGraph, Method, resource);
 }
 
-private void InitializeWorkers(array(Task) workers)
+private void DependsOn(void(*Method)(void), void(*Dependency)(void))
 {
-	for (int i = 0; i < OperatingSystem.ThreadCount() - 1; i++)
+	if (Application.InternalState.ParentProcessApplication)
+	{
+		Application.InternalState.ParentProcessApplication->DependsOn(Method, Dependency);
+		return;
+	}
+
+	if (Application.InternalState.RuntimeStarted is false)
 	{
-		arrays(Task).Append(workers, Tasks.Run(Tasks.Create(WorkerJob), null));
+		fprintf_red(stderr, "Failed to declare dependency, runtime not started%s", "");
+		throw(InvalidArgumentException);
 	}
+
+	EventGraphs.DependsOn(GLOBAL_UpdateGraph, Method, Dependency);
+	EventGraphs.DependsOn(GLOBAL_FixedUpdateGraph, Method, Dependency);
 }
 
 private void ExpandMultiThreadedEvents(RuntimeEventType type, _VoidMethod* methods)
@@ -256,45 +255,25 @@ private void InitializeRuntime()
 	arrays(array(_VoidMethod)).Append(GLOBAL_Events, GLOBAL_RenderEvents);
 	arrays(array(_VoidMethod)).Append(GLOBAL_Events, GLOBAL_AfterRenderEvents);
 
+	// created before any job thread can ask for it
+	Memory.Arena.Frame();
 
-	GLOBAL_EventStack = dynamic_array(_VoidMethod, 0);
-	GLOBAL_Workers = dynamic_array(Task, OperatingSystem.ThreadCount() - 1);
+	// the main thread runs jobs too whenever it waits on them
+	Jobs.Start(0);
 
-	InitializeWorkers(GLOBAL_Workers);
+	GLOBAL_UpdateGraph = EventGraphs.Create();
+	GLOBAL_FixedUpdateGraph = EventGraphs.Create();
 
 	Application.InternalState.RuntimeStarted = true;
 
 	InitializeThreadedEvents();
 }
 
-private void ExecuteEvents(array(_VoidMethod) events, bool mainthread)
+private void ExecuteEvents(array(_VoidMethod) events)
 {
 	for (int i = 0; i < events->Count; i++)
 	{
-		if (mainthread)
-		{
-			at(events, i)();
-		}
-		else
-		{
-			lock(GLOBAL_WorkerLock,
-				arrays(_VoidMethod).Append(GLOBAL_EventStack, at(events, i));
-			//fprintf(stdout, "Adding work: Active Workers:%i, Total Work:%lli [%i]\n", GLOBAL_WorkersWorkingCount, GLOBAL_EventStack->Count, Tasks.ThreadId());
-			);
-
-			Tasks.NotifyAddressChanged(&GLOBAL_NewWorkSignal);
-		}
-	}
-
-	// wait for workers to finish
-	if (mainthread is false && GLOBAL_WorkersWorkingCount)
-	{
-		while (GLOBAL_WorkersWorkingCount > 0)
-		{
-			_sleep(1);
-		}
-		//fprintf_red(stdout, "All events finished continuing to next events [%i]\n", Tasks.ThreadId());
-
+		at(events, i)();
 	}
 }
 
@@ -309,14 +288,18 @@ private void Start(void)
 	InitializeRuntime();
 
 	RunOnStartMethods();
-	ExecuteEvents(GLOBAL_StartEvents, true);
+	ExecuteEvents(GLOBAL_StartEvents);
 	Application.InternalState.StartMethodsBegan = true;
 
 	while (Application.InternalState.CloseApplicationFlag is false)
 	{
-		ExecuteEvents(GLOBAL_UpdateEvents, false);
+		// reads that finished during the last frame complete on the main thread before anything updates
+		IORequests.Update();
 
-		ExecuteEvents(GLOBAL_AfterUpdateEvents, false);
+		// continuations that have to run on the main thread, such as binding meshes that finished loading
+		Futures.Update();
+
+		bool fixedUpdate = false;
 
 		if (Application.InternalState.TimeProvider)
 		{
@@ -325,22 +308,49 @@ private void Start(void)
 			const double targetTime = Application.InternalState.PreviousTime + Application.FixedUpdateTimeInterval;
 
 			if (time >= targetTime) {
-				ExecuteEvents(GLOBAL_FixedUpdateEvents, false);
-				ExecuteEvents(GLOBAL_AfterFixedUpdateEvents, false);
+				fixedUpdate = true;
 
 				Application.InternalState.PreviousTime = time;
 			}
 		}
 
+		// events that declared what they use start as soon as the events they conflict with finish instead of
+		// waiting for the whole phase before them
+		Array phases[] = {
+			(Array)GLOBAL_UpdateEvents,
+			(Array)GLOBAL_AfterUpdateEvents,
+			(Array)GLOBAL_FixedUpdateEvents,
+			(Array)GLOBAL_AfterFixedUpdateEvents
+		};
+
+		if (fixedUpdate)
+		{
+			EventGraphs.Run(GLOBAL_FixedUpdateGraph, phases, 4);
+		}
+		else
+		{
+			EventGraphs.Run(GLOBAL_UpdateGraph, phases, 2);
+		}
+
 		RunOnRenderMethods();
-		ExecuteEvents(GLOBAL_RenderEvents, true);
+		ExecuteEvents(GLOBAL_RenderEvents);
 
 		RunOnAfterRenderMethods();
-		ExecuteEvents(GLOBAL_AfterRenderEvents, true);
+		ExecuteEvents(GLOBAL_AfterRenderEvents);
+
+		// everything allocated from the frame arena only lives until the end of the frame
+		Memory.Arena.ResetFrame();
 	}
 
-	ExecuteEvents(GLOBAL_CloseEvents, true);
+	ExecuteEvents(GLOBAL_CloseEvents);
 	RunOnCloseMethods();
+
+	IORequests.Shutdown();
+
+	EventGraphs.Dispose(GLOBAL_UpdateGraph);
+	EventGraphs.Dispose(GLOBAL_FixedUpdateGraph);
+
+	Jobs.Stop();
 }
 
 private void SetTimeProvider(double(*Provider)())
@@ -0,0 +1,728 @@
+#include "core/simd.h"
+#include "core/memory.h"
+#include "core/cunit.h"
+#include <string.h>
+#include <time.h>
+
+#if defined(_M_X64) || defined(_M_AMD64) || defined(__x86_64__)
+#include <immintrin.h>
+#define SIMD_X64
+#endif
+
+// msvc lets any function use avx2 intrinsics, gcc and clang have to be told which functions may use them
+#if defined(__GNUC__) || defined(__clang__)
+#define SIMD_AVX2_TARGET __attribute__((target("avx2")))
+#else
+#define SIMD_AVX2_TARGET
+#endif
+
+private enum SimdLevel Level(void);
+private enum SimdLevel SetLevel(enum SimdLevel level);
+private ulong FindByte(const void* values, ulong count, byte value);
+private ulong FindFirstEqual(const void* values, ulong count, ulong elementSize, const void* value);
+private ulong Mismatch(const void* left, const void* right, ulong size);
+private void Fill(void* values, ulong count, ulong elementSize, const void* value);
+private ulong Count(const void* values, ulong count, ulong elementSize, const void* value);
+private void RunUnitTests();
+
+struct _simdMethods Simd = {
+	.Level = Level,
+	.SetLevel = SetLevel,
+	.FindByte = FindByte,
+	.FindFirstEqual = FindFirstEqual,
+	.Mismatch = Mismatch,
+	.Fill = Fill,
+	.Count = Count,
+	.RunUnitTests = RunUnitTests
+};
+
+// one set of kernels per instruction set
+struct _simdKernels {
+	enum SimdLevel Level;
+	ulong(*FindByte)(const byte* values, ulong count, byte value);
+	ulong(*FindFirstEqual)(const byte* values, ulong count, ulong elementSize, const byte* value);
+	ulong(*Mismatch)(const byte* left, const byte* right, ulong size);
+	void (*Fill)(byte* values, ulong count, ulong elementSize, const byte* value);
+	ulong(*Count)(const byte* values, ulong count, ulong elementSize, const byte* value);
+};
+
+// whether the element size can be compared a whole register at a time
+#define SIMD_VECTOR_ELEMENT(size) ((size) is 1 or (size) is 4 or (size) is 8)
+
+private unsigned int LowestBit(unsigned int mask)
+{
+	unsigned long index;
+	_BitScanForward(&index, mask);
+	return (unsigned int)index;
+}
+
+private unsigned int CountBits(unsigned int mask)
+{
+	mask = mask - ((mask >> 1) & 0x55555555);
+	mask = (mask & 0x33333333) + ((mask >> 2) & 0x33333333);
+	return (((mask + (mask >> 4)) & 0x0F0F0F0F) * 0x01010101) >> 24;
+}
+
+// SCALAR
+
+private ulong ScalarFindByte(const byte* values, ulong count, byte value)
+{
+	for (ulong i = 0; i < count; i++)
+	{
+		if (values[i] is value)
+		{
+			return i;
+		}
+	}
+
+	return SIMD_NOT_FOUND;
+}
+
+private ulong ScalarFindFirstEqual(const byte* values, ulong count, ulong elementSize, const byte* value)
+{
+	for (ulong i = 0; i < count; i++)
+	{
+		if (memcmp(values + (i * elementSize), value, elementSize) is 0)
+		{
+			return i;
+		}
+	}
+
+	return SIMD_NOT_FOUND;
+}
+
+private ulong ScalarMismatch(const byte* left, const byte* right, ulong size)
+{
+	for (ulong i = 0; i < size; i++)
+	{
+		if (left[i] isnt right[i])
+		{
+			return i;
+		}
+	}
+
+	return SIMD_NOT_FOUND;
+}
+
+private void ScalarFill(byte* values, ulong count, ulong elementSize, const byte* value)
+{
+	for (ulong i = 0; i < count; i++)
+	{
+		memcpy(values + (i * elementSize), value, elementSize);
+	}
+}
+
+private ulong ScalarCount(const byte* values, ulong count, ulong elementSize, const byte* value)
+{
+	ulong result = 0;
+
+	for (ulong i = 0; i < count; i++)
+	{
+		result += memcmp(values + (i * elementSize), value, elementSize) is 0;
+	}
+
+	return result;
+}
+
+// the vector kernels hand the elements that don't fill a whole register to the scalar kernels,
+// these adjust the index the scalar kernels return
+private ulong FindTail(ulong offset, ulong found)
+{
+	return found is SIMD_NOT_FOUND ? SIMD_NOT_FOUND : offset + found;
+}
+
+static const struct _simdKernels ScalarKernels = {
+	.Level = SimdLevelScalar,
+	.FindByte = ScalarFindByte,
+	.FindFirstEqual = ScalarFindFirstEqual,
+	.Mismatch = ScalarMismatch,
+	.Fill = ScalarFill,
+	.Count = ScalarCount
+};
+
+#ifdef SIMD_X64
+
+// SSE2
+
+private __m128i Broadcast128(const byte* value, ulong elementSize)
+{
+	switch (elementSize)
+	{
+	case 1:
+		return _mm_set1_epi8((char)*value);
+	case 4:
+	{
+		int element;
+		memcpy(&element, value, sizeof(int));
+		return _mm_set1_epi32(element);
+	}
+	default:
+	{
+		long long element;
+		memcpy(&element, value, sizeof(long long));
+		return _mm_set1_epi64x(element);
+	}
+	}
+}
+
+// gets a mask with every bit set for each byte of each element that matches
+private unsigned int CompareMask128(__m128i values, __m128i needle, ulong elementSize)
+{
+	switch (elementSize)
+	{
+	case 1:
+		return (unsigned int)_mm_movemask_epi8(_mm_cmpeq_epi8(values, needle));
+	case 4:
+		return (unsigned int)_mm_movemask_epi8(_mm_cmpeq_epi32(values, needle));
+	default:
+	{
+		// sse2 can't compare 64 bit lanes, an element matches when both of its halves match
+		const __m128i halves = _mm_cmpeq_epi32(values, needle);
+		return (unsigned int)_mm_movemask_epi8(_mm_and_si128(halves, _mm_shuffle_epi32(halves, _MM_SHUFFLE(2, 3, 0, 1))));
+	}
+	}
+}
+
+private ulong SSE2FindByte(const byte* values, ulong count, byte value)
+{
+	const __m128i needle = _mm_set1_epi8((char)value);
+
+	ulong offset = 0;
+
+	for (; offset + sizeof(__m128i) <= count; offset += sizeof(__m128i))
+	{
+		const unsigned int mask = (unsigned int)_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_loadu_si128((const __m128i*)(values + offset)), needle));
+
+		if (mask)
+		{
+			return offset + LowestBit(mask);
+		}
+	}
+
+	return FindTail(offset, ScalarFindByte(values + offset, count - offset, value));
+}
+
+private ulong SSE2FindFirstEqual(const byte* values, ulong count, ulong elementSize, const byte* value)
+{
+	if (SIMD_VECTOR_ELEMENT(elementSize) is false)
+	{
+		return ScalarFindFirstEqual(values, count, elementSize, value);
+	}
+
+	const __m128i needle = Broadcast128(value, elementSize);
+	const ulong size = count * elementSize;
+
+	ulong offset = 0;
+
+	for (; offset + sizeof(__m128i) <= size; offset += sizeof(__m128i))
+	{
+		const unsigned int mask = CompareMask128(_mm_loadu_si128((const __m128i*)(values + offset)), needle, elementSize);
+
+		if (mask)
+		{
+			return (offset + LowestBit(mask)) / elementSize;
+		}
+	}
+
+	return FindTail(offset / elementSize, ScalarFindFirstEqual(values + offset, (size - offset) / elementSize, elementSize, value));
+}
+
+private ulong SSE2Mismatch(const byte* left, const byte* right, ulong size)
+{
+	ulong offset = 0;
+
+	for (; offset + sizeof(__m128i) <= size; offset += sizeof(__m128i))
+	{
+		const __m128i equal = _mm_cmpeq_epi8(_mm_loadu_si128((const __m128i*)(left + offset)), _mm_loadu_si128((const __m128i*)(right + offset)));
+		const unsigned int mask = (unsigned int)_mm_movemask_epi8(equal) ^ 0xFFFF;
+
+		if (mask)
+		{
+			return offset + LowestBit(mask);
+		}
+	}
+
+	return FindTail(offset, ScalarMismatch(left + offset, right + offset, size - offset));
+}
+
+private void SSE2Fill(byte* values, ulong count, ulong elementSize, const byte* value)
+{
+	// the value has to repeat evenly within a register
+	if (sizeof(__m128i) % elementSize isnt 0)
+	{
+		ScalarFill(values, count, elementSize, value);
+		return;
+	}
+
+	byte pattern[sizeof(__m128i)];
+
+	for (ulong i = 0; i < sizeof(__m128i); i += elementSize)
+	{
+		memcpy(pattern + i, value, elementSize);
+	}
+
+	const __m128i repeated = _mm_loadu_si128((const __m128i*)pattern);
+	const ulong size = count * elementSize;
+
+	ulong offset = 0;
+
+	for (; offset + sizeof(__m128i) <= size; offset += sizeof(__m128i))
+	{
+		_mm_storeu_si128((__m128i*)(values + offset), repeated);
+	}
+
+	// the offset is a multiple of the register size so the pattern still lines up with the elements
+	memcpy(values + offset, pattern, size - offset);
+}
+
+private ulong SSE2Count(const byte* values, ulong count, ulong elementSize, const byte* value)
+{
+	if (SIMD_VECTOR_ELEMENT(elementSize) is false)
+	{
+		return ScalarCount(values, count, elementSize, value);
+	}
+
+	const __m128i needle = Broadcast128(value, elementSize);
+	const ulong size = count * elementSize;
+
+	ulong offset = 0;
+	ulong matchedBytes = 0;
+
+	for (; offset + sizeof(__m128i) <= size; offset += sizeof(__m128i))
+	{
+		matchedBytes += CountBits(CompareMask128(_mm_loadu_si128((const __m128i*)(values + offset)), needle, elementSize));
+	}
+
+	return (matchedBytes / elementSize) + ScalarCount(values + offset, (size - offset) / elementSize, elementSize, value);
+}
+
+static const struct _simdKernels SSE2Kernels = {
+	.Level = SimdLevelSSE2,
+	.FindByte = SSE2FindByte,
+	.FindFirstEqual = SSE2FindFirstEqual,
+	.Mismatch = SSE2Mismatch,
+	.Fill = SSE2Fill,
+	.Count = SSE2Count
+};
+
+// AVX2
+
+SIMD_AVX2_TARGET private __m256i Broadcast256(const byte* value, ulong elementSize)
+{
+	switch (elementSize)
+	{
+	case 1:
+		return _mm256_set1_epi8((char)*value);
+	case 4:
+	{
+		int element;
+		memcpy(&element, value, sizeof(int));
+		return _mm256_set1_epi32(element);
+	}
+	default:
+	{
+		long long element;
+		memcpy(&element, value, sizeof(long long));
+		return _mm256_set1_epi64x(element);
+	}
+	}
+}
+
+SIMD_AVX2_TARGET private unsigned int CompareMask256(__m256i values, __m256i needle, ulong elementSize)
+{
+	switch (elementSize)
+	{
+	case 1:
+		return (unsigned int)_mm256_movemask_epi8(_mm256_cmpeq_epi8(values, needle));
+	case 4:
+		return (unsigned int)_mm256_movemask_epi8(_mm256_cmpeq_epi32(values, needle));
+	default:
+		return (unsigned int)_mm256_movemask_epi8(_mm256_cmpeq_epi64(values, needle));
+	}
+}
+
+SIMD_AVX2_TARGET private ulong AVX2FindByte(const byte* values, ulong count, byte value)
+{
+	const __m256i needle = _mm256_set1_epi8((char)value);
+
+	ulong offset = 0;
+
+	for (; offset + sizeof(__m256i) <= count; offset += sizeof(__m256i))
+	{
+		const unsigned int mask = (unsigned int)_mm256_movemask_epi8(_mm256_cmpeq_epi8(_mm256_loadu_si256((const __m256i*)(values + offset)), needle));
+
+		if (mask)
+		{
+			return offset + LowestBit(mask);
+		}
+	}
+
+	return FindTail(offset, SSE2FindByte(values + offset, count - offset, value));
+}
+
+SIMD_AVX2_TARGET private ulong AVX2FindFirstEqual(const byte* values, ulong count, ulong elementSize, const byte* value)
+{
+	if (SIMD_VECTOR_ELEMENT(elementSize) is false)
+	{
+		return ScalarFindFirstEqual(values, count, elementSize, value);
+	}
+
+	const __m256i needle = Broadcast256(value, elementSize);
+	const ulong size = count * elementSize;
+
+	ulong offset = 0;
+
+	for (; offset + sizeof(__m256i) <= size; offset += sizeof(__m256i))
+	{
+		const unsigned int mask = CompareMask256(_mm256_loadu_si256((const __m256i*)(values + offset)), needle, elementSize);
+
+		if (mask)
+		{
+			return (offset + LowestBit(mask)) / elementSize;
+		}
+	}
+
+	return FindTail(offset / elementSize, SSE2FindFirstEqual(values + offset, (size - offset) / elementSize, elementSize, value));
+}
+
+SIMD_AVX2_TARGET private ulong AVX2Mismatch(const byte* left, const byte* right, ulong size)
+{
+	ulong offset = 0;
+
+	for (; offset + sizeof(__m256i) <= size; offset += sizeof(__m256i))
+	{
+		const __m256i equal = _mm256_cmpeq_epi8(_mm256_loadu_si256((const __m256i*)(left + offset)), _mm256_loadu_si256((const __m256i*)(right + offset)));
+		const unsigned int mask = ~(unsigned int)_mm256_movemask_epi8(equal);
+
+		if (mask)
+		{
+			return offset + LowestBit(mask);
+		}
+	}
+
+	return FindTail(offset, SSE2Mismatch(left + offset, right + offset, size - offset));
+}
+
+SIMD_AVX2_TARGET private void AVX2Fill(byte* values, ulong count, ulong elementSize, const byte* value)
+{
+	if (sizeof(__m256i) % elementSize isnt 0)
+	{
+		ScalarFill(values, count, elementSize, value);
+		return;
+	}
+
+	byte pattern[sizeof(__m256i)];
+
+	for (ulong i = 0; i < sizeof(__m256i); i += elementSize)
+	{
+		memcpy(pattern + i, value, elementSize);
+	}
+
+	const __m256i repeated = _mm256_loadu_si256((const __m256i*)pattern);
+	const ulong size = count * elementSize;
+
+	ulong offset = 0;
+
+	for (; offset + sizeof(__m256i) <= size; offset += sizeof(__m256i))
+	{
+		_mm256_storeu_si256((__m256i*)(values + offset), repeated);
+	}
+
+	memcpy(values + offset, pattern, size - offset);
+}
+
+SIMD_AVX2_TARGET private ulong AVX2Count(const byte* values, ulong count, ulong elementSize, const byte* value)
+{
+	if (SIMD_VECTOR_ELEMENT(elementSize) is false)
+	{
+		return ScalarCount(values, count, elementSize, value);
+	}
+
+	const __m256i needle = Broadcast256(value, elementSize);
+	const ulong size = count * elementSize;
+
+	ulong offset = 0;
+	ulong matchedBytes = 0;
+
+	for (; offset + sizeof(__m256i) <= size; offset += sizeof(__m256i))
+	{
+		matchedBytes += CountBits(CompareMask256(_mm256_loadu_si256((const __m256i*)(values + offset)), needle, elementSize));
+	}
+
+	return (matchedBytes / elementSize) + SSE2Count(values + offset, (size - offset) / elementSize, elementSize, value);
+}
+
+static const struct _simdKernels AVX2Kernels = {
+	.Level = SimdLevelAVX2,
+	.FindByte = AVX2FindByte,
+	.FindFirstEqual = AVX2FindFirstEqual,
+	.Mismatch = AVX2Mismatch,
+	.Fill = AVX2Fill,
+	.Count = AVX2Count
+};
+
+private bool SupportsAVX2(void)
+{
+#ifdef _MSC_VER
+	int info[4];
+
+	__cpuid(info, 0);
+
+	if (info[0] < 7)
+	{
+		return false;
+	}
+
+	__cpuid(info, 1);
+
+	// the os has to save the upper halves of the ymm registers on context switches
+	const bool osSavesYmm = (info[2] & (1 << 27)) and (info[2] & (1 << 28)) and ((_xgetbv(0) & 0x6) is 0x6);
+
+	__cpuidex(info, 7, 0);
+
+	return osSavesYmm and (info[1] & (1 << 5));
+#else
+	return __builtin_cpu_supports("avx2");
+#endif
+}
+
+private enum SimdLevel SupportedLevel(void)
+{
+	return SupportsAVX2() ? SimdLevelAVX2 : SimdLevelSSE2;
+}
+
+#else
+
+private enum SimdLevel SupportedLevel(void)
+{
+	return SimdLevelScalar;
+}
+
+#endif
+
+// null until the first kernel is used
+static const struct _simdKernels* GLOBAL_Kernels = null;
+
+private enum SimdLevel SetLevel(enum SimdLevel level)
+{
+	level = min(level, SupportedLevel());
+
+	switch (level)
+	{
+#ifdef SIMD_X64
+	case SimdLevelAVX2:
+		GLOBAL_Kernels = &AVX2Kernels;
+		break;
+	case SimdLevelSSE2:
+		GLOBAL_Kernels = &SSE2Kernels;
+		break;
+#endif
+	default:
+		GLOBAL_Kernels = &ScalarKernels;
+		break;
+	}
+
+	return GLOBAL_Kernels->Level;
+}
+
+private const struct _simdKernels* Kernels(void)
+{
+	// picking the kernels more than once when threads race here is harmless, they all pick the same ones
+	if (GLOBAL_Kernels is null)
+	{
+		SetLevel(SimdLevelAVX2);
+	}
+
+	return GLOBAL_Kernels;
+}
+
+private enum SimdLevel Level(void)
+{
+	return Kernels()->Level;
+}
+
+private ulong FindByte(const void* values, ulong count, byte value)
+{
+	return Kernels()->FindByte(values, count, value);
+}
+
+private ulong FindFirstEqual(const void* values, ulong count, ulong elementSize, const void* value)
+{
+	return Kernels()->FindFirstEqual(values, count, elementSize, value);
+}
+
+private ulong Mismatch(const void* left, const void* right, ulong size)
+{
+	return Kernels()->Mismatch(left, right, size);
+}
+
+private void Fill(void* values, ulong count, ulong elementSize, const void* value)
+{
+	Kernels()->Fill(values, count, elementSize, value);
+}
+
+private ulong Count(const void* values, ulong count, ulong elementSize, const void* value)
+{
+	return Kernels()->Count(values, count, elementSize, value);
+}
+
+#define TEST_BUFFER_SIZE 1024
+
+// every level has to agree with the scalar kernels, including the elements that don't fill a whole register
+private bool MatchesScalar(enum SimdLevel level)
+{
+	SetLevel(level);
+
+	byte values[TEST_BUFFER_SIZE];
+	byte other[TEST_BUFFER_SIZE];
+
+	for (ulong i = 0; i < TEST_BUFFER_SIZE; i++)
+	{
+		values[i] = (byte)((i * 7) % 13);
+	}
+
+	const ulong elementSizes[] = { 1, 3, 4, 8 };
+
+	for (ulong sizeIndex = 0; sizeIndex < sizeof(elementSizes) / sizeof(ulong); sizeIndex++)
+	{
+		const ulong elementSize = elementSizes[sizeIndex];
+
+		for (ulong count = 0; count < (TEST_BUFFER_SIZE / elementSize) / 4; count += 3)
+		{
+			for (ulong needle = 0; needle < 5; needle++)
+			{
+				const byte* value = values + (needle * 11 * elementSize);
+
+				if (FindFirstEqual(values, count, elementSize, value) isnt ScalarFindFirstEqual(values, count, elementSize, value))
+				{
+					return false;
+				}
+
+				if (Count(values, count, elementSize, value) isnt ScalarCount(values, count, elementSize, value))
+				{
+					return false;
+				}
+			}
+
+			memset(other, 0xFF, TEST_BUFFER_SIZE);
+			Fill(other, count, elementSize, values);
+
+			if (ScalarCount(other, count, elementSize, values) isnt count or other[count * elementSize] isnt 0xFF)
+			{
+				return false;
+			}
+		}
+	}
+
+	for (ulong count = 0; count < TEST_BUFFER_SIZE; count += 5)
+	{
+		if (FindByte(values, count, 12) isnt ScalarFindByte(values, count, 12))
+		{
+			return false;
+		}
+
+		memcpy(other, values, TEST_BUFFER_SIZE);
+
+		if (Mismatch(values, other, count) isnt SIMD_NOT_FOUND)
+		{
+			return false;
+		}
+
+		if (count)
+		{
+			other[count - 1] ^= 1;
+
+			if (Mismatch(values, other, count) isnt count - 1)
+			{
+				return false;
+			}
+		}
+	}
+
+	return true;
+}
+
+TEST(MatchesScalar)
+{
+	const enum SimdLevel supported = SupportedLevel();
+
+	for (enum SimdLevel level = SimdLevelScalar; level <= supported; level++)
+	{
+		IsTrue(MatchesScalar(level));
+	}
+
+	SetLevel(supported);
+
+	IsEqual(supported, Level());
+
+	return true;
+}
+
+#define BENCHMARK_BUFFER_SIZE (64 * 1024 * 1024)
+#define BENCHMARK_ITERATIONS 10
+
+private void PrintThroughput(FILE* stream, const char* name, enum SimdLevel level, clock_t ticks)
+{
+	const double seconds = max((double)ticks / CLOCKS_PER_SEC, 1e-6);
+	const double gigabytes = ((double)BENCHMARK_BUFFER_SIZE * BENCHMARK_ITERATIONS) / (1024.0 * 1024.0 * 1024.0);
+
+	static const char* levelNames[] = { "scalar", "sse2", "avx2" };
+
+	fprintf(stream, "\t%s %s %.2f GB/s"NEWLINE, name, levelNames[level], gigabytes / seconds);
+}
+
+#define BENCHMARK_KERNEL(stream, name, level, expression) do\
+{\
+	const clock_t start = clock();\
+	for (int iteration = 0; iteration < BENCHMARK_ITERATIONS; iteration++)\
+	{\
+		expression;\
+	}\
+	PrintThroughput(stream, name, level, clock() - start);\
+} while (false)
+
+TEST(ThroughputBenchmark)
+{
+	byte* values = Memory.Alloc(BENCHMARK_BUFFER_SIZE, Memory.GenericMemoryBlock);
+	byte* other = Memory.Alloc(BENCHMARK_BUFFER_SIZE, Memory.GenericMemoryBlock);
+
+	memset(values, 1, BENCHMARK_BUFFER_SIZE);
+	memset(other, 1, BENCHMARK_BUFFER_SIZE);
+
+	const enum SimdLevel supported = SupportedLevel();
+
+	// the searched for values are never found so every kernel reads the whole buffer
+	const byte missingByte = 2;
+	const int missingInt = 2;
+
+	ulong misses = 0;
+
+	for (enum SimdLevel level = SimdLevelScalar; level <= supported; level++)
+	{
+		SetLevel(level);
+
+		BENCHMARK_KERNEL(__test_stream, "FindByte", level, misses += FindByte(values, BENCHMARK_BUFFER_SIZE, missingByte) is SIMD_NOT_FOUND);
+		BENCHMARK_KERNEL(__test_stream, "FindFirstEqual int", level, misses += FindFirstEqual(values, BENCHMARK_BUFFER_SIZE / sizeof(int), sizeof(int), &missingInt) is SIMD_NOT_FOUND);
+		BENCHMARK_KERNEL(__test_stream, "Mismatch", level, misses += Mismatch(values, other, BENCHMARK_BUFFER_SIZE) is SIMD_NOT_FOUND);
+		BENCHMARK_KERNEL(__test_stream, "Count int", level, misses += Count(values, BENCHMARK_BUFFER_SIZE / sizeof(int), sizeof(int), &missingInt) is 0);
+		BENCHMARK_KERNEL(__test_stream, "Fill int", level, Fill(other, BENCHMARK_BUFFER_SIZE / sizeof(int), sizeof(int), &missingInt));
+
+		memset(other, 1, BENCHMARK_BUFFER_SIZE);
+	}
+
+	SetLevel(supported);
+
+	// every search misses and every count is zero
+	const ulong expected = (ulong)(supported + 1) * BENCHMARK_ITERATIONS * 4;
+	IsEqual(expected, misses);
+
+	Memory.Free(values, Memory.GenericMemoryBlock);
+	Memory.Free(other, Memory.GenericMemoryBlock);
+
+	return true;
+}
+
+TEST_SUITE(RunUnitTests,
+	APPEND_TEST(MatchesScalar)
+	APPEND_TEST(ThroughputBenchmark)
+);
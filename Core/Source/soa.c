@@ -0,0 +1,341 @@
+#include "core/soa.h"
+#include "core/memory.h"
+#include "core/cunit.h"
+#include <string.h>
+
+private SoA Create(ulong columnCount, const ulong* columnSizes, ulong capacity, ulong typeId);
+private void Reserve(SoA, ulong count);
+private ulong Append(SoA);
+private void SwapRemove(SoA, ulong index);
+private void Clear(SoA);
+private ulong SelectColumns(SoA, ulong columns, void** out_columns);
+private void Foreach(SoA, ulong columns, void* context, void(*method)(void* context, void** elements));
+private void Dispose(SoA);
+private void RunUnitTests();
+
+const struct _soaMethods SoAs = {
+	.Create = Create,
+	.Reserve = Reserve,
+	.Append = Append,
+	.SwapRemove = SwapRemove,
+	.Clear = Clear,
+	.SelectColumns = SelectColumns,
+	.Foreach = Foreach,
+	.Dispose = Dispose,
+	.RunUnitTests = RunUnitTests
+};
+
+private SoA Create(ulong columnCount, const ulong* columnSizes, ulong capacity, ulong typeId)
+{
+	if (columnCount is 0 or columnCount > SOA_MAX_COLUMNS)
+	{
+		throw(InvalidArgumentException);
+	}
+
+	REGISTER_TYPE(SoA);
+
+	SoA soa = Memory.Alloc(sizeof(struct _soa) + (columnCount * sizeof(void*)), SoATypeId);
+
+	soa->Count = 0;
+	soa->Capacity = 0;
+	soa->TypeId = typeId;
+	soa->ColumnCount = columnCount;
+	soa->ColumnSizes = columnSizes;
+
+	if (capacity)
+	{
+		Reserve(soa, capacity);
+	}
+
+	return soa;
+}
+
+private void Reserve(SoA soa, ulong count)
+{
+	if (count <= soa->Capacity)
+	{
+		return;
+	}
+
+	for (ulong i = 0; i < soa->ColumnCount; i++)
+	{
+		const ulong size = soa->ColumnSizes[i];
+
+		// each column grows in place when it can, new elements are zeroed
+		Memory.ReallocOrCopy(&soa->Columns[i], soa->Capacity * size, count * size, soa->TypeId);
+	}
+
+	soa->Capacity = count;
+}
+
+private ulong Append(SoA soa)
+{
+	if (soa->Count >= soa->Capacity)
+	{
+		Reserve(soa, max(soa->Capacity << 1, SOA_MINIMUM_CAPACITY));
+	}
+
+	const ulong index = soa->Count;
+
+	// removed elements leave their values behind
+	for (ulong i = 0; i < soa->ColumnCount; i++)
+	{
+		const ulong size = soa->ColumnSizes[i];
+
+		memset((byte*)soa->Columns[i] + (index * size), 0, size);
+	}
+
+	soa->Count = safe_add(soa->Count, 1);
+
+	return index;
+}
+
+private void SwapRemove(SoA soa, ulong index)
+{
+	if (index >= soa->Count)
+	{
+		throw(IndexOutOfRangeException);
+	}
+
+	const ulong last = soa->Count - 1;
+
+	if (index isnt last)
+	{
+		for (ulong i = 0; i < soa->ColumnCount; i++)
+		{
+			const ulong size = soa->ColumnSizes[i];
+
+			byte* column = soa->Columns[i];
+
+			memcpy(column + (index * size), column + (last * size), size);
+		}
+	}
+
+	soa->Count = last;
+}
+
+private void Clear(SoA soa)
+{
+	soa->Count = 0;
+}
+
+private ulong SelectColumns(SoA soa, ulong columns, void** out_columns)
+{
+	ulong count = 0;
+
+	for (ulong i = 0; i < soa->ColumnCount; i++)
+	{
+		if (columns & (1ull << i))
+		{
+			out_columns[count++] = soa->Columns[i];
+		}
+	}
+
+	return count;
+}
+
+private void Foreach(SoA soa, ulong columns, void* context, void(*method)(void* context, void** elements))
+{
+	byte* selected[SOA_MAX_COLUMNS];
+	ulong sizes[SOA_MAX_COLUMNS];
+	void* elements[SOA_MAX_COLUMNS];
+
+	const ulong count = SelectColumns(soa, columns, (void**)selected);
+
+	for (ulong i = 0, column = 0; i < soa->ColumnCount; i++)
+	{
+		if (columns & (1ull << i))
+		{
+			sizes[column++] = soa->ColumnSizes[i];
+		}
+	}
+
+	for (ulong index = 0; index < soa->Count; index++)
+	{
+		for (ulong column = 0; column < count; column++)
+		{
+			elements[column] = selected[column] + (index * sizes[column]);
+		}
+
+		method(context, elements);
+	}
+}
+
+private void Dispose(SoA soa)
+{
+	if (soa is null)
+	{
+		return;
+	}
+
+	for (ulong i = 0; i < soa->ColumnCount; i++)
+	{
+		Memory.Free(soa->Columns[i], soa->TypeId);
+	}
+
+	Memory.Free(soa, SoATypeId);
+}
+
+#include "core/math/vectors.h"
+
+DEFINE_SOA(vector3, (float, x), (float, y), (float, z));
+
+TEST(AppendAndRemove)
+{
+	soa(vector3) positions = soas(vector3).Create(0);
+
+	for (int i = 0; i < 100; i++)
+	{
+		IsEqual((ulong)i, soas(vector3).Append(positions, (vector3) { (float)i, (float)(i * 2), (float)(i * 3) }));
+	}
+
+	IsEqual((ulong)100, positions->Count);
+	IsEqual(10.0f, soa_at(positions, x, 10));
+	IsEqual(20.0f, soa_at(positions, y, 10));
+	IsEqual(30.0f, soa_at(positions, z, 10));
+
+	vector3 value = soas(vector3).Get(positions, 50);
+
+	IsEqual(50.0f, value.x);
+	IsEqual(100.0f, value.y);
+	IsEqual(150.0f, value.z);
+
+	// the last element takes the place of the removed one
+	soas(vector3).SwapRemove(positions, 10);
+
+	IsEqual((ulong)99, positions->Count);
+	IsEqual(99.0f, soa_at(positions, x, 10));
+	IsEqual(198.0f, soa_at(positions, y, 10));
+	IsEqual(297.0f, soa_at(positions, z, 10));
+
+	soas(vector3).Set(positions, 0, (vector3) { -1.0f, -2.0f, -3.0f });
+
+	IsEqual(-2.0f, soa_at(positions, y, 0));
+
+	void* columns[SOA_MAX_COLUMNS];
+
+	IsEqual((ulong)2, soas(vector3).SelectColumns(positions, soa_column(vector3, x) | soa_column(vector3, z), columns));
+	IsTrue(columns[0] == positions->x);
+	IsTrue(columns[1] == positions->z);
+
+	soas(vector3).Dispose(positions);
+
+	return true;
+}
+
+private void SumColumns(void* sum, void** elements)
+{
+	*(float*)sum += *(float*)elements[0];
+}
+
+TEST(Foreach)
+{
+	soa(vector3) positions = soas(vector3).Create(4);
+
+	soas(vector3).Append(positions, (vector3) { 1, 2, 3 });
+	soas(vector3).Append(positions, (vector3) { 4, 5, 6 });
+
+	float sum = 0;
+
+	soas(vector3).Foreach(positions, soa_column(vector3, y), &sum, SumColumns);
+
+	IsEqual(7.0f, sum);
+
+	soas(vector3).Dispose(positions);
+
+	return true;
+}
+
+#define BENCHMARK_POSITION_COUNT 1000000
+#define BENCHMARK_ITERATIONS 100
+
+TEST(AoSvsSoABenchmark)
+{
+	vector3* aos = Memory.Alloc(sizeof(vector3) * BENCHMARK_POSITION_COUNT, Memory.GenericMemoryBlock);
+	soa(vector3) soa = soas(vector3).Create(BENCHMARK_POSITION_COUNT);
+
+	for (ulong i = 0; i < BENCHMARK_POSITION_COUNT; i++)
+	{
+		aos[i] = (vector3){ (float)i, (float)i, (float)i };
+		soas(vector3).Append(soa, aos[i]);
+	}
+
+	const float gravity = -9.81f / 60.0f;
+	const vector3 velocity = { 0.5f, 0.25f, 0.125f };
+
+	fprintf(__test_stream, "\tAoS %i positions, move xyz x%i ", BENCHMARK_POSITION_COUNT, BENCHMARK_ITERATIONS);
+	Benchmark(
+		for (ulong iteration = 0; iteration < BENCHMARK_ITERATIONS; iteration++)
+		{
+			for (ulong i = 0; i < BENCHMARK_POSITION_COUNT; i++)
+			{
+				aos[i].x += velocity.x;
+				aos[i].y += velocity.y;
+				aos[i].z += velocity.z;
+			}
+		}, __test_stream
+	);
+	fprintf(__test_stream, NEWLINE);
+
+	fprintf(__test_stream, "\tSoA %i positions, move xyz x%i ", BENCHMARK_POSITION_COUNT, BENCHMARK_ITERATIONS);
+	Benchmark(
+		for (ulong iteration = 0; iteration < BENCHMARK_ITERATIONS; iteration++)
+		{
+			float* x = soa->x;
+			float* y = soa->y;
+			float* z = soa->z;
+			const ulong count = soa->Count;
+
+			for (ulong i = 0; i < count; i++)
+			{
+				x[i] += velocity.x;
+				y[i] += velocity.y;
+				z[i] += velocity.z;
+			}
+		}, __test_stream
+	);
+	fprintf(__test_stream, NEWLINE);
+
+	// only the y column is touched, AoS still has to pull x and z into the cache
+	fprintf(__test_stream, "\tAoS %i positions, gravity on y x%i ", BENCHMARK_POSITION_COUNT, BENCHMARK_ITERATIONS);
+	Benchmark(
+		for (ulong iteration = 0; iteration < BENCHMARK_ITERATIONS; iteration++)
+		{
+			for (ulong i = 0; i < BENCHMARK_POSITION_COUNT; i++)
+			{
+				aos[i].y += gravity;
+			}
+		}, __test_stream
+	);
+	fprintf(__test_stream, NEWLINE);
+
+	fprintf(__test_stream, "\tSoA %i positions, gravity on y x%i ", BENCHMARK_POSITION_COUNT, BENCHMARK_ITERATIONS);
+	Benchmark(
+		for (ulong iteration = 0; iteration < BENCHMARK_ITERATIONS; iteration++)
+		{
+			float* y = soa->y;
+			const ulong count = soa->Count;
+
+			for (ulong i = 0; i < count; i++)
+			{
+				y[i] += gravity;
+			}
+		}, __test_stream
+	);
+	fprintf(__test_stream, NEWLINE);
+
+	// both layouts did the same work
+	IsEqual(aos[1234].y, soa_at(soa, y, 1234));
+	IsEqual(aos[BENCHMARK_POSITION_COUNT - 1].z, soa_at(soa, z, BENCHMARK_POSITION_COUNT - 1));
+
+	Memory.Free(aos, Memory.GenericMemoryBlock);
+	soas(vector3).Dispose(soa);
+
+	return true;
+}
+
+TEST_SUITE(RunUnitTests,
+	APPEND_TEST(AppendAndRemove)
+	APPEND_TEST(Foreach)
+	APPEND_TEST(AoSvsSoABenchmark)
+);
@@ -4,6 +4,11 @@
 #include <string.h>
 #include <stdlib.h>
 #include "core/memory.h"
+#include "core/simd.h"
+#include "core/hashing.h"
+#include "core/cunit.h"
+#include <math.h>
+#include <limits.h>
 
 
 static StringArray CreateStringArray(void);
@@ -274,25 +279,33 @@ static bool Contains(const char* source, ulong length, const char* target, const
 		return false;
 	}
 
-	for (ulong start = 0; start < length; start++)
+	if (targetLength is 0 or targetLength > length)
 	{
-		const char* buffer = source + start;
+		return false;
+	}
+
+	// only positions that start with the first character of the target can match, skip to them a register at a time
+	const ulong lastStart = length - targetLength;
 
-		// check if this character can be the start of the target string, if it can't move on
-		int firstChar = buffer[0];
+	ulong start = 0;
+
+	while (start <= lastStart)
+	{
+		const ulong found = Simd.FindByte(source + start, lastStart - start + 1, (byte)target[0]);
 
-		if (firstChar isnt target[0])
+		if (found is SIMD_NOT_FOUND)
 		{
-			continue;
+			return false;
 		}
 
-		if (length - start >= targetLength)
+		start += found;
+
+		if (memcmp(source + start, target, targetLength) is 0)
 		{
-			if (memcmp(buffer, target, min(length - start, targetLength)) is 0)
-			{
-				return true;
-			}
+			return true;
 		}
+
+		++start;
 	}
 
 	return false;
@@ -300,19 +313,9 @@ static bool Contains(const char* source, ulong length, const char* target, const
 
 static int IndexOf(const char* buffer, const ulong bufferLength, int character)
 {
-	int position = 0;
+	const ulong index = Simd.FindByte(buffer, bufferLength, (byte)character);
 
-	while (position < bufferLength)
-	{
-		if (buffer[position] is character)
-		{
-			return position;
-		}
-
-		++position;
-	}
-
-	return -1;
+	return index is SIMD_NOT_FOUND ? -1 : (int)index;
 }
 
 static bool Equals(const char* left, ulong leftLength, const char* right, ulong rightLength)
@@ -515,4 +518,606 @@ static void TrimArray(StringArray array)
 	{
 		array->StringLengths[i] = Trim(array->Strings[i], array->StringLengths[i]);
 	}
-}
\ No newline at end of file
+}
+
+private StringBuilder CreateBuilder(char* buffer, ulong bufferSize);
+private StringBuilder CreateBuilderFromArena(Arena, ulong initialCapacity);
+private void ClearBuilder(StringBuilder*);
+private bool Append(StringBuilder*, const char* bytes, ulong length);
+private bool AppendCString(StringBuilder*, const char* cString);
+private bool AppendString(StringBuilder*, const string);
+private bool AppendChar(StringBuilder*, char character);
+private bool AppendInt(StringBuilder*, long long value);
+private bool AppendUlong(StringBuilder*, ulong value);
+private bool AppendFloat(StringBuilder*, double value, int decimals);
+private bool AppendBool(StringBuilder*, bool value);
+private bool AppendVector2(StringBuilder*, vector2);
+private bool AppendVector3(StringBuilder*, vector3);
+private bool AppendVector4(StringBuilder*, vector4);
+private bool AppendQuaternion(StringBuilder*, quaternion);
+private const char* BuilderCString(const StringBuilder*);
+private void RunUnitTests();
+
+const struct _stringBuilderMethods StringBuilders = {
+	.Create = CreateBuilder,
+	.CreateFromArena = CreateBuilderFromArena,
+	.Clear = ClearBuilder,
+	.Append = Append,
+	.AppendCString = AppendCString,
+	.AppendString = AppendString,
+	.AppendChar = AppendChar,
+	.AppendInt = AppendInt,
+	.AppendUlong = AppendUlong,
+	.AppendFloat = AppendFloat,
+	.AppendBool = AppendBool,
+	.AppendVector2 = AppendVector2,
+	.AppendVector3 = AppendVector3,
+	.AppendVector4 = AppendVector4,
+	.AppendQuaternion = AppendQuaternion,
+	.CString = BuilderCString,
+	.RunUnitTests = RunUnitTests
+};
+
+// the most characters a ulong can be written as
+#define MAX_ULONG_DIGITS 20
+// the most digits the whole part of a double can be written as
+#define MAX_DOUBLE_DIGITS 309
+// the number of base 10^9 digits needed to store the whole part of a double
+#define MAX_DOUBLE_LIMBS ((MAX_DOUBLE_DIGITS / 9) + 1)
+
+// every two digit number, used to write integers two digits at a time
+static const char GLOBAL_DigitPairs[201] =
+"00010203040506070809"
+"10111213141516171819"
+"20212223242526272829"
+"30313233343536373839"
+"40414243444546474849"
+"50515253545556575859"
+"60616263646566676869"
+"70717273747576777879"
+"80818283848586878889"
+"90919293949596979899";
+
+static const ulong GLOBAL_PowersOfTen[STRING_BUILDER_MAX_DECIMALS + 1] = {
+	1, 10, 100, 1000, 10000, 100000, 1000000, 10000000, 100000000, 1000000000
+};
+
+private StringBuilder CreateBuilderFromBuffer(char* buffer, ulong capacity, Arena arena)
+{
+	buffer[0] = '\0';
+
+	return (StringBuilder) {
+		.String = {
+			.Values = (byte*)buffer,
+			.Size = capacity + 1,
+			.ElementSize = sizeof(byte),
+			.Capacity = capacity,
+			.Count = 0,
+			.TypeId = 0,
+			// the buffer belongs to the caller or the arena, disposing the string would free memory it doesn't own
+			.StackObject = true,
+			.Dirty = true,
+			.Hash = 0,
+			.AutoHash = false
+		},
+		.Arena = arena,
+		.Truncated = false
+	};
+}
+
+private StringBuilder CreateBuilder(char* buffer, ulong bufferSize)
+{
+	GuardNotNull(buffer);
+
+	if (bufferSize is 0)
+	{
+		throw(InvalidArgumentException);
+	}
+
+	return CreateBuilderFromBuffer(buffer, bufferSize - 1, null);
+}
+
+private StringBuilder CreateBuilderFromArena(Arena arena, ulong initialCapacity)
+{
+	GuardNotNull(arena);
+
+	initialCapacity = max(initialCapacity, 16);
+
+	return CreateBuilderFromBuffer(Memory.Arena.Alloc(arena, initialCapacity + 1), initialCapacity, arena);
+}
+
+private void ClearBuilder(StringBuilder* builder)
+{
+	builder->String.Count = 0;
+	builder->String.Dirty = true;
+	builder->String.Values[0] = '\0';
+	builder->Truncated = false;
+}
+
+// makes room for length more characters, returns the number of them that fit
+private ulong Reserve(StringBuilder* builder, ulong length)
+{
+	partial_string* str = &builder->String;
+
+	const ulong available = str->Capacity - str->Count;
+
+	if (length <= available)
+	{
+		return length;
+	}
+
+	if (builder->Arena is null)
+	{
+		builder->Truncated = true;
+		return available;
+	}
+
+	// the previous buffer can't be returned to the arena, it's released when the arena is reset
+	const ulong capacity = max(str->Capacity << 1, str->Count + length);
+
+	byte* values = Memory.Arena.Alloc(builder->Arena, capacity + 1);
+
+	memcpy(values, str->Values, str->Count);
+
+	str->Values = values;
+	str->Capacity = capacity;
+	str->Size = capacity + 1;
+
+	return length;
+}
+
+private bool Append(StringBuilder* builder, const char* bytes, ulong length)
+{
+	const ulong count = Reserve(builder, length);
+
+	partial_string* str = &builder->String;
+
+	memcpy(str->Values + str->Count, bytes, count);
+
+	str->Count += count;
+	str->Values[str->Count] = '\0';
+	str->Dirty = true;
+
+	return count is length;
+}
+
+private bool AppendCString(StringBuilder* builder, const char* cString)
+{
+	return Append(builder, cString, Length(cString));
+}
+
+private bool AppendString(StringBuilder* builder, const string str)
+{
+	if (str is null)
+	{
+		return true;
+	}
+
+	return Append(builder, (const char*)str->Values, str->Count);
+}
+
+private bool AppendChar(StringBuilder* builder, char character)
+{
+	return Append(builder, &character, 1);
+}
+
+private bool AppendBool(StringBuilder* builder, bool value)
+{
+	return value ? Append(builder, "true", 4) : Append(builder, "false", 5);
+}
+
+// writes the digits of value so they end at end, returns the first character written
+private char* WriteDigits(char* end, ulong value)
+{
+	while (value >= 100)
+	{
+		const ulong pair = (value % 100) << 1;
+		value /= 100;
+
+		*--end = GLOBAL_DigitPairs[pair + 1];
+		*--end = GLOBAL_DigitPairs[pair];
+	}
+
+	if (value >= 10)
+	{
+		const ulong pair = value << 1;
+
+		*--end = GLOBAL_DigitPairs[pair + 1];
+		*--end = GLOBAL_DigitPairs[pair];
+	}
+	else
+	{
+		*--end = (char)('0' + value);
+	}
+
+	return end;
+}
+
+private bool AppendUlong(StringBuilder* builder, ulong value)
+{
+	char digits[MAX_ULONG_DIGITS];
+
+	char* end = digits + sizeof(digits);
+	char* start = WriteDigits(end, value);
+
+	return Append(builder, start, end - start);
+}
+
+private bool AppendInt(StringBuilder* builder, long long value)
+{
+	char digits[MAX_ULONG_DIGITS + 1];
+
+	char* end = digits + sizeof(digits);
+
+	// negate as unsigned so the most negative value doesn't overflow
+	const ulong magnitude = value < 0 ? 0 - (ulong)value : (ulong)value;
+
+	char* start = WriteDigits(end, magnitude);
+
+	if (value < 0)
+	{
+		*--start = '-';
+	}
+
+	return Append(builder, start, end - start);
+}
+
+// writes the exact digits of a whole number too large for a ulong so they end at end, returns the first character written
+private char* WriteLargeDigits(char* end, double value)
+{
+	// value is mantissa * 2^exponent, the mantissa is multiplied by 2 exponent times in base 10^9
+	// so the digits are exact instead of the digits of the nearest value division by 10 can produce
+	int exponent;
+	const ulong mantissa = (ulong)ldexp(frexp(value, &exponent), 53);
+	exponent -= 53;
+
+	uint limbs[MAX_DOUBLE_LIMBS];
+	int count = 0;
+
+	for (ulong remaining = mantissa; remaining isnt 0; remaining /= 1000000000)
+	{
+		limbs[count++] = (uint)(remaining % 1000000000);
+	}
+
+	while (exponent > 0)
+	{
+		const int shift = min(exponent, 29);
+		exponent -= shift;
+
+		ulong carry = 0;
+
+		for (int i = 0; i < count; i++)
+		{
+			const ulong product = ((ulong)limbs[i] << shift) + carry;
+
+			limbs[i] = (uint)(product % 1000000000);
+			carry = product / 1000000000;
+		}
+
+		if (carry isnt 0)
+		{
+			limbs[count++] = (uint)carry;
+		}
+	}
+
+	// every limb but the most significant is written with its leading zeros
+	for (int i = 0; i < count - 1; i++)
+	{
+		ulong limb = limbs[i];
+
+		for (int digit = 0; digit < 9; digit++)
+		{
+			*--end = (char)('0' + (limb % 10));
+			limb /= 10;
+		}
+	}
+
+	return WriteDigits(end, limbs[count - 1]);
+}
+
+// rounds a non-negative value that fits within a ulong to the nearest whole number, ties to even like printf
+private ulong RoundToEven(double value)
+{
+	ulong rounded = (ulong)value;
+
+	const double remainder = value - (double)rounded;
+
+	if (remainder > 0.5 or (remainder == 0.5 and (rounded & 1)))
+	{
+		++rounded;
+	}
+
+	return rounded;
+}
+
+private bool AppendFloat(StringBuilder* builder, double value, int decimals)
+{
+	if (value != value)
+	{
+		return Append(builder, "nan", 3);
+	}
+
+	decimals = max(min(decimals, STRING_BUILDER_MAX_DECIMALS), 0);
+
+	// sign, the integer digits, the decimal point and the decimals
+	char characters[1 + MAX_DOUBLE_DIGITS + 1 + STRING_BUILDER_MAX_DECIMALS];
+
+	char* end = characters + sizeof(characters);
+	char* start = end;
+
+	const bool negative = signbit(value);
+	const double magnitude = fabs(value);
+	const ulong scale = GLOBAL_PowersOfTen[decimals];
+
+	if (isinf(magnitude))
+	{
+		return negative ? Append(builder, "-inf", 4) : Append(builder, "inf", 3);
+	}
+
+	// floats have 24 bits of precision and scales up to 10^6 fit within the 53 bits of a double
+	// so scaling them to a fixed point integer is exact and rounds the same as printf
+	const double scaled = magnitude * (double)scale;
+
+	if (scaled < 9223372036854775807.0 or magnitude < 9007199254740992.0)
+	{
+		ulong whole;
+		ulong fraction;
+
+		if (scaled < 9223372036854775807.0)
+		{
+			const ulong fixedPoint = RoundToEven(scaled);
+
+			whole = fixedPoint / scale;
+			fraction = fixedPoint % scale;
+		}
+		else
+		{
+			// the whole part fits within the 53 bits of a double but the scaled value doesn't fit a ulong, values this large
+			// only have a few fractional bits left so scaling just the fraction is exact
+			whole = (ulong)magnitude;
+			fraction = RoundToEven((magnitude - (double)whole) * (double)scale);
+
+			if (fraction is scale)
+			{
+				++whole;
+				fraction = 0;
+			}
+		}
+
+		for (int i = 0; i < decimals; i++)
+		{
+			*--start = (char)('0' + (fraction % 10));
+			fraction /= 10;
+		}
+
+		if (decimals > 0)
+		{
+			*--start = '.';
+		}
+
+		start = WriteDigits(start, whole);
+	}
+	else
+	{
+		// doubles of 2^53 or more are whole numbers
+		for (int i = 0; i < decimals; i++)
+		{
+			*--start = '0';
+		}
+
+		if (decimals > 0)
+		{
+			*--start = '.';
+		}
+
+		start = WriteLargeDigits(start, magnitude);
+	}
+
+	if (negative)
+	{
+		*--start = '-';
+	}
+
+	return Append(builder, start, end - start);
+}
+
+private bool AppendVector2(StringBuilder* builder, vector2 vector)
+{
+	bool fit = AppendFloat(builder, vector.x, STRING_BUILDER_DEFAULT_DECIMALS);
+	fit &= AppendChar(builder, ' ');
+	fit &= AppendFloat(builder, vector.y, STRING_BUILDER_DEFAULT_DECIMALS);
+
+	return fit;
+}
+
+private bool AppendVector3(StringBuilder* builder, vector3 vector)
+{
+	bool fit = AppendVector2(builder, (vector2) { vector.x, vector.y });
+	fit &= AppendChar(builder, ' ');
+	fit &= AppendFloat(builder, vector.z, STRING_BUILDER_DEFAULT_DECIMALS);
+
+	return fit;
+}
+
+private bool AppendVector4(StringBuilder* builder, vector4 vector)
+{
+	bool fit = AppendVector3(builder, (vector3) { vector.x, vector.y, vector.z });
+	fit &= AppendChar(builder, ' ');
+	fit &= AppendFloat(builder, vector.w, STRING_BUILDER_DEFAULT_DECIMALS);
+
+	return fit;
+}
+
+private bool AppendQuaternion(StringBuilder* builder, quaternion rotation)
+{
+	return AppendVector4(builder, (vector4) { rotation.x, rotation.y, rotation.z, rotation.w });
+}
+
+private const char* BuilderCString(const StringBuilder* builder)
+{
+	return (const char*)builder->String.Values;
+}
+
+TEST(Integers)
+{
+	char buffer[128];
+
+	StringBuilder builder = CreateBuilder(buffer, sizeof(buffer));
+
+	AppendInt(&builder, 0);
+	AppendChar(&builder, ' ');
+	AppendInt(&builder, -42);
+	AppendChar(&builder, ' ');
+	AppendInt(&builder, LLONG_MIN);
+	AppendChar(&builder, ' ');
+	AppendUlong(&builder, ULLONG_MAX);
+
+	IsTrue(strcmp(buffer, "0 -42 -9223372036854775808 18446744073709551615") is 0);
+	IsFalse(builder.Truncated);
+
+	return true;
+}
+
+TEST(FloatsMatchPrintf)
+{
+	char buffer[128];
+	char expected[128];
+
+	StringBuilder builder = CreateBuilder(buffer, sizeof(buffer));
+
+	const float values[] = { 0.0f, -0.0f, 1.0f, -1.5f, 0.1f, 2.4f, 3.14159265f, 1234567.875f, 1e-7f, -4.90f, 1e20f, -3.4e38f, 0.5f, 2.5f, 1e13f, -8589934591.5f };
+
+	ulong mismatches = 0;
+
+	for (ulong i = 0; i < sizeof(values) / sizeof(float); i++)
+	{
+		for (int decimals = 0; decimals <= STRING_BUILDER_DEFAULT_DECIMALS; decimals++)
+		{
+			ClearBuilder(&builder);
+			AppendFloat(&builder, values[i], decimals);
+
+			sprintf_s(expected, sizeof(expected), "%.*f", decimals, values[i]);
+
+			if (strcmp(buffer, expected) isnt 0)
+			{
+				fprintf(__test_stream, "\t%s isnt %s"NEWLINE, buffer, expected);
+				++mismatches;
+			}
+		}
+	}
+
+	IsZero(mismatches);
+
+	// doubles can have a whole part hundreds of digits long
+	char large[512];
+	char largeExpected[512];
+
+	StringBuilder largeBuilder = CreateBuilder(large, sizeof(large));
+	AppendFloat(&largeBuilder, 1.7976931348623157e308, 2);
+
+	sprintf_s(largeExpected, sizeof(largeExpected), "%.2f", 1.7976931348623157e308);
+
+	IsTrue(strcmp(large, largeExpected) is 0);
+
+	// whole parts below 2^53 whose scaled value doesn't fit a ulong still have fractional digits
+	ClearBuilder(&largeBuilder);
+	AppendFloat(&largeBuilder, 12345678901.4375, STRING_BUILDER_MAX_DECIMALS);
+
+	sprintf_s(largeExpected, sizeof(largeExpected), "%.*f", STRING_BUILDER_MAX_DECIMALS, 12345678901.4375);
+
+	IsTrue(strcmp(large, largeExpected) is 0);
+
+	ClearBuilder(&builder);
+	AppendVector3(&builder, (vector3) { -1.0f, 2.4f, 4.90f });
+
+	sprintf_s(expected, sizeof(expected), "%f %f %f", -1.0f, 2.4f, 4.90f);
+
+	IsTrue(strcmp(buffer, expected) is 0);
+
+	return true;
+}
+
+TEST(Truncation)
+{
+	char buffer[8];
+
+	StringBuilder builder = CreateBuilder(buffer, sizeof(buffer));
+
+	IsTrue(AppendCString(&builder, "1234"));
+	IsFalse(AppendCString(&builder, "56789"));
+	IsTrue(builder.Truncated);
+	IsTrue(strcmp(buffer, "1234567") is 0);
+
+	// the builder can be read like any other string
+	IsTrue(strings.Hash(&builder.String) is Hashing.HashSafe("1234567", 7));
+
+	return true;
+}
+
+TEST(ArenaGrowth)
+{
+	Arena arena = Memory.Arena.Create(4096, Memory.String);
+
+	StringBuilder builder = CreateBuilderFromArena(arena, 0);
+
+	for (int i = 0; i < 100; i++)
+	{
+		AppendInt(&builder, i);
+	}
+
+	IsFalse(builder.Truncated);
+	IsTrue(builder.String.Count is 190);
+	IsTrue(strncmp(BuilderCString(&builder), "0123456789101112", 16) is 0);
+
+	Memory.Arena.Dispose(arena);
+
+	return true;
+}
+
+private void BuildHud(StringBuilder* builder, double frameTime)
+{
+	ClearBuilder(builder);
+	AppendFloat(builder, frameTime * 1000.0, 4);
+	AppendCString(builder, " ms\n");
+	AppendFloat(builder, 1.0 / frameTime, 1);
+	AppendCString(builder, " FPS\nPosition: ");
+	AppendVector3(builder, (vector3) { (float)frameTime, 2.0f, -3.5f });
+}
+
+private void PrintHud(char* buffer, ulong size, double frameTime)
+{
+	sprintf_s(buffer, size, "%2.4lf ms\n%4.1lf FPS\nPosition: %f %f %f", frameTime * 1000.0, 1.0 / frameTime, (float)frameTime, 2.0f, -3.5f);
+}
+
+TEST(Benchmark)
+{
+	char buffer[256];
+
+	StringBuilder builder = CreateBuilder(buffer, sizeof(buffer));
+
+	const ulong count = 100000;
+
+	fprintf(__test_stream, "\tStringBuilder (%lli HUD rebuilds)"NEWLINE, count);
+	Benchmark(
+		for (ulong i = 0; i < count; i++)
+		{
+			BuildHud(&builder, 0.016 + i * 1e-9);
+		}, __test_stream);
+
+	fprintf(__test_stream, "\tsprintf_s (%lli HUD rebuilds)"NEWLINE, count);
+	Benchmark(
+		for (ulong i = 0; i < count; i++)
+		{
+			PrintHud(buffer, sizeof(buffer), 0.016 + i * 1e-9);
+		}, __test_stream);
+
+	return true;
+}
+
+TEST_SUITE(RunUnitTests,
+	APPEND_TEST(Integers)
+	APPEND_TEST(FloatsMatchPrintf)
+	APPEND_TEST(Truncation)
+	APPEND_TEST(ArenaGrowth)
+	APPEND_TEST(Benchmark)
+);
@@ -2,20 +2,32 @@
 
 #include "core/tasks.h"
 #include "core/memory.h"
+#include "core/cunit.h"
+#include <string.h>
+#include <limits.h>
 
 #ifdef WIN32
 #include <Windows.h>
 #include <synchapi.h>
+#else
+#include "core/atomic.h"
+#include <pthread.h>
+#include <errno.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/syscall.h>
+#include <linux/futex.h>
 #endif // WIN32
 
-#define MAX_HANDLES 1024
-
 private Task CreateTask(int (*Method)(void* state));
 private Task Run(Task task, void* state);
 private bool Stop(Task task);
 private void NotifyAllThreadsAddressChanged(void* address);
 private void NotifyAddressChanged(void* address);
 private bool _WaitOnAddress(volatile void* address, ulong addressSize, ulong milliseconds);
+private bool WaitWhileEqual(volatile void* address, const void* expected, ulong size, ulong milliseconds);
+private ulong DeadlineAfter(ulong milliseconds);
+private bool WaitUntil(volatile void* address, const void* expected, ulong size, ulong deadline);
 private int ThreadId();
 private WaitStatus Wait(Task task, ulong milliseconds);
 private WaitStatus WaitForState(Task task, WaitStatus state, ulong milliseconds);
@@ -25,6 +37,7 @@ private WaitStatus WaitAny(array(Task) tasks, ulong milliseconds);
 private void Dispose(Task);
 private Task CurrentTask();
 private Task TaskForThread(int threadId);
+private void RunUnitTests();
 
 struct _taskMethods Tasks = {
 	.Forever = ULLONG_MAX,
@@ -33,6 +46,9 @@ struct _taskMethods Tasks = {
 	.Stop = Stop,
 	.ThreadId = ThreadId,
 	.WaitOnAddress = _WaitOnAddress,
+	.WaitWhileEqual = WaitWhileEqual,
+	.DeadlineAfter = DeadlineAfter,
+	.WaitUntil = WaitUntil,
 	.NotifyAddressChanged = NotifyAddressChanged,
 	.NotifyAllThreadsAddressChanged = NotifyAllThreadsAddressChanged,
 	.Wait = Wait,
@@ -42,14 +58,18 @@ struct _taskMethods Tasks = {
 	.WaitAny = WaitAny,
 	.CurrentTask = CurrentTask,
 	.TaskForThread = TaskForThread,
-	.Dispose = Dispose
+	.Dispose = Dispose,
+	.RunUnitTests = RunUnitTests
 };
 
 DEFINE_TYPE_ID(Task);
 
+// incremented every time a task finishes so WaitAny can wait on every task at once
+static volatile long GLOBAL_CompletedTaskCount;
+
 private Task CreateTask(int (*Method)(void* state))
 {
-	REGISTER_TYPE(Task);
+	REGISTER_SLAB_TYPE(Task, sizeof(struct _task));
 
 	Task task = Memory.Alloc(sizeof(struct _task), TaskTypeId);
 
@@ -61,42 +81,359 @@ private Task CreateTask(int (*Method)(void* state))
 
 private void Dispose(Task task)
 {
-	Stop(task->ThreadHandle);
+	Stop(task);
 
 	Memory.Free(task, TaskTypeId);
 }
 
+#ifdef WIN32
+private long AtomicIncrement(volatile long* value)
+{
+	return _InterlockedIncrement(value);
+}
+
+// volatile accesses are acquire and release on windows
+private long AtomicLoad(volatile long* value)
+{
+	return *value;
+}
+
+private TaskState LoadStatus(Task task)
+{
+	return *(volatile TaskState*)&task->Status;
+}
+
+private void StoreStatus(Task task, TaskState status)
+{
+	*(volatile TaskState*)&task->Status = status;
+}
+
+private void SnapshotValue(volatile void* address, void* destination, ulong size)
+{
+	memcpy(destination, (const void*)address, size);
+}
+
+// milliseconds since some fixed point, only used to measure timeouts
+private ulong Milliseconds()
+{
+	return GetTickCount64();
+}
+
+// sleeps until the value at the address no longer matches expected, the address is notified, or the timeout elapses
+// returns false when the timeout elapsed
+private bool WaitWhileEqual(volatile void* address, const void* expected, ulong size, ulong milliseconds)
+{
+	return WaitOnAddress(address, (void*)expected, size, milliseconds >= INFINITE ? INFINITE : (DWORD)milliseconds);
+}
+
+private void NotifyAddressChanged(void* address)
+{
+	WakeByAddressSingle(address);
+}
+
+private void NotifyAllThreadsAddressChanged(void* address)
+{
+	WakeByAddressAll(address);
+}
+
+private int ThreadId()
+{
+	return GetCurrentThreadId();
+}
+#else
+// futexes can only wait on aligned ints, waiting on any other address parks the thread on
+// its own futex within one of these buckets until the address is notified
+#define ADDRESS_BUCKET_COUNT 256
+
+struct _addressWaiter {
+	volatile void* Address;
+	// the futex the waiting thread sleeps on, set by the thread that notified the address once it's done with the waiter
+	int Woken;
+	// set while the bucket is locked when the waiter is removed by the thread that notified the address
+	bool Unlinked;
+	struct _addressWaiter* Next;
+};
+
+struct _addressBucket {
+	locker Lock;
+	struct _addressWaiter* Waiters;
+};
+
+static struct _addressBucket GLOBAL_AddressBuckets[ADDRESS_BUCKET_COUNT];
+
+// gettid is a syscall, the thread id never changes so it's only asked for once per thread
+static _Thread_local int GLOBAL_CurrentThreadId;
+
+private long AtomicIncrement(volatile long* value)
+{
+	return __atomic_add_fetch(value, 1, __ATOMIC_SEQ_CST);
+}
+
+private long AtomicLoad(volatile long* value)
+{
+	return __atomic_load_n(value, __ATOMIC_ACQUIRE);
+}
+
+// everything the task wrote before changing its status is visible to the thread that sees the new status
+private TaskState LoadStatus(Task task)
+{
+	return __atomic_load_n(&task->Status, __ATOMIC_ACQUIRE);
+}
+
+private void StoreStatus(Task task, TaskState status)
+{
+	__atomic_store_n(&task->Status, status, __ATOMIC_RELEASE);
+}
+
+private ulong Milliseconds()
+{
+	struct timespec now;
+	clock_gettime(CLOCK_MONOTONIC, &now);
+
+	return ((ulong)now.tv_sec * 1000) + ((ulong)now.tv_nsec / 1000000);
+}
+
+private long Futex(int* address, int operation, int value, const struct timespec* deadline)
+{
+	return syscall(SYS_futex, address, operation | FUTEX_PRIVATE_FLAG, value, deadline, null, FUTEX_BITSET_MATCH_ANY);
+}
+
+private struct _addressBucket* BucketFor(volatile void* address)
+{
+	const ulong key = (ulong)address;
+
+	// the low bits are almost always the same due to alignment
+	return GLOBAL_AddressBuckets + (((key >> 3) ^ (key >> 12)) % ADDRESS_BUCKET_COUNT);
+}
+
+private void AcquireBucket(struct _addressBucket* bucket)
+{
+	while (Atomics.TryLock(&bucket->Lock)) {}
+}
+
+private void ReleaseBucket(struct _addressBucket* bucket)
+{
+	Atomics.Release(&bucket->Lock);
+}
+
+// copies the value at the address with an atomic load when it's the size of one
+private void SnapshotValue(volatile void* address, void* destination, ulong size)
+{
+	switch (size)
+	{
+	case sizeof(unsigned char):
+		*(unsigned char*)destination = __atomic_load_n((volatile unsigned char*)address, __ATOMIC_ACQUIRE);
+		break;
+	case sizeof(unsigned short):
+		*(unsigned short*)destination = __atomic_load_n((volatile unsigned short*)address, __ATOMIC_ACQUIRE);
+		break;
+	case sizeof(unsigned int):
+		*(unsigned int*)destination = __atomic_load_n((volatile unsigned int*)address, __ATOMIC_ACQUIRE);
+		break;
+	case sizeof(unsigned long long):
+		*(unsigned long long*)destination = __atomic_load_n((volatile unsigned long long*)address, __ATOMIC_ACQUIRE);
+		break;
+	default:
+		memcpy(destination, (const void*)address, size);
+		break;
+	}
+}
+
+private bool WaitWhileEqual(volatile void* address, const void* expected, ulong size, ulong milliseconds)
+{
+	struct _addressBucket* bucket = BucketFor(address);
+
+	struct _addressWaiter waiter = {
+		.Address = address,
+		.Woken = 0,
+		.Unlinked = false,
+		.Next = null
+	};
+
+	AcquireBucket(bucket);
+
+	// notifying takes the same lock so a change made before this comparison can't be missed
+	byte current[sizeof(ulong)];
+	SnapshotValue(address, current, size);
+
+	if (memcmp(current, expected, size) isnt 0)
+	{
+		ReleaseBucket(bucket);
+		return true;
+	}
+
+	waiter.Next = bucket->Waiters;
+	bucket->Waiters = &waiter;
+
+	ReleaseBucket(bucket);
+
+	struct timespec deadline;
+	if (milliseconds isnt Tasks.Forever)
+	{
+		clock_gettime(CLOCK_MONOTONIC, &deadline);
+
+		deadline.tv_sec += milliseconds / 1000;
+		deadline.tv_nsec += (milliseconds % 1000) * 1000000;
+
+		if (deadline.tv_nsec >= 1000000000)
+		{
+			deadline.tv_sec += 1;
+			deadline.tv_nsec -= 1000000000;
+		}
+	}
+
+	while (__atomic_load_n(&waiter.Woken, __ATOMIC_ACQUIRE) is 0)
+	{
+		const long result = Futex(&waiter.Woken, FUTEX_WAIT_BITSET, 0, milliseconds is Tasks.Forever ? null : &deadline);
+
+		if (result is -1 and errno is ETIMEDOUT)
+		{
+			break;
+		}
+	}
+
+	if (__atomic_load_n(&waiter.Woken, __ATOMIC_ACQUIRE))
+	{
+		return true;
+	}
+
+	AcquireBucket(bucket);
+
+	// the address may have been notified after the timeout but before the lock was taken
+	const bool unlinked = waiter.Unlinked;
+
+	if (unlinked is false)
+	{
+		struct _addressWaiter** link = &bucket->Waiters;
+
+		while (*link isnt &waiter)
+		{
+			link = &(*link)->Next;
+		}
+
+		*link = waiter.Next;
+	}
+
+	ReleaseBucket(bucket);
+
+	// the thread that notified the address still uses the waiter until it sets woken
+	while (unlinked and __atomic_load_n(&waiter.Woken, __ATOMIC_ACQUIRE) is 0)
+	{
+		Futex(&waiter.Woken, FUTEX_WAIT_BITSET, 0, null);
+	}
+
+	return unlinked;
+}
+
+// wakes at most count threads waiting on the address
+private void Notify(void* address, ulong count)
+{
+	struct _addressBucket* bucket = BucketFor(address);
+
+	// the change to the value at the address has to be visible before any waiter is woken
+	__atomic_thread_fence(__ATOMIC_SEQ_CST);
+
+	struct _addressWaiter* woken = null;
+
+	AcquireBucket(bucket);
+
+	struct _addressWaiter** link = &bucket->Waiters;
+
+	while (*link isnt null and count)
+	{
+		struct _addressWaiter* waiter = *link;
+
+		if (waiter->Address isnt address)
+		{
+			link = &waiter->Next;
+			continue;
+		}
+
+		*link = waiter->Next;
+
+		waiter->Unlinked = true;
+		waiter->Next = woken;
+		woken = waiter;
+
+		--count;
+	}
+
+	ReleaseBucket(bucket);
+
+	while (woken isnt null)
+	{
+		struct _addressWaiter* waiter = woken;
+
+		// the waiter returns as soon as it sees it was woken, after which it's gone
+		woken = waiter->Next;
+
+		__atomic_store_n(&waiter->Woken, 1, __ATOMIC_RELEASE);
+		Futex(&waiter->Woken, FUTEX_WAKE, 1, null);
+	}
+}
+
+private void NotifyAddressChanged(void* address)
+{
+	Notify(address, 1);
+}
+
+private void NotifyAllThreadsAddressChanged(void* address)
+{
+	Notify(address, ULLONG_MAX);
+}
+
+private int ThreadId()
+{
+	if (GLOBAL_CurrentThreadId is 0)
+	{
+		GLOBAL_CurrentThreadId = (int)syscall(SYS_gettid);
+	}
+
+	return GLOBAL_CurrentThreadId;
+}
+#endif // WIN32
 
 #define MAX_THREAD_ASSIGNMENTS 1024
 Task GLOBAL_ThreadAssignments[MAX_THREAD_ASSIGNMENTS];
 
+private void SetStatus(Task task, TaskState status)
+{
+	StoreStatus(task, status);
+	NotifyAllThreadsAddressChanged(&task->Status);
+}
+
 private int MethodWrapper(Task task)
 {
+	task->ThreadId = ThreadId();
+
 	int threadAssignment = task->ThreadId % MAX_THREAD_ASSIGNMENTS;
 	GLOBAL_ThreadAssignments[threadAssignment] = task;
 
-	task->Status = TaskStatus.Running;
-	NotifyAllThreadsAddressChanged(&task->Status);
+	SetStatus(task, TaskStatus.Running);
 
 	task->Method(task->InternalState.StatePointer);
 
-	task->Status = TaskStatus.RanToCompletion;
-	NotifyAllThreadsAddressChanged(&task->Status);
+	GLOBAL_ThreadAssignments[threadAssignment] = 0;
 
-	task->ThreadHandle = null;
 	task->ThreadId = 0;
 	task->InternalState.StatePointer = null;
 
-	// close our own handle
-	if (!Stop(task)) {
-		task->Status = TaskStatus.Faulted;
-		NotifyAllThreadsAddressChanged(&task->Status);
-	};
+	// whoever is waiting on the task may dispose it as soon as it completes, so this is the last time it's touched
+	SetStatus(task, TaskStatus.RanToCompletion);
 
-	GLOBAL_ThreadAssignments[threadAssignment] = 0;
+	AtomicIncrement(&GLOBAL_CompletedTaskCount);
+	NotifyAllThreadsAddressChanged((void*)&GLOBAL_CompletedTaskCount);
 
-	return task->Status isnt TaskStatus.RanToCompletion;
+	return 0;
+}
+
+#ifndef WIN32
+private void* ThreadStart(void* task)
+{
+	MethodWrapper(task);
+	return null;
 }
+#endif
 
 private void RunAll(array(Task) tasks, array(void_ptr) states)
 {
@@ -119,17 +456,17 @@ private Task CurrentTask()
 
 private Task Run(Task task, void* state)
 {
-	if (task->Status isnt TaskStatus.Created)
+	if (LoadStatus(task) isnt TaskStatus.Created)
 	{
 		// task already being started
 		return task;
 	}
 
-	task->Status = TaskStatus.WaitingForActivation;
-	NotifyAllThreadsAddressChanged(&task->Status);
+	SetStatus(task, TaskStatus.WaitingForActivation);
 
 	task->InternalState.StatePointer = state;
 
+#ifdef WIN32
 	task->ThreadHandle = CreateThread(
 		NULL,                   // Default security attributes
 		0,                      // Default stack size
@@ -139,68 +476,155 @@ private Task Run(Task task, void* state)
 		&task->ThreadId             // Receive thread identifier
 	);
 
-	return task;
-}
+	const bool started = task->ThreadHandle isnt null;
+#else
+	_Static_assert(sizeof(pthread_t) <= sizeof(void*), "pthread_t has to fit within a task's thread handle");
 
-private int ThreadId()
-{
-	return GetCurrentThreadId();
+	pthread_attr_t attributes;
+	pthread_attr_init(&attributes);
+
+	// nothing joins the thread, waiting is done on the status of the task instead
+	pthread_attr_setdetachstate(&attributes, PTHREAD_CREATE_DETACHED);
+
+	const bool started = pthread_create((pthread_t*)&task->ThreadHandle, &attributes, ThreadStart, task) is 0;
+
+	pthread_attr_destroy(&attributes);
+#endif
+
+	if (started is false)
+	{
+		task->ThreadHandle = null;
+		SetStatus(task, TaskStatus.Faulted);
+	}
+
+	return task;
 }
 
 private bool Stop(Task task)
 {
 	if (task->ThreadHandle)
 	{
-		return CloseHandle(task->ThreadHandle);
+#ifdef WIN32
+		const bool closed = CloseHandle(task->ThreadHandle);
+#else
+		// threads are detached so there is nothing to close
+		const bool closed = true;
+#endif
+		task->ThreadHandle = null;
+
+		return closed;
 	}
 
 	return false;
 }
 
-private WaitStatus WaitAny(array(Task) tasks, ulong milliseconds)
+private bool IsFinished(TaskState status)
 {
-	void* handles[MAX_HANDLES];
+	return status is TaskStatus.RanToCompletion or status is TaskStatus.Faulted or status is TaskStatus.Canceled;
+}
 
-	if (tasks->Count >= MAX_HANDLES)
+private ulong DeadlineAfter(ulong milliseconds)
+{
+	if (milliseconds is Tasks.Forever)
 	{
-		throw(OutOfMemoryException);
+		return Tasks.Forever;
 	}
 
-	for (int i = 0; i < tasks->Count; i++)
+	const ulong now = Milliseconds();
+
+	return milliseconds > Tasks.Forever - now ? Tasks.Forever : now + milliseconds;
+}
+
+// waits while the value at the address matches expected until the deadline, returns false when the deadline passed
+private bool WaitUntil(volatile void* address, const void* expected, ulong size, ulong deadline)
+{
+	if (deadline is Tasks.Forever)
+	{
+		return WaitWhileEqual(address, expected, size, Tasks.Forever);
+	}
+
+	const ulong now = Milliseconds();
+
+	if (now >= deadline)
 	{
-		handles[i] = at(tasks, i);
+		return false;
 	}
 
-	return WaitForMultipleObjects(tasks->Count, handles, false, milliseconds);
+	return WaitWhileEqual(address, expected, size, deadline - now);
 }
 
-private WaitStatus WaitAll(array(Task) tasks, ulong milliseconds)
+private WaitStatus WaitUntilFinished(Task task, ulong deadline)
+{
+	TaskState status;
+	while (IsFinished(status = LoadStatus(task)) is false)
+	{
+		if (WaitUntil(&task->Status, &status, sizeof(TaskState), deadline) is false)
+		{
+			return WaitStatuses.Timedout;
+		}
+	}
+
+	return WaitStatuses.Signaled;
+}
+
+// returns Signaled plus the index of the first task that finished, the same as WaitForMultipleObjects
+private WaitStatus WaitAny(array(Task) tasks, ulong milliseconds)
 {
-	void* handles[MAX_HANDLES];
+	if (tasks->Count is 0)
+	{
+		return WaitStatuses.Failed;
+	}
+
+	const ulong deadline = DeadlineAfter(milliseconds);
 
-	if (tasks->Count >= MAX_HANDLES)
+	while (true)
 	{
-		throw(OutOfMemoryException);
+		// read before the tasks are checked so a task that finishes after they're checked changes it
+		const long completed = AtomicLoad(&GLOBAL_CompletedTaskCount);
+
+		for (ulong i = 0; i < tasks->Count; i++)
+		{
+			if (IsFinished(LoadStatus(at(tasks, i))))
+			{
+				return WaitStatuses.Signaled + i;
+			}
+		}
+
+		if (WaitUntil(&GLOBAL_CompletedTaskCount, &completed, sizeof(long), deadline) is false)
+		{
+			return WaitStatuses.Timedout;
+		}
 	}
+}
 
-	for (int i = 0; i < tasks->Count; i++)
+private WaitStatus WaitAll(array(Task) tasks, ulong milliseconds)
+{
+	const ulong deadline = DeadlineAfter(milliseconds);
+
+	for (ulong i = 0; i < tasks->Count; i++)
 	{
-		handles[i] = at(tasks, i);
+		if (WaitUntilFinished(at(tasks, i), deadline) isnt WaitStatuses.Signaled)
+		{
+			return WaitStatuses.Timedout;
+		}
 	}
 
-	return WaitForMultipleObjects(tasks->Count, handles, true, milliseconds);
+	return WaitStatuses.Signaled;
 }
 
 private WaitStatus Wait(Task task, ulong milliseconds)
 {
-	return WaitForSingleObject(task->ThreadHandle, milliseconds);
+	return WaitUntilFinished(task, DeadlineAfter(milliseconds));
 }
 
 private WaitStatus WaitForState(Task task, WaitStatus state, ulong milliseconds)
 {
-	while (task->Status != state)
+	const ulong deadline = DeadlineAfter(milliseconds);
+
+	TaskState status;
+	while ((status = LoadStatus(task)) != state)
 	{
-		if (_WaitOnAddress(&task->Status, sizeof(byte), milliseconds) is false)
+		if (WaitUntil(&task->Status, &status, sizeof(TaskState), deadline) is false)
 		{
 			return WaitStatuses.Timedout;
 		}
@@ -212,15 +636,208 @@ private WaitStatus WaitForState(Task task, WaitStatus state, ulong milliseconds)
 // A thread can use the WaitOnAddress function to wait for the value of a target address to change from some undesired value to any other value. This enables threads to wait for a value to change without having to spin
 private bool _WaitOnAddress(volatile void* address, ulong addressSize, ulong milliseconds)
 {
-	return WaitOnAddress(address, ((byte*)address + 0), addressSize, milliseconds);
+	// addresses are at most 8 bytes, the same as WaitOnAddress
+	byte expected[sizeof(ulong)];
+
+	addressSize = min(addressSize, sizeof(expected));
+
+	SnapshotValue(address, expected, addressSize);
+
+	return WaitWhileEqual(address, expected, addressSize, milliseconds);
 }
 
-private void NotifyAddressChanged(void* address)
+#define STRESS_TASK_COUNT 100000
+// how many tasks are running at once during the stress test
+#define STRESS_BATCH_SIZE 64
+
+static volatile long GLOBAL_TestCounter;
+static volatile long GLOBAL_TestGate;
+
+private int IncrementCounter(void* state)
 {
-	WakeByAddressSingle(address);
+	ignore_unused(state);
+
+	AtomicIncrement(&GLOBAL_TestCounter);
+
+	return 0;
 }
 
-private void NotifyAllThreadsAddressChanged(void* address)
+private int RecordThread(void* state)
 {
-	WakeByAddressAll(address);
-}
\ No newline at end of file
+	int* ids = state;
+
+	ids[0] = ThreadId();
+	ids[1] = CurrentTask() isnt null ? CurrentTask()->ThreadId : 0;
+
+	return 0;
+}
+
+// blocks until the gate is opened
+private int WaitForGate(void* state)
+{
+	ignore_unused(state);
+
+	while (AtomicLoad(&GLOBAL_TestGate) is 0)
+	{
+		_WaitOnAddress(&GLOBAL_TestGate, sizeof(long), Tasks.Forever);
+	}
+
+	return 0;
+}
+
+private void OpenGate()
+{
+	AtomicIncrement(&GLOBAL_TestGate);
+	NotifyAllThreadsAddressChanged((void*)&GLOBAL_TestGate);
+}
+
+TEST(RunAndWait)
+{
+	int ids[2] = { 0 };
+
+	Task task = Run(CreateTask(RecordThread), ids);
+
+	const WaitStatus signaled = WaitStatuses.Signaled;
+
+	WaitStatus status = Wait(task, Tasks.Forever);
+	IsEqual(signaled, status);
+
+	const TaskState completed = TaskStatus.RanToCompletion;
+	const TaskState taskStatus = LoadStatus(task);
+	IsEqual(completed, taskStatus);
+
+	// the task ran on its own thread and could find itself
+	const int currentThread = ThreadId();
+	IsNotZero(ids[0]);
+	IsNotEqual(currentThread, ids[0]);
+	IsEqual(ids[0], ids[1]);
+
+	// waiting on a finished task returns right away
+	status = Wait(task, 0);
+	IsEqual(signaled, status);
+
+	Dispose(task);
+
+	return true;
+}
+
+TEST(WaitAnyAndTimeouts)
+{
+	GLOBAL_TestGate = 0;
+
+	array(Task) tasks = arrays(Task).Create(2);
+
+	Task blocked = Run(CreateTask(WaitForGate), null);
+
+	arrays(Task).Append(tasks, blocked);
+
+	const WaitStatus timedout = WaitStatuses.Timedout;
+	const WaitStatus signaled = WaitStatuses.Signaled;
+
+	WaitStatus status = Wait(blocked, 10);
+	IsEqual(timedout, status);
+
+	status = WaitAny(tasks, 10);
+	IsEqual(timedout, status);
+
+	arrays(Task).Append(tasks, Run(CreateTask(IncrementCounter), null));
+
+	// the second task finishes first
+	const WaitStatus second = WaitStatuses.Signaled + 1;
+	status = WaitAny(tasks, Tasks.Forever);
+	IsEqual(second, status);
+
+	status = WaitAll(tasks, 10);
+	IsEqual(timedout, status);
+
+	OpenGate();
+
+	status = WaitAll(tasks, Tasks.Forever);
+	IsEqual(signaled, status);
+
+	for (ulong i = 0; i < tasks->Count; i++)
+	{
+		Dispose(at(tasks, i));
+	}
+
+	arrays(Task).Dispose(tasks);
+
+	return true;
+}
+
+TEST(WaitOnAddress)
+{
+	GLOBAL_TestGate = 0;
+
+	// timeouts return false
+	byte flag = 0;
+	const bool woken = _WaitOnAddress(&flag, sizeof(byte), 10);
+	IsFalse(woken);
+
+	// the task sleeps on the gate until it's notified
+	Task task = Run(CreateTask(WaitForGate), null);
+
+	const WaitStatus signaled = WaitStatuses.Signaled;
+
+	WaitStatus status = WaitForState(task, TaskStatus.Running, Tasks.Forever);
+	IsEqual(signaled, status);
+
+	OpenGate();
+
+	status = Wait(task, Tasks.Forever);
+	IsEqual(signaled, status);
+
+	Dispose(task);
+
+	return true;
+}
+
+// runs and joins tasks in batches, returns the number of tasks that didn't run
+private ulong RunStressTest(ulong count)
+{
+	GLOBAL_TestCounter = 0;
+
+	array(Task) tasks = arrays(Task).Create(STRESS_BATCH_SIZE);
+
+	for (ulong started = 0; started < count; started += STRESS_BATCH_SIZE)
+	{
+		const ulong batch = min(STRESS_BATCH_SIZE, count - started);
+
+		for (ulong i = 0; i < batch; i++)
+		{
+			arrays(Task).Append(tasks, Run(CreateTask(IncrementCounter), null));
+		}
+
+		WaitAll(tasks, Tasks.Forever);
+
+		for (ulong i = 0; i < tasks->Count; i++)
+		{
+			Dispose(at(tasks, i));
+		}
+
+		arrays(Task).Clear(tasks);
+	}
+
+	arrays(Task).Dispose(tasks);
+
+	return count - AtomicLoad(&GLOBAL_TestCounter);
+}
+
+TEST(Stress)
+{
+	ulong missing = 0;
+
+	fprintf(__test_stream, "\tRun and wait on %i tasks, %i at a time"NEWLINE, STRESS_TASK_COUNT, STRESS_BATCH_SIZE);
+	Benchmark(missing = RunStressTest(STRESS_TASK_COUNT), __test_stream);
+
+	IsZero(missing);
+
+	return true;
+}
+
+TEST_SUITE(RunUnitTests,
+	APPEND_TEST(RunAndWait)
+	APPEND_TEST(WaitAnyAndTimeouts)
+	APPEND_TEST(WaitOnAddress)
+	APPEND_TEST(Stress)
+);
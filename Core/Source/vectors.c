@@ -2,6 +2,8 @@
 #include <stdio.h>
 #include "core/file.h"
 #include "core/cunit.h"
+#include "core/strings.h"
+#include "core/parsing.h"
 #include "string.h"
 #include "cglm/cam.h"
 #include "cglm/mat3.h"
@@ -92,6 +94,9 @@ const struct _mat3Methods Matrix3s = {
 #define Vector3SerializationFormat "%f %f %f"
 #define Vector4SerializationFormat "%f %f %f %f"
 
+// large enough for any vector4 written with the serialization format, floats have at most 39 whole digits
+#define SERIALIZED_VECTOR_SIZE (4 * (1 + 39 + 1 + STRING_BUILDER_DEFAULT_DECIMALS + 1))
+
 private bool EqualsVec2(const vector2 left, const vector2 right)
 {
 	return left.x == right.x && left.y == right.y;
@@ -110,12 +115,7 @@ private bool TryParseVector3(const char* buffer, ulong length, vector3* out_vect
 		return false;
 	}
 
-	int count = sscanf_s(buffer, "%f %f %f",
-		&out_vector3->x,
-		&out_vector3->y,
-		&out_vector3->z);
-
-	return count == 3;
+	return Parsing.TryGetFloats(buffer, length, (float*)out_vector3, 3);
 }
 
 private bool TryParseVector2(const char* buffer, ulong length, vector2* out_vector2)
@@ -125,11 +125,7 @@ private bool TryParseVector2(const char* buffer, ulong length, vector2* out_vect
 		return false;
 	}
 
-	int count = sscanf_s(buffer, "%f %f",
-		&out_vector2->x,
-		&out_vector2->y);
-
-	return count == 2;
+	return Parsing.TryGetFloats(buffer, length, (float*)out_vector2, 2);
 }
 
 private bool Equals(const vector3 left, const vector3 right)
@@ -217,13 +213,13 @@ private bool TrySerializeVec3Stream(File stream, const vector3 vector)
 		return false;
 	}
 
-	int result = fprintf_s(stream, Vector3SerializationFormat,
-		vector.x,
-		vector.y,
-		vector.z);
+	char buffer[SERIALIZED_VECTOR_SIZE];
+
+	StringBuilder builder = StringBuilders.Create(buffer, sizeof(buffer));
 
-	// 0 is runtime error, negative is encoding error
-	return result > 0;
+	StringBuilders.AppendVector3(&builder, vector);
+
+	return fwrite(buffer, 1, builder.String.Count, stream) is builder.String.Count;
 }
 
 private bool TrySerializeVec3(char* buffer, const ulong length, const vector3 vector)
@@ -233,10 +229,10 @@ private bool TrySerializeVec3(char* buffer, const ulong length, const vector3 ve
 		return false;
 	}
 
-	int result = sprintf_s(buffer, length, Vector3SerializationFormat, vector.x, vector.y, vector.z);
+	StringBuilder builder = StringBuilders.Create(buffer, length);
 
-	// 0 is runtime error, negative is encoding error
-	return result > 0;
+	// false when the buffer was too small
+	return StringBuilders.AppendVector3(&builder, vector);
 }
 
 private bool TrySerializeVec2(char* buffer, const ulong length, const vector2 vector)
@@ -246,10 +242,10 @@ private bool TrySerializeVec2(char* buffer, const ulong length, const vector2 ve
 		return false;
 	}
 
-	int result = sprintf_s(buffer, length, Vector2SerializationFormat, vector.x, vector.y);
+	StringBuilder builder = StringBuilders.Create(buffer, length);
 
-	// 0 is runtime error, negative is encoding error
-	return result > 0;
+	// false when the buffer was too small
+	return StringBuilders.AppendVector2(&builder, vector);
 }
 
 private bool TryDeserializeVec4(const char* buffer, const ulong length, vector4* out_vector4)
@@ -259,12 +255,7 @@ private bool TryDeserializeVec4(const char* buffer, const ulong length, vector4*
 		return false;
 	}
 
-	int count = sscanf_s(buffer, Vector4SerializationFormat, &out_vector4->x,
-		&out_vector4->y,
-		&out_vector4->z,
-		&out_vector4->w);
-
-	return count == 4;
+	return Parsing.TryGetFloats(buffer, length, (float*)out_vector4, 4);
 }
 
 private bool TrySerializeVec4Stream(File stream, const vector4 vector)
@@ -274,14 +265,13 @@ private bool TrySerializeVec4Stream(File stream, const vector4 vector)
 		return false;
 	}
 
-	int result = fprintf_s(stream, Vector4SerializationFormat,
-		vector.x,
-		vector.y,
-		vector.z,
-		vector.w);
+	char buffer[SERIALIZED_VECTOR_SIZE];
+
+	StringBuilder builder = StringBuilders.Create(buffer, sizeof(buffer));
+
+	StringBuilders.AppendVector4(&builder, vector);
 
-	// 0 is runtime error, negative is encoding error
-	return result > 0;
+	return fwrite(buffer, 1, builder.String.Count, stream) is builder.String.Count;
 }
 
 private bool TrySerializeVec4(char* buffer, const ulong length, const vector4 vector)
@@ -291,14 +281,10 @@ private bool TrySerializeVec4(char* buffer, const ulong length, const vector4 ve
 		return false;
 	}
 
-	int result = sprintf_s(buffer, length, Vector4SerializationFormat,
-		vector.x,
-		vector.y,
-		vector.z,
-		vector.w);
+	StringBuilder builder = StringBuilders.Create(buffer, length);
 
-	// 0 is runtime error, negative is encoding error
-	return result > 0;
+	// false when the buffer was too small
+	return StringBuilders.AppendVector4(&builder, vector);
 }
 
 TEST(Test_TryGetVector3)
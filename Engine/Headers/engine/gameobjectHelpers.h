@@ -2,7 +2,11 @@
 
 #include "engine/gameobject.h"
 #include "engine/modeling/importer.h"
+#include "core/futures.h"
 
 GameObject CreateGameObjectFromMesh(Mesh mesh);
 GameObject CreateFromRenderMesh(RenderMesh mesh);
-GameObject LoadGameObjectFromModel(string path, FileFormat format);
\ No newline at end of file
+GameObject LoadGameObjectFromModel(string path, FileFormat format);
+// Imports the model on a job thread, then binds its meshes and creates the gameobject on the main thread during the
+// following frames without blocking any thread, the future faults when the model can't be imported or bound
+future(GameObject) LoadGameObjectFromModelAsync(const string path, FileFormat format);
@@ -160,6 +160,8 @@ struct _transformMethods {
 	/// Saves a transform by serializing it to the provided stream
 	/// </summary>
 	void (*Save)(Transform, File stream);
+
+	void (*RunUnitTests)();
 };
 
 extern const struct _transformMethods Transforms;
\ No newline at end of file
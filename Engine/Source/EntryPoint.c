@@ -49,6 +49,8 @@
 #include "core/runtime.h"
 #include "core/tasks.h"
 #include "core/modules.h"
+#include "core/file.h"
+#include "core/packs.h"
 
 // scripts (not intrinsically part of the engine)
 #include "engine/scripts/fpsCamera.h"
@@ -183,6 +185,16 @@ void nocall()
 	glBindVertexArray(VertexArrayID);
 
 
+	// when the assets are packed, build one with the Packer tool, every asset is read from a single mapping
+	// instead of opening each file
+	Pack assetPack = null;
+	if (Files.Exists(stack_string("assets.pack")))
+	{
+		Packs.TryMount(stack_string("assets.pack"), &assetPack);
+	}
+
+	const double loadStartTime = Time.Time();
+
 	// load the default material so we can render gameobjects that have no set material
 	Material defaultMaterial = Materials.Load(stack_string("assets/materials/default.material"));
 	GameObjects.SetDefaultMaterial(defaultMaterial);
@@ -323,6 +335,10 @@ void nocall()
 
 	Material shadowMapMaterial = Materials.Load(stack_string("assets/materials/shadow.material"));
 
+	fprintf(stdout, "Loaded the scene from %s in %.2fms"NEWLINE,
+		assetPack isnt null ? "assets.pack" : "loose files",
+		(Time.Time() - loadStartTime) * 1000.0);
+
 	// main game loop
 	bool showNormals = false;
 
@@ -454,14 +470,20 @@ void nocall()
 
 		Transforms.SetRotationOnAxis(cube->Transform, (float)(3 * cos(Time.Time())), Vector3.Up);
 
-		int count = sprintf_s(text->Text, text->Length,
-			"%2.4lf ms (high:%2.4lf ms avg:%2.4lf)\n%4.1lf FPS\nIntersecting:%s",
-			Time.Statistics.FrameTime(),
-			Time.Statistics.HighestFrameTime(),
-			Time.Statistics.AverageFrameTime(),
-			1.0 / Time.Statistics.FrameTime(), intersects ? "true" : "false");
+		// rebuild the stats in place every frame, the text's buffer is one byte larger than its length
+		StringBuilder stats = StringBuilders.Create(text->Text, text->Length + 1);
+
+		StringBuilders.AppendFloat(&stats, Time.Statistics.FrameTime(), 4);
+		StringBuilders.AppendCString(&stats, " ms (high:");
+		StringBuilders.AppendFloat(&stats, Time.Statistics.HighestFrameTime(), 4);
+		StringBuilders.AppendCString(&stats, " ms avg:");
+		StringBuilders.AppendFloat(&stats, Time.Statistics.AverageFrameTime(), 4);
+		StringBuilders.AppendCString(&stats, ")\n");
+		StringBuilders.AppendFloat(&stats, 1.0 / Time.Statistics.FrameTime(), 1);
+		StringBuilders.AppendCString(&stats, " FPS\nIntersecting:");
+		StringBuilders.AppendBool(&stats, intersects);
 
-		Texts.SetText(text, text->Text, count);
+		Texts.SetText(text, text->Text, stats.String.Count);
 
 		// update the FPS camera
 		Transforms.SetPosition(camera->Transform, position);
@@ -538,6 +560,8 @@ void nocall()
 
 	Scenes.Dispose(scene);
 
+	Packs.Unmount(assetPack);
+
 	Windows.Dispose(window);
 
 	Windows.StopRuntime();
@@ -1,5 +1,6 @@
 #include "engine/gameobjectHelpers.h"
 #include "core/memory.h"
+#include "core/strings.h"
 
 DEFINE_TYPE_ID(GameObjectMeshes);
 
@@ -37,6 +38,25 @@ GameObject CreateFromRenderMesh(RenderMesh mesh)
 	return parent;
 }
 
+// creates a gameobject that owns the bound meshes of the model, disposes the model
+private GameObject CreateFromBoundModel(Model model, RenderMesh* meshes)
+{
+	GameObject parent = GameObjects.Create();
+
+	parent->Meshes = meshes;
+	parent->Count = model->Count;
+
+	// set all the children's meshes parent to the gameobjects transform
+	for (ulong i = 0; i < model->Count; i++)
+	{
+		Transforms.SetParent(meshes[i]->Transform, parent->Transform);
+	}
+
+	Models.Dispose(model);
+
+	return parent;
+}
+
 GameObject LoadGameObjectFromModel(const string path, FileFormat format)
 {
 	Model model;
@@ -58,18 +78,100 @@ GameObject LoadGameObjectFromModel(const string path, FileFormat format)
 		throw(FailedToBindMeshException);
 	}
 
-	GameObject parent = GameObjects.Create();
+	return CreateFromBoundModel(model, meshes);
+}
 
-	parent->Meshes = meshes;
-	parent->Count = model->Count;
+DEFINE_TYPE_ID(ModelLoad);
 
-	// set all the children's meshes parent to the gameobjects transform
-	for (ulong i = 0; i < model->Count; i++)
+struct _modelLoad {
+	string Path;
+	FileFormat Format;
+};
+
+struct _boundModel {
+	Model Model;
+	RenderMesh* Meshes;
+};
+
+// runs on a job thread since reading and parsing the file is most of the work
+private bool ImportModelStep(Future antecedent, void* state, void* out_result)
+{
+	ignore_unused(antecedent);
+
+	struct _modelLoad* load = state;
+
+	Model model;
+	const bool imported = Importers.TryImport(load->Path, load->Format, &model);
+
+	strings.Dispose(load->Path);
+	Memory.Free(load, ModelLoadTypeId);
+
+	if (imported is false)
 	{
-		Transforms.SetParent(meshes[i]->Transform, parent->Transform);
+		return false;
 	}
 
-	Models.Dispose(model);
+	if (model->Count is 0)
+	{
+		Models.Dispose(model);
+		return false;
+	}
 
-	return parent;
-}
\ No newline at end of file
+	*(Model*)out_result = model;
+
+	return true;
+}
+
+// buffers can only be created on the thread that owns the graphics context
+private bool BindModelStep(Future antecedent, void* state, void* out_result)
+{
+	ignore_unused(state);
+
+	Model model = future_result(Model, antecedent);
+
+	RenderMesh* meshes;
+	if (RenderMeshes.TryBindModel(model, &meshes) is false)
+	{
+		Models.Dispose(model);
+		return false;
+	}
+
+	struct _boundModel* bound = out_result;
+
+	bound->Model = model;
+	bound->Meshes = meshes;
+
+	return true;
+}
+
+private bool CreateGameObjectStep(Future antecedent, void* state, void* out_result)
+{
+	ignore_unused(state);
+
+	struct _boundModel bound = future_result(struct _boundModel, antecedent);
+
+	*(GameObject*)out_result = CreateFromBoundModel(bound.Model, bound.Meshes);
+
+	return true;
+}
+
+future(GameObject) LoadGameObjectFromModelAsync(const string path, FileFormat format)
+{
+	REGISTER_TYPE(ModelLoad);
+
+	// the path is copied since the caller's may not live until the import runs
+	struct _modelLoad* load = Memory.Alloc(sizeof(struct _modelLoad), ModelLoadTypeId);
+
+	load->Path = strings.Clone(path);
+	load->Format = format;
+
+	future(Model) imported = Futures.Run(ImportModelStep, load, sizeof(Model), FutureSchedulers.Pool);
+	future(struct _boundModel) bound = Futures.Then(imported, BindModelStep, null, sizeof(struct _boundModel), FutureSchedulers.MainThread);
+	future(GameObject) created = Futures.Then(bound, CreateGameObjectStep, null, sizeof(GameObject), FutureSchedulers.MainThread);
+
+	// the chain keeps each step alive until the next one ran
+	Futures.Dispose(imported);
+	Futures.Dispose(bound);
+
+	return created;
+}
@@ -271,64 +271,69 @@ static bool TryCountElements(File stream, array(byte) buffer, struct _elementCou
 	return ferror(stream) is 0;
 }
 
-static bool TryParseFace(const char* buffer, ulong* out_attributes)
+// true when the position holds part of the current vertex, rather than the space before the next one
+static bool IsWithinVertex(const char* position, const char* end)
 {
-	// base case assume the file includes normals, uv and vertices
-	int count = sscanf_s(buffer, "%lli/%lli/%lli %lli/%lli/%lli %lli/%lli/%lli",
-		&out_attributes[0], // vertex
-		&out_attributes[1], // uv
-		&out_attributes[2], // normal
-		&out_attributes[3], // vertex
-		&out_attributes[4], // uv
-		&out_attributes[5], // normal
-		&out_attributes[6], // vertex
-		&out_attributes[7], // uv
-		&out_attributes[8]); // normal
-
-	if (count is 9)
-	{
-		return true;
-	}
+	return position < end and isspace((unsigned char)*position) is false;
+}
+
+static bool TryParseFace(const char* buffer, ulong length, ulong* out_attributes)
+{
+	const char* position = buffer;
+	const char* end = buffer + length;
 
-	// if there are no normals OR UV's then our count will be 1(the first number)
-	// format: "f 57 56 58"
-	if (count is 1)
+	// each vertex is one of "v", "v/uv", "v/uv/", "v//normal" or "v/uv/normal"
+	// format: "f 1/2/3 4/5/6 7/8/9"
+	for (ulong i = 0; i < 3; i++)
 	{
-		count = sscanf_s(buffer, "%lli %lli %lli",
-			&out_attributes[0],
-			&out_attributes[3],
-			&out_attributes[6]);
+		ulong* attributes = out_attributes + (i * 3);
 
-		if (count is 3)
+		long long index;
+		if (Parsing.TryReadInt(&position, end, &index) is false)
 		{
-			return true;
+			return false;
 		}
-	}
 
-	// try to import it with vertices and normals but no uv
-	count = sscanf_s(buffer, "%lli//%lli %lli//%lli %lli//%lli",
-		&out_attributes[0], // vertex
-		&out_attributes[2], // normal
-		&out_attributes[3], // vertex
-		&out_attributes[5], // normal
-		&out_attributes[6], // vertex
-		&out_attributes[8]); // normal
+		attributes[0] = (ulong)index; // vertex
 
-	if (count is 6)
-	{
-		return true;
-	}
+		if (IsWithinVertex(position, end) is false or *position isnt '/')
+		{
+			continue;
+		}
+
+		++position;
 
-	// try to import with uv but no normals
-	count = sscanf_s(buffer, "%lli/%lli/ %lli/%lli/ %lli/%lli/",
-		&out_attributes[0], // vertex
-		&out_attributes[1], // uv
-		&out_attributes[3], // vertex
-		&out_attributes[4], // uv
-		&out_attributes[6], // vertex
-		&out_attributes[7]); // uv
+		// the uv is missing for "v//normal"
+		if (IsWithinVertex(position, end) and *position isnt '/')
+		{
+			if (Parsing.TryReadInt(&position, end, &index) is false)
+			{
+				return false;
+			}
+
+			attributes[1] = (ulong)index; // uv
+		}
 
-	return count == 6;
+		if (IsWithinVertex(position, end) is false or *position isnt '/')
+		{
+			continue;
+		}
+
+		++position;
+
+		// the normal is missing for "v/uv/"
+		if (IsWithinVertex(position, end))
+		{
+			if (Parsing.TryReadInt(&position, end, &index) is false)
+			{
+				return false;
+			}
+
+			attributes[2] = (ulong)index; // normal
+		}
+	}
+
+	return true;
 }
 
 // does not mutate the provided vector
@@ -501,9 +506,10 @@ static bool TryParseObjects(File stream,
 			Memory.ZeroArray(indices, sizeof(ulong) * 9);
 
 			offset = buffer->Values + Sequences.FaceSize;
+			size = min(lineLength - Sequences.FaceSize, lineLength);
 
 			// read the indices
-			if (TryParseFace(offset, indices) is false)
+			if (TryParseFace(offset, size, indices) is false)
 			{
 				Meshes.Dispose(currentMesh);
 				return false;
@@ -613,9 +619,6 @@ static bool TryParseObjects(File stream,
 	return true;
 }
 
-// buffer to keep the face counts
-ulong FaceCounts[MAX_FACES];
-
 DEFINE_TYPE_ID(Mesh);
 
 static bool TryImportModelStream(File stream,
@@ -628,6 +631,10 @@ static bool TryImportModelStream(File stream,
 
 	array(byte) streamBuffer = empty_stack_array(byte, BUFFER_SIZE);
 
+	// allocated per import instead of shared so models can be imported on more than one thread at once
+	// the block comes back zeroed so it costs the same as clearing a shared one
+	ulong* faceCounts = Memory.Alloc(MAX_FACES * sizeof(ulong), Memory.GenericMemoryBlock);
+
 	// create a place to put the counts of the file
 	struct _elementCounts elementCounts = {
 		.FaceCount = 0,
@@ -636,17 +643,16 @@ static bool TryImportModelStream(File stream,
 		.ObjectCount = 0,
 		.TextureCount = 0,
 		.VertexCount = 0,
-		.FaceCounts = FaceCounts
+		.FaceCounts = faceCounts
 	};
 
-	Memory.ZeroArray(FaceCounts, MAX_FACES * sizeof(ulong));
-
 	// count the occurences of the elements within the file
 	if (TryCountElements(stream,
 		streamBuffer,
 		&elementCounts) is false)
 	{
 		Files.TryClose(stream);
+		Memory.Free(faceCounts, Memory.GenericMemoryBlock);
 		// if we were not able to count all the elements we should return false, something weird happened
 		return false;
 	}
@@ -676,6 +682,7 @@ static bool TryImportModelStream(File stream,
 		Memory.Free(meshes, MeshTypeId);
 		DisposeBufferCollection(&buffers);
 		Files.TryClose(stream);
+		Memory.Free(faceCounts, Memory.GenericMemoryBlock);
 		return false;
 	}
 
@@ -690,6 +697,8 @@ static bool TryImportModelStream(File stream,
 	// make sure to dispose the buffer collection when we are done
 	DisposeBufferCollection(&buffers);
 
+	Memory.Free(faceCounts, Memory.GenericMemoryBlock);
+
 	*out_model = model;
 
 	return true;
@@ -128,7 +128,7 @@ static void ResizeShaders(Material material, ulong desiredCount)
 		ulong previousSize = material->Count * sizeof(Shader);
 		ulong newSize = desiredCount * sizeof(Shader);
 
-		if (Memory.TryRealloc(material->Shaders, previousSize, newSize, (void**)&material->Shaders) is false)
+		if (Memory.TryRealloc(material->Shaders, previousSize, newSize, MaterialShadersTypeId, (void**)&material->Shaders) is false)
 		{
 			Shader* newArray = Memory.Alloc(newSize, MaterialShadersTypeId);
 
@@ -695,7 +695,151 @@ TOKENS(11) {
 		TOKEN(reflectivity, "# float [0-1]; the reflectivity of this material"),
 };
 
-CONFIG(Material);
+// frees every value loaded into the definition
+static void DisposeDefinition(struct _materialDefinition* state)
+{
+	Memory.Free(state->MainTexturePath, Memory.String);
+	Memory.Free(state->SpecularTexturePath, Memory.String);
+	Memory.Free(state->ReflectionTexturePath, Memory.String);
+	Memory.Free(state->ReflectionMap, Memory.String);
+	Memory.Free(state->AreaMap, Memory.String);
+
+	Memory.Free(state->ShaderPathLengths, Memory.String);
+
+	for (ulong i = 0; i < state->ShaderCount; i++)
+	{
+		Memory.Free(state->ShaderPaths[i], Memory.String);
+	}
+
+	Memory.Free(state->ShaderPaths, Memory.String);
+}
+
+static void WritePath(string blob, const char* path)
+{
+	Configs.WriteString(blob, path, path isnt null ? strlen(path) : 0);
+}
+
+static bool TryReadPath(ConfigReader* reader, char** out_path)
+{
+	const char* path;
+	ulong length;
+
+	if (Configs.TryReadString(reader, &path, &length) is false)
+	{
+		return false;
+	}
+
+	if (path isnt null)
+	{
+		*out_path = Memory.Alloc(length + 1, Memory.String);
+
+		memcpy(*out_path, path, length);
+		(*out_path)[length] = '\0';
+	}
+
+	return true;
+}
+
+static void SaveBinary(string blob, void* definition)
+{
+	const struct _materialDefinition* state = definition;
+
+	Configs.Write(blob, &state->ShaderCount, sizeof(ulong));
+
+	for (ulong i = 0; i < state->ShaderCount; i++)
+	{
+		Configs.WriteString(blob, state->ShaderPaths[i], state->ShaderPathLengths[i]);
+	}
+
+	Configs.Write(blob, &state->Color, sizeof(color));
+	Configs.Write(blob, &state->Specular, sizeof(color));
+	Configs.Write(blob, &state->Ambient, sizeof(color));
+	Configs.Write(blob, &state->Diffuse, sizeof(color));
+	Configs.Write(blob, &state->Shininess, sizeof(float));
+	Configs.Write(blob, &state->Reflectivity, sizeof(float));
+
+	WritePath(blob, state->MainTexturePath);
+	WritePath(blob, state->SpecularTexturePath);
+	WritePath(blob, state->ReflectionMap);
+	WritePath(blob, state->AreaMap);
+}
+
+static bool TryLoadBinary(ConfigReader* reader, void* definition)
+{
+	struct _materialDefinition* state = definition;
+
+	// loaded into an empty definition so a corrupt cache leaves the state untouched, every value is read from the cache
+	// and nothing is shared with the state, so disposing it on failure can't free anything the state owns
+	struct _materialDefinition loaded = {
+		.ShaderCount = 0,
+		.ShaderPathLengths = null,
+		.ShaderPaths = null,
+		.MainTexturePath = null,
+		.SpecularTexturePath = null,
+		.ReflectionTexturePath = null,
+		.ReflectionMap = null,
+		.AreaMap = null
+	};
+
+	bool success = Configs.TryRead(reader, &loaded.ShaderCount, sizeof(ulong));
+
+	// a corrupt count can't be larger than the blob
+	success = success and loaded.ShaderCount <= reader->Count;
+
+	if (success is false)
+	{
+		return false;
+	}
+
+	loaded.ShaderPaths = Memory.Alloc(sizeof(char*) * max(loaded.ShaderCount, 1), Memory.String);
+	loaded.ShaderPathLengths = Memory.Alloc(sizeof(ulong) * max(loaded.ShaderCount, 1), Memory.String);
+
+	for (ulong i = 0; i < loaded.ShaderCount; i++)
+	{
+		loaded.ShaderPaths[i] = null;
+
+		if (success)
+		{
+			success = TryReadPath(reader, &loaded.ShaderPaths[i]);
+			loaded.ShaderPathLengths[i] = success and loaded.ShaderPaths[i] isnt null ? strlen(loaded.ShaderPaths[i]) : 0;
+		}
+	}
+
+	success = success and Configs.TryRead(reader, &loaded.Color, sizeof(color));
+	success = success and Configs.TryRead(reader, &loaded.Specular, sizeof(color));
+	success = success and Configs.TryRead(reader, &loaded.Ambient, sizeof(color));
+	success = success and Configs.TryRead(reader, &loaded.Diffuse, sizeof(color));
+	success = success and Configs.TryRead(reader, &loaded.Shininess, sizeof(float));
+	success = success and Configs.TryRead(reader, &loaded.Reflectivity, sizeof(float));
+
+	success = success and TryReadPath(reader, &loaded.MainTexturePath);
+	success = success and TryReadPath(reader, &loaded.SpecularTexturePath);
+	success = success and TryReadPath(reader, &loaded.ReflectionMap);
+	success = success and TryReadPath(reader, &loaded.AreaMap);
+
+	if (success is false)
+	{
+		DisposeDefinition(&loaded);
+		return false;
+	}
+
+	// nothing has been parsed into the state yet when the cache is read, but don't leak it if it was
+	DisposeDefinition(state);
+
+	*state = loaded;
+
+	return true;
+}
+
+// materials are cached after they're parsed, increment the version when the binary layout changes
+static const struct _configDefinition MaterialConfigDefinition = {
+	.Tokens = Tokens,
+	.CommentCharacter = '#',
+	.Count = sizeof(Tokens) / sizeof(struct _configToken),
+	.BinaryVersion = 1,
+	.SaveBinary = &SaveBinary,
+	.TryLoadBinary = &TryLoadBinary
+};
 
 static Material Load(const string path)
 {
@@ -839,18 +983,7 @@ static Material Load(const string path)
 		material->Name = strings.Clone(path);
 	}
 
-	Memory.Free(state.MainTexturePath, Memory.String);
-
-	Memory.Free(state.SpecularTexturePath, Memory.String);
-
-	Memory.Free(state.ShaderPathLengths, Memory.String);
-
-	for (ulong i = 0; i < state.ShaderCount; i++)
-	{
-		Memory.Free(state.ShaderPaths[i], Memory.String);
-	}
-
-	Memory.Free(state.ShaderPaths, Memory.String);
+	DisposeDefinition(&state);
 
 	return material;
 }
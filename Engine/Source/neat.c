@@ -755,8 +755,8 @@ private void AssignReferenceOrganism(Species species)
 // were removed
 private ulong RemovePoorFitnessOrganisms(Population population, Species species)
 {
-	// sort by fitness
-	arrays(Organism).InsertionSort(species->Organisms, OrganismFitnessComparator);
+	// sort by fitness, stable so organisms with equal fitness keep their order and the same ones are culled every run
+	arrays(Organism).StableSort(species->Organisms, OrganismFitnessComparator, null);
 
 	// determine how many to remove
 	const ulong count = (ulong)((ai_number)species->Organisms->Count * population->OrganismCullingRate);
@@ -126,7 +126,7 @@ private void Draw(RenderMesh mesh)
 
 private RenderMesh CreateRenderMesh()
 {
-	Memory.RegisterTypeName(nameof(RenderMesh), &RenderMeshTypeId);
+	Memory.RegisterSlabTypeName(nameof(RenderMesh), sizeof(struct _renderMesh), &RenderMeshTypeId);
 
 	RenderMesh mesh = Memory.Alloc(sizeof(struct _renderMesh), RenderMeshTypeId);
 
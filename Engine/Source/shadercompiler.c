@@ -4,6 +4,7 @@
 #include "core/memory.h"
 #include "GL/glew.h"
 #include <stdlib.h>
+#include <limits.h>
 #include "engine/graphics/shaders.h"
 #include "engine/graphics/shadercompiler.h"
 #include "core/config.h"
@@ -12,6 +13,7 @@
 #include "core/hashing.h"
 #include <string.h>
 #include "core/strings.h"
+#include "core/map.h"
 
 static Shader CompileShader(const StringArray vertexPaths, const StringArray fragmentPaths, const StringArray geometryPaths);
 static Shader Load(const string path);
@@ -54,12 +56,10 @@ static struct _shaderTypes
 
 #define CompiledHandleDictionarySize 1024
 
-Shader CompiledShaders[CompiledHandleDictionarySize];
-/// <summary>
-/// The number of handles within the compiled handles dict
-/// </summary>
-ulong HandleDictionaryCount = 0;
-ulong HandleDictionaryLength = CompiledHandleDictionarySize;
+DEFINE_MAP(ulong, Shader);
+
+// compiled shaders keyed by the full hash of their source paths, created the first time a shader is stored
+map(ulong, Shader) CompiledShaders = null;
 
 static ulong HashShaderPaths(const StringArray vertexPaths, const StringArray fragmentPaths, const StringArray geometryPaths)
 {
@@ -110,17 +110,15 @@ static bool TryGetStoredShader(const StringArray vertexPaths, const StringArray
 	// hash the two paths
 	ulong hash = HashShaderPaths(vertexPaths, fragmentPaths, geometryPaths);
 
-	// mod the hash with the array size
-	ulong index = hash % CompiledHandleDictionarySize;
-
-	Shader storedShader = CompiledShaders[index];
-
-	*out_shader = storedShader;
+	if (CompiledShaders is null)
+	{
+		return false;
+	}
 
-	return storedShader isnt null;
+	return maps(ulong, Shader).TryGetValue(CompiledShaders, hash, out_shader);
 }
 
-// stored the given handle within the compiled handle dictionary, returns true when no collision occurs
+// stored the given handle within the compiled handle dictionary, returns false when the paths were already stored
 static bool TryStoreShader(const StringArray vertexPaths, const StringArray fragmentPaths, const StringArray geometryPaths, Shader shader)
 {
 	if (vertexPaths is null or vertexPaths->Count < 1)
@@ -136,20 +134,20 @@ static bool TryStoreShader(const StringArray vertexPaths, const StringArray frag
 	// hash the two paths
 	ulong hash = HashShaderPaths(vertexPaths, fragmentPaths, geometryPaths);
 
-	// mod the hash with the array size
-	ulong index = hash % CompiledHandleDictionarySize;
-
-	Shader* position = &CompiledShaders[index];
+	if (CompiledShaders is null)
+	{
+		CompiledShaders = maps(ulong, Shader).Create(CompiledHandleDictionarySize);
+	}
 
 	// this may cause issues with disposed handles, we'll see
-	if (*position is null)
+	if (maps(ulong, Shader).ContainsKey(CompiledShaders, hash))
 	{
-		*position = shader;
-
-		return true;
+		return false;
 	}
 
-	return false;
+	maps(ulong, Shader).Set(CompiledShaders, hash, shader);
+
+	return true;
 }
 
 static bool VerifyHandle(unsigned int handle)
@@ -639,9 +637,15 @@ TOKEN_SAVE(customStencilFunction, Shader)
 
 TOKEN_LOAD(customStencilValue, struct _shaderState*)
 {
-	ignore_unused(length);
-	int count = sscanf_s(buffer, "%xui", &(state->StencilValue));
-	return count == 1;
+	unsigned long long value;
+	if (Parsing.TryGetHex(buffer, length, &value) is false or value > UINT_MAX)
+	{
+		return false;
+	}
+
+	state->StencilValue = (unsigned int)value;
+
+	return true;
 }
 
 TOKEN_SAVE(customStencilValue, Shader)
@@ -654,9 +658,15 @@ TOKEN_SAVE(customStencilValue, Shader)
 
 TOKEN_LOAD(customStencilMask, struct _shaderState*)
 {
-	ignore_unused(length);
-	int count = sscanf_s(buffer, "%xui", &(state->StencilMask));
-	return count == 1;
+	unsigned long long value;
+	if (Parsing.TryGetHex(buffer, length, &value) is false or value > UINT_MAX)
+	{
+		return false;
+	}
+
+	state->StencilMask = (unsigned int)value;
+
+	return true;
 }
 
 TOKEN_SAVE(customStencilMask, Shader)
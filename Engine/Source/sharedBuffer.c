@@ -41,7 +41,7 @@ static void Dispose(SharedHandle buffer, void* state, void(*OnDispose)(void* sta
 
 static SharedHandle CreateSharedHandle()
 {
-	Memory.RegisterTypeName(nameof(SharedHandle), &SharedHandleTypeId);
+	Memory.RegisterSlabTypeName(nameof(SharedHandle), sizeof(struct _sharedHandle), &SharedHandleTypeId);
 
 	SharedHandle buffer = Memory.Alloc(sizeof(struct _sharedHandle), SharedHandleTypeId);
 
@@ -11,6 +11,7 @@
 #include <stdlib.h>
 #include "core/config.h"
 #include "core/parsing.h"
+#include "core/cunit.h"
 
 #define PositionModifiedFlag FLAG_0
 #define RotationModifiedFlag FLAG_1
@@ -48,6 +49,7 @@ private void SetChildCapacity(Transform, ulong count);
 private void LookAt(Transform, vector3 target);
 private void LookAtPositions(Transform, float x, float y, float z);
 private vector3 TransformPoint(Transform, vector3 point);
+private void RunUnitTests();
 
 const struct _transformMethods Transforms = {
 	.Dispose = &Dispose,
@@ -78,7 +80,8 @@ const struct _transformMethods Transforms = {
 	.SetChildCapacity = &SetChildCapacity,
 	.LookAt = LookAt,
 	.LookAtPositions = LookAtPositions,
-	.TransformPoint = TransformPoint
+	.TransformPoint = TransformPoint,
+	.RunUnitTests = RunUnitTests
 };
 
 DEFINE_TYPE_ID(Transform);
@@ -105,7 +108,7 @@ private void Dispose(Transform transform)
 
 private Transform CreateTransform()
 {
-	Memory.RegisterTypeName(nameof(Transform), &TransformTypeId);
+	Memory.RegisterSlabTypeName(nameof(Transform), sizeof(struct _transform), &TransformTypeId);
 
 	Transform transform = Memory.Alloc(sizeof(struct _transform), TransformTypeId);
 
@@ -391,7 +394,7 @@ private void ReallocChildren(Transform transform, ulong newCount)
 	ulong newLength = newCount * sizeof(Transform);
 
 	// if we fail to realloc the array make a new one =(
-	if (Memory.TryRealloc(transform->Children, previousLength, newLength, (void**)&transform->Children) is false)
+	if (Memory.TryRealloc(transform->Children, previousLength, newLength, TransformTypeId, (void**)&transform->Children) is false)
 	{
 		Transform* newArray = Memory.Alloc(newLength, TransformTypeId);
 
@@ -837,4 +840,71 @@ private void Save(Transform transform, File stream)
 	GuardNotNull(stream);
 
 	Configs.SaveConfigStream(stream, &TransformConfigDefinition, transform);
-}
\ No newline at end of file
+}
+
+#define BENCHMARK_TRANSFORM_COUNT 1000000
+
+TEST(SlabAllocationBenchmark)
+{
+	Transform* transforms = Memory.Alloc(sizeof(Transform) * BENCHMARK_TRANSFORM_COUNT, Memory.GenericMemoryBlock);
+
+	// generic memory blocks never have a slab so this is the plain heap path
+	fprintf(__test_stream, "\tHeap alloc/free %i transforms ", BENCHMARK_TRANSFORM_COUNT);
+	Benchmark(
+		for (ulong i = 0; i < BENCHMARK_TRANSFORM_COUNT; i++)
+		{
+			transforms[i] = Memory.Alloc(sizeof(struct _transform), Memory.GenericMemoryBlock);
+		}
+		for (ulong i = 0; i < BENCHMARK_TRANSFORM_COUNT; i++)
+		{
+			Memory.Free(transforms[i], Memory.GenericMemoryBlock);
+		}
+	, __test_stream);
+	fprintf(__test_stream, NEWLINE);
+
+	Memory.RegisterSlabTypeName(nameof(Transform), sizeof(struct _transform), &TransformTypeId);
+
+	fprintf(__test_stream, "\tSlab alloc/free %i transforms ", BENCHMARK_TRANSFORM_COUNT);
+	Benchmark(
+		for (ulong i = 0; i < BENCHMARK_TRANSFORM_COUNT; i++)
+		{
+			transforms[i] = Memory.Alloc(sizeof(struct _transform), TransformTypeId);
+		}
+		for (ulong i = 0; i < BENCHMARK_TRANSFORM_COUNT; i++)
+		{
+			Memory.Free(transforms[i], TransformTypeId);
+		}
+	, __test_stream);
+	fprintf(__test_stream, NEWLINE);
+
+	fprintf(__test_stream, "\tTransforms.Create/Dispose %i transforms ", BENCHMARK_TRANSFORM_COUNT);
+	Benchmark(
+		for (ulong i = 0; i < BENCHMARK_TRANSFORM_COUNT; i++)
+		{
+			transforms[i] = CreateTransform();
+		}
+		for (ulong i = 0; i < BENCHMARK_TRANSFORM_COUNT; i++)
+		{
+			Dispose(transforms[i]);
+		}
+	, __test_stream);
+	fprintf(__test_stream, NEWLINE);
+
+	// freed slab elements should be handed back out before any new memory is used
+	Transform first = CreateTransform();
+	Dispose(first);
+	Transform second = CreateTransform();
+
+	IsEqual((ulong)first, (ulong)second);
+
+	Dispose(second);
+
+	Memory.Free(transforms, Memory.GenericMemoryBlock);
+
+	return true;
+}
+
+TEST_SUITE(
+	RunUnitTests,
+	APPEND_TEST(SlabAllocationBenchmark)
+)
@@ -970,10 +970,11 @@ TEST(GetMethodInfo)
 	{
 		array(int) actualInts = at(actual.TypeLocations, i);
 
-		ulong previousHash = actualInts->Hash;
 		ulong newHash = arrays(int).Hash(actualInts);
 
-		IsEqual(previousHash, newHash);
+		// the hash is cached until the array changes
+		IsFalse(actualInts->Dirty);
+		IsEqual(actualInts->Hash, newHash);
 
 		array(int) expectedInts = at(expected.TypeLocations, i);
 
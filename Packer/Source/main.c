@@ -0,0 +1,56 @@
+#include "core/memory.h"
+#include "core/array.h"
+#include "core/file.h"
+#include "core/os.h"
+#include "core/packs.h"
+#include <string.h>
+
+// bundles a directory into a pack that Files resolves paths through once it's mounted
+// usage: Packer <directory> <output.pack> [--compress]
+int main(int argc, char* argv[])
+{
+	if (argc < 3)
+	{
+		fprintf(stderr, "usage: Packer <directory> <output.pack> [--compress]"NEWLINE);
+		return 1;
+	}
+
+	const bool compress = argc > 3 and strcmp(argv[3], "--compress") is 0;
+
+	// one extra byte so the paths stay nul terminated
+	string directory = strings.Create(strlen(argv[1]) + 1);
+	strings.AppendCArray(directory, (byte*)argv[1], strlen(argv[1]));
+
+	string outputPath = strings.Create(strlen(argv[2]) + 1);
+	strings.AppendCArray(outputPath, (byte*)argv[2], strlen(argv[2]));
+
+	int result = 1;
+	Pack pack;
+
+	if (OperatingSystem.IsDirectory(directory) is false)
+	{
+		fprintf(stderr, "%s is not a directory"NEWLINE, directory->Values);
+	}
+	// the files are packed by the paths they're loaded with, so the pack must be built from the directory the engine runs in
+	else if (Packs.TryBuildDirectory(directory, outputPath, compress) is false)
+	{
+		fprintf(stderr, "Failed to build %s"NEWLINE, outputPath->Values);
+	}
+	else if (Packs.TryMount(outputPath, &pack) is false)
+	{
+		fprintf(stderr, "Failed to verify %s"NEWLINE, outputPath->Values);
+	}
+	else
+	{
+		Packs.Unmount(pack);
+
+		fprintf(stdout, "Packed %s into %s%s"NEWLINE, directory->Values, outputPath->Values, compress ? " (compressed)" : "");
+
+		result = 0;
+	}
+
+	strings.Dispose(directory);
+	strings.Dispose(outputPath);
+
+	return result;
+}